@@ -0,0 +1,54 @@
+/*
+ * kernel_bench.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Microbenchmarks of the control kernels (Clarke/Park, PI, SVPWM, sin/cos, biquad, observer, waveform
+ *  lookup and the whole current loop sample).
+ *
+ *  KB_kernels[] is the single list of kernels, used by both runners:
+ *  - Target (kernel_bench_target.cpp): times each kernel with CPU timer 2 and stores C28x cycles per
+ *    operation in kernelBenchResults[], which is read over the debug link (CCS Expressions window).
+ *    Enabled with KERNEL_BENCH_ON_BOOT.
+ *  - Host (HostSim/source/kernel_bench_host.cpp): times each kernel with a wall clock, reports ns per
+ *    operation and compares against a saved baseline to catch regressions.
+ *
+ *  Every kernel run does KB_BATCH operations on inputs prepared by KB_init(), so generating the inputs
+ *  and the call overhead aren't part of the time.
+ */
+
+#ifndef BENCHMARK_INCLUDE_KERNEL_BENCH_H_
+#define BENCHMARK_INCLUDE_KERNEL_BENCH_H_
+
+#include <stdint.h>
+
+#define KERNEL_BENCH_ON_BOOT 0 // 1 = run the benchmarks on the target before the controller starts
+#define KERNEL_BENCH_IN_RAM 1 // 1 = kernels run from RAM like the ISRs (HOT_FUNC); 0 = from flash, to measure the difference
+
+#define KB_BATCH 64 // Operations per kernel run
+#define KB_MAX_KERNELS 16
+
+typedef struct {
+    const char *name; // Matched against the host baseline file, so keep it stable
+    void (*run)(void); // KB_BATCH operations
+} KB_Kernel;
+
+typedef struct {
+    const char *name;
+    float cycles_per_op; // SYSCLK cycles, with the timing overhead removed
+} KB_Result;
+
+extern const KB_Kernel KB_kernels[];
+extern const uint16_t KB_kernelCount;
+
+/* Prepares the inputs and kernel state. Call once before running any kernel. */
+void KB_init(void);
+
+/* Target runner. Interrupts must be disabled (call before EnableInterrupts()). */
+void KB_runOnTarget(void);
+
+extern KB_Result kernelBenchResults[KB_MAX_KERNELS];
+extern volatile uint16_t kernelBenchDone; // Set to 1 when kernelBenchResults is complete
+
+#endif /* BENCHMARK_INCLUDE_KERNEL_BENCH_H_ */
@@ -0,0 +1,211 @@
+/*
+ * kernel_bench.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  The benchmarked kernels. Compiled into the CPU1 firmware and into the host runner, so both time
+ *  exactly the same code.
+ */
+
+#include "kernel_bench.h"
+#include "foc.h"
+#include "filters.h"
+#include "cla_shared.h"
+#include "trig_tables.h"
+#include "hot_path.h"
+
+#if KERNEL_BENCH_IN_RAM
+#define KB_PLACEMENT HOT_FUNC
+#else
+#define KB_PLACEMENT
+#endif
+
+#define KB_WAVE_SAMPLES 1000 // Samples per revolution of the waveform lookup, as in ThreePhaseGen
+#define KB_WAVE_PERIOD 250 // ThreePhaseGen's ePWM period (TBCLKs)
+
+static float inputAngle[KB_BATCH]; // Per-unit
+static float inputCurrentA[KB_BATCH]; // A
+static float inputCurrentB[KB_BATCH];
+static FOC_AlphaBeta inputVoltage[KB_BATCH]; // V
+static uint16_t inputAdc[KB_BATCH]; // ADC counts around mid scale
+
+static uint16_t waveTable[KB_WAVE_SAMPLES]; // Compare values, like ThreePhaseGen's generated table
+static uint16_t waveIndex[3];
+static uint16_t waveCompare[3];
+
+static FOC_PI benchPi;
+static FILT_Biquad benchBiquad;
+static OBS_FluxObserver benchObserver;
+static FOC_CurrentLoop benchLoop;
+static OBS_Sensorless benchSensorless;
+static CLA_CurrentLoopParams benchParams;
+static CLA_CurrentLoopTelemetry benchTelemetry;
+
+volatile float KB_sink; // Every kernel writes its result here so the compiler can't remove the work
+
+/* Linear congruential generator, so the inputs are the same on every build and target */
+static uint32_t lcgState;
+static float nextUniform(void) {
+    lcgState = lcgState*1664525UL + 1013904223UL;
+    return (float)(lcgState >> 8)*(1.0f/16777216.0f); // [0, 1)
+}
+
+void KB_init(void) {
+    lcgState = 12345;
+    for (uint16_t k = 0; k < KB_BATCH; k++) {
+        inputAngle[k] = nextUniform();
+        inputCurrentA[k] = 10.0f*nextUniform() - 5.0f;
+        inputCurrentB[k] = 10.0f*nextUniform() - 5.0f;
+        inputVoltage[k].alpha = 12.0f*nextUniform() - 6.0f;
+        inputVoltage[k].beta = 12.0f*nextUniform() - 6.0f;
+        inputAdc[k] = (uint16_t)(1848.0f + 400.0f*nextUniform());
+    }
+
+    for (uint16_t k = 0; k < KB_WAVE_SAMPLES; k++) {
+        waveTable[k] = (uint16_t)(KB_WAVE_PERIOD*(0.5f + 0.5f*FOC_sinPuPortable((float)k/KB_WAVE_SAMPLES)) + 0.5f);
+    }
+    waveIndex[0] = 0;
+    waveIndex[1] = KB_WAVE_SAMPLES/3;
+    waveIndex[2] = 2*KB_WAVE_SAMPLES/3;
+
+    FOC_initPI(&benchPi, 0.5f, 500.0f, 1.0f/FOC_SAMPLING_FREQUENCY, 10.0f);
+    FILT_initLowPass(&benchBiquad, 100.0f, 0.707f, FOC_SAMPLING_FREQUENCY);
+    OBS_initFluxObserver(&benchObserver, MOTOR_RS, MOTOR_LD, MOTOR_LQ, MOTOR_FLUX,
+                         1.0f/FOC_SAMPLING_FREQUENCY, OBS_PLL_BANDWIDTH_HZ);
+
+    FOC_initCurrentLoop(&benchLoop, MOTOR_RS, MOTOR_LD, MOTOR_LQ, MOTOR_FLUX, 1.0f/FOC_SAMPLING_FREQUENCY,
+                        FOC_CURRENT_BANDWIDTH_HZ, FOC_CURRENT_LOOP_DELAY, FOC_DEAD_TIME_DUTY);
+    FOC_initSensorless(&benchSensorless);
+    const FOC_DQ i_ref = {0.0f, 2.0f};
+    CLA_forceCurrentReference(&benchParams, i_ref);
+    CLA_initCurrentGains(&benchParams, FOC_designCurrentGains(MOTOR_RS, MOTOR_LD, MOTOR_LQ, 1.0f/FOC_SAMPLING_FREQUENCY,
+                                                              FOC_CURRENT_BANDWIDTH_HZ));
+    benchParams.angle.theta = 0.0f;
+    benchParams.angle.omega = 0.0f;
+    SEQ_init(&benchParams.angle_sequence);
+    benchParams.current_scale = 0.01f;
+    benchParams.current_offset_a = 2048.0f;
+    benchParams.current_offset_b = 2048.0f;
+    benchParams.vdc_scale = 0.01f; // Mid scale is about 20 V
+    benchParams.pwm_period = 62;
+    benchParams.enable = 1;
+    benchParams.sensorless = 1; // The most expensive path: observer and startup as well
+    SEQ_init(&benchTelemetry.sequence);
+    benchTelemetry.sample_count = 0;
+}
+
+KB_PLACEMENT static void runClarkePark(void) {
+    float sum = 0.0f;
+    for (uint16_t k = 0; k < KB_BATCH; k++) {
+        FOC_SinCos sc = {0.6f, 0.8f}; // Fixed, so only the transforms are timed
+        FOC_DQ dq = FOC_park(FOC_clarke(inputCurrentA[k], inputCurrentB[k]), sc);
+        sum += dq.d + dq.q;
+    }
+    KB_sink = sum;
+}
+
+KB_PLACEMENT static void runPi(void) {
+    float sum = 0.0f;
+    for (uint16_t k = 0; k < KB_BATCH; k++) {
+        sum += FOC_runPI(&benchPi, inputCurrentA[k], 0.0f);
+    }
+    KB_sink = sum;
+}
+
+KB_PLACEMENT static void runSvpwm(void) {
+    float duty[3];
+    float sum = 0.0f;
+    for (uint16_t k = 0; k < KB_BATCH; k++) {
+        FOC_modulate(inputVoltage[k], 1.0f/24.0f, duty);
+        sum += duty[0] + duty[1] + duty[2];
+    }
+    KB_sink = sum;
+}
+
+#if FOC_USE_TMU
+KB_PLACEMENT static void runSinCosTmu(void) {
+    float sum = 0.0f;
+    for (uint16_t k = 0; k < KB_BATCH; k++) {
+        FOC_SinCos sc = FOC_sinCos(inputAngle[k]);
+        sum += sc.sine + sc.cosine;
+    }
+    KB_sink = sum;
+}
+#endif
+
+KB_PLACEMENT static void runSinCosTable(void) {
+    float sum = 0.0f;
+    for (uint16_t k = 0; k < KB_BATCH; k++) {
+        float position = inputAngle[k]*TRIG_SIN_SIZE;
+        uint16_t i = (uint16_t)position;
+        float fraction = position - (float)i;
+        uint16_t j = i + TRIG_SIN_SIZE/4;
+        float sine = TRIG_sinTable[i] + fraction*(TRIG_sinTable[i + 1] - TRIG_sinTable[i]);
+        float cosine = TRIG_sinTable[j] + fraction*(TRIG_sinTable[j + 1] - TRIG_sinTable[j]);
+        sum += sine + cosine;
+    }
+    KB_sink = sum;
+}
+
+KB_PLACEMENT static void runSinCosPolynomial(void) {
+    float sum = 0.0f;
+    for (uint16_t k = 0; k < KB_BATCH; k++) {
+        sum += FOC_sinPuPortable(inputAngle[k]) + FOC_sinPuPortable(inputAngle[k] + 0.25f);
+    }
+    KB_sink = sum;
+}
+
+KB_PLACEMENT static void runBiquad(void) {
+    float sum = 0.0f;
+    for (uint16_t k = 0; k < KB_BATCH; k++) {
+        sum += FILT_runBiquad(&benchBiquad, inputCurrentA[k]);
+    }
+    KB_sink = sum;
+}
+
+KB_PLACEMENT static void runFluxObserver(void) {
+    for (uint16_t k = 0; k < KB_BATCH; k++) {
+        FOC_AlphaBeta i = {inputCurrentA[k], inputCurrentB[k]};
+        OBS_runFluxObserver(&benchObserver, inputVoltage[k], i);
+    }
+    KB_sink = benchObserver.theta;
+}
+
+/* ThreePhaseGen's timer ISR: advance three table indices and look up their compare values */
+KB_PLACEMENT static void runWaveformLookup(void) {
+    for (uint16_t k = 0; k < KB_BATCH; k++) {
+        for (uint16_t phase = 0; phase < 3; phase++) {
+            uint16_t index = waveIndex[phase] < KB_WAVE_SAMPLES - 1 ? waveIndex[phase] + 1 : 0;
+            waveIndex[phase] = index;
+            waveCompare[phase] = waveTable[index];
+        }
+    }
+    KB_sink = (float)(waveCompare[0] + waveCompare[1] + waveCompare[2]);
+}
+
+KB_PLACEMENT static void runCurrentLoopSample(void) {
+    uint16_t cmp[3];
+    for (uint16_t k = 0; k < KB_BATCH; k++) {
+        CLA_runCurrentLoopSample(&benchLoop, &benchSensorless, &benchParams, inputAdc[k],
+                                 inputAdc[KB_BATCH - 1 - k], 2048, cmp, &benchTelemetry);
+    }
+    KB_sink = (float)cmp[0];
+}
+
+const KB_Kernel KB_kernels[] = {
+    {"clarke_park", runClarkePark},
+    {"pi", runPi},
+    {"svpwm", runSvpwm},
+#if FOC_USE_TMU
+    {"sincos_tmu", runSinCosTmu},
+#endif
+    {"sincos_table", runSinCosTable},
+    {"sincos_polynomial", runSinCosPolynomial},
+    {"biquad", runBiquad},
+    {"flux_observer", runFluxObserver},
+    {"waveform_lookup", runWaveformLookup},
+    {"current_loop_sample", runCurrentLoopSample},
+};
+
+const uint16_t KB_kernelCount = sizeof(KB_kernels)/sizeof(KB_kernels[0]);
@@ -0,0 +1,48 @@
+/*
+ * kernel_bench_target.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Target runner: times the kernels in SYSCLK cycles with CPU timer 2.
+ */
+
+#include "kernel_bench.h"
+#include "timers.h"
+
+#define KB_REPEATS 8 // Minimum over this many runs, to drop flash wait states on the first run
+
+KB_Result kernelBenchResults[KB_MAX_KERNELS];
+volatile uint16_t kernelBenchDone = 0;
+
+static void emptyRun(void) {
+}
+
+/* Fewest timer counts taken by one run of the kernel */
+static uint32_t timeKernel(Timer &timer, void (*run)(void)) {
+    uint32_t best = 0xFFFFFFFF;
+    for (uint16_t r = 0; r < KB_REPEATS; r++) {
+        uint32_t start = timer.read();
+        run();
+        uint32_t elapsed = start - timer.read(); // Counts down. Won't wrap: ~170 s at 25 MHz.
+        if (elapsed < best) {
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+void KB_runOnTarget(void) {
+    Timer timer2(TIMER2, 0xFFFFFFFF, 1); // Free running at SYSCLK, so one count is one cycle
+    KB_init();
+
+    uint32_t overhead = timeKernel(timer2, emptyRun); // Call and timer reads
+    uint16_t count = KB_kernelCount < KB_MAX_KERNELS ? KB_kernelCount : KB_MAX_KERNELS;
+    for (uint16_t k = 0; k < count; k++) {
+        uint32_t counts = timeKernel(timer2, KB_kernels[k].run);
+        counts = counts > overhead ? counts - overhead : 0;
+        kernelBenchResults[k].name = KB_kernels[k].name;
+        kernelBenchResults[k].cycles_per_op = (float)counts/KB_BATCH;
+    }
+    kernelBenchDone = 1;
+}
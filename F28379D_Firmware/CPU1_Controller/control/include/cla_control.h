@@ -0,0 +1,24 @@
+/*
+ * cla_control.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  C28x side of the CLA current loop. See cla_shared.h for the data shared with the CLA.
+ *
+ *  Memory used:
+ *  - RAMLS4: CLA program memory (Cla1Prog, copied from flash at boot)
+ *  - RAMLS1: CLA data memory (.bss_cla, .scratchpad, .const_cla)
+ *  - CPU-to-CLA1 message RAM: claParams
+ *  - CLA1-to-CPU message RAM: claTelemetry
+ */
+
+#ifndef CONTROL_INCLUDE_CLA_CONTROL_H_
+#define CONTROL_INCLUDE_CLA_CONTROL_H_
+
+#include "cla_shared.h"
+
+void ConfigCla(); // Call after ConfigPwm() and ConfigAdcs(). Starts the current loop on the CLA.
+void CLA_enableCurrentLoop(bool enable);
+
+#endif /* CONTROL_INCLUDE_CLA_CONTROL_H_ */
@@ -0,0 +1,258 @@
+/*
+ * cla_shared.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Variables and functions shared between the C28x and CLA1 for running the current loop on the CLA.
+ *
+ *  CLA Task 1 is triggered directly by ADCA INT1 (end of conversion of the phase currents) and runs
+ *  CLA_runCurrentLoopSample(). The C28x only updates the parameter block in CPU-to-CLA message RAM
+ *  and reads the telemetry block from CLA-to-CPU message RAM.
+ *
+ *  Only types with the same size on both cores (float, uint16_t, uint32_t) are used in the shared
+ *  blocks. 'int', enums and pointers are different sizes on the CLA.
+ *
+ *  The current reference and the regulator gains are double-buffered the same way: the C28x fills the
+ *  slot the loop isn't using and switches an index to it with one write, the loop reads the index once at
+ *  the start of each sample and reports the slot it took in its telemetry. The loop never copies a set or
+ *  waits, and a sample never sees half of one.
+ *
+ *  State that changes every time it is written is guarded by a sequence count instead (seqlock.h): the
+ *  angle and speed from the C28x, which the loop reads again if it caught the C28x writing them, and the
+ *  telemetry, which the C28x copies with CLA_readTelemetry() to get all its fields from one sample.
+ */
+
+#ifndef CONTROL_INCLUDE_CLA_SHARED_H_
+#define CONTROL_INCLUDE_CLA_SHARED_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "foc_math.h"
+#include "observer.h"
+#include "seqlock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A current reference and where it came from */
+typedef struct {
+    FOC_DQ i_ref; // (A)
+    uint32_t sequence; // Sequence number of the reference message (see MOTION_Reference), 0 if set locally
+} CLA_CurrentReference;
+
+/* A set of current regulator gains and its version, which the telemetry reports for each sample */
+typedef struct {
+    FOC_CurrentGains pi;
+    uint32_t version; // Incremented by each CLA_commitCurrentGains()
+} CLA_CurrentGains;
+
+/* Rotor angle and speed for the next sample, written together by CLA_setRotorAngle() */
+typedef struct {
+    float theta; // Electrical angle at the next sampling instant (per-unit)
+    float omega; // Electrical speed (rad/s)
+} CLA_RotorAngle;
+
+#define CLA_ANGLE_READ_TRIES 3 // A sample that can't get a coherent angle in this many uses the last one
+#define CLA_TELEMETRY_READ_TRIES 3 // CLA_readTelemetry() gives up after this many torn copies
+
+/* Written by the C28x, read by the CLA. Placed in CpuToCla1MsgRAM. */
+typedef struct {
+    CLA_CurrentReference ref[2]; // Written alternately by CLA_setCurrentReference()
+    uint16_t ref_index; // Slot of ref[] the next sample uses. Written after the slot, so a sample sees a whole reference.
+    CLA_CurrentGains gains[2]; // The active set and the shadow set (CLA_editCurrentGains())
+    uint16_t gains_index; // Slot of gains[] the next sample uses
+    CLA_RotorAngle angle;
+    SEQ_Count angle_sequence; // Odd while CLA_setRotorAngle() writes angle
+    float current_scale; // Amps per ADC count
+    float current_offset_a; // ADC counts at zero current for phase A
+    float current_offset_b; // ADC counts at zero current for phase B
+    float vdc_scale; // Volts per ADC count
+    uint16_t pwm_period; // TBPRD of the phase ePWMs
+    uint16_t enable; // 0 = hold all phases at 50% duty and reset the regulators
+    uint16_t sensorless; // 1 = angle, speed and (during startup) current references come from the observer
+} CLA_CurrentLoopParams;
+
+/* Written by the CLA, read by the C28x. Placed in Cla1ToCpuMsgRAM. */
+typedef struct {
+    SEQ_Count sequence; // Odd while a sample writes the fields from ia to sample_count
+    float ia;
+    float ib;
+    float vdc;
+    FOC_DQ i_dq;
+    FOC_DQ v_dq;
+    float theta; // Angle used by the Park transforms (per-unit)
+    float omega; // Speed used for decoupling (rad/s)
+    uint16_t startup_state; // OBS_STATE_x when sensorless
+    uint16_t ref_index; // Slot of claParams.ref[] the running or last sample took its reference from
+    uint32_t ref_sequence; // Sequence number of that reference
+    uint16_t gains_index; // Slot of claParams.gains[] the running or last sample took its gains from
+    uint32_t gains_version; // Version of those gains
+    uint32_t sample_count; // Incremented every sample, so the C28x can tell when new data is available
+    uint16_t angle_stale; // Samples which used the last angle because the C28x was writing it every try
+} CLA_CurrentLoopTelemetry;
+
+extern CLA_CurrentLoopParams claParams;
+extern CLA_CurrentLoopTelemetry claTelemetry;
+extern FOC_CurrentLoop claLoop; // CLA Task 1's loop state (cla_tasks.cla), in CLA data RAM the C28x can read
+
+/* One sample of the current loop from raw ADC results to compare values.
+ * This is the whole of CLA Task 1 apart from the register accesses, so it can also be run on the
+ * C28x or on a host PC with exactly the same maths.
+ *
+ * \param cmp receives the CMPA values for phases A, B and C
+ * */
+static inline void CLA_runCurrentLoopSample(FOC_CurrentLoop *foc, OBS_Sensorless *obs,
+                                            const CLA_CurrentLoopParams *p,
+                                            uint16_t adc_ia, uint16_t adc_ib, uint16_t adc_vdc,
+                                            uint16_t cmp[3], CLA_CurrentLoopTelemetry *t) {
+    float ia = ((float)adc_ia - p->current_offset_a) * p->current_scale;
+    float ib = ((float)adc_ib - p->current_offset_b) * p->current_scale;
+    float vdc = (float)adc_vdc * p->vdc_scale;
+    float period = (float)p->pwm_period;
+    CLA_RotorAngle angle;
+    if (!SEQ_read(&p->angle_sequence, &angle, &p->angle, sizeof(angle), CLA_ANGLE_READ_TRIES)) {
+        angle.theta = t->theta; // The angle and speed of the last sample, which are coherent
+        angle.omega = t->omega;
+        t->angle_stale++;
+    }
+    float theta = angle.theta;
+    float omega = angle.omega;
+    uint16_t slot = p->ref_index; // Read once: this sample uses this slot even if the C28x switches meanwhile
+    t->ref_index = slot; // Tells the C28x the other slot is free
+    uint16_t gains_slot = p->gains_index; // The same for the gains
+    t->gains_index = gains_slot;
+    const CLA_CurrentGains *gains = &p->gains[gains_slot];
+
+    if (p->enable && vdc > 1.0f) {
+        FOC_AlphaBeta i_ab = FOC_clarke(ia, ib);
+        foc->i_ref = p->ref[slot].i_ref;
+        if (p->sensorless) {
+            OBS_runSensorless(obs, foc->v_ab, i_ab, &theta, &omega, &foc->i_ref);
+        }
+        FOC_runCurrentLoopAB(foc, &gains->pi, i_ab, theta, omega, vdc);
+    }
+    else {
+        foc->pi_d.integrator = 0.0f;
+        foc->pi_q.integrator = 0.0f;
+        foc->v_ab.alpha = 0.0f;
+        foc->v_ab.beta = 0.0f;
+        OBS_resetSensorless(obs);
+        foc->duty[0] = 0.5f;
+        foc->duty[1] = 0.5f;
+        foc->duty[2] = 0.5f;
+    }
+
+    cmp[0] = (uint16_t)(foc->duty[0] * period);
+    cmp[1] = (uint16_t)(foc->duty[1] * period);
+    cmp[2] = (uint16_t)(foc->duty[2] * period);
+
+    SEQ_writeBegin(&t->sequence); // The indexes above are outside: the C28x reads each of them on its own
+    t->ia = ia;
+    t->ib = ib;
+    t->vdc = vdc;
+    t->i_dq = foc->i_dq;
+    t->v_dq = foc->v_dq;
+    t->theta = theta;
+    t->omega = omega;
+    t->startup_state = obs->startup.state;
+    t->ref_sequence = p->ref[slot].sequence;
+    t->gains_version = gains->version;
+    t->sample_count++;
+    SEQ_writeEnd(&t->sequence);
+}
+
+#if !defined(__TMS320C28XX_CLA__) // C28x side
+
+/* Hands a current reference to the loop, whole, at its next sample, without stopping it. Call from one
+ * context on the C28x only.
+ *
+ * The reference goes in the slot the loop isn't using and ref_index is switched to it with one write.
+ * The loop reports the slot it latched in t->ref_index, so once that equals p->ref_index no sample can
+ * still be reading the other slot. Until then (two references within one sample) the new one is refused.
+ *
+ * \return false if the loop hasn't started a sample since the last reference, and nothing was written
+ */
+static inline bool CLA_setCurrentReference(CLA_CurrentLoopParams *p, const CLA_CurrentLoopTelemetry *t,
+                                           FOC_DQ i_ref, uint32_t sequence) {
+    uint16_t slot = p->ref_index;
+    if (t->ref_index != slot) {
+        return false;
+    }
+    slot ^= 1U;
+    p->ref[slot].i_ref = i_ref;
+    p->ref[slot].sequence = sequence;
+    p->ref_index = slot; // The next sample takes the whole new reference
+    return true;
+}
+
+/* Sets both slots. Only for when the loop can't be running a sample: initialisation, and simulations
+ * that run the loop and the C28x code in turn. */
+static inline void CLA_forceCurrentReference(CLA_CurrentLoopParams *p, FOC_DQ i_ref) {
+    p->ref[0].i_ref = i_ref;
+    p->ref[0].sequence = 0;
+    p->ref[1] = p->ref[0];
+    p->ref_index = 0;
+}
+
+/* Hands the loop the angle and speed for its next sample. Call from one context on the C28x only. */
+static inline void CLA_setRotorAngle(CLA_CurrentLoopParams *p, float theta, float omega) {
+    SEQ_writeBegin(&p->angle_sequence);
+    p->angle.theta = theta;
+    p->angle.omega = omega;
+    SEQ_writeEnd(&p->angle_sequence);
+}
+
+/* Copies the telemetry with every field from the same sample, from any context on the C28x. A copy
+ * which overlapped a sample writing the telemetry is taken again.
+ *
+ * \return false if every try overlapped a sample (snapshot then holds a torn copy)
+ * */
+static inline bool CLA_readTelemetry(const CLA_CurrentLoopTelemetry *t, CLA_CurrentLoopTelemetry *snapshot) {
+    return SEQ_read(&t->sequence, snapshot, t, sizeof(*t), CLA_TELEMETRY_READ_TRIES);
+}
+
+/* Sets both gain slots, as version 0. Only for when the loop can't be running a sample. */
+static inline void CLA_initCurrentGains(CLA_CurrentLoopParams *p, FOC_CurrentGains gains) {
+    p->gains[0].pi = gains;
+    p->gains[0].version = 0;
+    p->gains[1] = p->gains[0];
+    p->gains_index = 0;
+}
+
+/* Starts a change of the gains: returns the shadow set, a copy of the active one, to edit in place as
+ * long as needed, then CLA_commitCurrentGains(). Call from one context on the C28x only.
+ *
+ * The shadow is the slot the loop isn't using, once it has taken the last commit (t->gains_index equals
+ * p->gains_index). Until then, within a sample of the commit, there is no free slot.
+ *
+ * \return 0 if the loop hasn't started a sample since the last commit, and nothing was written
+ * */
+static inline CLA_CurrentGains *CLA_editCurrentGains(CLA_CurrentLoopParams *p, const CLA_CurrentLoopTelemetry *t) {
+    uint16_t slot = p->gains_index;
+    if (t->gains_index != slot) {
+        return 0;
+    }
+    CLA_CurrentGains *shadow = &p->gains[slot ^ 1U];
+    *shadow = p->gains[slot];
+    return shadow;
+}
+
+/* Makes the set from CLA_editCurrentGains() the loop's, whole, from its next sample, as the next version */
+static inline void CLA_commitCurrentGains(CLA_CurrentLoopParams *p) {
+    uint16_t slot = p->gains_index ^ 1U;
+    p->gains[slot].version = p->gains[slot ^ 1U].version + 1U;
+    p->gains_index = slot; // The one write the loop sees
+}
+#endif
+
+/* CLA tasks (cla_tasks.cla) */
+__interrupt void Cla1Task1(); // Current loop, triggered by ADCA INT1
+__interrupt void Cla1Task8(); // Initialises the current loop state, forced by software
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONTROL_INCLUDE_CLA_SHARED_H_ */
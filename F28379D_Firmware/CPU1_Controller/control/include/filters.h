@@ -0,0 +1,65 @@
+/*
+ * filters.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Second order (biquad) IIR filter, transposed direct form II, for smoothing measurements such as
+ *  speed and DC link voltage. Two states and five multiplies per sample.
+ *
+ *  Written like foc_math.h (plain C static inline) so it runs on the C28x, the CLA or a host PC.
+ *  The design function uses FOC_sinCos(), so it doesn't need the RTS library either.
+ */
+
+#ifndef CONTROL_INCLUDE_FILTERS_H_
+#define CONTROL_INCLUDE_FILTERS_H_
+
+#include "foc_math.h"
+
+typedef struct {
+    // Coefficients, normalised so a0 = 1
+    float b0;
+    float b1;
+    float b2;
+    float a1;
+    float a2;
+
+    // State
+    float s1;
+    float s2;
+} FILT_Biquad;
+
+/* Designs a low pass biquad (bilinear transform, RBJ cookbook).
+ *
+ * \param cutoff_Hz must be below half the sampling frequency
+ * \param Q is 0.707 for a Butterworth response
+ * */
+static inline void FILT_initLowPass(FILT_Biquad *f, float cutoff_Hz, float Q, float sampling_Hz) {
+    FOC_SinCos sc = FOC_sinCos(cutoff_Hz/sampling_Hz); // w0 = 2*pi*fc/fs
+    float alpha = sc.sine/(2.0f*Q);
+    float inv_a0 = 1.0f/(1.0f + alpha);
+    f->b0 = 0.5f*(1.0f - sc.cosine)*inv_a0;
+    f->b1 = (1.0f - sc.cosine)*inv_a0;
+    f->b2 = f->b0;
+    f->a1 = -2.0f*sc.cosine*inv_a0;
+    f->a2 = (1.0f - alpha)*inv_a0;
+    f->s1 = 0.0f;
+    f->s2 = 0.0f;
+}
+
+/* Starts the filter in steady state at x, to avoid the step from zero */
+static inline void FILT_resetBiquad(FILT_Biquad *f, float x) {
+    float gain = (f->b0 + f->b1 + f->b2)/(1.0f + f->a1 + f->a2); // DC gain
+    float y = gain*x;
+    f->s1 = y - f->b0*x;
+    f->s2 = f->b2*x - f->a2*y;
+}
+
+static inline float FILT_runBiquad(FILT_Biquad *f, float x) {
+    float y = f->b0*x + f->s1;
+    f->s1 = f->b1*x - f->a1*y + f->s2;
+    f->s2 = f->b2*x - f->a2*y;
+    return y;
+}
+
+#endif /* CONTROL_INCLUDE_FILTERS_H_ */
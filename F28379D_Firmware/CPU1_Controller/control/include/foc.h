@@ -0,0 +1,123 @@
+/*
+ * foc.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Field-oriented current control of a PMSM on the three half bridges in pwm.h.
+ *  The maths is in foc_math.h so it can be shared with the CLA and the host simulation.
+ */
+
+#ifndef CONTROL_INCLUDE_FOC_H_
+#define CONTROL_INCLUDE_FOC_H_
+
+#include "foc_math.h"
+#include "observer.h"
+#include "cla_shared.h" // CLA_CurrentLoopTelemetry
+#include "adc_channels.h"
+#include "clock_config.h"
+
+#define FOC_RUN_ON_CLA 1 // 0 = Current loop runs in the ADCA1 ISR on the C28x; 1 = Current loop runs in CLA Task 1
+
+// Current loop sampling frequency. Must divide the PWM frequency so sampling stays synchronous.
+#define FOC_SAMPLING_FREQUENCY 20000
+#define FOC_CURRENT_BANDWIDTH_HZ 1000 // Closed loop current bandwidth
+#define FOC_CURRENT_GAIN_MAX 100.0f // Largest gain FOC_setCurrentGains() takes. The design gains are ~1 V/A.
+
+// The PWM as pwm.h sets it up, for the CLA which can't include it. foc.cpp checks them against pwm.h.
+#define FOC_PWM_FREQUENCY_HZ 100000 // PWM_FREQUENCY_HZ
+#define FOC_DEAD_TIME_TBCLKS 2 // PWM_DEAD_TIME_NS rounded up to whole TBCLKs (PLLSYSCLK/2)
+
+// Sampling to applied voltage: SOCA is at the timer top and the compares load at the next zero, half a PWM
+// period later, and then hold for a sample, which is half a sample on average. This takes the loop to be done
+// by that zero; each later zero it makes adds a PWM period.
+#define FOC_CURRENT_LOOP_DELAY (0.5f*FOC_SAMPLING_FREQUENCY/FOC_PWM_FREQUENCY_HZ + 0.5f) // Samples
+#define FOC_DEAD_TIME_DUTY ((float)FOC_DEAD_TIME_TBCLKS*FOC_PWM_FREQUENCY_HZ/(PLLSYSCLK/2))
+
+// Sensorless observer and I/f startup (see observer.h)
+#define OBS_PLL_BANDWIDTH_HZ 50
+#define STARTUP_CURRENT 2.0 // Alignment and I/f current (A)
+#define STARTUP_ALIGN_TIME 0.5 // (s)
+#define STARTUP_ACCELERATION 500.0 // I/f frequency ramp (electrical rad/s^2)
+#define STARTUP_HANDOVER_SPEED 200.0 // (electrical rad/s)
+#define STARTUP_HANDOVER_TIME 0.1 // (s)
+
+// Motor parameters
+#define MOTOR_RS 0.36 // Stator resistance (ohm)
+#define MOTOR_LD 0.0002 // d-axis inductance (H)
+#define MOTOR_LQ 0.0002 // q-axis inductance (H)
+#define MOTOR_FLUX 0.0064 // Permanent magnet flux linkage (Wb)
+#define MOTOR_POLE_PAIRS 4
+
+void ConfigFoc(); // Starts the ADC-triggered current loop. Call after ConfigPwm() and ConfigAdcs().
+bool FOC_setCurrentReference(float id, float iq, uint32_t sequence); // Used whole from the next sample; false if refused (see CLA_setCurrentReference())
+bool FOC_setCurrentGains(const FOC_CurrentGains *gains); // Used whole from the next sample; false if out of range or refused (see CLA_editCurrentGains())
+void FOC_setRotorAngle(float theta, float omega); // Angle (per-unit) and speed (rad/s) used together by the next sample
+void FOC_setSensorless(bool sensorless); // Use the observer instead of FOC_setRotorAngle()
+const CLA_CurrentLoopTelemetry *FOC_getTelemetry(); // Written by whichever core runs the loop, every sample
+uint32_t FOC_getSamplePeriodCycles(); // Actual SYSCLK cycles between samples, from the PWM period
+
+extern FOC_CurrentLoop focLoop;
+extern OBS_Sensorless focObserver;
+
+// The running loop's telemetry and state by name, for tables of addresses (scope.h)
+#if FOC_RUN_ON_CLA
+#define FOC_TELEMETRY claTelemetry
+#define FOC_LOOP claLoop
+#else
+#define FOC_TELEMETRY focTelemetry
+#define FOC_LOOP focLoop
+extern CLA_CurrentLoopTelemetry focTelemetry;
+#endif
+
+/* Initialises the observer and I/f startup with the parameters above. Inline plain C since CLA Task 8 uses it too. */
+static inline void FOC_initSensorless(OBS_Sensorless *obs) {
+    OBS_initFluxObserver(&obs->observer, MOTOR_RS, MOTOR_LD, MOTOR_LQ, MOTOR_FLUX,
+                         1.0f/FOC_SAMPLING_FREQUENCY, OBS_PLL_BANDWIDTH_HZ);
+    OBS_initStartup(&obs->startup, 1.0f/FOC_SAMPLING_FREQUENCY, STARTUP_CURRENT, STARTUP_ALIGN_TIME,
+                    STARTUP_ACCELERATION, STARTUP_HANDOVER_SPEED, STARTUP_HANDOVER_TIME);
+}
+
+/* Sets up the parameter block for a stopped loop: no current, the design gains, the angle at zero, the
+ * scaling of the analogue front end (adc_channels.h) and the loop disabled. ConfigCla() does this before
+ * the CLA starts, and the host simulation the same.
+ *
+ * \param pwm_period is TBPRD of the phase ePWMs
+ * */
+static inline void FOC_initLoopParams(CLA_CurrentLoopParams *p, uint16_t pwm_period) {
+    const float adc_lsb = ADC_VREF/ADC_FULL_SCALE_COUNTS; // Volts per ADC count
+    const FOC_DQ zero = {0.0f, 0.0f};
+    CLA_forceCurrentReference(p, zero);
+    CLA_initCurrentGains(p, FOC_designCurrentGains(MOTOR_RS, MOTOR_LD, MOTOR_LQ, 1.0f/FOC_SAMPLING_FREQUENCY,
+                                                   FOC_CURRENT_BANDWIDTH_HZ));
+    p->angle.theta = 0.0f;
+    p->angle.omega = 0.0f;
+    SEQ_init(&p->angle_sequence);
+    p->current_scale = CURRENT_SENSE_A_PER_V * adc_lsb;
+    p->current_offset_a = CURRENT_SENSE_OFFSET_V/adc_lsb;
+    p->current_offset_b = CURRENT_SENSE_OFFSET_V/adc_lsb;
+    p->vdc_scale = VDC_SENSE_DIVIDER * adc_lsb;
+    p->pwm_period = pwm_period;
+    p->enable = 0;
+    p->sensorless = 0;
+}
+
+/* Initialises the loop and observer state and the telemetry. Inline plain C since CLA Task 8 runs it, on
+ * the state in CLA data RAM; the host simulation uses it on its own copies. */
+static inline void FOC_initLoopState(FOC_CurrentLoop *foc, OBS_Sensorless *obs, CLA_CurrentLoopTelemetry *t) {
+    FOC_initCurrentLoop(foc, MOTOR_RS, MOTOR_LD, MOTOR_LQ, MOTOR_FLUX,
+                        1.0f/FOC_SAMPLING_FREQUENCY, FOC_CURRENT_BANDWIDTH_HZ,
+                        FOC_CURRENT_LOOP_DELAY, FOC_DEAD_TIME_DUTY);
+    FOC_initSensorless(obs);
+    SEQ_init(&t->sequence);
+    t->theta = 0.0f; // The motion controller on CPU2 reads it before the loop is enabled
+    t->omega = 0.0f;
+    t->ref_index = 0;
+    t->ref_sequence = 0;
+    t->gains_index = 0;
+    t->gains_version = 0;
+    t->sample_count = 0;
+    t->angle_stale = 0;
+}
+
+#endif /* CONTROL_INCLUDE_FOC_H_ */
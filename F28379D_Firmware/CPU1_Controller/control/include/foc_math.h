@@ -0,0 +1,356 @@
+/*
+ * foc_math.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Field-oriented control math kernels: Clarke, Park, inverse Park, PI regulators with anti-windup
+ *  and the min-max (SVPWM equivalent) three-phase modulator.
+ *
+ *  Everything here is plain C in static inline functions so the same code can be compiled by:
+ *  - the C28x C/C++ compiler (FPU32 + TMU, uses __sinpuf32/__cospuf32/__sqrtf32)
+ *  - the CLA compiler (no RTS library, uses polynomial sin/cos and __meisqrtf32)
+ *  - g++/gcc on a host PC for simulation and testing (portable polynomial sin/cos and sqrtf)
+ *
+ *  Angles are in per-unit (0 to 1 = one electrical revolution), matching the TMU instructions.
+ */
+
+#ifndef CONTROL_INCLUDE_FOC_MATH_H_
+#define CONTROL_INCLUDE_FOC_MATH_H_
+
+#include <stdint.h>
+
+#if defined(__TMS320C28XX_TMU__) && !defined(__TMS320C28XX_CLA__)
+#define FOC_USE_TMU 1 // TMU instructions available (--tmu_support)
+#else
+#define FOC_USE_TMU 0 // Portable fallback
+#include <math.h>
+#endif
+
+#define FOC_PI_F        3.14159265358979f
+#define FOC_2PI_F       6.28318530717959f
+#define FOC_INV_2PI_F   0.15915494309190f
+#define FOC_SQRT3_F     1.73205080756888f
+#define FOC_INV_SQRT3_F 0.57735026918963f
+#define FOC_SQRT3_BY_2  0.86602540378444f
+
+/* Types */
+typedef struct {
+    float alpha;
+    float beta;
+} FOC_AlphaBeta;
+
+typedef struct {
+    float d;
+    float q;
+} FOC_DQ;
+
+typedef struct {
+    float sine;
+    float cosine;
+} FOC_SinCos;
+
+typedef struct {
+    float Kp; // Proportional gain
+    float Ki_Ts; // Integral gain multiplied by the sampling period
+    float out_min; // Output limits. Can be changed every sample (e.g. by the voltage limit).
+    float out_max;
+    float integrator; // Integrator state
+} FOC_PI;
+
+/* Gains of the current regulators, kept apart from their state so the loop can take a whole set from a
+ * parameter bank (cla_shared.h) each sample */
+typedef struct {
+    float Kp_d;
+    float Ki_Ts_d; // Integral gain multiplied by the sampling period
+    float Kp_q;
+    float Ki_Ts_q;
+} FOC_CurrentGains;
+
+/* Wraps a per-unit angle to [0, 1) */
+static inline float FOC_wrapAngle(float theta) {
+    int32_t n = (int32_t)theta;
+    if ((float)n > theta) {
+        n--; // Round towards -infinity for negative angles
+    }
+    return theta - (float)n;
+}
+
+/* sin(2*pi*theta) for |theta| <= 0.25 (a quarter revolution). Taylor series to x^11, error ~1e-6 in single precision. */
+static inline float FOC_sinQuarterPu(float theta) {
+    float x = FOC_2PI_F * theta;
+    float x2 = x * x;
+    return x * (1.0f + x2 * (-1.6666667e-1f + x2 * (8.3333333e-3f + x2 * (-1.9841270e-4f
+                + x2 * (2.7557319e-6f + x2 * -2.5052108e-8f)))));
+}
+
+/* sin(2*pi*theta) for any per-unit angle. Used when there's no TMU, and kept on the C28x for comparison. */
+static inline float FOC_sinPuPortable(float theta) {
+    float t = FOC_wrapAngle(theta + 0.5f) - 0.5f; // [-0.5, 0.5)
+    if (t > 0.25f) {
+        t = 0.5f - t; // sin(pi - x) = sin(x)
+    }
+    else if (t < -0.25f) {
+        t = -0.5f - t; // sin(-pi - x) = sin(x)
+    }
+    return FOC_sinQuarterPu(t);
+}
+
+/* Sine and cosine of a per-unit angle */
+static inline FOC_SinCos FOC_sinCos(float theta) {
+    FOC_SinCos sc;
+#if FOC_USE_TMU
+    sc.sine = __sinpuf32(theta);
+    sc.cosine = __cospuf32(theta);
+#else
+    sc.sine = FOC_sinPuPortable(theta);
+    sc.cosine = FOC_sinPuPortable(theta + 0.25f);
+#endif
+    return sc;
+}
+
+static inline float FOC_sqrt(float x) {
+#if FOC_USE_TMU
+    return __sqrtf32(x);
+#elif defined(__TMS320C28XX_CLA__)
+    // Inverse square root estimate refined by two Newton-Raphson iterations
+    float y;
+    if (x <= 0.0f) {
+        return 0.0f;
+    }
+    y = __meisqrtf32(x);
+    y = y * (1.5f - 0.5f * x * y * y);
+    y = y * (1.5f - 0.5f * x * y * y);
+    return x * y;
+#else
+    return sqrtf(x);
+#endif
+}
+
+static inline float FOC_saturate(float x, float min, float max) {
+    if (x > max) {
+        return max;
+    }
+    if (x < min) {
+        return min;
+    }
+    return x;
+}
+
+/* Clarke transform (amplitude invariant) from two phase currents, assuming ia + ib + ic = 0 */
+static inline FOC_AlphaBeta FOC_clarke(float ia, float ib) {
+    FOC_AlphaBeta ab;
+    ab.alpha = ia;
+    ab.beta = FOC_INV_SQRT3_F * (ia + 2.0f * ib);
+    return ab;
+}
+
+/* Park transform: stationary alpha-beta to the rotating d-q frame */
+static inline FOC_DQ FOC_park(FOC_AlphaBeta ab, FOC_SinCos sc) {
+    FOC_DQ dq;
+    dq.d = ab.alpha * sc.cosine + ab.beta * sc.sine;
+    dq.q = -ab.alpha * sc.sine + ab.beta * sc.cosine;
+    return dq;
+}
+
+/* Inverse Park transform: rotating d-q frame to stationary alpha-beta */
+static inline FOC_AlphaBeta FOC_inversePark(FOC_DQ dq, FOC_SinCos sc) {
+    FOC_AlphaBeta ab;
+    ab.alpha = dq.d * sc.cosine - dq.q * sc.sine;
+    ab.beta = dq.d * sc.sine + dq.q * sc.cosine;
+    return ab;
+}
+
+static inline void FOC_initPI(FOC_PI *pi, float Kp, float Ki, float Ts, float limit) {
+    pi->Kp = Kp;
+    pi->Ki_Ts = Ki * Ts;
+    pi->out_min = -limit;
+    pi->out_max = limit;
+    pi->integrator = 0.0f;
+}
+
+/* Runs one step of a parallel-form PI regulator with a feedforward term, with gains given by the caller
+ * instead of the ones in pi. Anti-windup is by conditional integration: the integrator is frozen while
+ * the output is saturated in the direction the error would push it. */
+static inline float FOC_runPIWithGains(FOC_PI *pi, float Kp, float Ki_Ts, float error, float feedforward) {
+    float out = Kp * error + pi->integrator + feedforward;
+
+    if (out > pi->out_max) {
+        out = pi->out_max;
+        if (error < 0.0f) {
+            pi->integrator += Ki_Ts * error;
+        }
+    }
+    else if (out < pi->out_min) {
+        out = pi->out_min;
+        if (error > 0.0f) {
+            pi->integrator += Ki_Ts * error;
+        }
+    }
+    else {
+        pi->integrator += Ki_Ts * error;
+    }
+    return out;
+}
+
+/* Runs one step of a PI regulator with its own gains. See FOC_runPIWithGains(). */
+static inline float FOC_runPI(FOC_PI *pi, float error, float feedforward) {
+    return FOC_runPIWithGains(pi, pi->Kp, pi->Ki_Ts, error, feedforward);
+}
+
+/* Three-phase modulator. Converts the alpha-beta voltage to duty cycles between 0 and 1 using
+ * min-max zero sequence injection, which gives the same switching times as centred SVPWM and
+ * allows a peak phase voltage of Vdc/sqrt(3) before overmodulation. */
+static inline void FOC_modulate(FOC_AlphaBeta v, float inv_vdc, float duty[3]) {
+    float va = v.alpha;
+    float vb = -0.5f * v.alpha + FOC_SQRT3_BY_2 * v.beta;
+    float vc = -0.5f * v.alpha - FOC_SQRT3_BY_2 * v.beta;
+
+    float vmax = va > vb ? va : vb;
+    float vmin = va < vb ? va : vb;
+    vmax = vc > vmax ? vc : vmax;
+    vmin = vc < vmin ? vc : vmin;
+    float offset = -0.5f * (vmax + vmin);
+
+    duty[0] = FOC_saturate(0.5f + (va + offset) * inv_vdc, 0.0f, 1.0f);
+    duty[1] = FOC_saturate(0.5f + (vb + offset) * inv_vdc, 0.0f, 1.0f);
+    duty[2] = FOC_saturate(0.5f + (vc + offset) * inv_vdc, 0.0f, 1.0f);
+}
+
+/* Dead time compensation. During the dead time a diode holds each leg at the rail its current comes
+ * from, which takes the dead time off the duty of a leg sourcing current and adds it to one sinking
+ * current. Puts it back by the sign of the measured phase current.
+ *
+ * \param dead_time_duty is the dead time as a fraction of the PWM period
+ * */
+static inline void FOC_compensateDeadTime(FOC_AlphaBeta i, float dead_time_duty, float duty[3]) {
+    float ia = i.alpha;
+    float ib = -0.5f * i.alpha + FOC_SQRT3_BY_2 * i.beta;
+    float ic = -ia - ib;
+
+    duty[0] = FOC_saturate(duty[0] + (ia >= 0.0f ? dead_time_duty : -dead_time_duty), 0.0f, 1.0f);
+    duty[1] = FOC_saturate(duty[1] + (ib >= 0.0f ? dead_time_duty : -dead_time_duty), 0.0f, 1.0f);
+    duty[2] = FOC_saturate(duty[2] + (ic >= 0.0f ? dead_time_duty : -dead_time_duty), 0.0f, 1.0f);
+}
+
+/*** Current loop ***/
+
+typedef struct {
+    // Motor parameters
+    float Ld; // d-axis inductance (H)
+    float Lq; // q-axis inductance (H)
+    float flux; // Permanent magnet flux linkage (Wb)
+
+    float Ts; // Sampling period (s)
+    float delay_samples; // Delay between sampling and the applied voltage, in samples
+    float dead_time_duty; // PWM dead time as a fraction of the period (FOC_compensateDeadTime())
+
+    FOC_PI pi_d; // State and limits. The gains come from a FOC_CurrentGains every sample.
+    FOC_PI pi_q;
+
+    // References (A)
+    FOC_DQ i_ref;
+
+    // Latest results, kept for telemetry and the observer
+    FOC_AlphaBeta i_ab; // Measured currents (A)
+    FOC_DQ i_dq;
+    FOC_DQ v_dq; // Voltage commands (V)
+    FOC_AlphaBeta v_ab; // Voltage command after delay compensation, i.e. the voltage applied until the next sample
+    float duty[3]; // Phase duty cycles (0 to 1)
+} FOC_CurrentLoop;
+
+/* Current regulator gains for a closed loop current bandwidth, by pole-zero cancellation:
+ * Kp = k*L, Ki = k*R. The loop is sampled, so k is chosen for the closed loop pole of the sampled loop to
+ * be exp(-wc*Ts): k = (1 - exp(-wc*Ts))/Ts, which is wc less about wc*Ts/2 (a continuous design of k = wc
+ * comes out about 20% fast at 1kHz and 20kHz). The series is good to 0.1% up to wc*Ts = 0.5. */
+static inline FOC_CurrentGains FOC_designCurrentGains(float Rs, float Ld, float Lq, float Ts, float bandwidth_Hz) {
+    float x = FOC_2PI_F * bandwidth_Hz * Ts;
+    float k = x * (1.0f - x * (0.5f - x * (1.0f/6.0f - x * (1.0f/24.0f)))) / Ts;
+    FOC_CurrentGains gains;
+    gains.Kp_d = k * Ld;
+    gains.Ki_Ts_d = k * Rs * Ts;
+    gains.Kp_q = k * Lq;
+    gains.Ki_Ts_q = k * Rs * Ts;
+    return gains;
+}
+
+/* Initialises the current loop.
+ *
+ * \param bandwidth_Hz is the closed loop current bandwidth, which the regulators' own gains are designed
+ * for (FOC_designCurrentGains()). The loop runs with the gains it is given each sample.
+ * \param delay_samples is the average delay from sampling the currents to applying the voltage, in samples
+ * \param dead_time_duty is the PWM dead time as a fraction of the period
+ * */
+static inline void FOC_initCurrentLoop(FOC_CurrentLoop *foc, float Rs, float Ld, float Lq, float flux,
+                                       float Ts, float bandwidth_Hz, float delay_samples, float dead_time_duty) {
+    FOC_CurrentGains gains = FOC_designCurrentGains(Rs, Ld, Lq, Ts, bandwidth_Hz);
+    foc->Ld = Ld;
+    foc->Lq = Lq;
+    foc->flux = flux;
+    foc->Ts = Ts;
+    foc->delay_samples = delay_samples;
+    foc->dead_time_duty = dead_time_duty;
+    FOC_initPI(&foc->pi_d, gains.Kp_d, gains.Ki_Ts_d/Ts, Ts, 0.0f);
+    FOC_initPI(&foc->pi_q, gains.Kp_q, gains.Ki_Ts_q/Ts, Ts, 0.0f);
+    foc->i_ref.d = 0.0f;
+    foc->i_ref.q = 0.0f;
+    foc->i_ab.alpha = 0.0f;
+    foc->i_ab.beta = 0.0f;
+    foc->i_dq.d = 0.0f;
+    foc->i_dq.q = 0.0f;
+    foc->v_dq.d = 0.0f;
+    foc->v_dq.q = 0.0f;
+    foc->v_ab.alpha = 0.0f;
+    foc->v_ab.beta = 0.0f;
+    foc->duty[0] = 0.5f;
+    foc->duty[1] = 0.5f;
+    foc->duty[2] = 0.5f;
+}
+
+/* Runs one sample of the current loop from alpha-beta currents and leaves the phase duty cycles in foc->duty.
+ *
+ * \param gains are the regulator gains for this sample, read where they are
+ * \param i_ab is the measured current (A)
+ * \param theta is the electrical angle at the sampling instant (per-unit)
+ * \param omega is the electrical speed (rad/s)
+ * \param vdc is the measured DC link voltage (V)
+ * */
+static inline void FOC_runCurrentLoopAB(FOC_CurrentLoop *foc, const FOC_CurrentGains *gains, FOC_AlphaBeta i_ab,
+                                        float theta, float omega, float vdc) {
+    FOC_SinCos sc = FOC_sinCos(theta);
+    foc->i_ab = i_ab;
+    foc->i_dq = FOC_park(i_ab, sc);
+
+    // Voltage limit: the largest undistorted phase voltage with min-max modulation is Vdc/sqrt(3).
+    // The d-axis has priority and the q-axis gets what is left of the voltage circle.
+    float v_max = FOC_INV_SQRT3_F * vdc;
+    foc->pi_d.out_max = v_max;
+    foc->pi_d.out_min = -v_max;
+
+    // Decoupling feedforward cancels the cross-coupling and back-EMF terms of the dq model
+    float ff_d = -omega * foc->Lq * foc->i_dq.q;
+    float ff_q = omega * (foc->Ld * foc->i_dq.d + foc->flux);
+
+    foc->v_dq.d = FOC_runPIWithGains(&foc->pi_d, gains->Kp_d, gains->Ki_Ts_d, foc->i_ref.d - foc->i_dq.d, ff_d);
+
+    float vq_max = FOC_sqrt(v_max * v_max - foc->v_dq.d * foc->v_dq.d);
+    foc->pi_q.out_max = vq_max;
+    foc->pi_q.out_min = -vq_max;
+    foc->v_dq.q = FOC_runPIWithGains(&foc->pi_q, gains->Kp_q, gains->Ki_Ts_q, foc->i_ref.q - foc->i_dq.q, ff_q);
+
+    // The voltage is applied on average 'delay_samples' after the currents were sampled, so rotate
+    // it forward by the angle travelled in that time.
+    float theta_out = theta + omega * FOC_INV_2PI_F * foc->Ts * foc->delay_samples;
+    foc->v_ab = FOC_inversePark(foc->v_dq, FOC_sinCos(theta_out));
+
+    FOC_modulate(foc->v_ab, 1.0f / vdc, foc->duty);
+    FOC_compensateDeadTime(i_ab, foc->dead_time_duty, foc->duty);
+}
+
+/* Runs one sample of the current loop from two phase currents (A). See FOC_runCurrentLoopAB(). */
+static inline void FOC_runCurrentLoop(FOC_CurrentLoop *foc, const FOC_CurrentGains *gains, float ia, float ib,
+                                      float theta, float omega, float vdc) {
+    FOC_runCurrentLoopAB(foc, gains, FOC_clarke(ia, ib), theta, omega, vdc);
+}
+
+#endif /* CONTROL_INCLUDE_FOC_MATH_H_ */
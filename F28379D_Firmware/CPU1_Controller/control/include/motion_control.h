@@ -0,0 +1,219 @@
+/*
+ * motion_control.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Speed and position control on top of the current loop. Runs on CPU2 (CPU2_Communication/motion_task.c),
+ *  which sends the q-axis current reference to CPU1 every period and gets the rotor angle back.
+ *
+ *  - Trajectory: moves the position (or speed) reference to its target within the speed and
+ *    acceleration limits, so a step target becomes a trapezoidal move.
+ *  - Observer: tracks the unwrapped mechanical position with a model of the mechanics (inertia and the
+ *    torque from iq), estimating speed and load torque. Its speed is much smoother than differentiating
+ *    the angle, and its load torque estimate feeds forward.
+ *  - Position P and speed PI cascade, with the trajectory's speed and acceleration fed forward.
+ *
+ *  Written like foc_math.h (plain C static inline) so the same code runs on CPU2 and the host bench.
+ */
+
+#ifndef CONTROL_INCLUDE_MOTION_CONTROL_H_
+#define CONTROL_INCLUDE_MOTION_CONTROL_H_
+
+#include "foc_math.h"
+#include "observer.h" // OBS_wrapDifference()
+
+// Motion control rate. Must divide FOC_SAMPLING_FREQUENCY: CPU2 locks it to a whole number of samples.
+#define MOTION_CONTROL_FREQUENCY 2000
+
+#define MOTION_INERTIA 5e-6 // Rotor and load inertia (kg m^2), as the HostSim motor
+#define MOTION_SPEED_BANDWIDTH_HZ 40
+#define MOTION_POSITION_BANDWIDTH_HZ 12
+#define MOTION_OBSERVER_BANDWIDTH_HZ 150 // Triple pole of the observer error dynamics
+#define MOTION_MAX_CURRENT 5.0 // iq limit (A)
+#define MOTION_MAX_SPEED 300.0 // Trajectory speed limit (rad/s, mechanical)
+#define MOTION_MAX_ACCELERATION 20000.0 // Trajectory acceleration limit (rad/s^2, mechanical)
+
+#define MOTION_MODE_OFF 0 // iq = 0, everything held at the measured position
+#define MOTION_MODE_SPEED 1 // Speed target, reached with the acceleration limit
+#define MOTION_MODE_POSITION 2 // Position target, reached with the speed and acceleration limits
+
+typedef struct {
+    float max_speed; // (rad/s)
+    float max_accel; // (rad/s^2)
+    float position; // Reference (rad)
+    float speed; // (rad/s)
+    float accel; // This period's acceleration (rad/s^2)
+} MOTION_Trajectory;
+
+typedef struct {
+    float J; // Inertia (kg m^2)
+    float l1, l2, l3; // Observer gains
+    float position; // Estimated mechanical position (rad)
+    float speed; // (rad/s)
+    float load_torque; // (Nm)
+} MOTION_Observer;
+
+typedef struct {
+    // Parameters
+    float Ts;
+    float pole_pairs;
+    float Kt; // Torque constant (Nm/A)
+    float position_kp; // (1/s)
+
+    // Commands
+    uint16_t mode; // MOTION_MODE_x
+    float target; // Position (rad) or speed (rad/s), depending on the mode
+
+    // State
+    uint16_t has_angle; // 0 until the first angle, which sets the position
+    float last_theta; // Electrical angle of the previous period (per-unit)
+    float position; // Measured mechanical position, unwrapped (rad)
+    MOTION_Trajectory trajectory;
+    MOTION_Observer observer;
+    FOC_PI speed_pi; // Speed error to torque (Nm)
+    float iq_ref; // Output (A)
+} MOTION_Controller;
+
+/* Moves the trajectory one period towards the target. In position mode the speed is limited so the
+ * move can stop at the target with the acceleration limit; in speed mode only the acceleration is. */
+static inline void MOTION_runTrajectory(MOTION_Trajectory *tr, uint16_t mode, float target, float Ts) {
+    float max_step = tr->max_accel * Ts;
+    float desired = target; // Speed mode
+    if (mode == MOTION_MODE_POSITION) {
+        // The speed from which the remaining distance is exactly the braking distance
+        float distance = target - tr->position;
+        float magnitude = distance < 0.0f ? -distance : distance;
+        float speed = tr->speed < 0.0f ? -tr->speed : tr->speed;
+        if (magnitude <= max_step * Ts && speed <= max_step) {
+            tr->accel = -tr->speed / Ts; // Within one step of stopping at the target: land on it
+            tr->speed = 0.0f;
+            tr->position = target;
+            return;
+        }
+        // Braking starts after this period's step, so solve v^2/(2a) + v*Ts/2 = remaining distance
+        float direction = distance < 0.0f ? -1.0f : 1.0f;
+        float remaining = magnitude - 0.5f * direction * tr->speed * Ts;
+        remaining = remaining > 0.0f ? remaining : 0.0f;
+        float half_step = 0.5f * max_step;
+        desired = direction * (FOC_sqrt(half_step * half_step + 2.0f * tr->max_accel * remaining) - half_step);
+    }
+    desired = FOC_saturate(desired, -tr->max_speed, tr->max_speed);
+
+    float step = FOC_saturate(desired - tr->speed, -max_step, max_step);
+    float previous = tr->speed;
+    tr->speed += step;
+    tr->accel = step / Ts;
+    tr->position += 0.5f * (previous + tr->speed) * Ts;
+}
+
+/* Initialises the observer with its three error poles at -2*pi*bandwidth */
+static inline void MOTION_initObserver(MOTION_Observer *o, float J, float bandwidth_Hz) {
+    float w = FOC_2PI_F * bandwidth_Hz;
+    o->J = J;
+    o->l1 = 3.0f * w;
+    o->l2 = 3.0f * w * w;
+    o->l3 = J * w * w * w;
+    o->position = 0.0f;
+    o->speed = 0.0f;
+    o->load_torque = 0.0f;
+}
+
+/* Runs one period of the observer.
+ *
+ * \param position is the measured mechanical position (rad)
+ * \param torque is the motor torque applied over the period (Nm)
+ * */
+static inline void MOTION_runObserver(MOTION_Observer *o, float position, float torque, float Ts) {
+    float error = position - o->position;
+    o->position += Ts * (o->speed + o->l1 * error);
+    o->speed += Ts * ((torque - o->load_torque) / o->J + o->l2 * error);
+    o->load_torque -= Ts * o->l3 * error;
+}
+
+/* Starts off, with the limits and gains from the MOTION_ settings above.
+ *
+ * \param flux is the permanent magnet flux linkage (Wb), for the torque constant
+ * */
+static inline void MOTION_init(MOTION_Controller *mc, float Ts, float pole_pairs, float flux) {
+    float J = (float)MOTION_INERTIA;
+    float wc = FOC_2PI_F * (float)MOTION_SPEED_BANDWIDTH_HZ;
+    mc->Ts = Ts;
+    mc->pole_pairs = pole_pairs;
+    mc->Kt = 1.5f * pole_pairs * flux;
+    mc->position_kp = FOC_2PI_F * (float)MOTION_POSITION_BANDWIDTH_HZ;
+    mc->mode = MOTION_MODE_OFF;
+    mc->target = 0.0f;
+    mc->has_angle = 0;
+    mc->last_theta = 0.0f;
+    mc->position = 0.0f;
+    mc->trajectory.max_speed = (float)MOTION_MAX_SPEED;
+    mc->trajectory.max_accel = (float)MOTION_MAX_ACCELERATION;
+    mc->trajectory.position = 0.0f;
+    mc->trajectory.speed = 0.0f;
+    mc->trajectory.accel = 0.0f;
+    MOTION_initObserver(&mc->observer, J, (float)MOTION_OBSERVER_BANDWIDTH_HZ);
+    // Integral corner a fifth of the crossover, so the phase margin is kept
+    FOC_initPI(&mc->speed_pi, J * wc, J * wc * wc / 5.0f, Ts, mc->Kt * (float)MOTION_MAX_CURRENT);
+    mc->iq_ref = 0.0f;
+}
+
+/* Changes the period, e.g. to lock it to a whole number of current loop samples */
+static inline void MOTION_setPeriod(MOTION_Controller *mc, float Ts) {
+    mc->speed_pi.Ki_Ts *= Ts / mc->Ts;
+    mc->Ts = Ts;
+}
+
+/* Changes the mode. The trajectory starts from where the motor is, so there's no jump. */
+static inline void MOTION_setMode(MOTION_Controller *mc, uint16_t mode, float target) {
+    if (mode != mc->mode) {
+        mc->trajectory.position = mc->observer.position;
+        mc->trajectory.speed = mode == MOTION_MODE_OFF ? 0.0f : mc->observer.speed;
+        mc->speed_pi.integrator = 0.0f;
+    }
+    mc->mode = mode;
+    mc->target = target;
+}
+
+/* Runs one period.
+ *
+ * \param theta is the rotor's electrical angle (per-unit) from CPU1's current loop
+ * \return the q-axis current reference (A)
+ * */
+static inline float MOTION_run(MOTION_Controller *mc, float theta) {
+    // Unwrap the electrical angle into a mechanical position. Needs less than half an electrical
+    // revolution per period: 1000 rev/s electrical at 2 kHz.
+    if (!mc->has_angle) {
+        mc->has_angle = 1;
+        mc->last_theta = theta;
+        mc->position = 0.0f;
+        mc->observer.position = 0.0f;
+        mc->trajectory.position = 0.0f;
+    }
+    float delta = OBS_wrapDifference(theta - mc->last_theta);
+    mc->last_theta = theta;
+    mc->position += delta * FOC_2PI_F / mc->pole_pairs;
+
+    MOTION_runObserver(&mc->observer, mc->position, mc->Kt * mc->iq_ref, mc->Ts);
+
+    if (mc->mode == MOTION_MODE_OFF) {
+        mc->trajectory.position = mc->observer.position;
+        mc->trajectory.speed = 0.0f;
+        mc->trajectory.accel = 0.0f;
+        mc->speed_pi.integrator = 0.0f;
+        mc->iq_ref = 0.0f;
+        return 0.0f;
+    }
+
+    MOTION_runTrajectory(&mc->trajectory, mc->mode, mc->target, mc->Ts);
+    float speed_ref = mc->trajectory.speed;
+    if (mc->mode == MOTION_MODE_POSITION) {
+        speed_ref += mc->position_kp * (mc->trajectory.position - mc->observer.position);
+    }
+    float feedforward = mc->observer.J * mc->trajectory.accel + mc->observer.load_torque;
+    float torque = FOC_runPI(&mc->speed_pi, speed_ref - mc->observer.speed, feedforward);
+    mc->iq_ref = torque / mc->Kt;
+    return mc->iq_ref;
+}
+
+#endif /* CONTROL_INCLUDE_MOTION_CONTROL_H_ */
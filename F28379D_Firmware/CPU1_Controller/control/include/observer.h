@@ -0,0 +1,233 @@
+/*
+ * observer.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Sensorless rotor position estimation for running without an encoder.
+ *
+ *  Active flux observer:
+ *  - The stator flux is integrated from the voltage model, dpsi/dt = v - Rs*i. Pure integration drifts,
+ *    so below the crossover frequency wc the estimate is pulled towards the current model
+ *    (psi_d = Ld*id + flux, psi_q = Lq*iq) instead, which doesn't drift but depends on the angle.
+ *  - The "active flux" psi - Lq*i is aligned with the rotor d-axis for both surface and interior
+ *    magnet machines, so its angle is the rotor angle.
+ *  A PLL tracks the angle of the active flux, which gives a smooth speed estimate and rejects noise.
+ *
+ *  The observer is unusable at standstill and very low speed (no back-EMF), so the motor is started
+ *  open loop with I/f control: align the rotor, then rotate a constant current vector with a frequency
+ *  ramp. Once above the handover speed the angle difference between the I/f frame and the observer is
+ *  removed gradually, after which the observer angle drives the Park transforms.
+ *
+ *  Written like foc_math.h (plain C static inline) so it runs on the C28x, the CLA or a host PC.
+ */
+
+#ifndef CONTROL_INCLUDE_OBSERVER_H_
+#define CONTROL_INCLUDE_OBSERVER_H_
+
+#include "foc_math.h"
+
+/* Startup states */
+#define OBS_STATE_ALIGN 0 // Current on the d-axis at zero angle to pull the rotor into a known position
+#define OBS_STATE_RAMP 1 // I/f: current vector rotated at a ramping frequency
+#define OBS_STATE_HANDOVER 2 // Blending the I/f angle into the observer angle
+#define OBS_STATE_CLOSED_LOOP 3 // Observer angle and speed used directly
+
+typedef struct {
+    // Parameters
+    float Rs;
+    float Ld;
+    float Lq;
+    float flux;
+    float Ts;
+    float wc; // Crossover between the current model (below) and voltage model (above) (rad/s)
+    float pll_kp;
+    float pll_ki_Ts;
+
+    // State
+    FOC_AlphaBeta psi; // Stator flux estimate (Wb)
+    float theta; // Estimated electrical angle (per-unit)
+    float omega; // Estimated electrical speed (rad/s)
+    float pll_integrator;
+} OBS_FluxObserver;
+
+typedef struct {
+    // Parameters
+    float Ts;
+    float i_start; // Current during alignment and I/f (A)
+    float t_align; // Alignment time (s)
+    float accel; // I/f frequency ramp (rad/s^2, electrical)
+    float omega_handover; // Speed at which the observer takes over (rad/s, electrical)
+    float t_handover; // Time over which the angle difference is removed (s)
+
+    // State
+    uint16_t state;
+    float time; // Time in the current state (s)
+    float theta; // I/f angle (per-unit)
+    float omega; // I/f speed (rad/s)
+    float delta; // Angle difference between the I/f frame and the observer at the start of handover (per-unit)
+} OBS_Startup;
+
+typedef struct {
+    OBS_FluxObserver observer;
+    OBS_Startup startup;
+} OBS_Sensorless;
+
+/* Wraps a per-unit angle difference to [-0.5, 0.5) */
+static inline float OBS_wrapDifference(float delta) {
+    return FOC_wrapAngle(delta + 0.5f) - 0.5f;
+}
+
+/* Initialises the observer.
+ *
+ * \param pll_bandwidth_Hz sets the PLL natural frequency (damping 0.707)
+ * */
+static inline void OBS_initFluxObserver(OBS_FluxObserver *o, float Rs, float Ld, float Lq, float flux,
+                                        float Ts, float pll_bandwidth_Hz) {
+    float wn = FOC_2PI_F * pll_bandwidth_Hz;
+    o->Rs = Rs;
+    o->Ld = Ld;
+    o->Lq = Lq;
+    o->flux = flux;
+    o->Ts = Ts;
+    o->wc = 0.2f * wn; // Well below the PLL bandwidth
+    o->pll_kp = 1.414f * wn;
+    o->pll_ki_Ts = wn * wn * Ts;
+    o->psi.alpha = flux; // Rotor assumed at zero, which is where the alignment puts it
+    o->psi.beta = 0.0f;
+    o->theta = 0.0f;
+    o->omega = 0.0f;
+    o->pll_integrator = 0.0f;
+}
+
+/* Runs one sample of the observer and PLL.
+ *
+ * \param v is the alpha-beta voltage applied since the previous sample (V)
+ * \param i is the alpha-beta current measured this sample (A)
+ * */
+static inline void OBS_runFluxObserver(OBS_FluxObserver *o, FOC_AlphaBeta v, FOC_AlphaBeta i) {
+    FOC_SinCos sc = FOC_sinCos(o->theta);
+
+    // Current model flux in the estimated rotor frame
+    FOC_DQ i_dq = FOC_park(i, sc);
+    FOC_DQ psi_model_dq;
+    psi_model_dq.d = o->Ld * i_dq.d + o->flux;
+    psi_model_dq.q = o->Lq * i_dq.q;
+    FOC_AlphaBeta psi_model = FOC_inversePark(psi_model_dq, sc);
+
+    // Voltage model integration, corrected towards the current model at low frequency
+    o->psi.alpha += o->Ts * (v.alpha - o->Rs * i.alpha + o->wc * (psi_model.alpha - o->psi.alpha));
+    o->psi.beta += o->Ts * (v.beta - o->Rs * i.beta + o->wc * (psi_model.beta - o->psi.beta));
+
+    // Active flux, aligned with the rotor d-axis
+    float psi_a_alpha = o->psi.alpha - o->Lq * i.alpha;
+    float psi_a_beta = o->psi.beta - o->Lq * i.beta;
+
+    // PLL. The error is |psi_a|*sin(theta - theta_est); dividing by the in-phase component
+    // (|psi_a|*cos(theta - theta_est)) makes the loop gain independent of the flux magnitude.
+    float in_phase = psi_a_alpha * sc.cosine + psi_a_beta * sc.sine;
+    float quadrature = psi_a_beta * sc.cosine - psi_a_alpha * sc.sine;
+    if (in_phase < 0.1f * o->flux) {
+        in_phase = 0.1f * o->flux;
+    }
+    float error = quadrature/in_phase; // Angle error (rad)
+
+    o->pll_integrator += o->pll_ki_Ts * error;
+    o->omega = o->pll_kp * error + o->pll_integrator;
+    o->theta = FOC_wrapAngle(o->theta + o->omega * o->Ts * FOC_INV_2PI_F);
+}
+
+static inline void OBS_initStartup(OBS_Startup *s, float Ts, float i_start, float t_align, float accel,
+                                   float omega_handover, float t_handover) {
+    s->Ts = Ts;
+    s->i_start = i_start;
+    s->t_align = t_align;
+    s->accel = accel;
+    s->omega_handover = omega_handover;
+    s->t_handover = t_handover;
+    s->state = OBS_STATE_ALIGN;
+    s->time = 0.0f;
+    s->theta = 0.0f;
+    s->omega = 0.0f;
+    s->delta = 0.0f;
+}
+
+/* Runs one sample of the startup sequence and chooses the angle and speed for the current loop.
+ *
+ * \param theta, omega receive the angle (per-unit) and speed (rad/s) to use this sample
+ * \param i_ref receives the current reference until the observer has taken over. In the closed loop
+ * state it isn't changed, so it belongs to the speed controller.
+ * */
+static inline void OBS_runStartup(OBS_Startup *s, const OBS_FluxObserver *o, float *theta, float *omega,
+                                  FOC_DQ *i_ref) {
+    s->time += s->Ts;
+
+    switch (s->state) {
+    case OBS_STATE_ALIGN:
+        i_ref->d = s->i_start;
+        i_ref->q = 0.0f;
+        *theta = 0.0f;
+        *omega = 0.0f;
+        if (s->time >= s->t_align) {
+            s->state = OBS_STATE_RAMP;
+            s->time = 0.0f;
+        }
+        break;
+
+    case OBS_STATE_RAMP:
+        // The rotor lags the I/f frame by the load angle, which settles so the torque matches the load
+        s->omega += s->accel * s->Ts;
+        s->theta = FOC_wrapAngle(s->theta + s->omega * s->Ts * FOC_INV_2PI_F);
+        i_ref->d = 0.0f;
+        i_ref->q = s->i_start;
+        *theta = s->theta;
+        *omega = s->omega;
+        if (s->omega >= s->omega_handover) {
+            s->state = OBS_STATE_HANDOVER;
+            s->time = 0.0f;
+            s->delta = OBS_wrapDifference(s->theta - o->theta);
+        }
+        break;
+
+    case OBS_STATE_HANDOVER: {
+        // Follow the observer with an offset which shrinks linearly to zero
+        float remaining = 1.0f - s->time/s->t_handover;
+        i_ref->d = 0.0f;
+        i_ref->q = s->i_start;
+        *theta = FOC_wrapAngle(o->theta + s->delta * remaining);
+        *omega = o->omega;
+        if (remaining <= 0.0f) {
+            s->state = OBS_STATE_CLOSED_LOOP;
+        }
+        break;
+    }
+
+    default: // OBS_STATE_CLOSED_LOOP
+        *theta = o->theta;
+        *omega = o->omega;
+        break;
+    }
+}
+
+/* Returns to the start of the alignment, e.g. after the inverter has been disabled */
+static inline void OBS_resetSensorless(OBS_Sensorless *obs) {
+    obs->observer.psi.alpha = obs->observer.flux;
+    obs->observer.psi.beta = 0.0f;
+    obs->observer.theta = 0.0f;
+    obs->observer.omega = 0.0f;
+    obs->observer.pll_integrator = 0.0f;
+    obs->startup.state = OBS_STATE_ALIGN;
+    obs->startup.time = 0.0f;
+    obs->startup.theta = 0.0f;
+    obs->startup.omega = 0.0f;
+}
+
+/* Runs the observer and startup. Call before the current loop with the currents of this sample and the
+ * voltage commanded in the previous sample. */
+static inline void OBS_runSensorless(OBS_Sensorless *obs, FOC_AlphaBeta v, FOC_AlphaBeta i, float *theta,
+                                     float *omega, FOC_DQ *i_ref) {
+    OBS_runFluxObserver(&obs->observer, v, i);
+    OBS_runStartup(&obs->startup, &obs->observer, theta, omega, i_ref);
+}
+
+#endif /* CONTROL_INCLUDE_OBSERVER_H_ */
@@ -0,0 +1,27 @@
+/*
+ * trig_tables.h
+ *
+ *  Generated by TableGen/tablegen.py from trig_tables.json. Don't edit: change the spec and regenerate.
+ *
+ *  Trigonometric lookup tables for CPU1.
+ */
+
+#ifndef CONTROL_INCLUDE_TRIG_TABLES_H_
+#define CONTROL_INCLUDE_TRIG_TABLES_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* sin(2*pi*i/SIZE), with a quarter period extra for the cosine (entry i + SIZE/4) and one more for linear interpolation */
+#define TRIG_SIN_SIZE 512
+#define TRIG_SIN_LENGTH 641
+extern const float TRIG_sinTable[641];
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONTROL_INCLUDE_TRIG_TABLES_H_ */
@@ -0,0 +1,66 @@
+/*
+ * cla_control.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Configures CLA1 to run the current loop from the ADC end of conversion trigger.
+ *  The C28x is then free for the speed loop, observers and communications.
+ */
+
+extern "C" {
+    #include <system_config.h>
+}
+
+#include "cla_control.h"
+#include "foc.h"
+#include "pwm.h"
+#include <string.h>
+
+#pragma DATA_SECTION("CpuToCla1MsgRAM")
+CLA_CurrentLoopParams claParams;
+
+#pragma DATA_SECTION("Cla1ToCpuMsgRAM")
+CLA_CurrentLoopTelemetry claTelemetry;
+
+void ConfigCla() {
+    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_CLA1);
+
+    // Copy the CLA program and constants from flash to the LS RAMs
+    memcpy((uint32_t *)&Cla1ProgRunStart, (uint32_t *)&Cla1ProgLoadStart, (uint32_t)&Cla1ProgLoadSize);
+    memcpy((uint32_t *)&Cla1ConstRunStart, (uint32_t *)&Cla1ConstLoadStart, (uint32_t)&Cla1ConstLoadSize);
+
+    // Give the CLA its program and data RAMs and zero the message RAMs
+    MemCfg_setLSRAMMasterSel(MEMCFG_SECT_LS4, MEMCFG_LSRAMMASTER_CPU_CLA1);
+    MemCfg_setCLAMemType(MEMCFG_SECT_LS4, MEMCFG_CLA_MEM_PROGRAM);
+    MemCfg_setLSRAMMasterSel(MEMCFG_SECT_LS1, MEMCFG_LSRAMMASTER_CPU_CLA1);
+    MemCfg_setCLAMemType(MEMCFG_SECT_LS1, MEMCFG_CLA_MEM_DATA);
+    MemCfg_initSections(MEMCFG_SECT_MSGCPUTOCLA1 | MEMCFG_SECT_MSGCLA1TOCPU);
+    while (!MemCfg_getInitStatus(MEMCFG_SECT_MSGCPUTOCLA1 | MEMCFG_SECT_MSGCLA1TOCPU));
+
+    // The CLA reaches the ePWM and ADC registers through the peripheral frame bridges
+    SysCtl_selectSecMaster(SYSCTL_SEC_MASTER_CLA, SYSCTL_SEC_MASTER_CLA);
+
+    // Parameters
+    FOC_initLoopParams(&claParams, phaseA->getTimerTop());
+
+    // Map the tasks. Task vectors are the addresses of the tasks in CLA program space (16 bit).
+    CLA_mapTaskVector(CLA1_BASE, CLA_MVECT_1, (uint16_t)&Cla1Task1);
+    CLA_mapTaskVector(CLA1_BASE, CLA_MVECT_8, (uint16_t)&Cla1Task8);
+    CLA_enableIACK(CLA1_BASE); // Allows the C28x to force tasks
+    CLA_enableTasks(CLA1_BASE, CLA_TASKFLAG_1 | CLA_TASKFLAG_8);
+
+    // Initialise the loop state on the CLA and wait for it to finish
+    CLA_forceTasks(CLA1_BASE, CLA_TASKFLAG_8);
+    asm(" RPT #3 || NOP"); // Give the task time to start
+    while (CLA_getTaskRunStatus(CLA1_BASE, CLA_TASK_8));
+
+    // From here Task 1 starts on every ADCA INT1 without the C28x
+    CLA_setTriggerSource(CLA_TASK_1, CLA_TRIGGER_ADCA1);
+    phaseA->configAdcTrigger(PWM_FREQUENCY_HZ/FOC_SAMPLING_FREQUENCY);
+}
+
+/* Enables or disables the current loop. When disabled the CLA holds all phases at 50% duty. */
+void CLA_enableCurrentLoop(bool enable) {
+    claParams.enable = enable ? 1 : 0;
+}
@@ -0,0 +1,165 @@
+/*
+ * foc.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Glue between the current loop in foc_math.h and the half bridges in pwm.h.
+ *
+ *  The loop is started by the ADC end of conversion and runs either on the CLA (see cla_control.h)
+ *  or in the ADCA1 ISR on the C28x. Both use CLA_runCurrentLoopSample() and the same parameter block.
+ *  After each sample the C28x reads the encoder and gives the loop the angle for the next one: in the
+ *  CLA Task 1 end of task ISR, which then records the live scope (scope.h), or at the end of the ADCA1 ISR.
+ *
+ *  Cycle budget: a sample of CLA Task 1 is 511 (encoder) to 764 (sensorless) CLA cycles, 20-30 us at
+ *  SYSCLK = 25MHz, out of the 50 us sampling period. Dead time compensation has since taken it to 579-832
+ *  cycles (23-33 us). These are the HostSim "isr" bench's counts; current_loop_sample in the kernel
+ *  benchmarks (benchmark/README.md) measures it on the target. The loop does not meet the target of about
+ *  1.5 us at 200MHz: it would be 2.9-4.2 us at 200MHz, and this board runs at 25MHz.
+ */
+
+#include "foc.h"
+#include "cla_control.h"
+#include "adcs.h"
+#include "pwm.h"
+#include "encoder.h"
+#include "scope.h"
+#include "hot_path.h"
+#include "isr_profile.h"
+
+FOC_CurrentLoop focLoop; // Loop state when running on the C28x
+OBS_Sensorless focObserver;
+
+#if FOC_RUN_ON_CLA
+HOT_ISR interrupt void focClaEndISR();
+#else
+CLA_CurrentLoopTelemetry focTelemetry; // The C28x can't write to the CLA-to-CPU message RAM
+HOT_ISR interrupt void focAdcISR();
+#endif
+
+static_assert(FOC_PWM_FREQUENCY_HZ == PWM_FREQUENCY_HZ, "FOC_PWM_FREQUENCY_HZ");
+static_assert(FOC_DEAD_TIME_TBCLKS*2e9/PLLSYSCLK >= PWM_DEAD_TIME_NS - 0.01f
+              && (FOC_DEAD_TIME_TBCLKS - 1)*2e9/PLLSYSCLK < PWM_DEAD_TIME_NS - 0.01f, "FOC_DEAD_TIME_TBCLKS"); // pwm.h
+
+void ConfigFoc() {
+    FOC_initCurrentLoop(&focLoop, MOTOR_RS, MOTOR_LD, MOTOR_LQ, MOTOR_FLUX,
+                        1.0f/FOC_SAMPLING_FREQUENCY, FOC_CURRENT_BANDWIDTH_HZ,
+                        FOC_CURRENT_LOOP_DELAY, FOC_DEAD_TIME_DUTY);
+    FOC_initSensorless(&focObserver);
+
+    ConfigCla(); // Also sets up the parameter block and the ADC trigger
+#if FOC_RUN_ON_CLA
+    // CLA Task 1 raises its end of task interrupt after every sample
+    Interrupt_register(INT_CLA1_1, &focClaEndISR);
+    Interrupt_enable(INT_CLA1_1);
+#else
+    CLA_setTriggerSource(CLA_TASK_1, CLA_TRIGGER_SOFTWARE);
+    Interrupt_register(INT_ADCA1, &focAdcISR);
+    Interrupt_enable(INT_ADCA1);
+#endif
+}
+
+bool FOC_setCurrentReference(float id, float iq, uint32_t sequence) {
+    FOC_DQ i_ref = {id, iq};
+    return CLA_setCurrentReference(&claParams, FOC_getTelemetry(), i_ref, sequence);
+}
+
+static bool isGain(float gain) {
+    return gain >= 0.0f && gain <= FOC_CURRENT_GAIN_MAX; // Also false for NaN
+}
+
+bool FOC_setCurrentGains(const FOC_CurrentGains *gains) {
+    if (!isGain(gains->Kp_d) || !isGain(gains->Ki_Ts_d) || !isGain(gains->Kp_q) || !isGain(gains->Ki_Ts_q)) {
+        return false;
+    }
+    CLA_CurrentGains *shadow = CLA_editCurrentGains(&claParams, FOC_getTelemetry());
+    if (!shadow) {
+        return false;
+    }
+    shadow->pi = *gains;
+    CLA_commitCurrentGains(&claParams);
+    return true;
+}
+
+HOT_FUNC void FOC_setRotorAngle(float theta, float omega) {
+    CLA_setRotorAngle(&claParams, theta, omega);
+}
+
+const CLA_CurrentLoopTelemetry *FOC_getTelemetry() {
+#if FOC_RUN_ON_CLA
+    return &claTelemetry;
+#else
+    return &focTelemetry;
+#endif
+}
+
+uint32_t FOC_getSamplePeriodCycles() {
+    return phaseA->getPeriodCycles()*(PWM_FREQUENCY_HZ/FOC_SAMPLING_FREQUENCY);
+}
+
+void FOC_setSensorless(bool sensorless) {
+    claParams.sensorless = sensorless ? 1 : 0;
+}
+
+/* SYSCLK cycles to the SOC of the next current loop sample. The SOC is EPWM1's SOCA at the timer top every
+ * PWM_FREQUENCY_HZ/FOC_SAMPLING_FREQUENCY periods: its event counter has the tops since the last one, and
+ * the time base counter the time past the last top (up-down count, SYMMETRICAL_PWM). Read again if a top
+ * comes in between. */
+static inline uint32_t cyclesToNextSoc() {
+    const uint32_t pwm = EPWM1_BASE; // PHASE_A_PWM
+    uint16_t top = EPWM_getTimeBasePeriod(pwm);
+    uint16_t tops, counter, direction;
+    do {
+        tops = EPWM_getADCTriggerEventCount(pwm, EPWM_SOC_A);
+        counter = EPWM_getTimeBaseCounterValue(pwm);
+        direction = EPWM_getTimeBaseCounterDirection(pwm);
+    } while (EPWM_getADCTriggerEventCount(pwm, EPWM_SOC_A) != tops);
+    uint32_t past_top = direction == EPWM_TIME_BASE_STATUS_COUNT_DOWN ? top - counter : top + counter;
+    uint32_t periods = PWM_FREQUENCY_HZ/FOC_SAMPLING_FREQUENCY - tops;
+    return 2*(2*(uint32_t)top*periods - past_top); // TBCLK is SYSCLK/2
+}
+
+/* Samples the encoder and, unless the loop is sensorless, gives it the angle predicted to its next SOC.
+ * Every sample, so no unit time out's latches are missed, and as soon after the sample as possible: the
+ * sooner it's read, the less the prediction has to cover. */
+static inline void updateRotorAngle() {
+    EncoderSnapshot snap = encoder->sample();
+    if (!claParams.sensorless) {
+        float lead_s = (float)cyclesToNextSoc()/PLLSYSCLK;
+        FOC_setRotorAngle(ENC_predict(snap.theta, snap.omega, lead_s), snap.omega);
+    }
+}
+
+#if FOC_RUN_ON_CLA
+ISR_PROFILE(focClaEndISR);
+
+/* After each sample on the CLA: the encoder's angle for the next one, then the live scope */
+HOT_ISR interrupt void focClaEndISR() {
+    ISR_PROFILE_BEGIN();
+    updateRotorAngle();
+    SCOPE_recordSample();
+
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP11); // CLA1_1 is INT11.1
+    ISR_PROFILE_END(focClaEndISR);
+}
+#else
+ISR_PROFILE(focAdcISR);
+
+/* Current loop on the C28x. Does exactly what CLA Task 1 does, then reads the encoder like focClaEndISR().
+ * The live scope is off in this mode (SCOPE_apply()). */
+HOT_ISR interrupt void focAdcISR() {
+    ISR_PROFILE_BEGIN();
+    uint16_t cmp[3];
+    CLA_runCurrentLoopSample(&focLoop, &focObserver, &claParams,
+                             ADC_readResult(ADCARESULT_BASE, (ADC_SOCNumber)PHASE_A_CURRENT_SOC),
+                             ADC_readResult(ADCBRESULT_BASE, (ADC_SOCNumber)PHASE_B_CURRENT_SOC),
+                             ADC_readResult(ADCARESULT_BASE, (ADC_SOCNumber)VDC_SOC),
+                             cmp, &focTelemetry);
+    setPhaseCompares(cmp[0], cmp[1], cmp[2]);
+    updateRotorAngle();
+
+    ADC_clearInterruptStatus(ADCA_BASE, ADC_INT_NUMBER1);
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP1);
+    ISR_PROFILE_END(focAdcISR);
+}
+#endif
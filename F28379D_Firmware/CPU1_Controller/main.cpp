@@ -7,19 +7,43 @@
 extern "C" {
     #include <system_config.h> // Also includes f2837xD includes and driverlib
 }
+#include "boot_sync.h"
+#include "ipc_channel.h"
 
 #include "pwm.h"
+#include "adcs.h"
+#include "encoder.h"
 #include "led_blink.h"
+#include "foc.h"
+#include "kernel_bench.h"
+#include "ipc_link.h"
+#include "scope.h"
+#include "isr_profile.h"
 
 int main(void) {
-    ConfigSystem();
+    bootReport.main_entry = BOOT_stamp();
+    ConfigSystem(); // Releases CPU2, which initialises alongside the rest of this
+#if KERNEL_BENCH_ON_BOOT
+    KB_runOnTarget(); // Results in kernelBenchResults. Before the ISRs are running, so nothing preempts it.
+#endif
+    ISR_PROFILE_init(); // After the kernel bench, which also uses CPU timer 2
     led_blink_init();
     ConfigPwm();
+    ConfigAdcs();
+    ConfigEncoder();
+    ConfigFoc();
+    ConfigIpcLink();
+    ConfigScope();
+    BOOT_rendezvous(); // Waits for CPU2, so both cores are ready before the first PWM edge
+    StartPwm();
+    bootReport.first_pwm = BOOT_stamp();
+    bootReport.time_to_pwm_us = BOOT_microseconds(&bootReport, bootReport.first_pwm);
+    // Before the interrupts: CPU2 is listening since the rendezvous, and once they're enabled only the ISRs
+    // send on the channel, so none of them can preempt a send half way through
+    CHAN_sendAndNotify(CHAN_MSG_BOOT_REPORT, &bootReport, CHAN_WORDS(bootReport));
     EnableInterrupts();
 
-    phaseA->setDutyCycle(0.2);
-    phaseB->setDutyCycle(0.5);
-    phaseC->setDutyCycle(0.8);
+    // The current loop now owns the duty cycles. It holds 50% duty until enabled with CLA_enableCurrentLoop().
 
     while (1) {
         IDLE; // Sleep
@@ -0,0 +1,36 @@
+/*
+ * adc_channels.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  ADC channel and SOC assignments for the motor drive measurements. Kept separate from adcs.h
+ *  (no device headers) so the CLA tasks can include it.
+ *
+ *  All SOCs are triggered by EPWM1 SOCA, which is generated at the timer top of phase A.
+ *  ADC-A and ADC-B convert the two phase currents simultaneously.
+ */
+
+#ifndef PERIPHERALS_INCLUDE_ADC_CHANNELS_H_
+#define PERIPHERALS_INCLUDE_ADC_CHANNELS_H_
+
+// Phase A current on ADCINA2 (ADC-A SOC0)
+#define PHASE_A_CURRENT_CHANNEL 2
+#define PHASE_A_CURRENT_SOC 0
+
+// Phase B current on ADCINB2 (ADC-B SOC0)
+#define PHASE_B_CURRENT_CHANNEL 2
+#define PHASE_B_CURRENT_SOC 0
+
+// DC link voltage on ADCINA3 (ADC-A SOC1). ADCA INT1 is generated at the end of this conversion.
+#define VDC_CHANNEL 3
+#define VDC_SOC 1
+
+// Scaling of the analogue front end
+#define ADC_VREF 3.3
+#define ADC_FULL_SCALE_COUNTS 4096.0 // 12-bit resolution
+#define CURRENT_SENSE_A_PER_V 5.0 // Current sensor gain (A per V at the ADC pin)
+#define CURRENT_SENSE_OFFSET_V 1.65 // ADC pin voltage at zero current
+#define VDC_SENSE_DIVIDER 20.0 // DC link voltage divider ratio
+
+#endif /* PERIPHERALS_INCLUDE_ADC_CHANNELS_H_ */
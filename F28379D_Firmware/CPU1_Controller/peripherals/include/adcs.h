@@ -10,14 +10,37 @@
 #ifndef CONFIG_ADC_H_
 #define CONFIG_ADC_H_
 
-#include "system_config.h"
+#include "hal.h"
+#include "adc_channels.h"
 #include <stdint.h>
 
 #define ACQUISITION_WINDOW 200 // Acquisition time in SYSCLK cycles
-#define ADC_VREF 3.3
 #define EXT_SIG_SAMP_FREQ 1.3 // Sampling frequency of the external signal
 #define TEMP_SENSE_SAMP_FREQ 1 // Sampling frequency of the temperature sensor
+#define CURRENT_ACQUISITION_WINDOW 15 // Acquisition time in SYSCLK cycles for the motor measurements (low impedance sources)
 
 void ConfigAdcs(void);
 
+/* Configures ADC-A and ADC-B for the motor drive measurements (see adc_channels.h).
+ *
+ * Every SOC is triggered by EPWM1 SOCA. ADCA INT1 fires at the end of the DC link voltage conversion,
+ * which is the last one, and triggers the current loop. It is in continuous mode so the flag does not
+ * have to be cleared by whoever services it (the CLA can't run ADC_clearInterruptStatus()).
+ * */
+template<class HalT>
+void ConfigAdcsT(void) {
+    HalT::powerUpAdc(HAL_ADC_A);
+    HalT::powerUpAdc(HAL_ADC_B);
+    HalT::waitAdcPowerUp();
+
+    HalT::setupAdcSoc(HAL_ADC_A, PHASE_A_CURRENT_SOC, HAL_ADC_TRIGGER_EPWM1_SOCA,
+                      PHASE_A_CURRENT_CHANNEL, CURRENT_ACQUISITION_WINDOW);
+    HalT::setupAdcSoc(HAL_ADC_B, PHASE_B_CURRENT_SOC, HAL_ADC_TRIGGER_EPWM1_SOCA,
+                      PHASE_B_CURRENT_CHANNEL, CURRENT_ACQUISITION_WINDOW);
+    HalT::setupAdcSoc(HAL_ADC_A, VDC_SOC, HAL_ADC_TRIGGER_EPWM1_SOCA,
+                      VDC_CHANNEL, CURRENT_ACQUISITION_WINDOW);
+
+    HalT::configAdcInterrupt(HAL_ADC_A, VDC_SOC);
+}
+
 #endif /* CONFIG_ADC_H_ */
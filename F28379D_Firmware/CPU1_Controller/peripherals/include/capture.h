@@ -0,0 +1,256 @@
+/*
+ * capture.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Triggered capture: records registry variables (scope.h) at up to the full current loop rate into a
+ *  ring in the GSx frame buffer CPU1 owns, freezes a set number of records after a trigger, and hands
+ *  the buffer to CPU2 to stream out at whatever rate the SCI manages. For signals the live scope can't
+ *  carry in real time.
+ *
+ *  - Depth: pre-trigger and post-trigger records. The trigger isn't looked at until the pre-trigger
+ *    records are there, so a capture always has all of them. The trigger record is the first post one.
+ *  - Triggers: a level (above or below), an edge (rising or falling through the level), or a fault: any
+ *    bit of a mask set in an integer variable, or CAPTURE_force() from a protection handler.
+ *  - Decimation: one record every N current loop samples, as the scope.
+ *
+ *  Recording is SCOPE_record() into the next ring slot, plus a fixed cost for the trigger test, so an
+ *  armed capture costs the same every sample. The frame is a CAPTURE_FrameHeader then the ring as it is
+ *  in memory: records starts at slot oldest and wraps. Nothing is moved when it freezes.
+ *
+ *  Capture and the live scope share the frame buffers, so one runs at a time. The engine is portable C,
+ *  tested on the host (HostSim bench "capture").
+ */
+
+#ifndef PERIPHERALS_INCLUDE_CAPTURE_H_
+#define PERIPHERALS_INCLUDE_CAPTURE_H_
+
+#include "scope.h"
+#include "frame_service.h" // FRAME_BUFFER_WORDS
+
+#define CAPTURE_FRAME_KIND 0xCA01U // First word of a capture frame
+#define CAPTURE_HEADER_WORDS 12U // CAPTURE_FrameHeader in 16-bit words
+#define CAPTURE_RING_WORDS (FRAME_BUFFER_WORDS - CAPTURE_HEADER_WORDS)
+
+typedef enum {
+    CAPTURE_TRIGGER_ABOVE = 0, // Value above the level
+    CAPTURE_TRIGGER_BELOW = 1,
+    CAPTURE_TRIGGER_RISING = 2, // At or below the level on the previous record, above it on this one
+    CAPTURE_TRIGGER_FALLING = 3,
+    CAPTURE_TRIGGER_FAULT = 4, // Integer variable AND mask non-zero
+    CAPTURE_TRIGGER_FORCED = 5 // Only reported: CAPTURE_force() fired it
+} CAPTURE_TriggerType;
+
+typedef enum {
+    CAPTURE_IDLE = 0,
+    CAPTURE_ARMED = 1, // Recording, waiting for the pre-trigger records and then the trigger
+    CAPTURE_TRIGGERED = 2, // Recording the post-trigger records
+    CAPTURE_FROZEN = 3 // Complete, waiting for CPU2 to take the buffer
+} CAPTURE_State;
+
+/* CHAN_MSG_CAPTURE_ARM payload, CPU2 to CPU1 */
+typedef struct {
+    uint16_t decimation; // Current loop samples per record, at least 1
+    uint16_t count; // Channels. 0 disarms.
+    uint16_t ids[SCOPE_MAX_CHANNELS]; // SCOPE_ID_x
+    uint16_t pre_trigger; // Records before the trigger record
+    uint16_t post_trigger; // Records from the trigger record on, at least 1
+    uint16_t trigger; // CAPTURE_TRIGGER_x, not FORCED
+    uint16_t trigger_id; // Variable tested, SCOPE_ID_x. Needn't be a channel.
+    float level; // In the variable's own units, unscaled
+    uint32_t mask; // For CAPTURE_TRIGGER_FAULT
+} CAPTURE_Arm;
+
+typedef struct {
+    uint16_t kind; // CAPTURE_FRAME_KIND
+    uint16_t decimation;
+    uint32_t trigger_sample; // Current loop sample count of the trigger record
+    uint16_t ids[SCOPE_MAX_CHANNELS/2U]; // As in a scope frame
+    uint16_t records; // In the ring, pre_trigger + post_trigger
+    uint16_t oldest; // Slot of the first record
+    uint16_t pre_trigger;
+    uint16_t trigger; // CAPTURE_TRIGGER_x that fired
+} CAPTURE_FrameHeader;
+
+typedef struct {
+    const SCOPE_Variable *registry;
+    uint16_t registry_size;
+
+    // Set up by CAPTURE_arm()
+    SCOPE_Channels channels;
+    uint16_t decimation;
+    uint16_t pre_trigger;
+    uint16_t post_trigger;
+    uint16_t depth; // Ring slots
+    uint16_t trigger;
+    const volatile void *trigger_address;
+    uint16_t trigger_type; // SCOPE_Type of the trigger variable
+    float level;
+    uint32_t mask;
+
+    // Recording
+    volatile uint16_t state; // CAPTURE_State
+    volatile uint16_t forced; // Set by CAPTURE_force()
+    uint16_t countdown; // Samples to the next record
+    uint16_t slot; // Next ring slot
+    uint16_t offset; // Its word offset in the ring
+    uint16_t written; // Records written, up to depth
+    uint16_t remaining; // Post-trigger records still to come
+    float previous; // Trigger variable at the previous record, for the edges
+} CAPTURE_Engine;
+
+static inline void CAPTURE_init(CAPTURE_Engine *c, const SCOPE_Variable *registry, uint16_t registry_size) {
+    c->registry = registry;
+    c->registry_size = registry_size;
+    SCOPE_bindChannels(&c->channels, registry, registry_size, 0, 0);
+    c->state = CAPTURE_IDLE;
+    c->forced = 0;
+}
+
+/* A variable as a float, for the level and edge triggers */
+static inline float CAPTURE_readValue(const volatile void *address, uint16_t type) {
+    switch (type) {
+        case SCOPE_FLOAT32: return *(const volatile float *)address;
+        case SCOPE_UINT32: return (float)*(const volatile uint32_t *)address;
+        case SCOPE_INT32: return (float)*(const volatile int32_t *)address;
+        case SCOPE_UINT16: return (float)*(const volatile uint16_t *)address;
+        default: return (float)*(const volatile int16_t *)address;
+    }
+}
+
+/* Records a channel set into the ring until the trigger. Also disarms, with a count of 0. Returns false,
+ * changing nothing, if the settings are invalid or the ring can't hold pre_trigger + post_trigger
+ * records. */
+static inline bool CAPTURE_arm(CAPTURE_Engine *c, const CAPTURE_Arm *arm) {
+    if (arm->count == 0U) {
+        c->state = CAPTURE_IDLE;
+        return true;
+    }
+    SCOPE_Channels channels;
+    if (arm->decimation == 0U || arm->post_trigger == 0U || arm->trigger >= CAPTURE_TRIGGER_FORCED
+            || arm->trigger_id >= c->registry_size
+            || !SCOPE_bindChannels(&channels, c->registry, c->registry_size, arm->ids, arm->count)) {
+        return false;
+    }
+    const SCOPE_Variable *trigger = &c->registry[arm->trigger_id];
+    if (arm->trigger == CAPTURE_TRIGGER_FAULT && trigger->type == SCOPE_FLOAT32) {
+        return false; // The mask is for integers
+    }
+    uint32_t depth = (uint32_t)arm->pre_trigger + arm->post_trigger;
+    if (depth > CAPTURE_RING_WORDS/channels.record_words) {
+        return false;
+    }
+
+    c->state = CAPTURE_IDLE; // Not sampled while it changes (the ISR doesn't nest with the caller anyway)
+    c->channels = channels;
+    c->decimation = arm->decimation;
+    c->pre_trigger = arm->pre_trigger;
+    c->post_trigger = arm->post_trigger;
+    c->depth = (uint16_t)depth;
+    c->trigger = arm->trigger;
+    c->trigger_address = trigger->address;
+    c->trigger_type = trigger->type;
+    c->level = arm->level;
+    c->mask = arm->mask;
+    c->forced = 0;
+    c->countdown = 1;
+    c->slot = 0;
+    c->offset = 0;
+    c->written = 0;
+    c->previous = CAPTURE_readValue(c->trigger_address, c->trigger_type);
+    c->state = CAPTURE_ARMED;
+    return true;
+}
+
+/* Triggers an armed capture at its next record, whatever its trigger. From any ISR, e.g. a trip. */
+static inline void CAPTURE_force(CAPTURE_Engine *c) {
+    c->forced = 1;
+}
+
+/* True if the trigger fires on this record */
+static inline bool CAPTURE_testTrigger(CAPTURE_Engine *c) {
+    if (c->trigger == CAPTURE_TRIGGER_FAULT) {
+        uint32_t bits = SCOPE_isWide(c->trigger_type) ? *(const volatile uint32_t *)c->trigger_address
+                                                      : *(const volatile uint16_t *)c->trigger_address;
+        return (bits & c->mask) != 0U;
+    }
+    float value = CAPTURE_readValue(c->trigger_address, c->trigger_type);
+    float previous = c->previous;
+    c->previous = value;
+    switch (c->trigger) {
+        case CAPTURE_TRIGGER_ABOVE: return value > c->level;
+        case CAPTURE_TRIGGER_BELOW: return value < c->level;
+        case CAPTURE_TRIGGER_RISING: return previous <= c->level && value > c->level;
+        default: return previous >= c->level && value < c->level;
+    }
+}
+
+/* Records a sample if one is due, into the ring after the header in frame (a whole frame buffer). Call
+ * after every current loop sample.
+ * \return the frame length once the capture is frozen, until CAPTURE_taken(); otherwise 0 */
+static inline uint16_t CAPTURE_sample(CAPTURE_Engine *c, uint16_t *frame, uint32_t sample_count) {
+    uint16_t state = c->state;
+    if (state == CAPTURE_FROZEN) {
+        return (uint16_t)(CAPTURE_HEADER_WORDS + c->depth*c->channels.record_words);
+    }
+    if (state == CAPTURE_IDLE || --c->countdown != 0U) {
+        return 0;
+    }
+    c->countdown = c->decimation;
+
+    SCOPE_record(&c->channels, frame + CAPTURE_HEADER_WORDS + c->offset);
+    c->slot++;
+    c->offset += c->channels.record_words;
+    if (c->slot == c->depth) {
+        c->slot = 0;
+        c->offset = 0;
+    }
+    if (c->written < c->depth) {
+        c->written++;
+    }
+
+    CAPTURE_FrameHeader *header = (CAPTURE_FrameHeader *)frame;
+    if (state == CAPTURE_ARMED) {
+        bool fired = CAPTURE_testTrigger(c); // Every record, so the edges see the previous one
+        if (c->written <= c->pre_trigger || !(fired || c->forced)) {
+            return 0;
+        }
+        header->trigger = c->forced ? (uint16_t)CAPTURE_TRIGGER_FORCED : c->trigger;
+        header->trigger_sample = sample_count;
+        c->remaining = c->post_trigger;
+    }
+    if (--c->remaining != 0U) {
+        c->state = CAPTURE_TRIGGERED;
+        return 0;
+    }
+
+    // The ring is full: the pre-trigger records were there at the trigger and the post ones since
+    header->kind = CAPTURE_FRAME_KIND;
+    header->decimation = c->decimation;
+    for (uint16_t k = 0; k < SCOPE_MAX_CHANNELS/2U; k++) {
+        header->ids[k] = c->channels.ids[k];
+    }
+    header->records = c->depth;
+    header->oldest = c->slot;
+    header->pre_trigger = c->pre_trigger;
+    c->state = CAPTURE_FROZEN;
+    return (uint16_t)(CAPTURE_HEADER_WORDS + c->depth*c->channels.record_words);
+}
+
+/* The frozen capture has been handed over: back to idle until armed again */
+static inline void CAPTURE_taken(CAPTURE_Engine *c) {
+    c->state = CAPTURE_IDLE;
+}
+
+/* Target side (scope.cpp, which runs it with the scope after each CLA Task 1 sample) */
+extern volatile uint16_t captureState; // CAPTURE_State, also in the registry
+
+/* Applies a CHAN_MSG_CAPTURE_ARM. Returns false if refused: invalid, the live scope is running, or
+ * FOC_RUN_ON_CLA is 0 (see SCOPE_apply()). */
+bool CAPTURE_apply(const CAPTURE_Arm *arm);
+
+/* Triggers the armed capture at its next record. From any ISR. */
+void CAPTURE_trigger();
+
+#endif /* PERIPHERALS_INCLUDE_CAPTURE_H_ */
@@ -0,0 +1,57 @@
+/*
+ * encoder.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Incremental encoder on eQEP1 (LAUNCHXL-F28379D J14)
+ *  - EQEP1A on GPIO20
+ *  - EQEP1B on GPIO21
+ *  - EQEP1I (index) on GPIO23
+ *
+ *  Speed is estimated with the M/T method: the unit timer latches the position count and the capture
+ *  timer (time since the last edge) together, so each unit period gives the number of edges AND the
+ *  exact time between the first and last of them. At low speed, where no edge arrives in a unit period,
+ *  the time since the last edge bounds the speed instead. No per-edge interrupts are needed.
+ *
+ *  sample() is called once per current loop sample, by the interrupt after it (see foc.cpp), which hands
+ *  the loop the angle. It interpolates the angle between edges using the capture timer and the latest
+ *  speed, and only recalculates the speed when the unit timer has timed out, so it always runs in a
+ *  bounded number of cycles. The estimation itself is in encoder_math.h.
+ */
+
+#ifndef PERIPHERALS_INCLUDE_ENCODER_H_
+#define PERIPHERALS_INCLUDE_ENCODER_H_
+
+#include "system_config.h"
+#include "static_instance.h"
+#include "encoder_math.h"
+#include <stdint.h>
+
+#define ENCODER_LINES 1000 // Lines per revolution. The count is 4x this (both edges of A and B).
+#define ENCODER_UNIT_FREQUENCY 1000 // Speed update rate (Hz)
+#define ENCODER_CAPTURE_PRESCALE 64 // Capture timer clock = SYSCLK/64. Must match EQEP_CAPTURE_CLK_DIV_64.
+
+typedef struct {
+    float theta; // Electrical angle (per-unit, 0 to 1)
+    float omega; // Electrical speed (rad/s)
+    float speed_rpm; // Mechanical speed (rpm)
+    uint16_t index_found; // 0 until the index pulse has been seen. The angle is only absolute after this.
+} EncoderSnapshot;
+
+class QuadEncoder {
+private:
+    uint32_t base;
+    ENC_Estimator estimator;
+
+public:
+    QuadEncoder(uint16_t lines, uint16_t pole_pairs);
+    void setAngleOffset(float theta_offset);
+    EncoderSnapshot sample();
+};
+
+extern StaticInstance<QuadEncoder> encoder; // Constructed by ConfigEncoder()
+
+void ConfigEncoder();
+
+#endif /* PERIPHERALS_INCLUDE_ENCODER_H_ */
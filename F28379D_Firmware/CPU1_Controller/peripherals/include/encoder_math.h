@@ -0,0 +1,126 @@
+/*
+ * encoder_math.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  The encoder's angle and speed estimation (see encoder.h) from the eQEP's counts and timer values, apart
+ *  from the register accesses. Plain C in static inline functions like foc_math.h, so QuadEncoder and a
+ *  host PC run the same code.
+ *
+ *  Positions are in counts (4 per line) and times in capture timer ticks, as the eQEP gives them. Angles
+ *  are per-unit electrical.
+ */
+
+#ifndef PERIPHERALS_INCLUDE_ENCODER_MATH_H_
+#define PERIPHERALS_INCLUDE_ENCODER_MATH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "foc_math.h" // FOC_wrapAngle()
+
+typedef struct {
+    // Parameters
+    uint32_t counts_per_rev;
+    uint16_t pole_pairs;
+    float capture_tick_s; // Period of the capture timer clock
+    float unit_period_s;
+    float theta_offset; // Electrical angle at the index pulse (per-unit)
+
+    // M/T speed estimation state
+    uint32_t last_position_latch;
+    uint16_t last_timer_latch;
+    float speed_cps; // Speed in counts per second
+} ENC_Estimator;
+
+static inline void ENC_init(ENC_Estimator *e, uint32_t counts_per_rev, uint16_t pole_pairs, float capture_tick_s,
+                            float unit_period_s) {
+    e->counts_per_rev = counts_per_rev;
+    e->pole_pairs = pole_pairs;
+    e->capture_tick_s = capture_tick_s;
+    e->unit_period_s = unit_period_s;
+    e->theta_offset = 0.0f;
+    e->last_position_latch = 0;
+    e->last_timer_latch = 0;
+    e->speed_cps = 0.0f;
+}
+
+/* M/T speed estimate, once per unit time out.
+ *
+ * \param position is the position count latched at the time out
+ * \param timer is the capture timer latched with it: the time from the last count to the time out
+ * \param overflow is true if the capture timer overflowed: no count for longer than it can measure
+ * */
+static inline void ENC_updateSpeed(ENC_Estimator *e, uint32_t position, uint16_t timer, bool overflow) {
+    // Counts this unit period, allowing for the counter wrapping at one revolution
+    int32_t counts = (int32_t)(position - e->last_position_latch);
+    if (counts > (int32_t)(e->counts_per_rev/2)) {
+        counts -= e->counts_per_rev;
+    }
+    else if (counts < -(int32_t)(e->counts_per_rev/2)) {
+        counts += e->counts_per_rev;
+    }
+
+    if (overflow) {
+        e->speed_cps = 0.0f; // Stopped
+    }
+    else if (counts != 0) {
+        // M/T: 'counts' edges took exactly the unit period, plus the time since the last edge of the
+        // previous period, minus the time since the last edge of this period.
+        float elapsed = e->unit_period_s + ((float)e->last_timer_latch - (float)timer) * e->capture_tick_s;
+        e->speed_cps = (float)counts/elapsed;
+    }
+    else {
+        // No edges this period. The speed can't be more than one count over the time since the last count.
+        float max_speed = 1.0f/((float)timer * e->capture_tick_s + 1e-9f);
+        if (e->speed_cps > max_speed) {
+            e->speed_cps = max_speed;
+        }
+        else if (e->speed_cps < -max_speed) {
+            e->speed_cps = -max_speed;
+        }
+    }
+
+    e->last_position_latch = position;
+    e->last_timer_latch = timer;
+}
+
+/* Electrical angle between counts.
+ *
+ * The count is the edge below the rotor either way: forwards it's the last edge passed, backwards the last
+ * edge passed is the one above. From that edge the rotor has moved (speed * time since the count), which
+ * can't be more than one count or the next count would have arrived.
+ *
+ * \param position is the position count
+ * \param capture_timer is the live capture timer: the time since that count
+ * */
+static inline float ENC_angle(const ENC_Estimator *e, uint32_t position, uint16_t capture_timer) {
+    float moved = e->speed_cps * (float)capture_timer * e->capture_tick_s;
+    float fraction;
+    if (e->speed_cps >= 0.0f) { // Not moved, which is 0 at the count either way
+        fraction = moved > 1.0f ? 1.0f : moved;
+    }
+    else {
+        fraction = moved < -1.0f ? 0.0f : 1.0f + moved;
+    }
+
+    float mechanical = ((float)position + fraction)/e->counts_per_rev;
+    return FOC_wrapAngle(mechanical * e->pole_pairs + e->theta_offset);
+}
+
+/* Electrical speed (rad/s) */
+static inline float ENC_omega(const ENC_Estimator *e) {
+    return FOC_2PI_F * e->pole_pairs * e->speed_cps/e->counts_per_rev;
+}
+
+/* Mechanical speed (rpm) */
+static inline float ENC_speedRpm(const ENC_Estimator *e) {
+    return 60.0f * e->speed_cps/e->counts_per_rev;
+}
+
+/* The angle lead_s later at speed omega (rad/s) */
+static inline float ENC_predict(float theta, float omega, float lead_s) {
+    return FOC_wrapAngle(theta + omega * lead_s * FOC_INV_2PI_F);
+}
+
+#endif /* PERIPHERALS_INCLUDE_ENCODER_MATH_H_ */
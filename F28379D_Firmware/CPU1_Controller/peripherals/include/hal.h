@@ -0,0 +1,76 @@
+/*
+ * hal.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Thin hardware abstraction layer for the peripheral drivers, so they also build with g++ on a host PC.
+ *
+ *  The drivers (HalfBridgePWMT, TimerT, ConfigAdcsT) are templates on a backend class with only static
+ *  inline functions, so there are no virtual calls and the target build compiles to the same register
+ *  accesses as calling driverlib directly. 'Hal' is the backend for this build:
+ *  - RegisterHal (hal_registers.h): writes the real registers through driverlib. The default.
+ *  - SimHal (HostSim/include/hal_sim.h): records the writes into simulated peripherals. Selected by
+ *    defining HAL_SIMULATED, which only the host build does.
+ *
+ *  The constants below are the register field encodings from the TRM (the same values as the driverlib
+ *  enums), so the register backend can pass them straight through.
+ *
+ *  A backend provides:
+ *  - PWM: pwmBase(), enablePwm(), setPwmClockDivider(), setPwmPeriod(), getPwmPeriod(), setPwmCounterMode(),
+ *    setPwmActionQualifiersA(), writePwmCompareA(), setDeadBandClock(), setDeadBandMode(),
+ *    setDeadBandDelays(), enablePwmAdcTrigger(), enablePwmTimeBaseSync(), disablePwmTimeBaseSync()
+ *  - CPU timers: cpuTimerBase(), configCpuTimer(), setCpuTimerInterrupt(), readCpuTimer(), acknowledgeInterruptGroup()
+ *  - ADC: powerUpAdc(), waitAdcPowerUp(), setupAdcSoc(), configAdcInterrupt(), readAdcResult()
+ */
+
+#ifndef PERIPHERALS_INCLUDE_HAL_H_
+#define PERIPHERALS_INCLUDE_HAL_H_
+
+#include <stdint.h>
+
+// ePWM clock dividers (TBCTL.CLKDIV and TBCTL.HSPCLKDIV)
+#define HAL_PWM_CLOCK_DIVIDER_1 0
+#define HAL_PWM_CLOCK_DIVIDER_2 1
+#define HAL_PWM_HSCLOCK_DIVIDER_1 0
+
+// ePWM counter modes (TBCTL.CTRMODE)
+#define HAL_PWM_COUNTER_UP 0
+#define HAL_PWM_COUNTER_DOWN 1
+#define HAL_PWM_COUNTER_UP_DOWN 2
+
+// ePWM action qualifier actions for output A (AQCTLA bits)
+#define HAL_AQ_LOW_ZERO 0x01
+#define HAL_AQ_HIGH_ZERO 0x02
+#define HAL_AQ_LOW_PERIOD 0x04
+#define HAL_AQ_HIGH_PERIOD 0x08
+#define HAL_AQ_LOW_UP_CMPA 0x10
+#define HAL_AQ_HIGH_UP_CMPA 0x20
+#define HAL_AQ_LOW_DOWN_CMPA 0x40
+#define HAL_AQ_HIGH_DOWN_CMPA 0x80
+
+// ePWM dead band (DBCTL.POLSEL and DBCTL.OUT_MODE)
+#define HAL_DB_POLARITY_ACTIVE_HIGH_COMPLEMENTARY 2 // EPWMxB is EPWMxA inverted
+#define HAL_DB_OUTPUT_RED_FED 3 // Rising and falling edge delays both enabled
+
+// ePWM ADC trigger sources (ETSEL.SOCASEL)
+#define HAL_PWM_SOC_TBCTR_ZERO 1
+#define HAL_PWM_SOC_TBCTR_PERIOD 2
+
+// ADC modules and SOC triggers (ADCSOCxCTL.TRIGSEL)
+#define HAL_ADC_A 0
+#define HAL_ADC_B 1
+#define HAL_ADC_TRIGGER_EPWM1_SOCA 5
+
+// PIE interrupt groups for acknowledgeInterruptGroup() (PIEACK bits)
+#define HAL_PIE_GROUP1 0x0001
+
+#if defined(HAL_SIMULATED)
+#include "hal_sim.h"
+typedef SimHal Hal;
+#else
+#include "hal_registers.h"
+typedef RegisterHal Hal;
+#endif
+
+#endif /* PERIPHERALS_INCLUDE_HAL_H_ */
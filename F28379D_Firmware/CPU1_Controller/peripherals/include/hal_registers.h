@@ -0,0 +1,152 @@
+/*
+ * hal_registers.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Register backend of the HAL (see hal.h). Each function is the driverlib call or register write
+ *  the drivers used to make themselves, so the target build is unchanged.
+ */
+
+#ifndef PERIPHERALS_INCLUDE_HAL_REGISTERS_H_
+#define PERIPHERALS_INCLUDE_HAL_REGISTERS_H_
+
+#include "system_config.h"
+#include <stdint.h>
+
+#define ADC_POWER_UP_TIME 500e-6f // (s)
+
+struct RegisterHal {
+    /*** ePWM ***/
+    static inline uint32_t pwmBase(EPWM_Module module) {
+        return EPWM1_BASE + module * 0x00000100U; // See <inc/hw.memmap.h> in driverlib
+    }
+
+    static inline void enablePwm(EPWM_Module module, EPWM_Outputs outputs) {
+        EPWM_enableModule(module, outputs);
+    }
+
+    static inline void setPwmClockDivider(uint32_t base, uint16_t divider, uint16_t hs_divider) {
+        EPWM_setClockPrescaler(base, (EPWM_ClockDivider)divider, (EPWM_HSClockDivider)hs_divider);
+    }
+
+    static inline void setPwmPeriod(uint32_t base, uint16_t period) {
+        EPWM_setTimeBasePeriod(base, period);
+    }
+
+    static inline uint16_t getPwmPeriod(uint32_t base) {
+        return HWREGH(base + EPWM_O_TBPRD);
+    }
+
+    static inline void setPwmCounterMode(uint32_t base, uint16_t mode) {
+        EPWM_setTimeBaseCounterMode(base, (EPWM_TimeBaseCountMode)mode);
+    }
+
+    static inline void setPwmActionQualifiersA(uint32_t base, uint16_t actions) {
+        EPWM_setActionQualifierActionComplete(base, EPWM_AQ_OUTPUT_A, actions);
+    }
+
+    /* Writes CMPA (no EALLOW protection). '+1' since it's the high word of a 32-bit register */
+    static inline void writePwmCompareA(uint32_t base, uint16_t value) {
+        HWREGH(base + EPWM_O_CMPA + 1) = value;
+    }
+
+    static inline void setDeadBandClock(uint32_t base, bool half_cycle) {
+        EPWM_setDeadBandCounterClock(base, half_cycle ? EPWM_DB_COUNTER_CLOCK_HALF_CYCLE
+                                                      : EPWM_DB_COUNTER_CLOCK_FULL_CYCLE);
+    }
+
+    /* See <inc/hw_epwm.h> for the register address shifts and bit shifts. Note that there is no EALLOW protection for this register.
+     * The fields are cleared first so reconfiguring a module doesn't leave bits from the previous mode set. */
+    static inline void setDeadBandMode(uint32_t base, uint16_t polarity, uint16_t output_mode) {
+        HWREGH(base + EPWM_O_DBCTL) = (HWREGH(base + EPWM_O_DBCTL) & ~(EPWM_DBCTL_POLSEL_M | EPWM_DBCTL_OUT_MODE_M))
+                                      | (polarity << EPWM_DBCTL_POLSEL_S)
+                                      | (output_mode << EPWM_DBCTL_OUT_MODE_S);
+    }
+
+    static inline void setDeadBandDelays(uint32_t base, uint16_t rising_count, uint16_t falling_count) {
+        EPWM_setRisingEdgeDelayCount(base, rising_count);
+        EPWM_setFallingEdgeDelayCount(base, falling_count);
+    }
+
+    static inline void enablePwmAdcTrigger(uint32_t base, uint16_t source, uint16_t prescale) {
+        EPWM_setADCTriggerSource(base, EPWM_SOC_A, (EPWM_ADCStartOfConversionSource)source);
+        EPWM_setADCTriggerEventPrescale(base, EPWM_SOC_A, prescale);
+        EPWM_enableADCTrigger(base, EPWM_SOC_A);
+    }
+
+    static inline void enablePwmTimeBaseSync() {
+        SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_TBCLKSYNC); // Enable time base clocks for all ePWM modules
+    }
+
+    static inline void disablePwmTimeBaseSync() {
+        SysCtl_disablePeripheral(SYSCTL_PERIPH_CLK_TBCLKSYNC);
+    }
+
+    /*** CPU timers ***/
+    static inline uint32_t cpuTimerBase(uint16_t index) {
+        return CPUTIMER0_BASE + index * (CPUTIMER1_BASE - CPUTIMER0_BASE);
+    }
+
+    static inline void configCpuTimer(uint32_t base, uint32_t period_count, uint16_t clock_divider) {
+        CPUTimer_setConfig(base, period_count, clock_divider);
+        CPUTimer_startTimer(base); // Start timer. Not actually necessary since timer starts automatically by default.
+    }
+
+    static inline void setCpuTimerInterrupt(uint32_t base, void (*handler)(void)) {
+        CPUTimer_configInterrupt(base, handler);
+    }
+
+    static inline uint32_t readCpuTimer(uint32_t base) {
+        return CPUTimer_getTimerCount(base);
+    }
+
+    static inline void acknowledgeInterruptGroup(uint16_t group) {
+        HWREGH(PIECTRL_BASE + PIE_O_ACK) = group; // PIEACK bits are cleared by writing 1
+    }
+
+    /*** ADC ***/
+    static inline uint32_t adcBase(uint16_t adc) {
+        return adc == HAL_ADC_A ? ADCA_BASE : ADCB_BASE;
+    }
+
+    static inline uint32_t adcResultBase(uint16_t adc) {
+        return adc == HAL_ADC_A ? ADCARESULT_BASE : ADCBRESULT_BASE;
+    }
+
+    /* Powers up an ADC module with a /4 clock, 12-bit single ended mode and late interrupt pulses */
+    static inline void powerUpAdc(uint16_t adc) {
+        uint32_t base = adcBase(adc);
+        SysCtl_enablePeripheral(adc == HAL_ADC_A ? SYSCTL_PERIPH_CLK_ADCA : SYSCTL_PERIPH_CLK_ADCB);
+        ADC_setPrescaler(base, ADC_CLK_DIV_4_0);
+        ADC_setMode(base, ADC_RESOLUTION_12BIT, ADC_MODE_SINGLE_ENDED);
+        ADC_setInterruptPulseMode(base, ADC_PULSE_END_OF_CONV);
+        ADC_enableConverter(base);
+    }
+
+    /* Delay for the 500us power up time recommended by the TRM. SysCtl_delay() takes 5 cycles a loop plus 9:
+     * 2498 loops at SYSCLK = 25MHz. */
+    static inline void waitAdcPowerUp() {
+        SysCtl_delay((uint32_t)((ADC_POWER_UP_TIME*PLLSYSCLK - 9)/5));
+    }
+
+    static inline void setupAdcSoc(uint16_t adc, uint16_t soc, uint16_t trigger, uint16_t channel,
+                                   uint32_t acquisition_window) {
+        ADC_setupSOC(adcBase(adc), (ADC_SOCNumber)soc, (ADC_Trigger)trigger, (ADC_Channel)channel, acquisition_window);
+    }
+
+    /* ADC INT1 at the end of conversion of 'soc', in continuous mode so the flag doesn't need clearing */
+    static inline void configAdcInterrupt(uint16_t adc, uint16_t soc) {
+        uint32_t base = adcBase(adc);
+        ADC_setInterruptSource(base, ADC_INT_NUMBER1, (ADC_SOCNumber)soc);
+        ADC_enableContinuousMode(base, ADC_INT_NUMBER1);
+        ADC_enableInterrupt(base, ADC_INT_NUMBER1);
+        ADC_clearInterruptStatus(base, ADC_INT_NUMBER1);
+    }
+
+    static inline uint16_t readAdcResult(uint16_t adc, uint16_t soc) {
+        return ADC_readResult(adcResultBase(adc), (ADC_SOCNumber)soc);
+    }
+};
+
+#endif /* PERIPHERALS_INCLUDE_HAL_REGISTERS_H_ */
@@ -0,0 +1,89 @@
+/*
+ * ipc_link.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  CPU1's end of the message channel to CPU2 (F28379D_Firmware/common/ipc_channel.h).
+ *
+ *  CPU2 is the communications processor: it owns SCI-A and CAN-B (see AssignCpu2Resources()), so CPU1
+ *  never touches a comms peripheral. Instead:
+ *  - Telemetry: CPU timer 0 publishes a LINK_Telemetry frame at LINK_TELEMETRY_FREQUENCY, which CPU2
+ *    sends out on SCI-A. Publishing never waits: a frame is dropped if the ring is full. Its fields all
+ *    come from one sample (seqlock.h), and a frame which couldn't be copied whole is dropped too.
+ *  - Commands: CPU2 executes the host's commands itself (CPU2_Communication/commands.h) and passes on
+ *    those for CPU1. CMD_FORWARD's bytes arrive in the INT_IPC_0 ISR and go to the handler set with
+ *    LINK_setCommandHandler().
+ *  - References: CPU2 runs the speed and position control (motion_link.h) and sends a current reference
+ *    every period. The INT_IPC_0 ISR hands it to the current loop, which takes it whole at its next
+ *    sample, and answers with the loop's angle and speed from one sample. CPU1 itself only runs the
+ *    current loop.
+ *  - Frames: bulk data such as waveform captures is written straight into a GSx frame buffer
+ *    (LINK_frameBuffer()) and handed to CPU2 with LINK_publishFrame(), which moves the block's
+ *    ownership instead of copying it (frame_service.h).
+ *  - Scope: CHAN_MSG_SCOPE_SELECT picks the live scope's channels (scope.h), whose records go out in frames.
+ *  - Capture: CHAN_MSG_CAPTURE_ARM arms a triggered capture (capture.h), which goes out as one frame, and
+ *    CHAN_MSG_CAPTURE_TRIGGER triggers it.
+ *  - Gains: CHAN_MSG_CURRENT_GAINS replaces the current regulator gains (FOC_setCurrentGains()), whole,
+ *    from the next sample. The telemetry says which version each frame ran with.
+ *
+ *  linkReferenceLatency measures the link from CPU2's send of each reference to it being in place, with
+ *  the IPC counter, which both cores read and which counts SYSCLK cycles.
+ */
+
+#ifndef PERIPHERALS_INCLUDE_IPC_LINK_H_
+#define PERIPHERALS_INCLUDE_IPC_LINK_H_
+
+#include <stdint.h>
+#include "ipc_channel.h"
+#include "frame_service.h"
+#include "motion_link.h"
+
+#define LINK_MAX_MESSAGE_WORDS 32 // Longest message CPU1 accepts. Longer ones are dropped and counted.
+#define LINK_TELEMETRY_FREQUENCY 500 // Hz. A frame is 54 bytes on the line, so 500 Hz is 35% of the SCI at full baud.
+
+/* Telemetry frame, a copy of the current loop telemetry from one sample */
+typedef struct {
+    uint32_t sample_count; // Current loop samples since it started
+    uint32_t gains_version; // Version of the current regulator gains it ran with (FOC_setCurrentGains())
+    float ia; // Phase currents (A)
+    float ib;
+    float vdc; // DC link voltage (V)
+    float id; // dq currents (A)
+    float iq;
+    float vd; // dq voltages (V)
+    float vq;
+    float theta; // Electrical angle (per-unit)
+    float omega; // Electrical speed (rad/s)
+    uint16_t startup_state; // OBS_STATE_x when sensorless
+} LINK_Telemetry;
+
+typedef void (*LINK_CommandHandler)(const uint16_t *bytes, uint16_t count);
+
+extern volatile uint16_t linkDropped; // Messages from CPU2 that were too long, of unknown type or refused
+extern volatile uint16_t linkTelemetryDropped; // Telemetry frames not sent because the ring was full or the copy torn
+extern volatile uint32_t linkReferenceLatency; // CPU2's send to the reference being in place (SYSCLK cycles)
+extern volatile uint32_t linkReferenceLatencyMax;
+extern volatile uint16_t linkReferencesRefused; // References that came within one current loop sample of the last
+
+/* Initializes CPU1's outbox, the receive interrupt and the telemetry timer. CPU2 must not send before this. */
+void ConfigIpcLink();
+
+/* Sets the function called (in the INT_IPC_0 ISR) with the bytes of each CMD_FORWARD from the host */
+void LINK_setCommandHandler(LINK_CommandHandler handler);
+
+/* The frame buffer CPU1 owns, FRAME_BUFFER_WORDS long. Changes after each successful LINK_publishFrame(). */
+uint16_t *LINK_frameBuffer();
+
+/* Hands the first words of the frame buffer to CPU2 for streaming. Returns false, and the buffer stays
+ * CPU1's, if CPU2 is still streaming the previous frame. Call from a non-nesting ISR: ipcReceiveISR()
+ * mustn't interrupt it, since both change GSxMSEL with a read-modify-write, and neither may another
+ * sender on the channel. */
+bool LINK_publishFrame(uint16_t words);
+
+extern FRAME_Writer linkFrames;
+
+interrupt void ipcReceiveISR();
+interrupt void telemetryTimerISR();
+
+#endif /* PERIPHERALS_INCLUDE_IPC_LINK_H_ */
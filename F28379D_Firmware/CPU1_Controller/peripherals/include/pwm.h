@@ -5,15 +5,29 @@
  *      Author: Charley Shi
  *
  *  Code for PWM generation via the ePWM modules
+ *
+ *  HalfBridgePWMT is written against the HAL (hal.h) so it also builds on a host PC. The firmware
+ *  uses HalfBridgePWM, which is HalfBridgePWMT on the HAL backend for this build.
  */
 
 #ifndef PERIPHERALS_INCLUDE_PWM_H_
 #define PERIPHERALS_INCLUDE_PWM_H_
 
-#include "system_config.h"
+#include "hal.h"
+#include "clock_config.h"
+#include "static_instance.h"
 #include <stdint.h>
+#include <math.h>
+
+void ConfigPwm(); // Initializes all PWM modules, with their counters stopped
+void StartPwm(); // Starts all PWM counters at once. The first switching (and ADC trigger) follows.
 
-void ConfigPwm(); // Initializes all PWM modules
+#define PWM_FREQUENCY_HZ 100000 // Switching frequency shared by all phases
+#define PWM_DEAD_TIME_NS 100.0f // Dead time of each half bridge
+
+#define PHASE_A_PWM EPWM1 // GPIO0 and GPIO1
+#define PHASE_B_PWM EPWM2 // GPIO2 and GPIO3
+#define PHASE_C_PWM EPWM3 // GPIO4 and GPIO5
 
 typedef enum PWM_Count_Mode {
     SYMMETRICAL_PWM, // Up-down count
@@ -23,7 +37,8 @@ typedef enum PWM_Count_Mode {
 
 #define HALFCYCLE_DB_CLOCKING_ENABLE 0 // 0 = Full Cycle clocking for dead band counters; 1 = Half Cycle clocking for dead band counters
 
-class HalfBridgePWM {
+template<class HalT>
+class HalfBridgePWMT {
     private:
         uint32_t base;
         uint32_t timer_top; // For setting duty cycle
@@ -32,16 +47,158 @@ class HalfBridgePWM {
 
         void configClock(uint32_t frequency_Hz);
         void configActionQualifiers();
-        void configDeadBand(uint32_t dead_time_ns);
+        void configDeadBand(float dead_time_ns);
 
     public:
-        HalfBridgePWM(EPWM_Module module, uint32_t frequency_Hz, PWMCountMode count_mode, float dead_time_ns);
+        HalfBridgePWMT(EPWM_Module module, uint32_t frequency_Hz, PWMCountMode count_mode, float dead_time_ns);
         void setDutyCycle(float D);
+        void setCompare(uint16_t compare_value);
+        void configAdcTrigger(uint16_t prescale);
+        uint16_t getTimerTop() { return (uint16_t)timer_top; }
+        uint32_t getPeriodCycles(); // Actual PWM period in SYSCLK cycles
 };
 
+typedef HalfBridgePWMT<Hal> HalfBridgePWM;
+
 // Global PWM modules for each phase. Making these global allows other files to update their duty cycles.
-extern HalfBridgePWM *phaseA;
-extern HalfBridgePWM *phaseB;
-extern HalfBridgePWM *phaseC;
+// Constructed by ConfigPwm() in static storage (static_instance.h).
+extern StaticInstance<HalfBridgePWM> phaseA;
+extern StaticInstance<HalfBridgePWM> phaseB;
+extern StaticInstance<HalfBridgePWM> phaseC;
+
+/* Writes the compare values of all three phases. The modules are known at compile time, so each one is
+ * a single store to a constant register address. For the current loop ISR. */
+static inline void setPhaseCompares(uint16_t a, uint16_t b, uint16_t c) {
+    Hal::writePwmCompareA(Hal::pwmBase(PHASE_A_PWM), a);
+    Hal::writePwmCompareA(Hal::pwmBase(PHASE_B_PWM), b);
+    Hal::writePwmCompareA(Hal::pwmBase(PHASE_C_PWM), c);
+}
+
+/* Configures the PWM module with active high complementary PWM for driving half bridges.
+ *
+ * \param module is the EPWM module (EPWM1, EPWM2,...,EPWM12) to use.
+ * \param frequency_Hz is the frequency of the PWM
+ * \param countMode determines whether the PWM is up counting, down counting or symmetrical
+ * \param dead_time_ns sets the dead time in ns
+ *
+ * A clock prescaler of /2 is used for TBCLK
+ *
+ * */
+template<class HalT>
+HalfBridgePWMT<HalT>::HalfBridgePWMT(EPWM_Module module, uint32_t frequency_Hz, PWMCountMode count_mode, float dead_time_ns) {
+    // Initialise fields
+    base = HalT::pwmBase(module); // Base address of registers
+    tbclk_Hz = (uint32_t)(PLLSYSCLK/2); // Prescaler of 2
+    countMode = count_mode;
+
+    HalT::enablePwm(module, EPWM_OUTPUT_A_B); // Enable the ePWM module and its outputs (warning: GPIO settings won't work for outside GPIO0-23)
+
+    // Configure the module
+    configClock(frequency_Hz);
+    configActionQualifiers();
+    configDeadBand(dead_time_ns);
+}
+
+/* Updates the duty cycle of the PWM */
+template<class HalT>
+inline void HalfBridgePWMT<HalT>::setDutyCycle(float D) {
+    HalT::writePwmCompareA(base, (uint16_t)(D*timer_top));
+}
+
+/* Writes the compare value directly, for code which has already scaled the duty cycle by the timer top */
+template<class HalT>
+inline void HalfBridgePWMT<HalT>::setCompare(uint16_t compare_value) {
+    HalT::writePwmCompareA(base, compare_value);
+}
+
+/* Generates SOCA at the timer top (TBPRD) to trigger the ADC. For symmetrical PWM this is the middle of
+ * the low side on time, where the low side shunt current is valid and free of switching noise.
+ *
+ * \param prescale is the number of PWM periods between triggers (1 to 15)
+ * */
+template<class HalT>
+void HalfBridgePWMT<HalT>::configAdcTrigger(uint16_t prescale) {
+    HalT::enablePwmAdcTrigger(base, HAL_PWM_SOC_TBCTR_PERIOD, prescale);
+}
+
+/* Configures the ePWM clock with a prescaler of 2 */
+template<class HalT>
+void HalfBridgePWMT<HalT>::configClock(uint32_t frequency_Hz) {
+    HalT::setPwmClockDivider(base, HAL_PWM_CLOCK_DIVIDER_2, HAL_PWM_HSCLOCK_DIVIDER_1); // Net prescaler of /2
+
+    // Calculate the timer top value
+    if (countMode == SYMMETRICAL_PWM) {
+        timer_top = tbclk_Hz/(2*frequency_Hz);
+    }
+    else {
+        timer_top = tbclk_Hz/frequency_Hz - 1;
+    }
+
+    HalT::setPwmPeriod(base, (uint16_t)timer_top);
+}
+
+/* The PWM period after rounding to whole TBCLKs, in SYSCLK cycles */
+template<class HalT>
+uint32_t HalfBridgePWMT<HalT>::getPeriodCycles() {
+    uint32_t period_tbclk = countMode == SYMMETRICAL_PWM ? 2*timer_top : timer_top + 1;
+    return period_tbclk*2; // Prescaler of 2
+}
+
+/* Configures the action qualifiers for output A based on the count mode.
+ * Note: Configuring the dead band submodule will automatically configure output B based on output A. */
+template<class HalT>
+void HalfBridgePWMT<HalT>::configActionQualifiers() {
+    switch (countMode) {
+    case SYMMETRICAL_PWM:
+        // Up-down count mode, non-inverting
+        HalT::setPwmCounterMode(base, HAL_PWM_COUNTER_UP_DOWN);
+
+        /* Configure action qualifiers */
+        // Set on bottom (zero), clear on compare match when up counting, clear on TOP, set on compare match when down counting
+        HalT::setPwmActionQualifiersA(base, HAL_AQ_HIGH_ZERO | HAL_AQ_LOW_UP_CMPA | HAL_AQ_LOW_PERIOD | HAL_AQ_HIGH_DOWN_CMPA);
+        break;
+
+    case UP_COUNT_PWM:
+        HalT::setPwmCounterMode(base, HAL_PWM_COUNTER_UP);
+
+        /* Configure action qualifiers */
+        // Set on bottom (zero), clear on compare match when up counting
+        HalT::setPwmActionQualifiersA(base, HAL_AQ_HIGH_ZERO | HAL_AQ_LOW_UP_CMPA);
+        break;
+
+    case DOWN_COUNT_PWM:
+        HalT::setPwmCounterMode(base, HAL_PWM_COUNTER_DOWN);
+
+        /* Configure action qualifiers */
+        // Clear on bottom (zero), set on compare match when down counting
+        HalT::setPwmActionQualifiersA(base, HAL_AQ_LOW_ZERO | HAL_AQ_HIGH_DOWN_CMPA);
+        break;
+    }
+}
+
+/* Configures the dead band submodule. Can use half cycle for more resolution. Assumes that
+ * the rising and falling edge delays (FED and RED) are the same. The counts are rounded up so the
+ * dead time is never shorter than asked for (less a small margin, so float error on an exact count
+ * doesn't add one). */
+template<class HalT>
+void HalfBridgePWMT<HalT>::configDeadBand(float dead_time_ns) {
+    uint16_t FED_count, RED_count;
+    if (HALFCYCLE_DB_CLOCKING_ENABLE) {
+        HalT::setDeadBandClock(base, true);
+        FED_count = (uint16_t)ceilf(2 * dead_time_ns * 1e-9f * tbclk_Hz - 0.01f); // Value to load DBFED register with
+        RED_count = (uint16_t)ceilf(2 * dead_time_ns * 1e-9f * tbclk_Hz - 0.01f); // Value to load DBRED register with
+    }
+    else {
+        HalT::setDeadBandClock(base, false);
+        FED_count = (uint16_t)ceilf(dead_time_ns * 1e-9f * tbclk_Hz - 0.01f); // Value to load DBFED register with
+        RED_count = (uint16_t)ceilf(dead_time_ns * 1e-9f * tbclk_Hz - 0.01f); // Value to load DBRED register with
+    }
+
+    HalT::setDeadBandMode(base, HAL_DB_POLARITY_ACTIVE_HIGH_COMPLEMENTARY, // Active high complementary mode (EPWMxB is EPWMxA inverted)
+                          HAL_DB_OUTPUT_RED_FED); // Fully enable DB submodule
+
+    // Assign RED and FED count values
+    HalT::setDeadBandDelays(base, RED_count, FED_count);
+}
 
 #endif /* PERIPHERALS_INCLUDE_PWM_H_ */
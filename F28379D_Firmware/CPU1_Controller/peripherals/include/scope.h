@@ -0,0 +1,270 @@
+/*
+ * scope.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Live scope: streams up to SCOPE_MAX_CHANNELS firmware variables, every current loop sample or every
+ *  Nth, chosen at run time from a registry built at compile time.
+ *
+ *  SCOPE_REGISTRY below is the one list of variables, as X(name, variable, type, scale, unit). The
+ *  firmware expands it into a table of addresses and types; the host expands the same list into names,
+ *  scales and units (HostSim's serial_decode). The target never sees a string: channels are numbers
+ *  (SCOPE_ID_x), so add variables at the end to keep the numbers of the others.
+ *
+ *  - Selection: CHAN_MSG_SCOPE_SELECT from CPU2 with the channel ids and the decimation. SCOPE_select()
+ *    resolves the ids to pointers once, split into 32-bit and 16-bit channels.
+ *  - Sampling: SCOPE_sample() after each current loop sample (from the CLA Task 1 end of task ISR in foc.cpp)
+ *    copies the selected variables into the frame buffer CPU1 owns (frame_service.h): one pointer load
+ *    and one or two word copies per channel, with no branch on the type, name or value.
+ *  - Streaming: a full frame is published to CPU2 without copying and goes out on the SCI as a
+ *    FRAME_READY header and data chunks. If CPU2 is still streaming the previous frame the new one is
+ *    dropped and the buffer refilled; the gap shows in the frame's first sample number.
+ *
+ *  A frame is a SCOPE_FrameHeader then whole records. Each record holds the selected 32-bit variables
+ *  in selection order, low word first, then the 16-bit ones in selection order.
+ *
+ *  The scope owns the frame buffers while channels are selected, and a triggered capture (capture.h)
+ *  while it is armed; CPU1 runs one at a time. The engine is portable C, tested on
+ *  the host (HostSim bench "scope").
+ */
+
+#ifndef PERIPHERALS_INCLUDE_SCOPE_H_
+#define PERIPHERALS_INCLUDE_SCOPE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "clock_config.h"
+
+#define SCOPE_MAX_CHANNELS 8U // Even: the header packs two ids per word
+#define SCOPE_NO_CHANNEL 0xFFU // Header id after the last channel
+#define SCOPE_FRAME_WORDS 256U // Frames are published at the most whole records that fit
+#define SCOPE_FRAME_KIND 0x5C01U // First word of a scope frame
+
+#define SCOPE_CYCLES_TO_US (1e6f/PLLSYSCLK)
+
+/* The registry. Variables are read where they are: the current loop's telemetry and state (foc.h),
+ * its angle input, the timings of the scope's own sampling and of the IPC link (ipc_link.h), and the state of
+ * the capture (capture.h). */
+#define SCOPE_REGISTRY(X) \
+    X(ia,                FOC_TELEMETRY.ia,         SCOPE_FLOAT32, 1.0f,               "A") \
+    X(ib,                FOC_TELEMETRY.ib,         SCOPE_FLOAT32, 1.0f,               "A") \
+    X(vdc,               FOC_TELEMETRY.vdc,        SCOPE_FLOAT32, 1.0f,               "V") \
+    X(id,                FOC_TELEMETRY.i_dq.d,     SCOPE_FLOAT32, 1.0f,               "A") \
+    X(iq,                FOC_TELEMETRY.i_dq.q,     SCOPE_FLOAT32, 1.0f,               "A") \
+    X(vd,                FOC_TELEMETRY.v_dq.d,     SCOPE_FLOAT32, 1.0f,               "V") \
+    X(vq,                FOC_TELEMETRY.v_dq.q,     SCOPE_FLOAT32, 1.0f,               "V") \
+    X(theta,             FOC_TELEMETRY.theta,      SCOPE_FLOAT32, 360.0f,             "deg") \
+    X(omega,             FOC_TELEMETRY.omega,      SCOPE_FLOAT32, 1.0f,               "rad/s") \
+    X(startup_state,     FOC_TELEMETRY.startup_state, SCOPE_UINT16, 1.0f,             "") \
+    X(sample_count,      FOC_TELEMETRY.sample_count, SCOPE_UINT32, 1.0f,              "") \
+    X(duty_a,            FOC_LOOP.duty[0],         SCOPE_FLOAT32, 100.0f,             "%") \
+    X(duty_b,            FOC_LOOP.duty[1],         SCOPE_FLOAT32, 100.0f,             "%") \
+    X(duty_c,            FOC_LOOP.duty[2],         SCOPE_FLOAT32, 100.0f,             "%") \
+    X(theta_input,       claParams.angle.theta,    SCOPE_FLOAT32, 360.0f,             "deg") \
+    X(sample_interval,   scopeSampleInterval,      SCOPE_UINT32,  SCOPE_CYCLES_TO_US, "us") \
+    X(scope_cycles,      scopeCycles,              SCOPE_UINT32,  1.0f,               "cycles") \
+    X(reference_latency, linkReferenceLatency,     SCOPE_UINT32,  SCOPE_CYCLES_TO_US, "us") \
+    X(reference_latency_max, linkReferenceLatencyMax, SCOPE_UINT32, SCOPE_CYCLES_TO_US, "us") \
+    X(references_refused, linkReferencesRefused,   SCOPE_UINT16,  1.0f,               "") \
+    X(capture_state,     captureState,             SCOPE_UINT16,  1.0f,               "") \
+    X(gains_version,     FOC_TELEMETRY.gains_version, SCOPE_UINT32, 1.0f,             "")
+
+#define SCOPE_ID_ENTRY(name, variable, type, scale, unit) SCOPE_ID_##name,
+enum {
+    SCOPE_REGISTRY(SCOPE_ID_ENTRY)
+    SCOPE_VARIABLE_COUNT
+};
+
+typedef enum {
+    SCOPE_FLOAT32 = 0, // 32-bit types first: SCOPE_isWide()
+    SCOPE_UINT32 = 1,
+    SCOPE_INT32 = 2,
+    SCOPE_UINT16 = 3,
+    SCOPE_INT16 = 4
+} SCOPE_Type;
+
+static inline bool SCOPE_isWide(uint16_t type) {
+    return type < SCOPE_UINT16;
+}
+
+typedef struct {
+    const volatile void *address;
+    uint16_t type; // SCOPE_Type
+} SCOPE_Variable;
+
+/* CHAN_MSG_SCOPE_SELECT payload, CPU2 to CPU1 */
+typedef struct {
+    uint16_t decimation; // Current loop samples per record, at least 1
+    uint16_t count; // Channels. 0 stops the scope.
+    uint16_t ids[SCOPE_MAX_CHANNELS]; // SCOPE_ID_x
+} SCOPE_Select;
+
+typedef struct {
+    uint16_t kind; // SCOPE_FRAME_KIND
+    uint16_t decimation;
+    uint32_t first_sample; // Current loop sample count of the first record
+    uint16_t ids[SCOPE_MAX_CHANNELS/2U]; // Two per word, low byte first, then SCOPE_NO_CHANNEL
+} SCOPE_FrameHeader;
+
+#define SCOPE_HEADER_WORDS 8U // SCOPE_FrameHeader in 16-bit words
+
+/* A set of channels bound to their variables, shared by the scope and the capture (capture.h) */
+typedef struct {
+    const volatile uint32_t *wide[SCOPE_MAX_CHANNELS];
+    const volatile uint16_t *narrow[SCOPE_MAX_CHANNELS];
+    uint16_t wide_count;
+    uint16_t narrow_count;
+    uint16_t ids[SCOPE_MAX_CHANNELS/2U]; // As in a frame header
+    uint16_t record_words; // 0 when there are no channels
+} SCOPE_Channels;
+
+/* Binds channels to the registry's variables. Returns false, changing nothing, if there are too many
+ * or one isn't in the registry. */
+static inline bool SCOPE_bindChannels(SCOPE_Channels *c, const SCOPE_Variable *registry, uint16_t registry_size,
+                                      const uint16_t *ids, uint16_t count) {
+    if (count > SCOPE_MAX_CHANNELS) {
+        return false;
+    }
+    for (uint16_t k = 0; k < count; k++) {
+        if (ids[k] >= registry_size) {
+            return false;
+        }
+    }
+
+    c->wide_count = 0;
+    c->narrow_count = 0;
+    uint16_t words = 0;
+    for (uint16_t k = 0; k < SCOPE_MAX_CHANNELS; k++) {
+        uint16_t id = k < count ? ids[k] : SCOPE_NO_CHANNEL;
+        if (k < count) {
+            const SCOPE_Variable *v = &registry[id];
+            if (SCOPE_isWide(v->type)) {
+                c->wide[c->wide_count++] = (const volatile uint32_t *)v->address;
+                words += 2U;
+            }
+            else {
+                c->narrow[c->narrow_count++] = (const volatile uint16_t *)v->address;
+                words += 1U;
+            }
+        }
+        if (k & 1U) {
+            c->ids[k/2U] = (uint16_t)((c->ids[k/2U] & 0xFFU) | (id << 8));
+        }
+        else {
+            c->ids[k/2U] = id;
+        }
+    }
+    c->record_words = words;
+    return true;
+}
+
+/* Copies one record of the channels to out: one pointer load and one or two word copies per channel */
+static inline void SCOPE_record(const SCOPE_Channels *c, uint16_t *out) {
+    for (uint16_t k = 0; k < c->wide_count; k++) {
+        uint32_t value = *c->wide[k]; // One 32-bit read, so the variable isn't torn
+        out[0] = (uint16_t)value;
+        out[1] = (uint16_t)(value >> 16);
+        out += 2;
+    }
+    for (uint16_t k = 0; k < c->narrow_count; k++) {
+        *out++ = *c->narrow[k];
+    }
+}
+
+/* Channel id k (0 to SCOPE_MAX_CHANNELS - 1) of a frame header's ids, SCOPE_NO_CHANNEL past the last */
+static inline uint16_t SCOPE_channelId(const uint16_t *ids, uint16_t k) {
+    return (k & 1U) ? ids[k/2U] >> 8 : ids[k/2U] & 0xFFU;
+}
+
+typedef struct {
+    const SCOPE_Variable *registry;
+    uint16_t registry_size;
+
+    // Selection
+    SCOPE_Channels channels;
+    uint16_t frame_words; // Publish at this length
+    uint16_t decimation;
+
+    // Sampling
+    uint16_t countdown; // Samples to the next record
+    uint16_t fill; // Words of the frame written, 0 before its header
+} SCOPE_Engine;
+
+static inline void SCOPE_init(SCOPE_Engine *s, const SCOPE_Variable *registry, uint16_t registry_size) {
+    s->registry = registry;
+    s->registry_size = registry_size;
+    SCOPE_bindChannels(&s->channels, registry, registry_size, 0, 0);
+    s->frame_words = 0;
+    s->decimation = 1;
+    s->countdown = 1;
+    s->fill = 0;
+}
+
+/* Selects the channels, which are recorded from the next sample into a new frame. A count of 0 stops
+ * the scope. Returns false, changing nothing, if a channel or the decimation is invalid. */
+static inline bool SCOPE_select(SCOPE_Engine *s, const uint16_t *ids, uint16_t count, uint16_t decimation) {
+    if (decimation == 0U || !SCOPE_bindChannels(&s->channels, s->registry, s->registry_size, ids, count)) {
+        return false;
+    }
+    uint16_t words = s->channels.record_words;
+    s->frame_words = words ? (uint16_t)(SCOPE_HEADER_WORDS + words*((SCOPE_FRAME_WORDS - SCOPE_HEADER_WORDS)/words)) : 0U;
+    s->decimation = decimation;
+    s->countdown = 1;
+    s->fill = 0;
+    return true;
+}
+
+/* True while channels are selected */
+static inline bool SCOPE_running(const SCOPE_Engine *s) {
+    return s->channels.record_words != 0U;
+}
+
+/* Records the selected variables if this sample is due, into frame (which has room for
+ * SCOPE_FRAME_WORDS). Call after every current loop sample.
+ * \return the frame length when this record completes it, which the caller publishes, otherwise 0. The
+ * next record starts a new frame either way. */
+static inline uint16_t SCOPE_sample(SCOPE_Engine *s, uint16_t *frame, uint32_t sample_count) {
+    if (s->channels.record_words == 0U || --s->countdown != 0U) {
+        return 0;
+    }
+    s->countdown = s->decimation;
+
+    if (s->fill == 0U) {
+        SCOPE_FrameHeader *header = (SCOPE_FrameHeader *)frame;
+        header->kind = SCOPE_FRAME_KIND;
+        header->decimation = s->decimation;
+        header->first_sample = sample_count;
+        for (uint16_t k = 0; k < SCOPE_MAX_CHANNELS/2U; k++) {
+            header->ids[k] = s->channels.ids[k];
+        }
+        s->fill = SCOPE_HEADER_WORDS;
+    }
+
+    SCOPE_record(&s->channels, frame + s->fill);
+    s->fill += s->channels.record_words;
+    if (s->fill < s->frame_words) {
+        return 0;
+    }
+    uint16_t words = s->fill;
+    s->fill = 0;
+    return words;
+}
+
+/* Target side (scope.cpp) */
+extern volatile uint32_t scopeSampleInterval; // SYSCLK cycles between the last two samples
+extern volatile uint32_t scopeCycles; // SYSCLK cycles the last sample took
+extern volatile uint16_t scopeFramesDropped; // Frames refilled because CPU2 was still streaming
+
+/* Call after ConfigIpcLink() and before the PWM starts. */
+void ConfigScope();
+
+/* Applies a CHAN_MSG_SCOPE_SELECT. Returns false if refused: invalid, or the current loop runs on the
+ * C28x (FOC_RUN_ON_CLA 0), whose ADC ISR has no time left for it at 25 MHz. */
+bool SCOPE_apply(const SCOPE_Select *select);
+
+/* Records the sample CLA Task 1 just finished into the scope or the capture, if one is due. Called by
+ * its end of task ISR (foc.cpp). */
+void SCOPE_recordSample();
+
+#endif /* PERIPHERALS_INCLUDE_SCOPE_H_ */
@@ -0,0 +1,50 @@
+/*
+ * static_instance.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Storage for the driver objects, so the firmware doesn't need the heap (.sysmem is size zero).
+ *
+ *  A StaticInstance<T> is uninitialised memory the size of a T, with no constructor of its own. Nothing
+ *  runs before main() for it, so there's no static initialisation order to get wrong, and the driver's
+ *  constructor (which writes registers) only runs when its Config function calls construct(), after
+ *  ConfigSystem(). Callers use it through -> like the pointer it replaces, but since the storage is at a
+ *  fixed address the compiler accesses the members directly instead of loading a pointer first.
+ *
+ *  Define the instances with PERIPHERAL_OBJECT to put them in the .bss:peripherals section, which the
+ *  linker command file places in RAM.
+ */
+
+#ifndef PERIPHERALS_INCLUDE_STATIC_INSTANCE_H_
+#define PERIPHERALS_INCLUDE_STATIC_INSTANCE_H_
+
+#include <stdint.h>
+#include <new> // Placement new only, which doesn't allocate
+
+#if defined(__TI_COMPILER_VERSION__)
+#define PERIPHERAL_OBJECT __attribute__((section(".bss:peripherals")))
+#else
+#define PERIPHERAL_OBJECT // Host build: ordinary .bss
+#endif
+
+template<class T>
+class StaticInstance {
+    private:
+        union {
+            uint32_t align; // The drivers' members are at most 32 bits (uint32_t, float, pointers)
+            unsigned char bytes[sizeof(T)];
+        } storage;
+
+    public:
+        /* Constructs the object in place. Call once, from the driver's Config function. */
+        template<class... Args>
+        T &construct(Args... args) {
+            return *new (storage.bytes) T(args...);
+        }
+
+        T *operator->() { return reinterpret_cast<T *>(storage.bytes); }
+        T &operator*() { return *operator->(); }
+};
+
+#endif /* PERIPHERALS_INCLUDE_STATIC_INSTANCE_H_ */
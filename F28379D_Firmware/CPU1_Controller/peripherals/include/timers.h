@@ -8,30 +8,41 @@
  *  - Configuring the CPU Timers 0, 1 and 2
  *  - ISRs for each timer
  *
- *  Driver code for timers.
+ *  Driver code for timers. TimerT is written against the HAL (hal.h); Timer uses the backend for this build.
  */
 
 #ifndef PERIPHERALS_INCLUDE_TIMERS_H_
 #define PERIPHERALS_INCLUDE_TIMERS_H_
 
-#include "system_config.h"
+#include "hal.h"
 #include <stdint.h>
 
 typedef enum {
-    TIMER0 = CPUTIMER0_BASE,
-    TIMER1 = CPUTIMER1_BASE,
-    TIMER2 = CPUTIMER2_BASE
+    TIMER0,
+    TIMER1,
+    TIMER2
 } TimerNumber;
 
-class Timer {
+template<class HalT>
+class TimerT {
 private:
     uint32_t base;
 
 public:
-    Timer(TimerNumber index, uint32_t periodCount, uint16_t clkDivFactor);
-    void configInterrupt(void (*handler)(void));
+    TimerT(TimerNumber index, uint32_t periodCount, uint16_t clkDivFactor) {
+        base = HalT::cpuTimerBase(index);
+        HalT::configCpuTimer(base, periodCount, clkDivFactor); // Also starts the timer
+    }
+
+    void configInterrupt(void (*handler)(void)) {
+        HalT::setCpuTimerInterrupt(base, handler);
+    }
+
+    uint32_t read() { return HalT::readCpuTimer(base); } // Counts down from the period
 };
 
+typedef TimerT<Hal> Timer;
+
 /* Interrupt Service Routines
  * (Template code, does not need to be used)
  * */
@@ -10,11 +10,8 @@
  */
 
 #include "adcs.h"
-#include "timers.h"
-
 
+/* Configures the ADCs on the HAL backend for this build. See ConfigAdcsT() in adcs.h. */
 void ConfigAdcs(void) {
-    // Add code here later
-    asm(" RPT #125 || NOP"); // Delay for 500us (125 clock cycles at SYSCLK = 25MHz) recommended by TRM
+    ConfigAdcsT<Hal>();
 }
-
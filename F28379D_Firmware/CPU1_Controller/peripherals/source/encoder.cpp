@@ -0,0 +1,82 @@
+/*
+ * encoder.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  eQEP1 encoder service. See encoder.h for the estimation method.
+ */
+
+#include "encoder.h"
+#include "foc.h"
+#include "hot_path.h"
+
+PERIPHERAL_OBJECT StaticInstance<QuadEncoder> encoder;
+
+void ConfigEncoder() {
+    encoder.construct(ENCODER_LINES, MOTOR_POLE_PAIRS);
+}
+
+/* Configures eQEP1 for a quadrature encoder with index.
+ *
+ * \param lines is the number of encoder lines per revolution
+ * \param pole_pairs is the number of motor pole pairs, to convert to electrical angle and speed
+ * */
+QuadEncoder::QuadEncoder(uint16_t lines, uint16_t pole_pairs) {
+    base = EQEP1_BASE;
+    uint32_t counts_per_rev = 4 * (uint32_t)lines;
+    ENC_init(&estimator, counts_per_rev, pole_pairs, (float)ENCODER_CAPTURE_PRESCALE/PLLSYSCLK,
+             1.0f/ENCODER_UNIT_FREQUENCY);
+
+    // Pins
+    GPIO_setPinConfig(GPIO_20_EQEP1A);
+    GPIO_setPinConfig(GPIO_21_EQEP1B);
+    GPIO_setPinConfig(GPIO_23_EQEP1I);
+    GPIO_setQualificationMode(20, GPIO_QUAL_SYNC);
+    GPIO_setQualificationMode(21, GPIO_QUAL_SYNC);
+    GPIO_setQualificationMode(23, GPIO_QUAL_SYNC);
+
+    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_EQEP1);
+
+    // Quadrature decoding, counting both edges of A and B. The count resets on the index pulse,
+    // and wraps at one revolution until then.
+    EQEP_setDecoderConfig(base, EQEP_CONFIG_QUADRATURE | EQEP_CONFIG_2X_RESOLUTION | EQEP_CONFIG_NO_SWAP);
+    EQEP_setEmulationMode(base, EQEP_EMULATIONMODE_RUNFREE);
+    EQEP_setPositionCounterConfig(base, EQEP_POSITION_RESET_IDX, counts_per_rev - 1);
+
+    // The unit timer latches the position count, capture timer and capture period together
+    EQEP_setLatchMode(base, EQEP_LATCH_UNIT_TIME_OUT | EQEP_LATCH_RISING_INDEX);
+    EQEP_enableUnitTimer(base, (uint32_t)(PLLSYSCLK/ENCODER_UNIT_FREQUENCY) - 1);
+
+    // The capture timer measures the time between (and since) individual counts
+    EQEP_setCaptureConfig(base, EQEP_CAPTURE_CLK_DIV_64, EQEP_UNIT_POS_EVNT_DIV_1);
+    EQEP_enableCapture(base);
+
+    EQEP_enableModule(base);
+}
+
+/* Sets the electrical angle at the index pulse (per-unit), found by aligning the rotor */
+void QuadEncoder::setAngleOffset(float theta_offset) {
+    estimator.theta_offset = theta_offset;
+}
+
+/* Returns the electrical angle and speed. Call once per current loop sample. */
+HOT_FUNC EncoderSnapshot QuadEncoder::sample() {
+    EncoderSnapshot snap;
+
+    if (EQEP_getInterruptStatus(base) & EQEP_INT_UNIT_TIME_OUT) {
+        uint16_t status = EQEP_getStatus(base);
+        ENC_updateSpeed(&estimator, EQEP_getPositionLatch(base), EQEP_getCaptureTimerLatch(base),
+                        (status & EQEP_STS_CAP_OVRFLW_ERROR) != 0);
+        if (status & EQEP_STS_CAP_OVRFLW_ERROR) {
+            EQEP_clearStatus(base, EQEP_STS_CAP_OVRFLW_ERROR);
+        }
+        EQEP_clearInterruptStatus(base, EQEP_INT_UNIT_TIME_OUT | EQEP_INT_GLOBAL);
+    }
+
+    snap.theta = ENC_angle(&estimator, EQEP_getPosition(base), EQEP_getCaptureTimer(base));
+    snap.omega = ENC_omega(&estimator);
+    snap.speed_rpm = ENC_speedRpm(&estimator);
+    snap.index_found = (EQEP_getStatus(base) & EQEP_STS_1ST_IDX_FLAG) != 0;
+    return snap;
+}
@@ -0,0 +1,176 @@
+/*
+ * ipc_link.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ */
+
+#include "ipc_link.h"
+#include "system_config.h"
+#include "timers.h"
+#include "foc.h"
+#include "scope.h"
+#include "capture.h"
+#include "isr_profile.h"
+
+volatile uint16_t linkDropped;
+volatile uint16_t linkTelemetryDropped;
+volatile uint32_t linkReferenceLatency;
+volatile uint32_t linkReferenceLatencyMax;
+volatile uint16_t linkReferencesRefused;
+static LINK_CommandHandler commandHandler;
+FRAME_Writer linkFrames;
+
+/* GS12 and GS13 hold the frame buffers (see the linker command file) */
+static void selectFrameOwner(uint16_t buffer, uint16_t owner) {
+    MemCfg_setGSRAMControllerSel(buffer ? MEMCFG_SECT_GS13 : MEMCFG_SECT_GS12,
+                                 owner == FRAME_OWNER_CPU2 ? MEMCFG_GSRAMCONTROLLER_CPU2
+                                                           : MEMCFG_GSRAMCONTROLLER_CPU1);
+}
+
+void ConfigIpcLink() {
+    CHAN_init();
+    linkDropped = 0;
+    linkTelemetryDropped = 0;
+    linkReferenceLatency = 0;
+    linkReferenceLatencyMax = 0;
+    linkReferencesRefused = 0;
+    commandHandler = 0;
+    FRAME_initWriter(&linkFrames, frameBuffer0, frameBuffer1, selectFrameOwner);
+    Interrupt_register(INT_IPC_0, &ipcReceiveISR);
+    Interrupt_enable(INT_IPC_0);
+
+    uint32_t timer_top = (uint32_t)((float)PLLSYSCLK/LINK_TELEMETRY_FREQUENCY) - 1;
+    Timer timer0(TIMER0, timer_top, 1);
+    timer0.configInterrupt(telemetryTimerISR);
+}
+
+void LINK_setCommandHandler(LINK_CommandHandler handler) {
+    commandHandler = handler;
+}
+
+uint16_t *LINK_frameBuffer() {
+    return FRAME_buffer(&linkFrames);
+}
+
+bool LINK_publishFrame(uint16_t words) {
+    if (!FRAME_publish(&linkFrames, &ipcChannel, words)) {
+        return false;
+    }
+    CHAN_notify();
+    return true;
+}
+
+/* Hands a reference from CPU2's motion controller to the current loop and answers with the loop's
+ * latest angle and speed */
+static void applyReference(const MOTION_Reference *reference) {
+    MOTION_Feedback feedback;
+    feedback.accepted = FOC_setCurrentReference(reference->id, reference->iq, reference->sequence) ? 1 : 0;
+    feedback.applied = (uint32_t)IPC_getCounter(IPC_CPU1_L_CPU2_R);
+    if (feedback.accepted) {
+        linkReferenceLatency = feedback.applied - reference->sent;
+        if (linkReferenceLatency > linkReferenceLatencyMax) {
+            linkReferenceLatencyMax = linkReferenceLatency;
+        }
+    }
+    else {
+        linkReferencesRefused++;
+    }
+
+    // The angle, speed and current of one sample. Only the fields needed are copied, in the window.
+    const volatile CLA_CurrentLoopTelemetry *t = FOC_getTelemetry();
+    bool coherent = false;
+    for (uint16_t n = 0; n < CLA_TELEMETRY_READ_TRIES && !coherent; n++) {
+        uint32_t sequence = SEQ_readBegin(&t->sequence);
+        feedback.sample_count = t->sample_count;
+        feedback.theta = t->theta;
+        feedback.omega = t->omega;
+        feedback.iq = t->i_dq.q;
+        coherent = SEQ_readValid(&t->sequence, sequence);
+    }
+    if (!coherent) {
+        return; // CPU2 copes with a missing feedback
+    }
+    feedback.sequence = reference->sequence;
+    feedback.sent = reference->sent;
+    feedback.sample_cycles = FOC_getSamplePeriodCycles();
+    CHAN_sendAndNotify(CHAN_MSG_FEEDBACK, &feedback, CHAN_WORDS(feedback));
+}
+
+ISR_PROFILE(ipcReceiveISR);
+ISR_PROFILE(telemetryTimerISR);
+
+interrupt void ipcReceiveISR() {
+    ISR_PROFILE_BEGIN();
+    CHAN_acknowledge(); // First, so a message sent while draining raises the interrupt again
+
+    uint32_t message[LINK_MAX_MESSAGE_WORDS/2]; // 32-bit aligned for the payload structs
+    uint16_t type;
+    int16_t words;
+    while ((words = CHAN_receive(&ipcChannel, &type, message, LINK_MAX_MESSAGE_WORDS)) != CHAN_EMPTY) {
+        if (type == CHAN_MSG_REFERENCE && words == CHAN_WORDS(MOTION_Reference)) {
+            applyReference((const MOTION_Reference *)message);
+        }
+        else if (type == CHAN_MSG_FRAME_RELEASE && words == CHAN_WORDS(FRAME_Release)) {
+            FRAME_handleRelease(&linkFrames, (const FRAME_Release *)message);
+        }
+        else if (type == CHAN_MSG_SCOPE_SELECT && words == CHAN_WORDS(SCOPE_Select)) {
+            if (!SCOPE_apply((const SCOPE_Select *)message)) {
+                linkDropped++;
+            }
+        }
+        else if (type == CHAN_MSG_CAPTURE_ARM && words == CHAN_WORDS(CAPTURE_Arm)) {
+            if (!CAPTURE_apply((const CAPTURE_Arm *)message)) {
+                linkDropped++;
+            }
+        }
+        else if (type == CHAN_MSG_CAPTURE_TRIGGER && words == 0) {
+            CAPTURE_trigger();
+        }
+        else if (type == CHAN_MSG_CURRENT_GAINS && words == CHAN_WORDS(FOC_CurrentGains)) {
+            if (!FOC_setCurrentGains((const FOC_CurrentGains *)message)) {
+                linkDropped++;
+            }
+        }
+        else if (type == CHAN_MSG_COMMAND && words >= 0 && commandHandler) {
+            commandHandler((const uint16_t *)message, (uint16_t)words);
+        }
+        else {
+            linkDropped++;
+        }
+    }
+
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP1);
+    ISR_PROFILE_END(ipcReceiveISR);
+}
+
+/* Copies the current loop telemetry into a frame for CPU2, every field from the same sample. The fields
+ * go straight into the frame, and are copied again if a sample wrote them meanwhile (seqlock.h). */
+interrupt void telemetryTimerISR() {
+    ISR_PROFILE_BEGIN();
+    const volatile CLA_CurrentLoopTelemetry *t = FOC_getTelemetry();
+    LINK_Telemetry frame;
+    bool coherent = false;
+    for (uint16_t n = 0; n < CLA_TELEMETRY_READ_TRIES && !coherent; n++) {
+        uint32_t sequence = SEQ_readBegin(&t->sequence);
+        frame.sample_count = t->sample_count;
+        frame.gains_version = t->gains_version;
+        frame.ia = t->ia;
+        frame.ib = t->ib;
+        frame.vdc = t->vdc;
+        frame.id = t->i_dq.d;
+        frame.iq = t->i_dq.q;
+        frame.vd = t->v_dq.d;
+        frame.vq = t->v_dq.q;
+        frame.theta = t->theta;
+        frame.omega = t->omega;
+        frame.startup_state = t->startup_state;
+        coherent = SEQ_readValid(&t->sequence, sequence);
+    }
+    if (!coherent || !CHAN_sendAndNotify(CHAN_MSG_TELEMETRY, &frame, CHAN_WORDS(frame))) {
+        linkTelemetryDropped++; // A torn frame isn't sent
+    }
+
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP1); // CPU timer 0 is INT1.7
+    ISR_PROFILE_END(telemetryTimerISR);
+}
@@ -8,6 +8,7 @@
 #include "led_blink.h"
 #include "system_config.h"
 #include "timers.h"
+#include "isr_profile.h"
 
 void led_blink_init() {
     // Set LED pins as outputs
@@ -21,7 +22,11 @@ void led_blink_init() {
     timer1.configInterrupt(blink_led);
 }
 
+ISR_PROFILE(blink_led);
+
 interrupt void blink_led() {
+    ISR_PROFILE_BEGIN();
     GPIO_togglePin(RED_LED);
     GPIO_togglePin(BLUE_LED);
+    ISR_PROFILE_END(blink_led);
 }
@@ -0,0 +1,101 @@
+/*
+ * scope.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  The live scope and the triggered capture on the target: the registry's addresses, and the sampling
+ *  after each CLA Task 1 sample that runs whichever of them is on.
+ */
+
+#include "scope.h"
+#include "capture.h"
+#include "ipc_link.h"
+#include "system_config.h"
+#include "foc.h"
+#include "hot_path.h"
+
+volatile uint32_t scopeSampleInterval;
+volatile uint32_t scopeCycles;
+volatile uint16_t scopeFramesDropped;
+volatile uint16_t captureState;
+static SCOPE_Engine scope;
+static CAPTURE_Engine capture;
+static uint32_t lastSample; // IPC counter at the previous sample
+
+#define SCOPE_TABLE_ENTRY(name, variable, type, scale, unit) {&(variable), type},
+static const SCOPE_Variable registry[SCOPE_VARIABLE_COUNT] = {
+    SCOPE_REGISTRY(SCOPE_TABLE_ENTRY)
+};
+
+static_assert(SCOPE_VARIABLE_COUNT < SCOPE_NO_CHANNEL, "Channel ids are one byte in the frame header");
+static_assert(CHAN_WORDS(SCOPE_FrameHeader) == SCOPE_HEADER_WORDS, "SCOPE_HEADER_WORDS");
+static_assert(SCOPE_FRAME_WORDS <= FRAME_BUFFER_WORDS, "A scope frame fills at most one frame buffer");
+static_assert(CHAN_WORDS(CAPTURE_FrameHeader) == CAPTURE_HEADER_WORDS, "CAPTURE_HEADER_WORDS");
+
+void ConfigScope() {
+    scopeSampleInterval = 0;
+    scopeCycles = 0;
+    scopeFramesDropped = 0;
+    lastSample = 0;
+    captureState = CAPTURE_IDLE;
+    SCOPE_init(&scope, registry, SCOPE_VARIABLE_COUNT);
+    CAPTURE_init(&capture, registry, SCOPE_VARIABLE_COUNT);
+}
+
+bool SCOPE_apply(const SCOPE_Select *select) {
+#if FOC_RUN_ON_CLA
+    if (select->count && capture.state != CAPTURE_IDLE) {
+        return false; // The capture has the frame buffer until it's disarmed or streamed
+    }
+    return SCOPE_select(&scope, select->ids, select->count, select->decimation);
+#else
+    (void)select;
+    return false;
+#endif
+}
+
+bool CAPTURE_apply(const CAPTURE_Arm *arm) {
+#if FOC_RUN_ON_CLA
+    if (capture.state == CAPTURE_FROZEN && arm->count) {
+        return false; // Still waiting for CPU2 to take the last one
+    }
+    if (!CAPTURE_arm(&capture, arm)) {
+        return false;
+    }
+    if (arm->count) {
+        SCOPE_select(&scope, 0, 0, 1); // Stops the scope. Its partial frame is dropped.
+    }
+    captureState = capture.state;
+    return true;
+#else
+    (void)arm;
+    return false;
+#endif
+}
+
+void CAPTURE_trigger() {
+    CAPTURE_force(&capture);
+}
+
+/* CLA Task 1 raises its end of task interrupt after every sample, so every record is one sample. That
+ * ISR doesn't nest, and neither does ipcReceiveISR(), which changes the selection and takes frame
+ * releases, so neither sees the other half done. */
+HOT_FUNC void SCOPE_recordSample() {
+    uint32_t start = (uint32_t)IPC_getCounter(IPC_CPU1_L_CPU2_R);
+    scopeSampleInterval = start - lastSample;
+    lastSample = start;
+
+    uint16_t *frame = LINK_frameBuffer();
+    uint32_t sample_count = FOC_TELEMETRY.sample_count;
+    uint16_t words = SCOPE_sample(&scope, frame, sample_count);
+    if (words && !LINK_publishFrame(words)) {
+        scopeFramesDropped++; // CPU2 still has the other buffer: this one is refilled
+    }
+    words = CAPTURE_sample(&capture, frame, sample_count);
+    if (words && LINK_publishFrame(words)) {
+        CAPTURE_taken(&capture); // Otherwise it's offered again next sample, once CPU2 frees a buffer
+    }
+    captureState = capture.state;
+    scopeCycles = (uint32_t)IPC_getCounter(IPC_CPU1_L_CPU2_R) - start;
+}
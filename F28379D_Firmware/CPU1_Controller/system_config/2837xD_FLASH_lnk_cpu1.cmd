@@ -8,11 +8,11 @@ PAGE 0 :  /* Program Memory */
    BEGIN           	: origin = 0x080000, length = 0x000002
    RAMM0           	: origin = 0x000123, length = 0x0002DD
    RAMD0           	: origin = 0x00B000, length = 0x000800
-   RAMLS0          	: origin = 0x008000, length = 0x000800
-   RAMLS1          	: origin = 0x008800, length = 0x000800
-   RAMLS2      		: origin = 0x009000, length = 0x000800
+   RAMLS0          	: origin = 0x008000, length = 0x000800     /* Hot code (.TI.ramfunc) budget */
+   RAMLS1          	: origin = 0x008800, length = 0x000800     /* CLA data RAM */
+   RAMLS2      		: origin = 0x009000, length = 0x000800     /* Hot constants (ramconsts) budget */
    RAMLS3      		: origin = 0x009800, length = 0x000800
-   RAMLS4      		: origin = 0x00A000, length = 0x000800
+   RAMLS4      		: origin = 0x00A000, length = 0x000800     /* CLA program RAM */
    RAMGS14          : origin = 0x01A000, length = 0x001000     /* Only Available on F28379D, F28377D, F28375D devices. Remove line on other devices. */
    RAMGS15          : origin = 0x01B000, length = 0x000FF8     /* Only Available on F28379D, F28377D, F28375D devices. Remove line on other devices. */
 
@@ -46,6 +46,9 @@ PAGE 1 : /* Data Memory */
 //   RAMM1_RSVD      : origin = 0x0007F8, length = 0x000008     /* Reserve and do not use for code as per the errata advisory "Memory: Prefetching Beyond Valid Memory" */
    RAMD1           : origin = 0x00B800, length = 0x000800
 
+   CLA1_MSGRAMLOW  : origin = 0x001480, length = 0x000080     /* CLA1 to CPU message RAM */
+   CLA1_MSGRAMHIGH : origin = 0x001500, length = 0x000080     /* CPU to CLA1 message RAM */
+
    RAMLS5      : origin = 0x00A800, length = 0x000800
 
    RAMGS0      : origin = 0x00C000, length = 0x001000
@@ -88,8 +91,9 @@ SECTIONS
    .bss                : > RAMLS5,       PAGE = 1
    .bss:output         : > RAMLS3,       PAGE = 0
    .bss:cio            : > RAMLS5,       PAGE = 1
+   .bss:peripherals    : > RAMLS5,       PAGE = 1   /* Driver objects (static_instance.h) */
    .data               : > RAMLS5,       PAGE = 1
-   .sysmem             : > RAMLS5,       PAGE = 1
+   .sysmem             : > RAMLS5,       PAGE = 1   /* Heap. Size zero (--heap_size=0): nothing uses malloc or new. */
    /* Initalized sections go in Flash */
    .const              : > FLASHF,       PAGE = 0,       ALIGN(8)
 #else
@@ -109,6 +113,11 @@ SECTIONS
    ramgs0           : > RAMGS0,     PAGE = 1
    ramgs1           : > RAMGS1,     PAGE = 1
 
+   /* Frame buffers handed to CPU2 (F28379D_Firmware/common/frame_service.h). One GSx block each, since
+    * the master select is per block. */
+   frame_buffer0    : > RAMGS12,    PAGE = 1
+   frame_buffer1    : > RAMGS13,    PAGE = 1
+
 #ifdef __TI_COMPILER_VERSION__
     #if __TI_COMPILER_VERSION__ >= 15009000
         #if defined(__TI_EABI__)
@@ -146,7 +155,39 @@ SECTIONS
 
 #endif
 
+   /* Constants read by the hot path (HOT_CONST in hot_path.h), copied from flash by InitRam().
+    * The hot code (.TI.ramfunc, including its :isr and :kernels subsections) must fit RAMLS0 and these
+    * RAMLS2, so the link fails if either hot set outgrows its block. */
+   ramconsts        : LOAD = FLASHD,
+                      RUN = RAMLS2,
+                      LOAD_START(RamconstsLoadStart),
+                      LOAD_SIZE(RamconstsLoadSize),
+                      RUN_START(RamconstsRunStart),
+                      PAGE = 0, ALIGN(8)
+
+   /* CLA program, copied from flash to CLA program RAM by ConfigCla() */
+   Cla1Prog         : LOAD = FLASHD,
+                      RUN = RAMLS4,
+                      LOAD_START(Cla1ProgLoadStart),
+                      LOAD_SIZE(Cla1ProgLoadSize),
+                      RUN_START(Cla1ProgRunStart),
+                      PAGE = 0, ALIGN(4)
+
+   /* CLA message RAMs and data. The CLA data sections must be in CLA data RAM. */
+   CpuToCla1MsgRAM  : > CLA1_MSGRAMHIGH,   PAGE = 1
+   Cla1ToCpuMsgRAM  : > CLA1_MSGRAMLOW,    PAGE = 1
+   .scratchpad      : > RAMLS1,            PAGE = 0
+   .bss_cla         : > RAMLS1,            PAGE = 0
+   .const_cla       : LOAD = FLASHB,
+                      RUN = RAMLS1,
+                      LOAD_START(Cla1ConstLoadStart),
+                      LOAD_SIZE(Cla1ConstLoadSize),
+                      RUN_START(Cla1ConstRunStart),
+                      PAGE = 0, ALIGN(4)
+
    /* The following section definitions are required when using the IPC API Drivers */
+   /* PUTBUFFER holds this core's outbox of the message channel and GETBUFFER the other core's
+    * (F28379D_Firmware/common/ipc_channel.h) */
     GROUP : > CPU1TOCPU2RAM, PAGE = 1
     {
         PUTBUFFER
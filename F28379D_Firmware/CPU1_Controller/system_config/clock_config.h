@@ -0,0 +1,41 @@
+/*
+ * clock_config.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Clock scaling factors and the resulting clock frequencies. Split out of system_config.h so code
+ *  which is also built on a host PC (see hal.h) can use PLLSYSCLK without the device headers.
+ */
+
+#ifndef CLOCK_CONFIG_H_
+#define CLOCK_CONFIG_H_
+
+#define USE_PLL 1 // 0 = Not using PLL clock; 1 = Using PLL clock
+
+// Clock scaling factors
+#if USE_PLL == 1 // See Section 3.7.6: Clock Source and PLL Setup in the TRM
+#define PLL_IMULT 5 // Integer multiplier between 0 and 127 inclusive
+#define PLL_FMULT 0 // Fractional multiplier between 0 and 3 inclusive (actual multiplier is 0.25*PLL_FMULT)
+#endif
+#define SYSCLKDIV 2 // System clock divider of /2
+#define LSPCLKDIVIDER 2
+
+/* Clock frequencies: With the internal 10MHz oscillator and the above clock scaling factors:
+ * OSCCLK = 10MHz
+ * PLLRAWCLK = 10MHz * 5 = 50MHz
+ * PLLSYSCLK = 50MHz / 2 = 25MHz
+ * LSPCLK = 25MHz / 2 = 12.5MHz
+ *
+ * Note that PLLRAWCLK is restricted to be below 120MHz as per the datasheet (pg 88)
+ */
+#define OSCCLK_FREQ_HZ 10000000UL // Oscillator frequency (Hz) for OSCCLK source chosen
+#if USE_PLL == 1
+#define PLLRAWCLK ((OSCCLK_FREQ_HZ * (PLL_IMULT + (float)0.25*PLL_FMULT)))  // Raw PLL clock frequency (Hz)
+#define PLLSYSCLK (PLLRAWCLK / SYSCLKDIV) // SYSCLK (PLLSYSCLK) frequency (Hz)
+#else
+#define PLLSYSCLK (OSCCLK_FREQ_HZ / SYSCLKDIV) // SYSCLK (PLLSYSCLK) frequency (Hz)
+#endif
+#define LSPCLK (PLLSYSCLK / LSPCLKDIVIDER)
+
+#endif /* CLOCK_CONFIG_H_ */
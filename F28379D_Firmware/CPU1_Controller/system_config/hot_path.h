@@ -0,0 +1,35 @@
+/*
+ * hot_path.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Places time-critical code and data in zero-wait-state RAM. Nothing sets up the flash wait states, so
+ *  flash runs at the reset default (the maximum), and even when tuned the prefetch buffer only helps
+ *  straight-line code. ISRs and the kernels they call run faster and with less jitter from RAM.
+ *  - HOT_ISR: interrupt service routines (.TI.ramfunc:isr)
+ *  - HOT_FUNC: control kernels called from ISRs (.TI.ramfunc:kernels)
+ *  - HOT_CONST: tables and constants read by them (ramconsts)
+ *
+ *  The sections are loaded to flash and copied to RAM by InitRam(). .TI.ramfunc runs from RAMLS0 and ramconsts
+ *  from RAMLS2. Each block is the budget for its hot set: the link fails if the set no longer fits.
+ *
+ *  Put the macro before the declaration: HOT_ISR interrupt void myISR() {...}
+ *  Tables made by TableGen use "section": "ramconsts" in their spec instead.
+ *  On the host (HostSim) the macros are empty.
+ */
+
+#ifndef HOT_PATH_H_
+#define HOT_PATH_H_
+
+#if defined(__TI_COMPILER_VERSION__)
+#define HOT_ISR __attribute__((section(".TI.ramfunc:isr")))
+#define HOT_FUNC __attribute__((section(".TI.ramfunc:kernels")))
+#define HOT_CONST __attribute__((section("ramconsts")))
+#else
+#define HOT_ISR
+#define HOT_FUNC
+#define HOT_CONST
+#endif
+
+#endif /* HOT_PATH_H_ */
@@ -8,10 +8,12 @@
  */
 
 #include <system_config.h>
+#include "boot_sync.h"
 
 /* Initializes the system
  *
  * - Disables the watchdog timer
+ * - Gives CPU2 its peripherals and RAM and releases it, so it initialises while CPU1 carries on
  * - Configures the system clocks
  * - Initializes the RAM
  * - Configures the sleep mode
@@ -23,7 +25,10 @@ void ConfigSystem() {
     WdRegs.WDCR.bit.WDDIS = 1; // Disable watchdog timer by setting WDDIS. (manual p.501)
     EDIS;
 
+    AssignCpu2Resources();
+    BOOT_releaseCpu2(); // CPU2 boots during the PLL lock and RAM copies below (boot_sync.h)
     ConfigPllSysClock();
+    bootReport.pll_locked = BOOT_stamp();
     SysCtl_setLowSpeedClock(SYSCTL_LSPCLK_PRESCALE_2);
     InitRam();
     ConfigSleepMode();
@@ -79,6 +84,30 @@ void ConfigPllSysClock() {
 
 void InitRam() {
     memcpy((uint32_t *)&RamfuncsRunStart, (uint32_t *)&RamfuncsLoadStart, (uint32_t)&RamfuncsLoadSize);
+    memcpy((uint32_t *)&RamconstsRunStart, (uint32_t *)&RamconstsLoadStart, (uint32_t)&RamconstsLoadSize);
+}
+
+/* Gives CPU2, the communications processor, what it owns: SCI-A and CAN-B with their pins, and GS14 and GS15
+ * for its buffers. Only CPU1 can write the ownership registers and the pin muxes, so this runs before CPU2
+ * is released. CPU1 never touches these again, so the control ISRs can't wait on a comms FIFO. */
+void AssignCpu2Resources() {
+    SysCtl_selectCPUForPeripheralInstance(SYSCTL_CPUSEL_SCIA, SYSCTL_CPUSEL_CPU2);
+    SysCtl_selectCPUForPeripheralInstance(SYSCTL_CPUSEL_CANB, SYSCTL_CPUSEL_CPU2);
+
+    GPIO_setPinConfig(GPIO_28_SCIRXDA);
+    GPIO_setPinConfig(GPIO_29_SCITXDA);
+    GPIO_setPinConfig(GPIO_12_CANTXB);
+    GPIO_setPinConfig(GPIO_17_CANRXB);
+    GPIO_setPadConfig(28, GPIO_PIN_TYPE_PULLUP); // RX idles high if nothing is connected
+    GPIO_setPadConfig(17, GPIO_PIN_TYPE_PULLUP);
+    GPIO_setQualificationMode(28, GPIO_QUAL_ASYNC);
+    GPIO_setQualificationMode(17, GPIO_QUAL_ASYNC);
+    GPIO_setControllerCore(28, GPIO_CORE_CPU2);
+    GPIO_setControllerCore(29, GPIO_CORE_CPU2);
+    GPIO_setControllerCore(12, GPIO_CORE_CPU2);
+    GPIO_setControllerCore(17, GPIO_CORE_CPU2);
+
+    MemCfg_setGSRAMControllerSel(MEMCFG_SECT_GS14 | MEMCFG_SECT_GS15, MEMCFG_GSRAMCONTROLLER_CPU2);
 }
 
 /* Enables the PIE and global interrupts */
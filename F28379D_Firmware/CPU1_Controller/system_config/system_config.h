@@ -15,40 +15,17 @@
 #include <F2837xD_device.h> // Includes all files in f2837xD_includes
 #include <driverlib.h>
 
-#define USE_PLL 1 // 0 = Not using PLL clock; 1 = Using PLL clock
+#include "clock_config.h" // Clock frequencies, without the device headers so portable code can use them
 
 /* MACROS */
 #define DELAY_SIXTY_CYCLES asm(" RPT #60 || NOP")
 
-// Clock scaling factors
-#if USE_PLL == 1 // See Section 3.7.6: Clock Source and PLL Setup in the TRM
-#define PLL_IMULT 5 // Integer multiplier between 0 and 127 inclusive
-#define PLL_FMULT 0 // Fractional multiplier between 0 and 3 inclusive (actual multiplier is 0.25*PLL_FMULT)
-#endif
-#define SYSCLKDIV 2 // System clock divider of /2
-#define LSPCLKDIVIDER 2
-
-/* Clock frequencies: With the internal 10MHz oscillator and the above clock scaling factors:
- * OSCCLK = 10MHz
- * PLLRAWCLK = 10MHz * 5 = 50MHz
- * PLLSYSCLK = 50MHz / 2 = 25MHz
- * LSPCLK = 25MHz / 2 = 12.5MHz
- *
- * Note that PLLRAWCLK is restricted to be below 120MHz as per the datasheet (pg 88)
- */
-#define OSCCLK_FREQ_HZ 10000000UL // Oscillator frequency (Hz) for OSCCLK source chosen
-#if USE_PLL == 1
-#define PLLRAWCLK ((OSCCLK_FREQ_HZ * (PLL_IMULT + (float)0.25*PLL_FMULT)))  // Raw PLL clock frequency (Hz)
-#define PLLSYSCLK (PLLRAWCLK / SYSCLKDIV) // SYSCLK (PLLSYSCLK) frequency (Hz)
-#else
-#define PLLSYSCLK (OSCCLK_FREQ_HZ / SYSCLKDIV) // SYSCLK (PLLSYSCLK) frequency (Hz)
-#endif
-#define LSPCLK (PLLSYSCLK / LSPCLKDIVIDER)
 
 /* Functions */
 void ConfigSystem();
 void ConfigPllSysClock(); // Configures the PLL clock for SYSCLK = 60MHz operation
-void InitRam(); // Copies functions from FLASH to RAM
+void InitRam(); // Copies functions and hot constants (hot_path.h) from FLASH to RAM
+void AssignCpu2Resources(); // SCI-A, CAN-B, their pins and GS14/GS15 to CPU2
 void EnableInterrupts(); // Initializes the interrupts and PIE
 void ConfigSleepMode();
 
@@ -68,4 +45,17 @@ extern Uint16 RamfuncsRunStart; // Start address of RAM functions in RAM
 extern Uint16 RamfuncsRunEnd; // Start address of RAM functions in run location (RAM)
 extern Uint16 RamfuncsRunSize; // Size of memory allocated to RAM functions in RAM
 
+/* For constants read from RAM (HOT_CONST in hot_path.h) */
+extern Uint16 RamconstsLoadStart; // Start address of the constants in flash
+extern Uint16 RamconstsLoadSize; // Size of the constants
+extern Uint16 RamconstsRunStart; // Start address of the constants in RAM
+
+/* For the CLA program and constants (see cla_control.h) */
+extern Uint16 Cla1ProgLoadStart; // Start address of the CLA program in flash
+extern Uint16 Cla1ProgLoadSize; // Size of the CLA program
+extern Uint16 Cla1ProgRunStart; // Start address of the CLA program in CLA program RAM
+extern Uint16 Cla1ConstLoadStart; // Start address of the CLA constants in flash
+extern Uint16 Cla1ConstLoadSize; // Size of the CLA constants
+extern Uint16 Cla1ConstRunStart; // Start address of the CLA constants in CLA data RAM
+
 #endif /* INIT_H_ */
@@ -49,6 +49,8 @@ PAGE 1 :
    RAMGS0          : origin = 0x00C000, length = 0x001000
    RAMGS1          : origin = 0x00D000, length = 0x001000
    RAMGS2          : origin = 0x00E000, length = 0x001000
+   RAMGS12         : origin = 0x018000, length = 0x001000     /* CPU1's frame buffers */
+   RAMGS13         : origin = 0x019000, length = 0x001000
    CPU2TOCPU1RAM   : origin = 0x03F800, length = 0x000400
    CPU1TOCPU2RAM   : origin = 0x03FC00, length = 0x000400
 }
@@ -85,6 +87,11 @@ SECTIONS
    .econst             : >> FLASHF       PAGE = 0, ALIGN(8)
 #endif
 
+   comms_buffers    : > RAMGS14,     PAGE = 0    /* GS14 and GS15 are given to CPU2 by CPU1's AssignCpu2Resources() */
+   /* CPU1 places the frame buffers (F28379D_Firmware/common/frame_service.h) and hands them over */
+   frame_buffer0    : > RAMGS12,     PAGE = 1, TYPE = DSECT
+   frame_buffer1    : > RAMGS13,     PAGE = 1, TYPE = DSECT
+
    SHARERAMGS0		: > RAMGS0,		PAGE = 1
    SHARERAMGS1		: > RAMGS1,		PAGE = 1
    SHARERAMGS2		: > RAMGS2,		PAGE = 1
@@ -126,6 +133,8 @@ SECTIONS
 #endif
 
    /* The following section definitions are required when using the IPC API Drivers */
+   /* PUTBUFFER holds this core's outbox of the message channel and GETBUFFER the other core's
+    * (F28379D_Firmware/common/ipc_channel.h) */
     GROUP : > CPU2TOCPU1RAM, PAGE = 1
     {
         PUTBUFFER
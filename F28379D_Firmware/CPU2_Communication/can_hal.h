@@ -0,0 +1,48 @@
+/*
+ * can_hal.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Thin hardware abstraction for the CAN port, so can_port.c also builds with gcc on a host PC and runs in
+ *  the HostSim bench "can" as it is. As in ThreePhaseGen/hal.h, the backend is chosen at compile time:
+ *  - can_hal_registers.h: driverlib calls and interface register transfers. The default.
+ *  - HostSim/include/hal_sim.h: the simulated DCAN and bus (can_sim.h). Selected by defining HAL_SIMULATED,
+ *    which only the host build does.
+ *
+ *  Each function is one driverlib call sequence or one IF2 transfer. What's made of the results (the frame,
+ *  its DLC, MsgLst and the TxRqst bits) is up to can_port.c.
+ *
+ *  The constants are the register field encodings from the TRM (the same values as driverlib's).
+ */
+
+#ifndef CAN_HAL_H_
+#define CAN_HAL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Base addresses, the same for the real and simulated modules
+#define HAL_CANA_BASE 0x00048000U
+#define HAL_CANB_BASE 0x0004A000U
+
+// CAN_INT.INT0ID other than a message object
+#define HAL_CAN_INT0ID_STATUS 0x8000U
+
+// CAN_ES
+#define HAL_CAN_STATUS_EPASS 0x0020U
+#define HAL_CAN_STATUS_BUS_OFF 0x0080U
+
+// CAN_IFxMCTL
+#define HAL_CAN_MCTL_DLC_M 0x000FU
+#define HAL_CAN_MCTL_INTPND 0x2000U
+#define HAL_CAN_MCTL_MSGLST 0x4000U
+#define HAL_CAN_MCTL_NEWDAT 0x8000U
+
+#if defined(HAL_SIMULATED)
+#include "hal_sim.h"
+#else
+#include "can_hal_registers.h"
+#endif
+
+#endif /* CAN_HAL_H_ */
@@ -0,0 +1,100 @@
+/*
+ * can_hal_registers.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Register backend of the CAN HAL (see can_hal.h). The calls and register accesses can_port.c used to make
+ *  itself, so the target build is unchanged.
+ */
+
+#ifndef CAN_HAL_REGISTERS_H_
+#define CAN_HAL_REGISTERS_H_
+
+#include <driverlib.h>
+
+#define HAL_CAN_IF2_BUSY(base) ((HWREGH((base) + CAN_O_IF2CMD) & CAN_IF2CMD_BUSY) == CAN_IF2CMD_BUSY)
+
+/* Clocks the module from SYSCLK at bit_rate, with bit_time quanta a bit */
+static inline void HAL_initCan(uint32_t base, uint32_t sysclk, uint32_t bit_rate, uint16_t bit_time) {
+    SysCtl_enablePeripheral(base == CANA_BASE ? SYSCTL_PERIPH_CLK_CANA : SYSCTL_PERIPH_CLK_CANB);
+    CAN_initModule(base);
+    CAN_selectClockSource(base, CAN_CLOCK_SOURCE_SYS);
+    CAN_setBitRate(base, sysclk, bit_rate, bit_time);
+}
+
+/* Internal loopback (CAN_TEST_LBACK): the module receives its own frames and ignores the bus */
+static inline void HAL_enableCanLoopback(uint32_t base) {
+    CAN_enableTestMode(base, CAN_TEST_LBACK);
+}
+
+/* A receive object for standard identifiers with ((id ^ object id) & mask) == 0, interrupting on INT0 */
+static inline void HAL_setupCanRxObject(uint32_t base, uint16_t object, uint32_t id, uint32_t mask) {
+    CAN_setupMessageObject(base, object, id, CAN_MSG_FRAME_STD, CAN_MSG_OBJ_TYPE_RX, mask,
+                           CAN_MSG_OBJ_RX_INT_ENABLE | CAN_MSG_OBJ_USE_ID_FILTER, 0);
+}
+
+/* A transmit object for a standard identifier. No interrupt: its TxRqst bit says if the frame has gone. */
+static inline void HAL_setupCanTxObject(uint32_t base, uint16_t object, uint32_t id, uint16_t bytes) {
+    CAN_setupMessageObject(base, object, id, CAN_MSG_FRAME_STD, CAN_MSG_OBJ_TYPE_TX, 0, CAN_MSG_OBJ_NO_FLAGS, bytes);
+}
+
+/* Automatic bus on after 1 ms, INT0 on message objects and error state changes to handler, and joins the bus */
+static inline void HAL_startCan(uint32_t base, uint32_t sysclk, void (*handler)(void)) {
+    uint32_t interrupt = base == CANA_BASE ? INT_CANA0 : INT_CANB0;
+    CAN_enableAutoBusOn(base); // Rejoins after a bus off without the CPU
+    CAN_setAutoBusOnTime(base, sysclk/1000U);
+    CAN_enableInterrupt(base, CAN_INT_IE0 | CAN_INT_ERROR); // Not CAN_INT_STATUS: one per frame
+    CAN_enableGlobalInterrupt(base, CAN_GLOBAL_INT_CANINT0);
+    Interrupt_register(interrupt, handler);
+    Interrupt_enable(interrupt);
+    CAN_startModule(base);
+}
+
+/* INT0ID: the lowest numbered object with an interrupt pending, HAL_CAN_INT0ID_STATUS or 0 */
+static inline uint16_t HAL_getCanInterruptCause(uint32_t base) {
+    return (uint16_t)(CAN_getInterruptCause(base) & CAN_INT_INT0ID_M);
+}
+
+/* CAN_ES. Reading it clears a status interrupt. */
+static inline uint16_t HAL_getCanStatus(uint32_t base) {
+    return (uint16_t)CAN_getStatus(base);
+}
+
+/* TXRQ21: a TxRqst bit per object, object 1 in bit 0 */
+static inline uint32_t HAL_getCanTxRequests(uint32_t base) {
+    return CAN_getTxRequests(base);
+}
+
+/* Loads a transmit object through IF1 and requests it */
+static inline void HAL_sendCanMessage(uint32_t base, uint16_t object, uint16_t count, const uint16_t *bytes) {
+    CAN_sendMessage(base, object, count, bytes);
+}
+
+/* Reads an object through IF2 in one transfer, which also clears its NewDat and IntPnd, and copies the data
+ * registers whole. Returns its control bits (IF2MCTL) as they were. */
+static inline uint16_t HAL_readCanObject(uint32_t base, uint16_t object, uint32_t *data) {
+    HWREG_BP(base + CAN_O_IF2CMD) = CAN_IF2CMD_DATA_A | CAN_IF2CMD_DATA_B | CAN_IF2CMD_CONTROL
+                                    | CAN_IF2CMD_CLRINTPND | CAN_IF2CMD_TXRQST | object;
+    while (HAL_CAN_IF2_BUSY(base)) {
+    }
+    data[0] = HWREG(base + CAN_O_IF2DATA);
+    data[1] = HWREG(base + CAN_O_IF2DATB);
+    return HWREGH(base + CAN_O_IF2MCTL);
+}
+
+/* Writes an object's control bits through IF2: the only way to clear MsgLst */
+static inline void HAL_writeCanObjectControl(uint32_t base, uint16_t object, uint16_t control) {
+    HWREGH(base + CAN_O_IF2MCTL) = control;
+    HWREG_BP(base + CAN_O_IF2CMD) = CAN_IF2CMD_DIR | CAN_IF2CMD_CONTROL | object;
+    while (HAL_CAN_IF2_BUSY(base)) {
+    }
+}
+
+/* At the end of the INT0 handler. Another pending object interrupts again. */
+static inline void HAL_acknowledgeCanInterrupt(uint32_t base) {
+    CAN_clearGlobalInterruptStatus(base, CAN_GLOBAL_INT_CANINT0);
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP9);
+}
+
+#endif /* CAN_HAL_REGISTERS_H_ */
@@ -0,0 +1,103 @@
+/*
+ * can_port.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ */
+
+#include "clock_config.h"
+#include "can_port.h"
+#include "isr_profile.h"
+
+CANP_Service canService;
+volatile uint16_t canBusErrors;
+
+static CANP_Mailbox mailboxes[CANP_MAILBOX_COUNT];
+
+void CANPORT_init(void) {
+    CANP_init(&canService, CAN_PORT_NODE, CAN_PORT_LATCH);
+    CANP_initMailboxes(mailboxes, CAN_PORT_NODE);
+    canBusErrors = 0;
+
+    HAL_initCan(CAN_PORT_BASE, (uint32_t)PLLSYSCLK, CAN_PORT_BITRATE, CAN_PORT_BIT_TIME);
+#if CAN_PORT_LOOPBACK
+    HAL_enableCanLoopback(CAN_PORT_BASE);
+#endif
+
+    for (uint16_t k = 0; k < CANP_MAILBOX_COUNT; k++) {
+        const CANP_Mailbox *m = &mailboxes[k];
+        if (m->direction == CANP_RX) {
+            HAL_setupCanRxObject(CAN_PORT_BASE, m->object, m->id, m->mask);
+        }
+        else {
+            HAL_setupCanTxObject(CAN_PORT_BASE, m->object, m->id, m->bytes);
+        }
+    }
+
+    HAL_startCan(CAN_PORT_BASE, (uint32_t)PLLSYSCLK, &canRxISR);
+}
+
+bool CANPORT_startPeriod(CANP_Setpoint *setpoint, uint16_t *due) {
+    return CANP_startPeriod(&canService, setpoint, due);
+}
+
+void CANPORT_sendStatus(uint16_t due, const CANP_Status *status) {
+    uint16_t bytes[CANP_FRAME_BYTES];
+    uint32_t waiting = due ? HAL_getCanTxRequests(CAN_PORT_BASE) : 0; // A bit per object, 1 to 32
+    for (uint16_t k = 0; k < CANP_STATUS_FRAMES; k++) {
+        if (due & (1U << k)) {
+            CANP_encodeStatus(&canService, k, status, (waiting >> (CANP_OBJECT_STATUS + k - 1U)) & 1U, bytes);
+            HAL_sendCanMessage(CAN_PORT_BASE, CANP_OBJECT_STATUS + k, CANP_FRAME_BYTES, bytes); // Through IF1
+        }
+    }
+}
+
+#if CAN_PORT_LOOPBACK
+void CANPORT_inject(uint32_t id, const uint16_t *bytes, uint16_t count) {
+    HAL_setupCanTxObject(CAN_PORT_BASE, CANP_OBJECT_TEST, id, count);
+    HAL_sendCanMessage(CAN_PORT_BASE, CANP_OBJECT_TEST, count, bytes);
+}
+#endif
+
+/* Reads a receive object through IF2 in one transfer, which also clears its NewDat and IntPnd, and copies
+ * the data registers whole. MsgLst is only cleared by writing the control bits back. */
+static void readObject(uint16_t object, CANP_Frame *frame) {
+    uint16_t control = HAL_readCanObject(CAN_PORT_BASE, object, frame->data);
+    uint16_t count = control & HAL_CAN_MCTL_DLC_M;
+    frame->object = object;
+    frame->count = count > CANP_FRAME_BYTES ? CANP_FRAME_BYTES : count; // DLC 9 to 15 mean 8
+
+    frame->lost = (control & HAL_CAN_MCTL_MSGLST) != 0;
+    if (frame->lost) {
+        HAL_writeCanObjectControl(CAN_PORT_BASE, object,
+                                  control & ~(HAL_CAN_MCTL_MSGLST | HAL_CAN_MCTL_NEWDAT | HAL_CAN_MCTL_INTPND));
+    }
+}
+
+ISR_PROFILE(canRxISR);
+
+/* CAN INT0: one received frame into the ring, for the next control period, or an error. Another pending
+ * object interrupts again after the acknowledge. */
+interrupt void canRxISR(void) {
+    ISR_PROFILE_BEGIN();
+    uint16_t cause = HAL_getCanInterruptCause(CAN_PORT_BASE);
+    if (cause == HAL_CAN_INT0ID_STATUS) {
+        if (HAL_getCanStatus(CAN_PORT_BASE) & (HAL_CAN_STATUS_BUS_OFF | HAL_CAN_STATUS_EPASS)) { // Reading it clears the interrupt
+            canBusErrors++;
+        }
+    }
+    else if (cause >= 1U && cause <= 32U) {
+        CANP_Frame *frame = CANP_rxSlot(&canService);
+        if (frame) {
+            readObject(cause, frame);
+            CANP_rxPublish(&canService);
+        }
+        else {
+            CANP_Frame dropped;
+            readObject(cause, &dropped); // Still read, which clears its interrupt
+        }
+    }
+
+    HAL_acknowledgeCanInterrupt(CAN_PORT_BASE);
+    ISR_PROFILE_END(canRxISR);
+}
@@ -0,0 +1,77 @@
+/*
+ * can_port.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  CAN-B on CPU2 (GPIO12 TX, GPIO17 RX) at 1 Mbit/s: setpoints from the bus master and cyclic status frames
+ *  (common/can_protocol.h), for drives that are commanded over CAN rather than the serial link.
+ *
+ *  The message objects are set up once from the mailbox table. Received frames interrupt on CAN INT0
+ *  (canRxISR), one message object per interrupt, read through IF2 into the service's ring for the next
+ *  control period to decode. Status frames are loaded through IF1 by the motion control period
+ *  (CANPORT_startPeriod() and CANPORT_sendStatus()), which reads their objects' TxRqst bits to tell
+ *  whether the last ones went out, so sending takes no interrupt. IF1 is only used by the motion ISR and
+ *  IF2 only by the receive interrupt, so it can come in the middle of a load.
+ *
+ *  The CAN interrupt is in PIE group 9 with the SCI, so it nests in CPU2's long ISRs too
+ *  (COMMS_ALLOW_SCI_INTERRUPTS() in comms.h): frames are taken off the bus within microseconds, so a SYNC
+ *  and a setpoint either side of it go into the ring in the order they were sent.
+ *
+ *  CAN_PORT_LOOPBACK 1 builds the DCAN's internal loopback: nothing goes on the bus, the node receives its
+ *  own frames through its acceptance filters, and CANPORT_inject() sends it any frame, e.g. a SYNC, to check
+ *  the receive path on a board by itself.
+ *
+ *  The registers are behind can_hal.h, so this file also runs on a host PC against a simulated DCAN and bus
+ *  (HostSim bench "can").
+ *
+ *  CPU1 gives CPU2 CAN-B and the pins in AssignCpu2Resources() before CPU2 runs.
+ */
+
+#ifndef CAN_PORT_H_
+#define CAN_PORT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "can_protocol.h"
+#include "can_hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CAN_PORT_BASE HAL_CANB_BASE
+#define CAN_PORT_BITRATE 1000000U
+#define CAN_PORT_BIT_TIME 25 // Time quanta per bit: SYSCLK/25 = 1 Mbit/s with a prescaler of 1
+#define CAN_PORT_NODE 1
+#define CAN_PORT_LATCH CANP_LATCH_ON_SYNC
+#ifndef CAN_PORT_LOOPBACK
+#define CAN_PORT_LOOPBACK 0
+#endif
+
+extern CANP_Service canService;
+extern volatile uint16_t canBusErrors; // Changes to error passive or bus off
+
+/* Configures CAN-B, its message objects and interrupts, and joins the bus */
+void CANPORT_init(void);
+
+/* At the start of every motion control period: a new setpoint to apply from this period, and the status
+ * frames due at its end (CANP_startPeriod()) */
+bool CANPORT_startPeriod(CANP_Setpoint *setpoint, uint16_t *due);
+
+/* At the end of the motion control period: loads the due status frames into their objects */
+void CANPORT_sendStatus(uint16_t due, const CANP_Status *status);
+
+#if CAN_PORT_LOOPBACK
+/* Sends a frame with any identifier through the test object, for the node to receive itself. Uses IF1, so
+ * not while the motion ISR could be interrupted in CANPORT_sendStatus(). */
+void CANPORT_inject(uint32_t id, const uint16_t *bytes, uint16_t count);
+#endif
+
+interrupt void canRxISR(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAN_PORT_H_ */
@@ -0,0 +1,92 @@
+/*
+ * commands.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ */
+
+#include <driverlib.h>
+#include "clock_config.h"
+#include "ipc_channel.h"
+#include "sci_port.h"
+#include "comms.h"
+#include "motion_task.h"
+#include "can_port.h"
+#include "commands.h"
+
+CMD_RxRing commandRing;
+SFRAME_Decoder commandDecoder;
+CMD_Service commandService;
+
+#define COMMAND_TABLE_ENTRY(name, variable, type, access, min, max) {&(variable), type, access, min, max},
+static const CMD_Parameter parameters[COMMAND_PARAMETER_COUNT] = {
+    COMMAND_PARAMETERS(COMMAND_TABLE_ENTRY)
+};
+
+/* Sends a command's payload to CPU1 as a message of this type */
+static uint16_t passToCpu1(uint16_t message_type, const SFRAME_Decoder *frame) {
+    uint16_t words[COMMS_MAX_FRAME_WORDS];
+    if (SFRAME_payloadBytes(frame) > 2U*COMMS_MAX_FRAME_WORDS) {
+        return CMD_BAD_LENGTH;
+    }
+    uint16_t count = SFRAME_payloadWords(frame, words, COMMS_MAX_FRAME_WORDS);
+    return CHAN_sendAndNotify(message_type, words, count) ? CMD_OK : CMD_BUSY;
+}
+
+static uint16_t handleCommand(uint16_t type, const SFRAME_Decoder *frame, CMD_Reply *reply) {
+    (void)reply;
+    switch (type) {
+        case CMD_MODE: {
+            if (!CMD_hasWords(frame, CHAN_WORDS(CMD_Mode))) {
+                return CMD_BAD_LENGTH;
+            }
+            uint16_t mode = CMD_word(frame, 0);
+            float target = CMD_toFloat(CMD_long(frame, 2));
+            if (mode > MOTION_MODE_POSITION || !(target >= -1e6f && target <= 1e6f)) {
+                return CMD_OUT_OF_RANGE;
+            }
+            motionCommandMode = mode; // Taken together by the next motion period
+            motionCommandTarget = target;
+            return CMD_OK;
+        }
+        case CMD_SCOPE_SELECT:
+            return passToCpu1(CHAN_MSG_SCOPE_SELECT, frame);
+        case CMD_CAPTURE_ARM:
+            return passToCpu1(CHAN_MSG_CAPTURE_ARM, frame);
+        case CMD_CAPTURE_TRIGGER:
+            return CMD_hasWords(frame, 0) ? passToCpu1(CHAN_MSG_CAPTURE_TRIGGER, frame) : CMD_BAD_LENGTH;
+        case CMD_CURRENT_GAINS:
+            return CMD_hasWords(frame, CHAN_WORDS(FOC_CurrentGains)) ? passToCpu1(CHAN_MSG_CURRENT_GAINS, frame)
+                                                                     : CMD_BAD_LENGTH;
+        case CMD_FORWARD: {
+            // One byte per word, as CPU1's command handler takes them
+            uint16_t count = SFRAME_payloadBytes(frame);
+            if (count > COMMS_MAX_FRAME_WORDS) {
+                return CMD_BAD_LENGTH;
+            }
+            return CHAN_sendAndNotify(CHAN_MSG_COMMAND, frame->raw + SFRAME_HEADER_BYTES, count) ? CMD_OK : CMD_BUSY;
+        }
+        default:
+            return CMD_UNKNOWN;
+    }
+}
+
+void COMMANDS_init(void) {
+    CMD_initRing(&commandRing);
+    SFRAME_initDecoder(&commandDecoder);
+    CMD_initService(&commandService, parameters, COMMAND_PARAMETER_COUNT, handleCommand);
+}
+
+void COMMANDS_receive(const uint16_t *bytes, uint16_t count) {
+    CMD_putBytes(&commandRing, bytes, count);
+}
+
+void COMMANDS_poll(void) {
+    uint16_t budget = COMMANDS_BYTES_PER_POLL;
+    if (!CMD_nextFrame(&commandRing, &commandDecoder, &budget)) {
+        return;
+    }
+    CMD_Reply reply;
+    CMD_execute(&commandService, &commandDecoder, &reply);
+    COMMS_sendFrame(CMD_REPLY, (const uint16_t *)&reply, CHAN_WORDS(reply));
+}
@@ -0,0 +1,84 @@
+/*
+ * commands.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Commands from the host (common/command_protocol.h) on CPU2: parameter reads and writes, mode changes,
+ *  and the live scope and triggered capture on CPU1.
+ *
+ *  The SCI receive interrupt puts bytes into the command ring. The comms poll timer decodes up to
+ *  COMMANDS_BYTES_PER_POLL of them and executes at most one command per period, so a flood from the host
+ *  costs no more than one command: the rest waits in the ring, and what doesn't fit is lost and counted.
+ *  The timer lets the SCI interrupts nest while it does, which the ring allows (one writer each side).
+ *
+ *  Parameters are written by the poll timer, which doesn't nest with the motion control timer, so the
+ *  motion control sees each change between two of its periods. Mode and target change together
+ *  (CMD_MODE), as MOTION_setMode() takes them.
+ *
+ *  - CMD_SCOPE_SELECT, CMD_CAPTURE_ARM and CMD_CURRENT_GAINS are passed to CPU1 as they are, which checks
+ *    them: a refusal shows in CPU1's linkDropped, in capture_state on the scope, and in the gains version
+ *    in the telemetry.
+ *  - CMD_FORWARD's bytes go to CPU1 as a CHAN_MSG_COMMAND, one per word, for LINK_setCommandHandler().
+ */
+
+#ifndef COMMANDS_H_
+#define COMMANDS_H_
+
+#include <stdint.h>
+#include "command_protocol.h"
+
+#define COMMANDS_BYTES_PER_POLL 16 // 16 kB/s of commands, 20% of the line at full baud
+
+/* The parameters, as X(name, variable, type, access, min, max). The host tools expand the same list into
+ * names (HostSim serial_command and serial_decode). Parameters are numbered in order, so add new ones at
+ * the end. Counters take a write of 0, to clear them. */
+#define COMMAND_PARAMETERS(X) \
+    X(mode,              motionCommandMode,              CMD_UINT16,  CMD_RO, 0.0f, 0.0f) \
+    X(target,            motionCommandTarget,            CMD_FLOAT32, CMD_RO, 0.0f, 0.0f) \
+    X(position_kp,       motion.position_kp,             CMD_FLOAT32, CMD_RW, 0.0f, 1000.0f) \
+    X(speed_kp,          motion.speed_pi.Kp,             CMD_FLOAT32, CMD_RW, 0.0f, 0.1f) \
+    X(speed_ki_ts,       motion.speed_pi.Ki_Ts,          CMD_FLOAT32, CMD_RW, 0.0f, 0.1f) \
+    X(max_speed,         motion.trajectory.max_speed,    CMD_FLOAT32, CMD_RW, 0.0f, 1000.0f) \
+    X(max_accel,         motion.trajectory.max_accel,    CMD_FLOAT32, CMD_RW, 0.0f, 100000.0f) \
+    X(round_trip,        motionRoundTrip,                CMD_UINT32,  CMD_RO, 0.0f, 0.0f) \
+    X(round_trip_max,    motionRoundTripMax,             CMD_UINT32,  CMD_RW, 0.0f, 0.0f) \
+    X(missed_feedback,   motionMissedFeedback,           CMD_UINT16,  CMD_RW, 0.0f, 0.0f) \
+    X(refused,           motionRefused,                  CMD_UINT16,  CMD_RW, 0.0f, 0.0f) \
+    X(comms_dropped,     commsDropped,                   CMD_UINT16,  CMD_RW, 0.0f, 0.0f) \
+    X(sci_rx_errors,     sciRxErrors,                    CMD_UINT16,  CMD_RW, 0.0f, 0.0f) \
+    X(sci_tx_overflows,  sciTxOverflows,                 CMD_UINT16,  CMD_RW, 0.0f, 0.0f) \
+    X(command_overflows, commandRing.overflows,          CMD_UINT16,  CMD_RW, 0.0f, 0.0f) \
+    X(command_crc_errors, commandDecoder.crc_errors,     CMD_UINT32,  CMD_RW, 0.0f, 0.0f) \
+    X(command_framing_errors, commandDecoder.framing_errors, CMD_UINT32, CMD_RW, 0.0f, 0.0f) \
+    X(commands_refused,  commandService.refused,         CMD_UINT32,  CMD_RW, 0.0f, 0.0f) \
+    X(can_setpoints,     canService.received,            CMD_UINT32,  CMD_RW, 0.0f, 0.0f) \
+    X(can_refused,       canService.refused,             CMD_UINT32,  CMD_RW, 0.0f, 0.0f) \
+    X(can_overwritten,   canService.overwritten,         CMD_UINT32,  CMD_RW, 0.0f, 0.0f) \
+    X(can_lost,          canService.lost,                CMD_UINT32,  CMD_RW, 0.0f, 0.0f) \
+    X(can_overflows,     canService.overflows,           CMD_UINT32,  CMD_RW, 0.0f, 0.0f) \
+    X(can_late,          canService.late,                CMD_UINT32,  CMD_RW, 0.0f, 0.0f) \
+    X(can_bus_errors,    canBusErrors,                   CMD_UINT16,  CMD_RW, 0.0f, 0.0f)
+
+#define COMMAND_ID_ENTRY(name, variable, type, access, min, max) COMMAND_ID_##name,
+enum {
+    COMMAND_PARAMETERS(COMMAND_ID_ENTRY)
+    COMMAND_PARAMETER_COUNT
+};
+
+/* Target side (commands.c) */
+#if defined(__TI_COMPILER_VERSION__)
+extern CMD_RxRing commandRing;
+extern SFRAME_Decoder commandDecoder;
+extern CMD_Service commandService;
+
+void COMMANDS_init(void);
+
+/* Takes bytes from the SCI receive interrupt */
+void COMMANDS_receive(const uint16_t *bytes, uint16_t count);
+
+/* Decodes and executes received commands, within the limits above. From the comms poll timer. */
+void COMMANDS_poll(void);
+#endif
+
+#endif /* COMMANDS_H_ */
@@ -0,0 +1,98 @@
+/*
+ * comms.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ */
+
+#include <driverlib.h>
+#include "clock_config.h"
+#include "ipc_channel.h"
+#include "sci_port.h"
+#include "comms.h"
+#include "commands.h"
+#include "isr_profile.h"
+
+volatile uint16_t commsDropped;
+volatile uint16_t commsSequence;
+FRAME_Reader commsFrames;
+static bool frameHeaderSent;
+
+void COMMS_sendFrame(uint16_t type, const uint16_t *payload, uint16_t words) {
+    uint16_t bytes[COMMS_FRAME_BYTES(COMMS_MAX_FRAME_WORDS)];
+    uint16_t n = SFRAME_encode(bytes, type, commsSequence++ & 0xFFU, (uint32_t)IPC_getCounter(IPC_CPU2_L_CPU1_R),
+                               payload, words);
+    if (!SCIPORT_write(bytes, n)) {
+        commsDropped++;
+    }
+}
+
+/* Queues as much of the frame being streamed as the TX ring has room for, then gives its buffer back */
+static void streamFrame(void) {
+    if (!commsFrames.active) {
+        return;
+    }
+    if (!frameHeaderSent) {
+        if (SCIPORT_txFree() < COMMS_FRAME_BYTES(CHAN_WORDS(FRAME_Ready))) {
+            return;
+        }
+        COMMS_sendFrame(CHAN_MSG_FRAME_READY, (const uint16_t *)&commsFrames.frame, CHAN_WORDS(FRAME_Ready));
+        frameHeaderSent = true;
+    }
+    uint16_t words;
+    const uint16_t *chunk;
+    while (SCIPORT_txFree() >= COMMS_FRAME_BYTES(COMMS_MAX_FRAME_WORDS)
+           && (chunk = FRAME_nextChunk(&commsFrames, COMMS_MAX_FRAME_WORDS, &words)) != 0) {
+        COMMS_sendFrame(COMMS_FRAME_DATA, chunk, words);
+    }
+    if (FRAME_release(&commsFrames, &ipcChannel)) {
+        CHAN_notify();
+    }
+}
+
+void COMMS_init(void) {
+    commsDropped = 0;
+    commsSequence = 0;
+    FRAME_initReader(&commsFrames, frameBuffer0, frameBuffer1);
+    frameHeaderSent = false;
+    COMMANDS_init();
+    SCIPORT_init(COMMANDS_receive);
+
+    CPUTimer_setPeriod(CPUTIMER0_BASE, (uint32_t)((float)PLLSYSCLK/COMMS_POLL_FREQUENCY) - 1);
+    CPUTimer_setPreScaler(CPUTIMER0_BASE, 0);
+    CPUTimer_reloadTimerCounter(CPUTIMER0_BASE);
+    CPUTimer_enableInterrupt(CPUTIMER0_BASE);
+    Interrupt_register(INT_TIMER0, &commsTimerISR);
+    Interrupt_enable(INT_TIMER0);
+    CPUTimer_startTimer(CPUTIMER0_BASE);
+}
+
+void COMMS_handleMessage(uint16_t type, const uint16_t *payload, int16_t words) {
+    if (type == CHAN_MSG_FRAME_READY && words == CHAN_WORDS(FRAME_Ready)) {
+        if (FRAME_accept(&commsFrames, (const FRAME_Ready *)payload)) {
+            frameHeaderSent = false;
+            streamFrame();
+        }
+    }
+    else if ((type == CHAN_MSG_TELEMETRY || type == CHAN_MSG_BOOT_REPORT)
+             && words >= 0 && words <= COMMS_MAX_FRAME_WORDS) {
+        COMMS_sendFrame(type, payload, (uint16_t)words);
+    }
+    else {
+        commsDropped++;
+    }
+}
+
+ISR_PROFILE(commsTimerISR);
+
+interrupt void commsTimerISR(void) {
+    ISR_PROFILE_BEGIN();
+    SCIPORT_poll(); // The end of a command shorter than the RX FIFO level. Before the SCI can nest.
+    COMMS_ALLOW_SCI_INTERRUPTS(); // Decoding commands takes longer than the FIFOs last
+    COMMANDS_poll();
+    streamFrame();
+    ISR_PROFILE_END(commsTimerISR);
+
+    DINT;
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP1); // CPU timer 0 is INT1.7
+}
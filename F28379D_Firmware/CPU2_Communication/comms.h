@@ -0,0 +1,55 @@
+/*
+ * comms.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  CPU2's job as the communications processor: moving data between CPU1 (the message channel in
+ *  F28379D_Firmware/common/ipc_channel.h) and the host (SCI-A, see sci_port.h).
+ *
+ *  - Telemetry frames from CPU1 are queued on the SCI as binary frames (serial_frame.h): COBS with a
+ *    CRC, a sequence number and the IPC counter when CPU2 took the message off the channel. A frame that
+ *    doesn't fit the TX ring is dropped whole, and the gap in the sequence tells the host.
+ *  - Commands from the host (commands.h) are decoded and executed once per COMMS_POLL_FREQUENCY period
+ *    and answered with a reply frame. Those for CPU1 are passed on as messages, so CPU1 isn't
+ *    interrupted for every byte.
+ *  - Frames CPU1 hands over in GSx RAM (frame_service.h) are streamed in place as a CHAN_MSG_FRAME_READY
+ *    header and COMMS_FRAME_DATA chunks of up to COMMS_MAX_FRAME_WORDS, as fast as the TX ring drains,
+ *    and the buffer is released back to CPU1 after the last chunk. They share the SCI with telemetry.
+ *  - CPU1's boot report (boot_sync.h) is forwarded once, like a telemetry frame.
+ */
+
+#ifndef COMMS_H_
+#define COMMS_H_
+
+#include <stdint.h>
+#include "frame_service.h"
+#include "serial_frame.h"
+
+#define COMMS_POLL_FREQUENCY 1000 // Hz. Executes received commands.
+#define COMMS_MAX_FRAME_WORDS 32 // Longest message from CPU1
+#define COMMS_FRAME_BYTES(words) SFRAME_ENCODED_BYTES(2U*(words)) // SCI bytes of a frame with this many payload words
+#define COMMS_FRAME_DATA 0x80 // SCI frame type of a chunk of a GSx frame. Not a message type.
+
+/* Lets the SCI interrupts (INT9) preempt the rest of a long ISR, so the FIFOs are served within their
+ * headroom at full baud. Nothing else nests: IER holds only INT9, the ISR's own group stays blocked by
+ * its PIEACK, and IRET restores IER. Call DINT before acknowledging the group. */
+#define COMMS_ALLOW_SCI_INTERRUPTS() do { IER = INTERRUPT_CPU_INT9; EINT; } while (0)
+
+extern volatile uint16_t commsDropped; // Messages from CPU1 of unknown type, or frames that didn't fit the TX ring
+extern volatile uint16_t commsSequence; // Serial frames framed, including dropped ones (low byte goes out)
+extern FRAME_Reader commsFrames;
+
+/* Configures SCI-A and the poll timer. Call after CHAN_init(). */
+void COMMS_init(void);
+
+/* Frames a message for the host, stamped with the IPC counter now. From the comms poll timer or the
+ * INT_IPC_0 ISR, which don't nest. */
+void COMMS_sendFrame(uint16_t type, const uint16_t *payload, uint16_t words);
+
+/* Handles one message from CPU1. Called from the INT_IPC_0 ISR. */
+void COMMS_handleMessage(uint16_t type, const uint16_t *payload, int16_t words);
+
+interrupt void commsTimerISR(void);
+
+#endif /* COMMS_H_ */
@@ -1,9 +1,67 @@
-
-
-/**
+/*
  * main.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  CPU2, the communications processor: owns SCI-A and CAN-B and passes telemetry and commands between
+ *  CPU1 and the host (see comms.h). It also runs the speed and position control (motion_task.h), with
+ *  setpoints from the host or the CAN bus (can_port.h), so CPU1 only has the current loop. CPU1
+ *  configures the clocks, pin muxes and resource ownership, so CPU2 only sets up its own peripherals
+ *  and interrupts.
+ *
+ *  CPU1 releases CPU2 early and both initialise in parallel. CPU2 enables its interrupts only after
+ *  BOOT_rendezvous(), when CPU1's half of the channel is initialised too (boot_sync.h).
  */
-int main(void)
-{
-	return 0;
+
+#include <driverlib.h>
+#include "ipc_channel.h"
+#include "boot_sync.h"
+#include "comms.h"
+#include "motion_task.h"
+#include "can_port.h"
+#include "isr_profile.h"
+
+ISR_PROFILE(cpu1MessageISR);
+
+interrupt void cpu1MessageISR(void) {
+    ISR_PROFILE_BEGIN();
+    CHAN_acknowledge(); // First, so a message sent while draining raises the interrupt again
+    COMMS_ALLOW_SCI_INTERRUPTS(); // Framing telemetry for the SCI takes longer than its FIFOs last
+
+    uint32_t message[COMMS_MAX_FRAME_WORDS/2]; // 32-bit aligned for the payload structs
+    uint16_t type;
+    int16_t words;
+    while ((words = CHAN_receive(&ipcChannel, &type, message, COMMS_MAX_FRAME_WORDS)) != CHAN_EMPTY) {
+        if (type == CHAN_MSG_FEEDBACK && words == CHAN_WORDS(MOTION_Feedback)) {
+            MOTIONTASK_handleFeedback((const MOTION_Feedback *)message);
+        }
+        else {
+            COMMS_handleMessage(type, (const uint16_t *)message, words);
+        }
+    }
+    ISR_PROFILE_END(cpu1MessageISR);
+
+    DINT;
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP1);
+}
+
+int main(void) {
+    SysCtl_disableWatchdog();
+    Interrupt_initModule();
+    Interrupt_initVectorTable();
+
+    CHAN_init();
+    COMMS_init();
+    MOTIONTASK_init();
+    CANPORT_init();
+    ISR_PROFILE_init();
+    Interrupt_register(INT_IPC_0, &cpu1MessageISR);
+    Interrupt_enable(INT_IPC_0);
+    BOOT_rendezvous();
+    Interrupt_enableMaster();
+
+    while (1) {
+        IDLE; // Everything happens in interrupts
+    }
 }
@@ -0,0 +1,123 @@
+/*
+ * motion_task.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ */
+
+#include <driverlib.h>
+#include "clock_config.h"
+#include "ipc_channel.h"
+#include "foc.h" // Motor parameters
+#include "motion_task.h"
+#include "comms.h" // COMMS_ALLOW_SCI_INTERRUPTS()
+#include "can_port.h"
+#include "isr_profile.h"
+
+#define MOTION_SAMPLES_PER_PERIOD (FOC_SAMPLING_FREQUENCY/MOTION_CONTROL_FREQUENCY)
+
+MOTION_Controller motion;
+volatile uint16_t motionCommandMode;
+volatile float motionCommandTarget;
+
+volatile uint32_t motionRoundTrip;
+volatile uint32_t motionRoundTripMax;
+volatile uint32_t motionOneWayMax;
+volatile uint16_t motionMissedFeedback;
+volatile uint16_t motionRefused;
+volatile uint32_t motionPeriodCycles;
+
+static MOTION_Feedback latestFeedback;
+static bool haveFeedback; // Any feedback yet
+static bool feedbackFresh; // Feedback to the last reference
+static uint32_t referenceSequence;
+
+void MOTIONTASK_init(void) {
+    MOTION_init(&motion, 1.0f/MOTION_CONTROL_FREQUENCY, MOTOR_POLE_PAIRS, MOTOR_FLUX);
+    motionCommandMode = MOTION_MODE_OFF;
+    motionCommandTarget = 0.0f;
+    motionRoundTrip = 0;
+    motionRoundTripMax = 0;
+    motionOneWayMax = 0;
+    motionMissedFeedback = 0;
+    motionRefused = 0;
+    haveFeedback = false;
+    feedbackFresh = true;
+    referenceSequence = 0;
+    motionPeriodCycles = (uint32_t)((float)PLLSYSCLK/MOTION_CONTROL_FREQUENCY); // Until CPU1 reports its sample period
+
+    CPUTimer_setPeriod(CPUTIMER1_BASE, motionPeriodCycles - 1);
+    CPUTimer_setPreScaler(CPUTIMER1_BASE, 0);
+    CPUTimer_reloadTimerCounter(CPUTIMER1_BASE);
+    CPUTimer_enableInterrupt(CPUTIMER1_BASE);
+    Interrupt_register(INT_TIMER1, &motionTimerISR);
+    Interrupt_enable(INT_TIMER1);
+    CPUTimer_startTimer(CPUTIMER1_BASE);
+}
+
+void MOTIONTASK_handleFeedback(const MOTION_Feedback *feedback) {
+    if (feedback->sequence != referenceSequence) {
+        return; // Answer to an older reference, which arrived late
+    }
+    latestFeedback = *feedback;
+    haveFeedback = true;
+    feedbackFresh = true;
+
+    motionRoundTrip = (uint32_t)IPC_getCounter(IPC_CPU2_L_CPU1_R) - feedback->sent;
+    if (motionRoundTrip > motionRoundTripMax) {
+        motionRoundTripMax = motionRoundTrip;
+    }
+    uint32_t one_way = feedback->applied - feedback->sent;
+    if (feedback->accepted && one_way > motionOneWayMax) {
+        motionOneWayMax = one_way;
+    }
+    if (!feedback->accepted) {
+        motionRefused++;
+    }
+
+    // Lock the period to whole current loop samples. Takes effect at the timer's next reload.
+    uint32_t period = MOTION_SAMPLES_PER_PERIOD*feedback->sample_cycles;
+    if (period != motionPeriodCycles && feedback->sample_cycles != 0) {
+        motionPeriodCycles = period;
+        CPUTimer_setPeriod(CPUTIMER1_BASE, period - 1);
+        MOTION_setPeriod(&motion, (float)period/(float)PLLSYSCLK);
+    }
+}
+
+ISR_PROFILE(motionTimerISR);
+
+interrupt void motionTimerISR(void) {
+    ISR_PROFILE_BEGIN();
+    COMMS_ALLOW_SCI_INTERRUPTS(); // And the CAN receive interrupt, in the same group
+    CANP_Setpoint setpoint;
+    uint16_t due;
+    if (CANPORT_startPeriod(&setpoint, &due)) {
+        motionCommandMode = setpoint.mode; // A CAN setpoint replaces the last command, and the other way round
+        motionCommandTarget = setpoint.target;
+    }
+    if (!feedbackFresh) {
+        motionMissedFeedback++; // Uses the previous angle, one period older
+    }
+
+    MOTION_Reference reference;
+    reference.id = 0.0f;
+    reference.iq = 0.0f;
+    if (haveFeedback) {
+        MOTION_setMode(&motion, motionCommandMode, motionCommandTarget);
+        reference.iq = MOTION_run(&motion, latestFeedback.theta);
+    }
+    reference.sequence = ++referenceSequence;
+    reference.sent = (uint32_t)IPC_getCounter(IPC_CPU2_L_CPU1_R);
+    feedbackFresh = false;
+    CHAN_sendAndNotify(CHAN_MSG_REFERENCE, &reference, CHAN_WORDS(reference));
+
+    CANP_Status status;
+    status.position = motion.position;
+    status.speed = motion.observer.speed;
+    status.iq = reference.iq;
+    status.mode = motion.mode;
+    CANPORT_sendStatus(due, &status);
+    ISR_PROFILE_END(motionTimerISR);
+    DINT;
+    // CPU timer 1 is INT13, which doesn't go through the PIE, so there's no group to acknowledge
+}
@@ -0,0 +1,51 @@
+/*
+ * motion_task.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Speed and position control on CPU2 (CPU1_Controller/control/include/motion_control.h), so CPU1 only
+ *  runs the current loop.
+ *
+ *  CPU timer 1 runs the controller at MOTION_CONTROL_FREQUENCY, locked to a whole number of current loop
+ *  samples once CPU1 has reported its sample period (motion_link.h). Each period uses the rotor angle from
+ *  CPU1's latest MOTION_Feedback and sends the new current reference as a MOTION_Reference
+ *  (F28379D_Firmware/common/motion_link.h). CPU1 answers every reference at once, so the feedback for
+ *  this period is normally back long before the next one.
+ *
+ *  Until the first feedback arrives the references are zero current, so the position starts from a
+ *  real angle.
+ *
+ *  Each period starts by taking a new CAN setpoint, if the CAN port has latched one (can_port.h), and
+ *  ends by loading the status frames due, so on SYNC they report the period that applied the setpoint.
+ */
+
+#ifndef MOTION_TASK_H_
+#define MOTION_TASK_H_
+
+#include <stdint.h>
+#include "motion_control.h"
+#include "motion_link.h"
+
+extern MOTION_Controller motion;
+
+// Set from the debugger, a command or a CAN setpoint (can_port.h), taken by the next period
+extern volatile uint16_t motionCommandMode; // MOTION_MODE_x
+extern volatile float motionCommandTarget; // Position (rad) or speed (rad/s)
+
+extern volatile uint32_t motionRoundTrip; // Reference sent to its feedback received (SYSCLK cycles)
+extern volatile uint32_t motionRoundTripMax;
+extern volatile uint32_t motionOneWayMax; // Reference sent to CPU1 handing it to the current loop (SYSCLK cycles)
+extern volatile uint16_t motionMissedFeedback; // Periods that started without feedback to the last reference
+extern volatile uint16_t motionRefused; // References CPU1's current loop refused (see CLA_setCurrentReference())
+extern volatile uint32_t motionPeriodCycles; // Timer period (SYSCLK cycles)
+
+/* Starts the motion control timer. Call after CHAN_init(). */
+void MOTIONTASK_init(void);
+
+/* Takes a CHAN_MSG_FEEDBACK from CPU1. Called from the INT_IPC_0 ISR. */
+void MOTIONTASK_handleFeedback(const MOTION_Feedback *feedback);
+
+interrupt void motionTimerISR(void);
+
+#endif /* MOTION_TASK_H_ */
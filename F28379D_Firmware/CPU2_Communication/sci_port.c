@@ -0,0 +1,118 @@
+/*
+ * sci_port.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ */
+
+#include <driverlib.h>
+#include "clock_config.h"
+#include "sci_port.h"
+#include "isr_profile.h"
+
+#define TX_MASK (SCI_TX_RING_SIZE - 1U)
+
+#pragma DATA_SECTION(txRing, "comms_buffers")
+static uint16_t txRing[SCI_TX_RING_SIZE];
+static volatile uint16_t txHead; // Bytes queued, written by SCIPORT_write()
+static volatile uint16_t txTail; // Bytes moved to the FIFO, written by the TX interrupt
+
+static SCI_ReceiveHandler receiveHandler;
+volatile uint16_t sciTxOverflows;
+volatile uint16_t sciRxErrors;
+
+void SCIPORT_init(SCI_ReceiveHandler handler) {
+    receiveHandler = handler;
+    txHead = 0;
+    txTail = 0;
+    sciTxOverflows = 0;
+    sciRxErrors = 0;
+
+    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_SCIA);
+    SCI_performSoftwareReset(SCI_PORT_BASE);
+    SCI_setConfig(SCI_PORT_BASE, (uint32_t)LSPCLK, SCI_PORT_BAUD,
+                  SCI_CONFIG_WLEN_8 | SCI_CONFIG_STOP_ONE | SCI_CONFIG_PAR_NONE);
+    SCI_enableFIFO(SCI_PORT_BASE);
+    SCI_resetChannels(SCI_PORT_BASE);
+    SCI_setFIFOInterruptLevel(SCI_PORT_BASE, (SCI_TxFIFOLevel)SCI_TX_FIFO_LEVEL, (SCI_RxFIFOLevel)SCI_RX_FIFO_LEVEL);
+    SCI_clearInterruptStatus(SCI_PORT_BASE, SCI_INT_RXFF | SCI_INT_TXFF | SCI_INT_RXERR);
+    SCI_enableInterrupt(SCI_PORT_BASE, SCI_INT_RXFF | SCI_INT_RXERR); // TXFF only while there's data
+    SCI_enableModule(SCI_PORT_BASE);
+
+    Interrupt_register(INT_SCIA_RX, &sciRxISR);
+    Interrupt_register(INT_SCIA_TX, &sciTxISR);
+    Interrupt_enable(INT_SCIA_RX);
+    Interrupt_enable(INT_SCIA_TX);
+}
+
+uint16_t SCIPORT_txFree(void) {
+    return (uint16_t)(SCI_TX_RING_SIZE - (uint16_t)(txHead - txTail));
+}
+
+bool SCIPORT_write(const uint16_t *bytes, uint16_t count) {
+    if (SCIPORT_txFree() < count) {
+        sciTxOverflows++;
+        return false;
+    }
+    uint16_t head = txHead;
+    for (uint16_t k = 0; k < count; k++) {
+        txRing[head & TX_MASK] = bytes[k] & 0xFFU;
+        head++;
+    }
+    txHead = head; // Publishes the bytes to the TX interrupt
+    SCI_enableInterrupt(SCI_PORT_BASE, SCI_INT_TXFF); // Fires at once while the FIFO is below its level
+    return true;
+}
+
+ISR_PROFILE(sciTxISR);
+ISR_PROFILE(sciRxISR);
+
+/* TX FIFO down to its level: refill it from the ring, and stop interrupting when the ring is empty */
+interrupt void sciTxISR(void) {
+    ISR_PROFILE_BEGIN();
+    uint16_t tail = txTail;
+    uint16_t space = SCI_FIFO_DEPTH - (uint16_t)SCI_getTxFIFOStatus(SCI_PORT_BASE);
+    while (space > 0 && tail != txHead) {
+        HWREGH(SCI_PORT_BASE + SCI_O_TXBUF) = txRing[tail & TX_MASK];
+        tail++;
+        space--;
+    }
+    txTail = tail;
+    if (tail == txHead) {
+        SCI_disableInterrupt(SCI_PORT_BASE, SCI_INT_TXFF);
+    }
+
+    SCI_clearInterruptStatus(SCI_PORT_BASE, SCI_INT_TXFF);
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP9);
+    ISR_PROFILE_END(sciTxISR);
+}
+
+void SCIPORT_poll(void) {
+    if (SCI_getRxStatus(SCI_PORT_BASE) & SCI_RXSTATUS_ERROR) {
+        sciRxErrors++;
+        SCI_performSoftwareReset(SCI_PORT_BASE); // Clears the error flags
+    }
+    if (SCI_getOverflowStatus(SCI_PORT_BASE)) {
+        sciRxErrors++;
+        SCI_clearOverflowStatus(SCI_PORT_BASE);
+    }
+
+    uint16_t bytes[SCI_FIFO_DEPTH];
+    uint16_t count = 0;
+    while (count < SCI_FIFO_DEPTH && SCI_getRxFIFOStatus(SCI_PORT_BASE) != SCI_FIFO_RX0) {
+        bytes[count++] = HWREGH(SCI_PORT_BASE + SCI_O_RXBUF) & 0xFFU;
+    }
+    if (count && receiveHandler) {
+        receiveHandler(bytes, count);
+    }
+}
+
+/* RX FIFO at its level or a receive error */
+interrupt void sciRxISR(void) {
+    ISR_PROFILE_BEGIN();
+    SCIPORT_poll();
+
+    SCI_clearInterruptStatus(SCI_PORT_BASE, SCI_INT_RXFF | SCI_INT_RXERR);
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP9);
+    ISR_PROFILE_END(sciRxISR);
+}
@@ -0,0 +1,59 @@
+/*
+ * sci_port.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  SCI-A on CPU2 (GPIO28 RX, GPIO29 TX), interrupt driven with the 16-level FIFOs, at the fastest baud
+ *  LSPCLK allows.
+ *
+ *  Transmit goes through a byte ring in GS14: SCIPORT_write() queues bytes from any single context and
+ *  the TX FIFO interrupt moves them into the FIFO, so nothing waits for the line. The interrupt comes
+ *  while SCI_TX_FIFO_LEVEL bytes are still queued in the FIFO, so the line keeps going while it is
+ *  serviced. Received bytes are read out of the RX FIFO every SCI_RX_FIFO_LEVEL bytes, and by
+ *  SCIPORT_poll() so the end of a short command isn't left in the FIFO, and passed to the receive handler.
+ *
+ *  The ring has one writer and one reader, so neither side masks interrupts. At full baud a byte takes
+ *  12.8 us, so the FIFOs give the SCI interrupts SCI_TX_FIFO_LEVEL and 16 - SCI_RX_FIFO_LEVEL bytes of
+ *  headroom; CPU2's long ISRs let them nest (COMMS_ALLOW_SCI_INTERRUPTS() in comms.h) to stay inside it.
+ *
+ *  CPU1 gives CPU2 the SCI and the pins in AssignCpu2Resources() before CPU2 runs.
+ */
+
+#ifndef SCI_PORT_H_
+#define SCI_PORT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "clock_config.h"
+
+#define SCI_PORT_BASE SCIA_BASE
+#define SCI_PORT_BAUD ((uint32_t)LSPCLK/16U) // 781250 baud, BRR = 1: the SCI's fastest at 12.5 MHz LSPCLK
+#define SCI_TX_RING_SIZE 1024U // Bytes. Power of two.
+#define SCI_RX_FIFO_LEVEL 8 // Receive interrupt every this many bytes
+#define SCI_TX_FIFO_LEVEL 6 // Transmit interrupt when the FIFO is down to this many bytes
+#define SCI_FIFO_DEPTH 16
+
+typedef void (*SCI_ReceiveHandler)(const uint16_t *bytes, uint16_t count);
+
+extern volatile uint16_t sciTxOverflows; // SCIPORT_write() calls refused because the ring was full
+extern volatile uint16_t sciRxErrors; // Overrun, framing or parity errors
+
+/* Configures SCI-A and its interrupts. The handler is called from the RX interrupt, which can nest in
+ * CPU2's long ISRs, so it mustn't use the message channel. */
+void SCIPORT_init(SCI_ReceiveHandler handler);
+
+/* Queues count bytes (the low 8 bits of each word). All or nothing: returns false if they don't fit. */
+bool SCIPORT_write(const uint16_t *bytes, uint16_t count);
+
+/* Bytes free in the transmit ring */
+uint16_t SCIPORT_txFree(void);
+
+/* Passes whatever is in the RX FIFO to the handler. Call periodically from an interrupt of the same
+ * priority as the SCI's (they don't nest), e.g. a timer. */
+void SCIPORT_poll(void);
+
+interrupt void sciRxISR(void);
+interrupt void sciTxISR(void);
+
+#endif /* SCI_PORT_H_ */
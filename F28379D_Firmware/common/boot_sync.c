@@ -0,0 +1,53 @@
+/*
+ * boot_sync.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Target side of the dual-core boot (see boot_sync.h). Compiled into both cores' firmware.
+ */
+
+#if defined(__TI_COMPILER_VERSION__)
+
+#include <driverlib.h>
+#include "boot_sync.h"
+
+#if defined(CPU1)
+#define BOOT_IPC IPC_CPU1_L_CPU2_R
+#else
+#define BOOT_IPC IPC_CPU2_L_CPU1_R
+#endif
+
+// CPU2 boot ROM interface (TRM, "CPU2 Boot ROM" and TI's Device_bootCPU2())
+#define BOOT_CPU2_ROM_READY 0x00000002UL // IPCBOOTSTS: the boot ROM is waiting for a boot command
+#define BOOT_CPU2_FROM_FLASH 0x0000000BUL // IPCBOOTMODE: branch to CPU2's flash entry point
+#define BOOT_CPU2_COMMAND_FLAGS (IPC_FLAG0 | IPC_FLAG31) // Raised together to hand the boot ROM its command
+
+#if defined(CPU1)
+BOOT_Report bootReport;
+
+void BOOT_releaseCpu2(void) {
+    while ((IPC_getBootStatus(BOOT_IPC) & BOOT_CPU2_ROM_READY) == 0);
+    while (IPC_isFlagBusyLtoR(BOOT_IPC, BOOT_CPU2_COMMAND_FLAGS));
+    IPC_setBootMode(BOOT_IPC, BOOT_CPU2_FROM_FLASH);
+    IPC_setFlagLtoR(BOOT_IPC, BOOT_CPU2_COMMAND_FLAGS);
+    bootReport.cpu2_released = BOOT_stamp();
+}
+#endif
+
+uint32_t BOOT_stamp(void) {
+    return (uint32_t)IPC_getCounter(BOOT_IPC);
+}
+
+void BOOT_rendezvous(void) {
+#if defined(CPU1)
+    bootReport.cpu1_ready = BOOT_stamp();
+    IPC_sync(BOOT_IPC, BOOT_SYNC_FLAG);
+    bootReport.cpu2_ready = IPC_getResponse(BOOT_IPC);
+#else
+    IPC_sendResponse(BOOT_IPC, BOOT_stamp()); // Written before the flag, so CPU1 reads it after the sync
+    IPC_sync(BOOT_IPC, BOOT_SYNC_FLAG);
+#endif
+}
+
+#endif
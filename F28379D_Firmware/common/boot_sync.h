@@ -0,0 +1,80 @@
+/*
+ * boot_sync.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Dual-core boot. CPU1 releases CPU2 as early as it can and both cores initialise in parallel, then meet
+ *  before the PWM starts:
+ *
+ *      CPU1: watchdog, AssignCpu2Resources(), BOOT_releaseCpu2()
+ *      CPU1: PLL lock, RAM copies, PWM (time base stopped), ADCs, CLA, IPC link ...   BOOT_rendezvous()
+ *      CPU2:                          boot ROM, C init, channel, comms, motion ...    BOOT_rendezvous()
+ *      CPU1: StartPwm(), boot report to CPU2, interrupts           CPU2: interrupts
+ *
+ *  CPU2 needs its resources assigned before it configures them, so AssignCpu2Resources() still comes
+ *  first. Everything after it on CPU1, in particular waiting for the PLL to lock, overlaps with CPU2's boot
+ *  ROM and initialisation. The rendezvous is IPC_sync() on BOOT_SYNC_FLAG: neither core returns until the
+ *  other has arrived, so both halves of the message channel are initialised before either sends, and the
+ *  gate drivers see no switching until both cores are ready for the control and comms interrupts.
+ *
+ *  The boot is timed with the IPC counter, which counts SYSCLK from reset on both cores. CPU1 stamps the
+ *  milestones in bootReport and sends it to CPU2 (CHAN_MSG_BOOT_REPORT), which forwards it to the host.
+ */
+
+#ifndef COMMON_BOOT_SYNC_H_
+#define COMMON_BOOT_SYNC_H_
+
+#include <stdint.h>
+#include "clock_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// SYSCLK until the PLL is locked: the oscillator through the divider, which ConfigPllSysClock() sets
+// before waiting for the lock. Stamps up to pll_locked count at this rate.
+#define BOOT_RESET_SYSCLK_HZ ((float)OSCCLK_FREQ_HZ/SYSCLKDIV)
+
+/* Low words of the IPC counter at each milestone. CHAN_MSG_BOOT_REPORT payload. */
+typedef struct {
+    uint32_t main_entry; // CPU1 entered main(), after its boot ROM and C initialisation
+    uint32_t cpu2_released; // CPU2's boot ROM told to boot from flash
+    uint32_t pll_locked; // SYSCLK switched to the PLL
+    uint32_t cpu1_ready; // CPU1 arrived at the rendezvous
+    uint32_t cpu2_ready; // CPU2 arrived at the rendezvous
+    uint32_t first_pwm; // Time base clocks started
+    uint32_t time_to_pwm_us; // Reset to first_pwm (us)
+} BOOT_Report;
+
+/* Microseconds from reset to a stamp taken after the PLL locked */
+static inline uint32_t BOOT_microseconds(const BOOT_Report *r, uint32_t stamp) {
+    float seconds = (float)r->pll_locked/BOOT_RESET_SYSCLK_HZ + (float)(stamp - r->pll_locked)/(float)PLLSYSCLK;
+    return (uint32_t)(seconds*1e6f + 0.5f);
+}
+
+/* Target side (boot_sync.c) */
+#if defined(__TI_COMPILER_VERSION__)
+#define BOOT_SYNC_FLAG IPC_FLAG30 // CPU2's boot ROM uses flags 0 and 31, and the channel's doorbell is flag 0
+
+/* Low word of the IPC counter */
+uint32_t BOOT_stamp(void);
+
+/* Signals this core is initialised and waits for the other core to be. CPU2 passes its arrival stamp
+ * to CPU1 in its IPC reply register. */
+void BOOT_rendezvous(void);
+
+#if defined(CPU1)
+extern BOOT_Report bootReport;
+
+/* Tells CPU2's boot ROM to boot from flash, once it is ready for the command. Call after
+ * AssignCpu2Resources(). */
+void BOOT_releaseCpu2(void);
+#endif
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COMMON_BOOT_SYNC_H_ */
@@ -0,0 +1,359 @@
+/*
+ * can_protocol.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Setpoints and status on the drive's CAN bus (CPU2's CAN-B, can_port.h). Standard 11-bit identifiers,
+ *  numbered by node where CANopen puts its default PDOs, so a bus analyser shows them where it expects:
+ *
+ *  - CANP_ID_SYNC (0x080): the bus master's SYNC, common to every drive. No data, or a counter byte.
+ *  - CANP_ID_SETPOINT(node) (0x200 + node): mode, sequence and target for this drive (CANP_Setpoint).
+ *  - CANP_ID_STATUS(k, node) (0x180 + 0x100*k + node): status frame k from this drive (CANP_Status).
+ *
+ *  Each frame has its own DCAN message object (CANP_initMailboxes()), set up once. The receive objects'
+ *  acceptance filters match their identifier exactly, so the rest of the bus never interrupts, and a
+ *  received frame is dispatched by its object number without looking at the identifier.
+ *
+ *  As with the SCI, the receive interrupt only moves a frame out of its object into a ring (CANP_rxSlot()
+ *  and CANP_rxPublish()), so it's short and the same whatever the bus carries, and the next control
+ *  period decodes the frames in the order they arrived (CANP_startPeriod()). The ring's order is what
+ *  tells a setpoint sent just before a SYNC from one sent just after it.
+ *
+ *  Setpoints are latched in one of two ways:
+ *  - CANP_LATCH_NEXT_PERIOD: the next control period takes the latest setpoint.
+ *  - CANP_LATCH_ON_SYNC: setpoints wait for the next SYNC, and the first control period after it takes the
+ *    latest one and sends the status frames. Every drive on the bus changes at the same SYNC and reports
+ *    the same instant, within a control period.
+ *  A setpoint replaced before a control period took it is counted (overwritten). Without SYNC, status
+ *  frame k goes out every every[k] control periods.
+ *
+ *  Status frames each have a transmit object, loaded by the control period, so nothing waits for the bus
+ *  and nothing interrupts when a frame has gone out. A frame due while the last one is still waiting to
+ *  win arbitration (its TxRqst still set) replaces its data and is counted late, rather than queued
+ *  behind it.
+ *
+ *  Portable C, tested on the host against a model of the DCAN and the bus (HostSim bench "can").
+ */
+
+#ifndef COMMON_CAN_PROTOCOL_H_
+#define COMMON_CAN_PROTOCOL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CANP_ID_SYNC 0x080U
+#define CANP_ID_SETPOINT(node) (0x200U + (node))
+#define CANP_ID_STATUS(k, node) (0x180U + 0x100U*(k) + (node))
+#define CANP_ID_MASK 0x7FFU // Standard identifiers, matched exactly
+#define CANP_MAX_NODE 127U
+
+#define CANP_STATUS_FRAMES 2
+#define CANP_FRAME_BYTES 8 // Setpoints and status frames are always full
+#define CANP_MAX_MODE 2 // MOTION_MODE_POSITION
+#define CANP_MAX_TARGET 1e6f // As CMD_MODE
+#define CANP_RX_RING_SIZE 16 // Power of two. Frames are at least 47 us at 1 Mbit/s: under 11 per control period.
+
+#define CANP_LATCH_NEXT_PERIOD 0
+#define CANP_LATCH_ON_SYNC 1
+
+/* DCAN message objects (1 to 32). The lowest pending one interrupts first. */
+enum {
+    CANP_OBJECT_SYNC = 1,
+    CANP_OBJECT_SETPOINT = 2,
+    CANP_OBJECT_STATUS = 3, // Status frame k is object CANP_OBJECT_STATUS + k
+    CANP_OBJECT_TEST = CANP_OBJECT_STATUS + CANP_STATUS_FRAMES // Loopback only (CANPORT_inject())
+};
+#define CANP_MAILBOX_COUNT (2 + CANP_STATUS_FRAMES)
+
+#define CANP_RX 0
+#define CANP_TX 1
+
+/* What CANP_receive() did with a frame */
+#define CANP_IGNORED 0
+#define CANP_SYNC 1
+#define CANP_SETPOINT 2
+#define CANP_REFUSED 3
+
+typedef struct {
+    uint16_t object; // DCAN message object
+    uint16_t direction; // CANP_RX or CANP_TX
+    uint32_t id;
+    uint32_t mask; // Identifier bits the acceptance filter compares (receive)
+    uint16_t bytes; // Data length (transmit)
+} CANP_Mailbox;
+
+/* Setpoint frame: mode, sequence, two reserved bytes, then the target as an IEEE single, low byte first */
+typedef struct {
+    uint16_t mode; // MOTION_MODE_x
+    uint16_t sequence; // The master's, echoed in status frame 1 once a control period has taken it
+    float target; // Position (rad) or speed (rad/s)
+} CANP_Setpoint;
+
+/* What the control period reports. Frame 0: position and speed. Frame 1: iq, mode, the sequence of the
+ * setpoint in use, and the low bytes of the SYNC count and of the setpoints refused. */
+typedef struct {
+    float position; // (rad)
+    float speed; // (rad/s)
+    float iq; // Reference (A)
+    uint16_t mode;
+} CANP_Status;
+
+/* A received frame as the receive interrupt copies it out of its message object: the two data registers
+ * as they are, so the interrupt doesn't unpack bytes */
+typedef struct {
+    uint16_t object;
+    uint16_t count; // Data bytes, at most CANP_FRAME_BYTES
+    uint16_t lost; // The object's MsgLst: a frame before this one was overwritten unread
+    uint32_t data[2]; // Bytes 0 to 3 and 4 to 7, low byte first (IFxDATA and IFxDATB)
+} CANP_Frame;
+
+/* The setpoint for the next control period */
+typedef struct {
+    CANP_Setpoint setpoint;
+    uint32_t version; // Setpoints latched
+    uint32_t syncs; // SYNCs received
+} CANP_Latch;
+
+typedef struct {
+    uint16_t node;
+    uint16_t latch_mode; // CANP_LATCH_x
+    uint16_t every[CANP_STATUS_FRAMES]; // Control periods between status frames without SYNC, 0 for never
+
+    // The receive ring
+    CANP_Frame frames[CANP_RX_RING_SIZE];
+    volatile uint16_t head; // Written by the receive interrupt
+    volatile uint16_t tail; // Written by the control period
+    volatile uint32_t overflows; // Frames left in their objects because the ring was full
+
+    // Written by the control period
+    CANP_Setpoint pending; // Waiting for the next SYNC
+    uint16_t has_pending;
+    CANP_Latch latch;
+    uint32_t received; // Setpoint frames accepted
+    uint32_t refused; // Setpoint frames of the wrong length or out of range
+    uint32_t overwritten; // Setpoints replaced before a control period took them
+    uint32_t lost; // Frames the DCAN overwrote before the interrupt read them (MsgLst)
+    uint32_t taken_version;
+    uint32_t taken_syncs;
+    uint16_t applied_sequence; // Of the setpoint in use
+    uint16_t countdown[CANP_STATUS_FRAMES];
+    uint32_t loaded[CANP_STATUS_FRAMES]; // Status frames loaded, late ones included
+    uint32_t late; // Status frames due while the last was still waiting for the bus
+} CANP_Service;
+
+/* The message objects for a node: SYNC and setpoint receive objects, then one transmit object per status frame */
+static inline void CANP_initMailboxes(CANP_Mailbox *table, uint16_t node) {
+    table[0].object = CANP_OBJECT_SYNC;
+    table[0].direction = CANP_RX;
+    table[0].id = CANP_ID_SYNC;
+    table[1].object = CANP_OBJECT_SETPOINT;
+    table[1].direction = CANP_RX;
+    table[1].id = CANP_ID_SETPOINT(node);
+    for (uint16_t k = 0; k < CANP_STATUS_FRAMES; k++) {
+        table[2 + k].object = CANP_OBJECT_STATUS + k;
+        table[2 + k].direction = CANP_TX;
+        table[2 + k].id = CANP_ID_STATUS(k, node);
+    }
+    for (uint16_t k = 0; k < CANP_MAILBOX_COUNT; k++) {
+        table[k].mask = CANP_ID_MASK;
+        table[k].bytes = table[k].direction == CANP_TX ? CANP_FRAME_BYTES : 0U;
+    }
+}
+
+/* The DCAN's acceptance filter: true if a receive object takes a frame with this identifier */
+static inline bool CANP_accepts(const CANP_Mailbox *m, uint32_t id) {
+    return m->direction == CANP_RX && ((id ^ m->id) & m->mask) == 0U;
+}
+
+static inline void CANP_init(CANP_Service *s, uint16_t node, uint16_t latch_mode) {
+    s->node = node;
+    s->latch_mode = latch_mode;
+    s->pending.mode = 0;
+    s->pending.sequence = 0;
+    s->pending.target = 0.0f;
+    s->has_pending = 0;
+    s->latch.setpoint = s->pending;
+    s->latch.version = 0;
+    s->latch.syncs = 0;
+    s->head = 0;
+    s->tail = 0;
+    s->overflows = 0;
+    s->received = 0;
+    s->refused = 0;
+    s->overwritten = 0;
+    s->lost = 0;
+    s->taken_version = 0;
+    s->taken_syncs = 0;
+    s->applied_sequence = 0;
+    s->late = 0;
+    for (uint16_t k = 0; k < CANP_STATUS_FRAMES; k++) {
+        s->every[k] = 2; // 1 kHz at the 2 kHz motion control
+        s->countdown[k] = 1;
+        s->loaded[k] = 0;
+    }
+}
+
+static inline uint32_t CANP_bytesToLong(const uint16_t *bytes) {
+    return (uint32_t)(bytes[0] & 0xFFU) | (uint32_t)(bytes[1] & 0xFFU) << 8 | (uint32_t)(bytes[2] & 0xFFU) << 16
+           | (uint32_t)(bytes[3] & 0xFFU) << 24;
+}
+
+static inline void CANP_longToBytes(uint32_t value, uint16_t *bytes) {
+    for (uint16_t k = 0; k < 4; k++) {
+        bytes[k] = (uint16_t)(value >> 8*k) & 0xFFU;
+    }
+}
+
+static inline float CANP_toFloat(uint32_t bits) {
+    union {
+        uint32_t bits;
+        float value;
+    } u;
+    u.bits = bits;
+    return u.value;
+}
+
+static inline uint32_t CANP_fromFloat(float value) {
+    union {
+        uint32_t bits;
+        float value;
+    } u;
+    u.value = value;
+    return u.bits;
+}
+
+/* A setpoint frame's bytes (the low 8 bits of each word), for the master's side */
+static inline void CANP_encodeSetpoint(const CANP_Setpoint *setpoint, uint16_t *bytes) {
+    bytes[0] = setpoint->mode & 0xFFU;
+    bytes[1] = setpoint->sequence & 0xFFU;
+    bytes[2] = 0;
+    bytes[3] = 0;
+    CANP_longToBytes(CANP_fromFloat(setpoint->target), bytes + 4);
+}
+
+/* False if the frame is the wrong length or the mode or target is invalid, NaN included */
+static inline bool CANP_decodeSetpoint(const CANP_Frame *frame, CANP_Setpoint *setpoint) {
+    if (frame->count != CANP_FRAME_BYTES) {
+        return false;
+    }
+    setpoint->mode = (uint16_t)frame->data[0] & 0xFFU;
+    setpoint->sequence = (uint16_t)(frame->data[0] >> 8) & 0xFFU;
+    setpoint->target = CANP_toFloat(frame->data[1]);
+    return setpoint->mode <= CANP_MAX_MODE
+           && setpoint->target >= -CANP_MAX_TARGET && setpoint->target <= CANP_MAX_TARGET;
+}
+
+/* The ring slot for the next received frame, from the receive interrupt, or 0 if the ring is full and the
+ * frame has to be dropped (counted). Fill it, then CANP_rxPublish(). */
+static inline CANP_Frame *CANP_rxSlot(CANP_Service *s) {
+    uint16_t head = s->head;
+    if ((uint16_t)(head - s->tail) >= CANP_RX_RING_SIZE) {
+        s->overflows++;
+        return 0;
+    }
+    return &s->frames[head & (CANP_RX_RING_SIZE - 1U)];
+}
+
+static inline void CANP_rxPublish(CANP_Service *s) {
+    s->head = s->head + 1U; // Publishes the slot to the control period
+}
+
+/* Takes one received frame, by the object that accepted it */
+static inline uint16_t CANP_receive(CANP_Service *s, const CANP_Frame *frame) {
+    s->lost += frame->lost;
+    if (frame->object == CANP_OBJECT_SYNC) {
+        if (s->has_pending) {
+            s->overwritten += s->latch.version != s->taken_version;
+            s->latch.setpoint = s->pending;
+            s->latch.version++;
+            s->has_pending = 0;
+        }
+        s->latch.syncs++;
+        return CANP_SYNC;
+    }
+    if (frame->object != CANP_OBJECT_SETPOINT) {
+        return CANP_IGNORED;
+    }
+    CANP_Setpoint setpoint;
+    if (!CANP_decodeSetpoint(frame, &setpoint)) {
+        s->refused++;
+        return CANP_REFUSED;
+    }
+    s->received++;
+    if (s->latch_mode == CANP_LATCH_ON_SYNC) {
+        s->overwritten += s->has_pending;
+        s->pending = setpoint;
+        s->has_pending = 1;
+    }
+    else {
+        s->overwritten += s->latch.version != s->taken_version;
+        s->latch.setpoint = setpoint;
+        s->latch.version++;
+    }
+    return CANP_SETPOINT;
+}
+
+/* Call at the start of every control period. Takes the frames received since the last one, in the order
+ * they arrived, then returns true with the setpoint to apply from this period if there's a new one. *due
+ * gets the status frames to send at the end of the period, bit k for frame k. */
+static inline bool CANP_startPeriod(CANP_Service *s, CANP_Setpoint *setpoint, uint16_t *due) {
+    *due = 0;
+    uint16_t tail = s->tail;
+    uint16_t head = s->head; // Frames published after this wait for the next period
+    for (; tail != head; tail++) {
+        CANP_receive(s, &s->frames[tail & (CANP_RX_RING_SIZE - 1U)]);
+    }
+    s->tail = tail; // Frees the slots
+
+    if (s->latch_mode == CANP_LATCH_ON_SYNC) {
+        if (s->latch.syncs != s->taken_syncs) {
+            *due = (1U << CANP_STATUS_FRAMES) - 1U;
+            s->taken_syncs = s->latch.syncs;
+        }
+    }
+    else {
+        for (uint16_t k = 0; k < CANP_STATUS_FRAMES; k++) {
+            if (s->every[k] && --s->countdown[k] == 0) {
+                *due |= 1U << k;
+                s->countdown[k] = s->every[k];
+            }
+        }
+    }
+    if (s->latch.version == s->taken_version) {
+        return false;
+    }
+    *setpoint = s->latch.setpoint;
+    s->taken_version = s->latch.version;
+    s->applied_sequence = s->latch.setpoint.sequence;
+    return true;
+}
+
+/* Status frame k's bytes, before loading them into its object. waiting is the object's TxRqst: the last
+ * frame hasn't gone out yet, the new data replaces it, and the frame is counted late. */
+static inline void CANP_encodeStatus(CANP_Service *s, uint16_t k, const CANP_Status *status, bool waiting,
+                                     uint16_t *bytes) {
+    s->loaded[k]++;
+    s->late += waiting;
+    if (k == 0) {
+        CANP_longToBytes(CANP_fromFloat(status->position), bytes);
+        CANP_longToBytes(CANP_fromFloat(status->speed), bytes + 4);
+    }
+    else {
+        CANP_longToBytes(CANP_fromFloat(status->iq), bytes);
+        bytes[4] = status->mode & 0xFFU;
+        bytes[5] = s->applied_sequence & 0xFFU;
+        bytes[6] = (uint16_t)s->latch.syncs & 0xFFU;
+        bytes[7] = (uint16_t)s->refused & 0xFFU;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COMMON_CAN_PROTOCOL_H_ */
@@ -0,0 +1,264 @@
+/*
+ * command_protocol.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Commands from the host on the serial link (CPU2's SCI-A), framed like everything going the other way
+ *  (serial_frame.h): the frame's type is the command, its sequence is echoed in the reply, and its
+ *  timestamp is ignored.
+ *
+ *  - CMD_PARAM_READ and CMD_PARAM_WRITE read and write registered parameters by number. A write is
+ *    refused, changing nothing, if the parameter is read only or the value is outside its range.
+ *  - Everything else (mode changes, current gains, scope and capture control, bytes for CPU1) goes to
+ *    the service's handler, which returns the status.
+ *  - Every command frame gets one CMD_REPLY frame with its status, and for the parameter commands the
+ *    value the parameter has now. A frame that fails the CRC gets none: the host retries after a timeout.
+ *
+ *  Nothing is allocated or copied: received bytes go into a fixed ring (CMD_RxRing) from the SCI
+ *  interrupt, the serial frame decoder undoes the COBS and checks the CRC as each byte comes out of it,
+ *  and commands are read from the decoded frame where it is. CMD_nextFrame() takes a byte budget, so
+ *  the time per call is bounded whatever arrives. Portable C, fuzzed on the host (HostSim bench "command").
+ */
+
+#ifndef COMMON_COMMAND_PROTOCOL_H_
+#define COMMON_COMMAND_PROTOCOL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "serial_frame.h"
+#include "ipc_channel.h" // CHAN_WORDS()
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CMD_RX_RING_SIZE 256U // Bytes. Power of two.
+
+/* Serial frame types, host to CPU2. Payloads are 16-bit words, low byte first. */
+enum {
+    CMD_PARAM_READ = 0x40, // CMD_ParamRead
+    CMD_PARAM_WRITE = 0x41, // CMD_ParamWrite
+    CMD_MODE = 0x42, // CMD_Mode
+    CMD_SCOPE_SELECT = 0x43, // A SCOPE_Select (CPU1 scope.h), passed on to CPU1
+    CMD_CAPTURE_ARM = 0x44, // A CAPTURE_Arm (CPU1 capture.h), passed on to CPU1
+    CMD_CAPTURE_TRIGGER = 0x45, // No payload. Triggers the armed capture.
+    CMD_FORWARD = 0x46, // Bytes for CPU1's command handler (LINK_setCommandHandler())
+    CMD_CURRENT_GAINS = 0x47 // A FOC_CurrentGains (CPU1 foc_math.h), passed on to CPU1
+};
+
+#define CMD_REPLY 0x81 // Serial frame type of a CMD_Reply, CPU2 to host
+
+typedef enum {
+    CMD_OK = 0,
+    CMD_UNKNOWN = 1, // Not a command type
+    CMD_BAD_LENGTH = 2, // Payload too short or too long for the command
+    CMD_BAD_ID = 3, // No such parameter
+    CMD_READ_ONLY = 4,
+    CMD_OUT_OF_RANGE = 5, // Value, mode or setting invalid
+    CMD_BUSY = 6 // Couldn't be passed on to CPU1 now. Try again.
+} CMD_Status;
+
+typedef enum {
+    CMD_FLOAT32 = 0,
+    CMD_UINT32 = 1,
+    CMD_UINT16 = 2
+} CMD_Type;
+
+#define CMD_RO 0 // Parameter access
+#define CMD_RW 1
+
+typedef struct {
+    uint16_t id;
+} CMD_ParamRead;
+
+typedef struct {
+    uint16_t id;
+    uint16_t reserved;
+    uint32_t value; // The parameter's bits: IEEE single for CMD_FLOAT32
+} CMD_ParamWrite;
+
+typedef struct {
+    uint16_t mode; // MOTION_MODE_x
+    uint16_t reserved;
+    float target; // Position (rad) or speed (rad/s)
+} CMD_Mode;
+
+typedef struct {
+    uint16_t command; // Frame type of the command
+    uint16_t sequence; // Its sequence
+    uint16_t status; // CMD_Status
+    uint16_t id; // Parameter, for the parameter commands
+    uint32_t value; // Its bits after the command
+} CMD_Reply;
+
+typedef struct {
+    volatile void *address;
+    uint16_t type; // CMD_Type
+    uint16_t access; // CMD_RO or CMD_RW
+    float min; // Range of a write
+    float max;
+} CMD_Parameter;
+
+/* Executes a command other than a parameter read or write, from the decoded frame. Sets reply->value if
+ * it has one. */
+typedef uint16_t (*CMD_Handler)(uint16_t type, const SFRAME_Decoder *frame, CMD_Reply *reply);
+
+typedef struct {
+    const CMD_Parameter *parameters;
+    uint16_t parameter_count;
+    CMD_Handler handler;
+    uint32_t executed; // Command frames, including refused ones
+    uint32_t refused; // Replied with a status other than CMD_OK
+} CMD_Service;
+
+typedef struct {
+    uint16_t bytes[CMD_RX_RING_SIZE];
+    volatile uint16_t head; // Written by the receiver
+    volatile uint16_t tail; // Written by the parser
+    volatile uint16_t overflows; // Bytes lost because the ring was full
+} CMD_RxRing;
+
+static inline void CMD_initRing(CMD_RxRing *r) {
+    r->head = 0;
+    r->tail = 0;
+    r->overflows = 0;
+}
+
+/* Adds received bytes, from the receive interrupt. Bytes that don't fit are lost and counted: the frame
+ * they were in fails its CRC. */
+static inline void CMD_putBytes(CMD_RxRing *r, const uint16_t *bytes, uint16_t count) {
+    uint16_t head = r->head;
+    for (uint16_t k = 0; k < count; k++) {
+        if ((uint16_t)(head - r->tail) >= CMD_RX_RING_SIZE) {
+            r->overflows += count - k;
+            break;
+        }
+        r->bytes[head & (CMD_RX_RING_SIZE - 1U)] = bytes[k] & 0xFFU;
+        head++;
+    }
+    r->head = head; // Publishes them to the parser
+}
+
+/* Feeds ring bytes to the decoder until a frame is complete or *budget bytes have been taken. Returns
+ * true with the frame in the decoder, which stays valid until the next call. */
+static inline bool CMD_nextFrame(CMD_RxRing *r, SFRAME_Decoder *d, uint16_t *budget) {
+    uint16_t tail = r->tail;
+    uint16_t head = r->head;
+    bool complete = false;
+    while (*budget && tail != head && !complete) {
+        complete = SFRAME_decodeByte(d, r->bytes[tail & (CMD_RX_RING_SIZE - 1U)]);
+        tail++;
+        (*budget)--;
+    }
+    r->tail = tail; // Frees the bytes for the receiver
+    return complete;
+}
+
+/* Payload word k of a decoded frame, read from its bytes where they are */
+static inline uint16_t CMD_word(const SFRAME_Decoder *d, uint16_t k) {
+    const uint16_t *payload = d->raw + SFRAME_HEADER_BYTES;
+    return (uint16_t)(payload[2U*k] | (payload[2U*k + 1U] << 8));
+}
+
+static inline uint32_t CMD_long(const SFRAME_Decoder *d, uint16_t k) {
+    return (uint32_t)CMD_word(d, k) | ((uint32_t)CMD_word(d, k + 1U) << 16);
+}
+
+/* True if the payload is exactly words long */
+static inline bool CMD_hasWords(const SFRAME_Decoder *d, uint16_t words) {
+    return SFRAME_payloadBytes(d) == 2U*words;
+}
+
+static inline float CMD_toFloat(uint32_t bits) {
+    union {
+        uint32_t bits;
+        float value;
+    } u;
+    u.bits = bits;
+    return u.value;
+}
+
+static inline uint32_t CMD_fromFloat(float value) {
+    union {
+        uint32_t bits;
+        float value;
+    } u;
+    u.value = value;
+    return u.bits;
+}
+
+static inline uint32_t CMD_readParameter(const CMD_Parameter *p) {
+    if (p->type == CMD_UINT16) {
+        return *(const volatile uint16_t *)p->address;
+    }
+    return *(const volatile uint32_t *)p->address; // One 32-bit read: not torn
+}
+
+static inline uint16_t CMD_writeParameter(const CMD_Parameter *p, uint32_t bits) {
+    if (p->access != CMD_RW) {
+        return CMD_READ_ONLY;
+    }
+    float value = p->type == CMD_FLOAT32 ? CMD_toFloat(bits) : (float)bits;
+    if (!(value >= p->min && value <= p->max) || (p->type == CMD_UINT16 && bits > 0xFFFFU)) {
+        return CMD_OUT_OF_RANGE; // Also NaN
+    }
+    if (p->type == CMD_UINT16) {
+        *(volatile uint16_t *)p->address = (uint16_t)bits;
+    }
+    else {
+        *(volatile uint32_t *)p->address = bits; // One 32-bit write: a reader never sees half of it
+    }
+    return CMD_OK;
+}
+
+static inline void CMD_initService(CMD_Service *s, const CMD_Parameter *parameters, uint16_t parameter_count,
+                                   CMD_Handler handler) {
+    s->parameters = parameters;
+    s->parameter_count = parameter_count;
+    s->handler = handler;
+    s->executed = 0;
+    s->refused = 0;
+}
+
+/* Executes the command in a decoded frame and fills in its reply */
+static inline void CMD_execute(CMD_Service *s, const SFRAME_Decoder *d, CMD_Reply *reply) {
+    uint16_t type = SFRAME_type(d);
+    reply->command = type;
+    reply->sequence = SFRAME_sequence(d);
+    reply->id = 0;
+    reply->value = 0;
+
+    uint16_t status;
+    if (type == CMD_PARAM_READ || type == CMD_PARAM_WRITE) {
+        bool write = type == CMD_PARAM_WRITE;
+        if (!CMD_hasWords(d, write ? CHAN_WORDS(CMD_ParamWrite) : CHAN_WORDS(CMD_ParamRead))) {
+            status = CMD_BAD_LENGTH;
+        }
+        else if ((reply->id = CMD_word(d, 0)) >= s->parameter_count) {
+            status = CMD_BAD_ID;
+        }
+        else {
+            const CMD_Parameter *p = &s->parameters[reply->id];
+            status = write ? CMD_writeParameter(p, CMD_long(d, 2)) : (uint16_t)CMD_OK;
+            reply->value = CMD_readParameter(p);
+        }
+    }
+    else if (s->handler) {
+        status = s->handler(type, d, reply);
+    }
+    else {
+        status = CMD_UNKNOWN;
+    }
+    reply->status = status;
+    s->executed++;
+    if (status != CMD_OK) {
+        s->refused++;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COMMON_COMMAND_PROTOCOL_H_ */
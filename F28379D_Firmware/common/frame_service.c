@@ -0,0 +1,23 @@
+/*
+ * frame_service.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Target side of the frame buffers (see frame_service.h). Compiled into both cores' firmware.
+ *
+ *  CPU1's linker command file places frame_buffer0/1 in RAMGS12/13. CPU2's has the same sections as
+ *  DSECTs at the same addresses, so CPU2 links to the buffers without initialising them.
+ */
+
+#if defined(__TI_COMPILER_VERSION__)
+
+#include <stdint.h>
+#include "frame_service.h"
+
+#pragma DATA_SECTION(frameBuffer0, "frame_buffer0")
+uint16_t frameBuffer0[FRAME_BUFFER_WORDS];
+#pragma DATA_SECTION(frameBuffer1, "frame_buffer1")
+uint16_t frameBuffer1[FRAME_BUFFER_WORDS];
+
+#endif
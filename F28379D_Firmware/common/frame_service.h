@@ -0,0 +1,211 @@
+/*
+ * frame_service.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Double-buffered frames in global shared RAM, handed from CPU1 to CPU2 without copying.
+ *
+ *  The two frame buffers are whole GSx blocks (RAMGS12 and RAMGS13). At any time CPU1 owns one of them
+ *  (its master select is CPU1) and writes a frame into it, e.g. a waveform capture, while CPU2 owns the
+ *  other and streams it out. At a frame boundary CPU1 publishes the buffer it filled:
+ *
+ *      CPU1: FRAME_publish()   master select of the full buffer -> CPU2, CHAN_MSG_FRAME_READY ->
+ *      CPU2: FRAME_accept(), reads the frame in place (FRAME_nextChunk()) ...
+ *      CPU2: FRAME_release()   <- CHAN_MSG_FRAME_RELEASE
+ *      CPU1: FRAME_handleRelease()   master select -> CPU1, the buffer can be filled again
+ *
+ *  Only the master select moves, never the data, so a multi-kilobyte frame costs two register writes and
+ *  two IPC messages. Each core works in its own GSx block, so CPU2 reading a frame never stalls CPU1's
+ *  writes behind bus arbitration during the control ISR.
+ *
+ *  CPU1 fills one buffer while CPU2 has the other, so CPU2 holds at most one frame. If CPU2 is still
+ *  streaming when the next frame is full, FRAME_publish() returns false and CPU1 keeps the buffer: the
+ *  producer decides whether to overwrite it or wait.
+ *
+ *  Only CPU1 can write the GSxMSEL registers, so the owner changes are a callback run on CPU1. The
+ *  protocol is portable C, tested on the host with two threads (HostSim bench "frames").
+ *  frame_service.c places the buffers on the target.
+ */
+
+#ifndef COMMON_FRAME_SERVICE_H_
+#define COMMON_FRAME_SERVICE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ipc_channel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FRAME_BUFFER_WORDS 0x1000U // One GSx block (8 kB)
+#define FRAME_BUFFER_COUNT 2U
+
+enum {
+    FRAME_OWNER_CPU1 = 0,
+    FRAME_OWNER_CPU2 = 1
+};
+
+/* Sets the master select of a buffer's GSx block. Called on CPU1 only. */
+typedef void (*FRAME_SelectOwner)(uint16_t buffer, uint16_t owner);
+
+/* CHAN_MSG_FRAME_READY payload, CPU1 to CPU2 */
+typedef struct {
+    uint32_t sequence; // Frames published since FRAME_initWriter()
+    uint16_t buffer; // 0 or 1
+    uint16_t words; // Frame length
+} FRAME_Ready;
+
+/* CHAN_MSG_FRAME_RELEASE payload, CPU2 to CPU1 */
+typedef struct {
+    uint32_t sequence; // Of the frame released
+    uint16_t buffer;
+} FRAME_Release;
+
+/* CPU1 side */
+typedef struct {
+    uint16_t *buffers[FRAME_BUFFER_COUNT];
+    FRAME_SelectOwner select_owner;
+    uint16_t filling; // Buffer CPU1 is writing
+    uint16_t cpu2_owns[FRAME_BUFFER_COUNT]; // Set by FRAME_publish(), cleared by FRAME_handleRelease()
+    uint32_t sequence;
+    uint32_t busy; // Publishes refused because CPU2 still had the other buffer
+} FRAME_Writer;
+
+/* CPU2 side */
+typedef struct {
+    const uint16_t *buffers[FRAME_BUFFER_COUNT];
+    FRAME_Ready frame; // The frame being streamed
+    uint16_t offset; // Words of it streamed so far
+    bool active;
+    uint32_t frames; // Frames accepted
+    uint32_t lost; // Gaps in the sequence, i.e. frames CPU1 overwrote while CPU2 was streaming
+    uint32_t errors; // FRAME_READY messages that broke the protocol
+} FRAME_Reader;
+
+/* Starts with both buffers owned by CPU1 and buffer 0 being filled */
+static inline void FRAME_initWriter(FRAME_Writer *w, uint16_t *buffer0, uint16_t *buffer1,
+                                    FRAME_SelectOwner select_owner) {
+    w->buffers[0] = buffer0;
+    w->buffers[1] = buffer1;
+    w->select_owner = select_owner;
+    w->filling = 0;
+    w->sequence = 0;
+    w->busy = 0;
+    for (uint16_t k = 0; k < FRAME_BUFFER_COUNT; k++) {
+        w->cpu2_owns[k] = 0;
+        select_owner(k, FRAME_OWNER_CPU1);
+    }
+}
+
+/* The buffer to write the next frame into, FRAME_BUFFER_WORDS long */
+static inline uint16_t *FRAME_buffer(const FRAME_Writer *w) {
+    return w->buffers[w->filling];
+}
+
+/* True if FRAME_publish() would succeed, i.e. CPU2 has released the other buffer */
+static inline bool FRAME_canPublish(const FRAME_Writer *w) {
+    return !w->cpu2_owns[w->filling ^ 1U];
+}
+
+/* Hands the first words of the buffer to CPU2 and switches to the other buffer.
+ * Returns false, keeping the buffer, if CPU2 still has the other one or the channel is full. */
+static inline bool FRAME_publish(FRAME_Writer *w, CHAN_Ring *ring, uint16_t words) {
+    uint16_t buffer = w->filling;
+    if (!FRAME_canPublish(w) || words > FRAME_BUFFER_WORDS) {
+        w->busy++;
+        return false;
+    }
+    w->select_owner(buffer, FRAME_OWNER_CPU2); // Before the message, so CPU2 never sees a frame it doesn't own
+    FRAME_Ready ready;
+    ready.sequence = w->sequence;
+    ready.buffer = buffer;
+    ready.words = words;
+    if (!CHAN_SEND_STRUCT(ring, CHAN_MSG_FRAME_READY, ready)) {
+        w->select_owner(buffer, FRAME_OWNER_CPU1);
+        w->busy++;
+        return false;
+    }
+    w->cpu2_owns[buffer] = 1;
+    w->sequence++;
+    w->filling = buffer ^ 1U;
+    return true;
+}
+
+/* Takes a buffer back. Call with each CHAN_MSG_FRAME_RELEASE payload. */
+static inline void FRAME_handleRelease(FRAME_Writer *w, const FRAME_Release *release) {
+    if (release->buffer < FRAME_BUFFER_COUNT && w->cpu2_owns[release->buffer]) {
+        w->select_owner(release->buffer, FRAME_OWNER_CPU1);
+        w->cpu2_owns[release->buffer] = 0;
+    }
+}
+
+static inline void FRAME_initReader(FRAME_Reader *r, const uint16_t *buffer0, const uint16_t *buffer1) {
+    r->buffers[0] = buffer0;
+    r->buffers[1] = buffer1;
+    r->offset = 0;
+    r->active = false;
+    r->frames = 0;
+    r->lost = 0;
+    r->errors = 0;
+}
+
+/* Starts streaming a frame. Call with each CHAN_MSG_FRAME_READY payload.
+ * Returns false (and counts an error) if it isn't a valid frame or one is already being streamed. */
+static inline bool FRAME_accept(FRAME_Reader *r, const FRAME_Ready *ready) {
+    if (r->active || ready->buffer >= FRAME_BUFFER_COUNT || ready->words > FRAME_BUFFER_WORDS) {
+        r->errors++;
+        return false;
+    }
+    if (r->frames) {
+        r->lost += ready->sequence - r->frame.sequence - 1U;
+    }
+    r->frame = *ready;
+    r->offset = 0;
+    r->active = true;
+    r->frames++;
+    return true;
+}
+
+/* The next chunk of the frame being streamed, up to max_words long, or NULL when there's none left.
+ * \param words is set to the chunk length */
+static inline const uint16_t *FRAME_nextChunk(FRAME_Reader *r, uint16_t max_words, uint16_t *words) {
+    if (!r->active || r->offset >= r->frame.words) {
+        *words = 0;
+        return 0;
+    }
+    uint16_t left = r->frame.words - r->offset;
+    *words = left < max_words ? left : max_words;
+    const uint16_t *chunk = r->buffers[r->frame.buffer] + r->offset;
+    r->offset += *words;
+    return chunk;
+}
+
+/* Gives the frame's buffer back to CPU1 once it has all been streamed. Returns false if there's nothing
+ * to release yet or the channel is full (call again later). */
+static inline bool FRAME_release(FRAME_Reader *r, CHAN_Ring *ring) {
+    if (!r->active || r->offset < r->frame.words) {
+        return false;
+    }
+    FRAME_Release release;
+    release.sequence = r->frame.sequence;
+    release.buffer = r->frame.buffer;
+    if (!CHAN_SEND_STRUCT(ring, CHAN_MSG_FRAME_RELEASE, release)) {
+        return false;
+    }
+    r->active = false;
+    return true;
+}
+
+/* Target side (frame_service.c) */
+#if defined(__TI_COMPILER_VERSION__)
+extern uint16_t frameBuffer0[FRAME_BUFFER_WORDS]; // RAMGS12
+extern uint16_t frameBuffer1[FRAME_BUFFER_WORDS]; // RAMGS13
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COMMON_FRAME_SERVICE_H_ */
@@ -0,0 +1,52 @@
+/*
+ * ipc_channel.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Target side of the CPU1-CPU2 channel (see ipc_channel.h). Compiled into both cores' firmware.
+ *
+ *  Both linker command files put PUTBUFFER in the core's own message RAM and GETBUFFER (a DSECT, so the
+ *  core never writes it) in the other core's, so the same code links to the right addresses on each core.
+ */
+
+#if defined(__TI_COMPILER_VERSION__)
+
+#include <driverlib.h>
+#include "ipc_channel.h"
+
+#if defined(CPU1)
+#define CHAN_IPC IPC_CPU1_L_CPU2_R
+#else
+#define CHAN_IPC IPC_CPU2_L_CPU1_R
+#endif
+#define CHAN_DOORBELL IPC_FLAG0 // Raises INT_IPC_0 on the other core
+
+#pragma DATA_SECTION(ipcOutbox, "PUTBUFFER")
+static CHAN_Outbox ipcOutbox;
+#pragma DATA_SECTION(ipcInbox, "GETBUFFER")
+static CHAN_Outbox ipcInbox; // The other core's outbox
+
+CHAN_Ring ipcChannel;
+
+void CHAN_init(void) {
+    CHAN_initRing(&ipcChannel, &ipcOutbox, &ipcInbox);
+}
+
+bool CHAN_sendAndNotify(uint16_t type, const void *payload, uint16_t words) {
+    if (!CHAN_send(&ipcChannel, type, payload, words)) {
+        return false;
+    }
+    CHAN_notify();
+    return true;
+}
+
+void CHAN_notify(void) {
+    IPC_setFlagLtoR(CHAN_IPC, CHAN_DOORBELL); // Already set if the receiver hasn't woken up yet, which is fine
+}
+
+void CHAN_acknowledge(void) {
+    IPC_ackFlagRtoL(CHAN_IPC, CHAN_DOORBELL);
+}
+
+#endif
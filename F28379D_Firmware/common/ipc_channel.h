@@ -0,0 +1,173 @@
+/*
+ * ipc_channel.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Lock-free message channel between CPU1 and CPU2 through the IPC message RAMs.
+ *
+ *  Each direction is a single-producer, single-consumer ring of 16-bit words. A core can only write its
+ *  own message RAM (CPU1TOCPU2RAM on CPU1, CPU2TOCPU1RAM on CPU2), so each core's CHAN_Outbox holds the
+ *  ring it sends on and the read index of the ring it receives from:
+ *
+ *      CPU1TOCPU2RAM: CPU1 outbox {write_index, read_index of CPU2's ring, data}
+ *      CPU2TOCPU1RAM: CPU2 outbox {write_index, read_index of CPU1's ring, data}
+ *
+ *  Every index has exactly one writer, so neither side takes a lock or masks interrupts. Indexes are
+ *  free-running 16-bit counts of words, and CHAN_RING_WORDS divides 65536, so they wrap without special
+ *  cases. A sender publishes a message by advancing its write index after the data is written, and a
+ *  receiver frees the space by advancing its read index after the data is read.
+ *
+ *  A message is a two-word header {type, length} followed by up to CHAN_MAX_PAYLOAD_WORDS words:
+ *  - Typed messages: a struct sent with CHAN_SEND_STRUCT(), e.g. a current reference every PWM period
+ *  - Bulk frames: any array of words up to CHAN_MAX_PAYLOAD_WORDS (half a ring)
+ *  CHAN_send() never waits: it returns false if the ring doesn't have room for the whole message.
+ *
+ *  The ring functions here are portable C, tested on the host with two threads (HostSim bench "ipc").
+ *  ipc_channel.c places the outboxes in the message RAMs and rings the receiver with an IPC flag.
+ */
+
+#ifndef COMMON_IPC_CHANNEL_H_
+#define COMMON_IPC_CHANNEL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CHAN_RING_WORDS 512U // Power of two. The outbox has to fit the 0x400-word message RAM.
+#define CHAN_RING_MASK (CHAN_RING_WORDS - 1U)
+#define CHAN_HEADER_WORDS 2U // Type and payload length
+#define CHAN_MAX_PAYLOAD_WORDS (CHAN_RING_WORDS/2U - CHAN_HEADER_WORDS)
+
+#define CHAN_EMPTY (-1) // CHAN_receive(): no message
+#define CHAN_TOO_LONG (-2) // CHAN_receive(): the message didn't fit the buffer and was dropped
+
+/* Payload length of an object in 16-bit words. sizeof() counts 16-bit chars on the C28x and bytes on the host. */
+#define CHAN_WORDS(object) ((uint16_t)((sizeof(object) + sizeof(uint16_t) - 1U)/sizeof(uint16_t)))
+
+/* Message types. The payload layout of each is defined by its user. */
+enum {
+    CHAN_MSG_TELEMETRY = 2, // CPU1 to CPU2: a telemetry frame for CPU2 to send out
+    CHAN_MSG_COMMAND = 3, // CPU2 to CPU1: bytes of a CMD_FORWARD from the host (command_protocol.h), one per word
+    CHAN_MSG_FRAME_READY = 4, // CPU1 to CPU2: a frame buffer is CPU2's (frame_service.h)
+    CHAN_MSG_FRAME_RELEASE = 5, // CPU2 to CPU1: a frame buffer is CPU1's again
+    CHAN_MSG_REFERENCE = 6, // CPU2 to CPU1: current reference from the motion controller (motion_link.h)
+    CHAN_MSG_FEEDBACK = 7, // CPU1 to CPU2: the answer to a reference, with the rotor angle
+    CHAN_MSG_BOOT_REPORT = 8, // CPU1 to CPU2: boot milestones (boot_sync.h), once, forwarded to the host
+    CHAN_MSG_SCOPE_SELECT = 9, // CPU2 to CPU1: live scope channels and decimation (CPU1_Controller scope.h)
+    CHAN_MSG_CAPTURE_ARM = 10, // CPU2 to CPU1: arms or disarms a triggered capture (CPU1_Controller capture.h)
+    CHAN_MSG_CAPTURE_TRIGGER = 11, // CPU2 to CPU1: triggers the armed capture now, whatever its trigger
+    CHAN_MSG_CURRENT_GAINS = 12, // CPU2 to CPU1: new current regulator gains (CPU1_Controller foc_math.h FOC_CurrentGains)
+    CHAN_MSG_USER = 16 // First type free for the application
+};
+
+/* Index accesses. On the C28x both cores see writes to the message RAMs in program order, and the data
+ * and indexes are volatile so the compiler keeps that order too. The host needs acquire/release. */
+#if defined(__TI_COMPILER_VERSION__)
+#define CHAN_LOAD_INDEX(p) (*(p))
+#define CHAN_STORE_INDEX(p, v) (*(p) = (v))
+#else
+#define CHAN_LOAD_INDEX(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define CHAN_STORE_INDEX(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#endif
+
+typedef struct {
+    volatile uint16_t write_index; // Words written to data[], by this core
+    volatile uint16_t read_index; // Words read from the other core's data[], by this core
+    volatile uint16_t data[CHAN_RING_WORDS];
+} CHAN_Outbox;
+
+typedef struct {
+    CHAN_Outbox *tx; // This core's outbox (writable)
+    const CHAN_Outbox *rx; // The other core's outbox (read only)
+} CHAN_Ring;
+
+/* Resets this core's half of the channel. Call before the other core starts sending or receiving. */
+static inline void CHAN_initRing(CHAN_Ring *ring, CHAN_Outbox *tx, const CHAN_Outbox *rx) {
+    ring->tx = tx;
+    ring->rx = rx;
+    CHAN_STORE_INDEX(&tx->write_index, 0);
+    CHAN_STORE_INDEX(&tx->read_index, 0);
+}
+
+/* Words free in the send ring */
+static inline uint16_t CHAN_freeWords(const CHAN_Ring *ring) {
+    uint16_t used = (uint16_t)(ring->tx->write_index - CHAN_LOAD_INDEX(&ring->rx->read_index));
+    return (uint16_t)(CHAN_RING_WORDS - used);
+}
+
+/* True if the receive ring has a message */
+static inline bool CHAN_hasMessage(const CHAN_Ring *ring) {
+    return CHAN_LOAD_INDEX(&ring->rx->write_index) != ring->tx->read_index;
+}
+
+/* Sends a message. Returns false, having written nothing, if the ring is full or the payload too long. */
+static inline bool CHAN_send(CHAN_Ring *ring, uint16_t type, const void *payload, uint16_t words) {
+    if (words > CHAN_MAX_PAYLOAD_WORDS || CHAN_freeWords(ring) < words + CHAN_HEADER_WORDS) {
+        return false;
+    }
+    volatile uint16_t *data = ring->tx->data;
+    const uint16_t *source = (const uint16_t *)payload;
+    uint16_t index = ring->tx->write_index;
+    data[index & CHAN_RING_MASK] = type;
+    data[(uint16_t)(index + 1U) & CHAN_RING_MASK] = words;
+    index += CHAN_HEADER_WORDS;
+    for (uint16_t k = 0; k < words; k++) {
+        data[index & CHAN_RING_MASK] = source[k];
+        index++;
+    }
+    CHAN_STORE_INDEX(&ring->tx->write_index, index); // Publishes the message
+    return true;
+}
+
+/* Receives the oldest message into payload (max_words long).
+ * \return the payload length in words, CHAN_EMPTY or CHAN_TOO_LONG (the message is dropped) */
+static inline int16_t CHAN_receive(CHAN_Ring *ring, uint16_t *type, void *payload, uint16_t max_words) {
+    uint16_t index = ring->tx->read_index;
+    if (CHAN_LOAD_INDEX(&ring->rx->write_index) == index) {
+        return CHAN_EMPTY;
+    }
+    const volatile uint16_t *data = ring->rx->data;
+    uint16_t words = data[(uint16_t)(index + 1U) & CHAN_RING_MASK];
+    *type = data[index & CHAN_RING_MASK];
+    index += CHAN_HEADER_WORDS;
+    int16_t result = CHAN_TOO_LONG;
+    if (words <= max_words) {
+        uint16_t *destination = (uint16_t *)payload;
+        for (uint16_t k = 0; k < words; k++) {
+            destination[k] = data[(uint16_t)(index + k) & CHAN_RING_MASK];
+        }
+        result = (int16_t)words;
+    }
+    CHAN_STORE_INDEX(&ring->tx->read_index, (uint16_t)(index + words)); // Frees the space
+    return result;
+}
+
+#define CHAN_SEND_STRUCT(ring, type, object) CHAN_send((ring), (type), &(object), CHAN_WORDS(object))
+
+/* Target side (ipc_channel.c) */
+#if defined(__TI_COMPILER_VERSION__)
+extern CHAN_Ring ipcChannel; // This core's end of the channel
+
+/* Initializes this core's outbox. Both cores must call it before either sends. */
+void CHAN_init(void);
+
+/* Sends a message and rings the other core's doorbell (IPC flag 0, which raises its INT_IPC_0). */
+bool CHAN_sendAndNotify(uint16_t type, const void *payload, uint16_t words);
+
+/* Rings the doorbell, for messages sent with CHAN_send() directly */
+void CHAN_notify(void);
+
+/* Acknowledges the doorbell. Call at the start of the INT_IPC_0 ISR, before draining the ring, so a
+ * message sent while draining rings it again. */
+void CHAN_acknowledge(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COMMON_IPC_CHANNEL_H_ */
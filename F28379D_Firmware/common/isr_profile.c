@@ -0,0 +1,14 @@
+/*
+ * isr_profile.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Compiled into both cores' firmware.
+ */
+
+#include "isr_profile.h"
+
+#if ISR_PROFILE_ENABLE
+uint32_t isrProfileOverhead = 0;
+#endif
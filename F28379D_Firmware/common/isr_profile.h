@@ -0,0 +1,84 @@
+/*
+ * isr_profile.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Cycle counts of the ISRs on the target, for the HostSim PIE profiles (HostSim/profiles, bench "pie").
+ *
+ *  With ISR_PROFILE_ENABLE 1, ISR_PROFILE_BEGIN() at the top of an ISR and ISR_PROFILE_END() before it
+ *  returns time it with CPU timer 2, free running at SYSCLK, and keep the fewest and most cycles and the
+ *  number of runs in isrProfile_<name>, which the CCS Expressions window reads. ISR_PROFILE_init() starts
+ *  the timer, after anything else that uses it (CPU1's kernel bench), and before the interrupts.
+ *
+ *  The counts are the body only: add the compiler's context save and restore, from the ISR's disassembly,
+ *  before putting them in a profile. The hardware's entry and IRET are in the PIE clock profile already.
+ *  An ISR which lets others nest counts their time too, so take its maximum with the nesting ones idle or
+ *  subtract theirs. Each BEGIN/END costs about ten cycles, so leave it off in normal builds.
+ */
+
+#ifndef COMMON_ISR_PROFILE_H_
+#define COMMON_ISR_PROFILE_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef ISR_PROFILE_ENABLE
+#define ISR_PROFILE_ENABLE 0
+#endif
+
+typedef struct {
+    uint32_t min; // SYSCLK cycles
+    uint32_t max;
+    uint32_t count;
+} ISR_Profile;
+
+#if ISR_PROFILE_ENABLE
+
+#include <driverlib.h>
+
+extern uint32_t isrProfileOverhead; // Cycles of two back to back reads, taken off every count
+
+#define ISR_PROFILE(name) ISR_Profile isrProfile_##name = {0xFFFFFFFF, 0, 0}
+#define ISR_PROFILE_BEGIN() uint32_t isr_profile_start = HWREG(CPUTIMER2_BASE + CPUTIMER_O_TIM)
+#define ISR_PROFILE_END(name) ISR_PROFILE_record(&isrProfile_##name, \
+                                                 isr_profile_start - HWREG(CPUTIMER2_BASE + CPUTIMER_O_TIM))
+
+static inline void ISR_PROFILE_init(void) {
+    CPUTimer_stopTimer(CPUTIMER2_BASE);
+    CPUTimer_setPeriod(CPUTIMER2_BASE, 0xFFFFFFFF);
+    CPUTimer_setPreScaler(CPUTIMER2_BASE, 0); // One count per SYSCLK cycle
+    CPUTimer_reloadTimerCounter(CPUTIMER2_BASE);
+    CPUTimer_startTimer(CPUTIMER2_BASE);
+    uint32_t start = HWREG(CPUTIMER2_BASE + CPUTIMER_O_TIM);
+    isrProfileOverhead = start - HWREG(CPUTIMER2_BASE + CPUTIMER_O_TIM);
+}
+
+static inline void ISR_PROFILE_record(ISR_Profile *profile, uint32_t counts) {
+    uint32_t cycles = counts > isrProfileOverhead ? counts - isrProfileOverhead : 0; // Counts down; wraps after ~170 s
+    if (cycles < profile->min) {
+        profile->min = cycles;
+    }
+    if (cycles > profile->max) {
+        profile->max = cycles;
+    }
+    profile->count++;
+}
+
+#else
+
+#define ISR_PROFILE(name)
+#define ISR_PROFILE_BEGIN()
+#define ISR_PROFILE_END(name)
+#define ISR_PROFILE_init()
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COMMON_ISR_PROFILE_H_ */
@@ -0,0 +1,50 @@
+/*
+ * motion_link.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Messages between the motion controller on CPU2 and the current loop on CPU1.
+ *
+ *  Every motion control period CPU2 sends a MOTION_Reference. CPU1 hands it to the current loop in its
+ *  INT_IPC_0 ISR (CLA_setCurrentReference(): the loop takes the whole reference at its next sample) and
+ *  answers at once with a MOTION_Feedback carrying the loop's latest angle and speed, which CPU2 uses
+ *  in its next period.
+ *
+ *  The feedback also carries the current loop's actual sample period in SYSCLK cycles, from the ePWM
+ *  period rather than the nominal FOC_SAMPLING_FREQUENCY. CPU2 sets its timer to a whole number of
+ *  samples, so both cores count the same SYSCLK and the angle is the same age every period instead of
+ *  beating against the sampling.
+ *
+ *  Both messages carry IPC counter values. The counter is common to both cores and counts SYSCLK
+ *  cycles, so applied - sent is the one-way latency from CPU2's send to the reference being in place
+ *  for the next current loop sample, and CPU2 gets the round trip from the feedback's arrival.
+ */
+
+#ifndef COMMON_MOTION_LINK_H_
+#define COMMON_MOTION_LINK_H_
+
+#include <stdint.h>
+
+/* CHAN_MSG_REFERENCE payload */
+typedef struct {
+    uint32_t sequence; // Counts up from 1. Reported by the current loop telemetry as ref_sequence.
+    uint32_t sent; // Low word of the IPC counter when CPU2 sent it
+    float id; // (A)
+    float iq; // (A)
+} MOTION_Reference;
+
+/* CHAN_MSG_FEEDBACK payload */
+typedef struct {
+    uint32_t sequence; // Of the reference this answers
+    uint32_t sent; // Copied from the reference
+    uint32_t applied; // Low word of the IPC counter when CPU1 handed it to the current loop
+    uint32_t sample_count; // Current loop samples so far
+    uint32_t sample_cycles; // SYSCLK cycles between current loop samples
+    float theta; // Electrical angle of the latest sample (per-unit)
+    float omega; // Electrical speed of the latest sample (rad/s)
+    float iq; // Measured q-axis current (A)
+    uint16_t accepted; // 0 if the loop hadn't taken the previous reference yet, so this one was refused
+} MOTION_Feedback;
+
+#endif /* COMMON_MOTION_LINK_H_ */
@@ -0,0 +1,96 @@
+/*
+ * seqlock.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Coherent snapshots of multi-word state written by an ISR or the other core (the CLA's telemetry,
+ *  the angle and speed the C28x hands the current loop) for readers which can't stop the writer.
+ *
+ *  The state has a sequence count next to it. The writer makes it odd before changing anything and even
+ *  again after, so it never waits or masks an interrupt. A reader takes the count, copies the state and
+ *  takes the count again: if it was odd or has changed, the copy may mix two writes and is taken again.
+ *  Readers are bounded (SEQ_read() gives up after a number of tries), since an ISR can't wait for a writer
+ *  which may be the code it interrupted: the caller decides what to do without a coherent copy.
+ *
+ *  One writer per count. Any number of readers, which never write anything the writer reads.
+ *
+ *  Portable C, stress tested on the host with a writer and reader threads (HostSim bench "snapshot").
+ */
+
+#ifndef COMMON_SEQLOCK_H_
+#define COMMON_SEQLOCK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef volatile uint32_t SEQ_Count; // 32 bits, so it is written in one access on the C28x and the CLA
+
+/* Count accesses. The C28x and the CLA make their memory accesses in program order and the count is
+ * volatile, so the compiler keeps the state's accesses between them as written. The host needs fences. */
+#if defined(__TI_COMPILER_VERSION__)
+#define SEQ_LOAD(p) (*(p))
+#define SEQ_WRITE_FENCE()
+#define SEQ_READ_FENCE()
+#define SEQ_STORE(p, v) (*(p) = (v))
+#else
+#define SEQ_LOAD(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define SEQ_WRITE_FENCE() __atomic_thread_fence(__ATOMIC_RELEASE) // The odd count before the state
+#define SEQ_READ_FENCE() __atomic_thread_fence(__ATOMIC_ACQUIRE) // The state before the second count
+#define SEQ_STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#endif
+
+static inline void SEQ_init(SEQ_Count *count) {
+    SEQ_STORE(count, 0);
+}
+
+/* Before the writer changes the state */
+static inline void SEQ_writeBegin(SEQ_Count *count) {
+    SEQ_STORE(count, *count + 1U);
+    SEQ_WRITE_FENCE();
+}
+
+/* After the writer has changed the state */
+static inline void SEQ_writeEnd(SEQ_Count *count) {
+    SEQ_STORE(count, *count + 1U);
+}
+
+/* Before a reader copies the state. Returns the count for SEQ_readValid(). */
+static inline uint32_t SEQ_readBegin(const SEQ_Count *count) {
+    return SEQ_LOAD(count);
+}
+
+/* After a reader has copied the state: true if no write was under way or happened meanwhile */
+static inline bool SEQ_readValid(const SEQ_Count *count, uint32_t start) {
+    SEQ_READ_FENCE();
+    return (start & 1U) == 0U && SEQ_LOAD(count) == start;
+}
+
+/* Copies size (sizeof()) of state guarded by a count, taking it again if a write got in the way, up to
+ * tries times. Returns false if none of the copies was coherent; copy then holds the last one.
+ * Copies chars, which may alias anything: 16 bits each on the C28x and the CLA. */
+static inline bool SEQ_read(const SEQ_Count *count, void *copy, const volatile void *state, uint16_t size,
+                            uint16_t tries) {
+    const volatile unsigned char *source = (const volatile unsigned char *)state;
+    unsigned char *destination = (unsigned char *)copy;
+    for (uint16_t n = 0; n < tries; n++) {
+        uint32_t start = SEQ_readBegin(count);
+        for (uint16_t k = 0; k < size; k++) {
+            destination[k] = source[k];
+        }
+        if (SEQ_readValid(count, start)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COMMON_SEQLOCK_H_ */
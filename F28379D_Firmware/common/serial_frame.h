@@ -0,0 +1,239 @@
+/*
+ * serial_frame.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Binary framing of the serial link to the host (CPU2's SCI-A, see CPU2_Communication/comms.h).
+ *
+ *  A frame is
+ *
+ *      type | sequence | timestamp (4 bytes) | payload | CRC-16 (2 bytes)
+ *
+ *  COBS encoded and followed by a zero byte. COBS replaces every zero in the frame, so a zero only ever
+ *  marks the end of a frame: a receiver that joins mid-stream or loses a byte resynchronises at the next
+ *  one. The overhead is one byte per 254, i.e. one byte for any frame here, plus the delimiter.
+ *
+ *  - type: the message type it carries (CHAN_MSG_x, or COMMS_FRAME_DATA for a chunk of a GSx frame)
+ *  - sequence: counts every frame the sender framed, including those it then had to drop, so the host
+ *    sees a gap for each lost frame
+ *  - timestamp: low word of the IPC counter (SYSCLK cycles) when the data was taken, low byte first
+ *  - payload: 16-bit words, low byte first
+ *  - CRC: CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF) of everything before it, high
+ *    byte first, so the CRC of a whole valid frame is zero
+ *
+ *  Bytes are held one per uint16_t, as the C28x has no 8-bit type. Encoding and decoding are portable C
+ *  and take a fixed time per byte: the decoder undoes the COBS and runs the CRC as each byte arrives, so
+ *  nothing is left to do at the delimiter. HostSim tests them (bench "serial") and its serial_decode tool
+ *  reads captures of the link with the same code.
+ */
+
+#ifndef COMMON_SERIAL_FRAME_H_
+#define COMMON_SERIAL_FRAME_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SFRAME_HEADER_BYTES 6U // Type, sequence and timestamp
+#define SFRAME_CRC_BYTES 2U
+#define SFRAME_MAX_PAYLOAD_BYTES 128U // Keeps a frame under the 254 bytes of one COBS block
+#define SFRAME_MAX_RAW_BYTES (SFRAME_HEADER_BYTES + SFRAME_MAX_PAYLOAD_BYTES + SFRAME_CRC_BYTES)
+#define SFRAME_DELIMITER 0x00U
+
+/* Bytes on the line for a frame with this many payload bytes: COBS adds one, and the delimiter */
+#define SFRAME_ENCODED_BYTES(payload_bytes) ((payload_bytes) + SFRAME_HEADER_BYTES + SFRAME_CRC_BYTES + 2U)
+
+/* Adds a byte to a CRC-16/CCITT-FALSE. A nibble at a time from a 16 entry table. */
+static inline uint16_t SFRAME_crc16(uint16_t crc, uint16_t byte) {
+    static const uint16_t table[16] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+    };
+    crc = (uint16_t)((crc << 4) ^ table[((crc >> 12) ^ (byte >> 4)) & 0xFU]);
+    crc = (uint16_t)((crc << 4) ^ table[((crc >> 12) ^ byte) & 0xFU]);
+    return crc;
+}
+
+typedef struct {
+    uint16_t *out; // Encoded bytes
+    uint16_t length; // Bytes written to out
+    uint16_t code_index; // Where the current COBS block's code byte goes
+    uint16_t code; // The current block's length so far, plus one
+    uint16_t crc;
+} SFRAME_Encoder;
+
+/* COBS encodes one byte */
+static inline void SFRAME_stuff(SFRAME_Encoder *e, uint16_t byte) {
+    if (byte == 0U) {
+        e->out[e->code_index] = e->code;
+        e->code_index = e->length++;
+        e->code = 1;
+        return;
+    }
+    e->out[e->length++] = byte;
+    if (++e->code == 0xFFU) { // A full block ends without a zero
+        e->out[e->code_index] = e->code;
+        e->code_index = e->length++;
+        e->code = 1;
+    }
+}
+
+static inline void SFRAME_put(SFRAME_Encoder *e, uint16_t byte) {
+    byte &= 0xFFU;
+    e->crc = SFRAME_crc16(e->crc, byte);
+    SFRAME_stuff(e, byte);
+}
+
+/* Encodes a frame into out, which must have room for SFRAME_ENCODED_BYTES(2*words).
+ * \return the encoded length including the delimiter, or 0 if the payload is longer than
+ * SFRAME_MAX_PAYLOAD_BYTES */
+static inline uint16_t SFRAME_encode(uint16_t *out, uint16_t type, uint16_t sequence, uint32_t timestamp,
+                                     const uint16_t *payload, uint16_t words) {
+    if (2U*words > SFRAME_MAX_PAYLOAD_BYTES) {
+        return 0;
+    }
+    SFRAME_Encoder e;
+    e.out = out;
+    e.length = 1;
+    e.code_index = 0;
+    e.code = 1;
+    e.crc = 0xFFFFU;
+    SFRAME_put(&e, type);
+    SFRAME_put(&e, sequence);
+    for (uint16_t k = 0; k < 4U; k++) {
+        SFRAME_put(&e, (uint16_t)(timestamp >> (8U*k)));
+    }
+    for (uint16_t k = 0; k < words; k++) {
+        SFRAME_put(&e, payload[k]);
+        SFRAME_put(&e, payload[k] >> 8);
+    }
+    uint16_t crc = e.crc;
+    SFRAME_stuff(&e, crc >> 8);
+    SFRAME_stuff(&e, crc & 0xFFU);
+    e.out[e.code_index] = e.code;
+    e.out[e.length++] = SFRAME_DELIMITER;
+    return e.length;
+}
+
+typedef struct {
+    uint16_t raw[SFRAME_MAX_RAW_BYTES]; // The frame being received, decoded
+    uint16_t length; // Bytes in raw
+    uint16_t block; // Bytes left in the current COBS block. 0: the next byte is a code byte.
+    uint16_t zero_after; // The current block is followed by a zero (its code was below 0xFF)
+    bool started; // A code byte has been received since the last delimiter
+    bool overflow; // The frame was longer than raw
+    uint16_t crc;
+
+    uint32_t frames; // Valid frames
+    uint32_t crc_errors; // Complete frames that failed the CRC
+    uint32_t framing_errors; // Frames cut short by a delimiter, too long or too short
+} SFRAME_Decoder;
+
+static inline void SFRAME_resetFrame(SFRAME_Decoder *d) {
+    d->length = 0;
+    d->block = 0;
+    d->zero_after = 0;
+    d->started = false;
+    d->overflow = false;
+    d->crc = 0xFFFFU;
+}
+
+static inline void SFRAME_initDecoder(SFRAME_Decoder *d) {
+    SFRAME_resetFrame(d);
+    d->frames = 0;
+    d->crc_errors = 0;
+    d->framing_errors = 0;
+}
+
+static inline void SFRAME_keep(SFRAME_Decoder *d, uint16_t byte) {
+    if (d->length >= SFRAME_MAX_RAW_BYTES) {
+        d->overflow = true;
+        return;
+    }
+    d->raw[d->length++] = byte;
+    d->crc = SFRAME_crc16(d->crc, byte);
+}
+
+/* Takes one byte from the line. Returns true when it completes a valid frame, which can then be read
+ * with the accessors below until the next byte. */
+static inline bool SFRAME_decodeByte(SFRAME_Decoder *d, uint16_t byte) {
+    byte &= 0xFFU;
+    if (byte == SFRAME_DELIMITER) {
+        if (!d->started) {
+            return false; // Idle line or back-to-back delimiters
+        }
+        bool valid = false;
+        if (d->block != 0U || d->overflow || d->length < SFRAME_HEADER_BYTES + SFRAME_CRC_BYTES) {
+            d->framing_errors++;
+        }
+        else if (d->crc != 0U) {
+            d->crc_errors++;
+        }
+        else {
+            d->frames++;
+            valid = true;
+        }
+        uint16_t length = d->length;
+        SFRAME_resetFrame(d);
+        d->length = valid ? length : 0U; // Kept for the accessors
+        return valid;
+    }
+
+    if (d->block == 0U) { // Code byte
+        if (d->started && d->zero_after) {
+            SFRAME_keep(d, 0);
+        }
+        if (!d->started) {
+            d->length = 0; // The previous frame is gone
+        }
+        d->started = true;
+        d->block = byte - 1U;
+        d->zero_after = byte != 0xFFU;
+    }
+    else {
+        SFRAME_keep(d, byte);
+        d->block--;
+    }
+    return false;
+}
+
+static inline uint16_t SFRAME_type(const SFRAME_Decoder *d) {
+    return d->raw[0];
+}
+
+static inline uint16_t SFRAME_sequence(const SFRAME_Decoder *d) {
+    return d->raw[1];
+}
+
+static inline uint32_t SFRAME_timestamp(const SFRAME_Decoder *d) {
+    return (uint32_t)d->raw[2] | ((uint32_t)d->raw[3] << 8) | ((uint32_t)d->raw[4] << 16) | ((uint32_t)d->raw[5] << 24);
+}
+
+/* Payload length in bytes */
+static inline uint16_t SFRAME_payloadBytes(const SFRAME_Decoder *d) {
+    return d->length - SFRAME_HEADER_BYTES - SFRAME_CRC_BYTES;
+}
+
+/* Copies the payload back into 16-bit words (an odd last byte is the low byte of the last word).
+ * \return the number of words, at most max_words */
+static inline uint16_t SFRAME_payloadWords(const SFRAME_Decoder *d, uint16_t *words, uint16_t max_words) {
+    uint16_t bytes = SFRAME_payloadBytes(d);
+    uint16_t count = (uint16_t)((bytes + 1U)/2U);
+    count = count < max_words ? count : max_words;
+    const uint16_t *payload = d->raw + SFRAME_HEADER_BYTES;
+    for (uint16_t k = 0; k < count; k++) {
+        uint16_t high = 2U*k + 1U < bytes ? payload[2U*k + 1U] : 0U;
+        words[k] = (uint16_t)(payload[2U*k] | (high << 8));
+    }
+    return count;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COMMON_SERIAL_FRAME_H_ */
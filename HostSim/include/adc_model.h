@@ -0,0 +1,33 @@
+/*
+ * adc_model.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  12-bit ADC with the analogue front end in adc_channels.h: quantization, clipping to the reference
+ *  and optional Gaussian noise. Results are the raw counts the CLA task reads from the result registers.
+ */
+
+#ifndef HOSTSIM_INCLUDE_ADC_MODEL_H_
+#define HOSTSIM_INCLUDE_ADC_MODEL_H_
+
+#include <stdint.h>
+#include <random>
+
+#define SIM_ADC_VREF 3.3 // ADC_VREF in adcs.h
+#define SIM_ADC_FULL_SCALE_COUNTS 4096 // ADC_FULL_SCALE_COUNTS in adcs.h
+
+class AdcModel {
+    private:
+        double noise_lsb; // RMS noise (counts)
+        std::mt19937 rng;
+        std::normal_distribution<double> noise;
+
+    public:
+        AdcModel(double noise_lsb, unsigned seed);
+        uint16_t convert(double volts); // Voltage at the ADC pin to counts
+        uint16_t convertCurrent(double amps); // Phase current through the current sensor
+        uint16_t convertVdc(double volts); // DC link voltage through the divider
+};
+
+#endif /* HOSTSIM_INCLUDE_ADC_MODEL_H_ */
@@ -0,0 +1,119 @@
+/*
+ * can_sim.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Simulated DCAN module on a CAN bus, at the level CPU2's CAN port (can_port.c) uses it through can_hal.h
+ *  (hal_sim.h forwards the HAL to simPeripherals.can):
+ *  - 32 message objects, receive or transmit, with an identifier, an acceptance mask, data, and the NewDat,
+ *    MsgLst, TxRqst and IntPnd bits. A frame off the bus goes to the lowest numbered receive object whose
+ *    filter takes it, and sets MsgLst if the last one hadn't been read. A frame no object takes is dropped
+ *    without an interrupt.
+ *  - Interrupt line INT0, reporting its lowest numbered pending object like the DCAN's INT register.
+ *  - The bus: standard data frames at their exact length, stuff bits over the real CRC-15 included, and the
+ *    interframe space. Whenever the bus goes idle, the pending frame with the lowest identifier wins
+ *    arbitration, out of the other nodes' queued frames and this module's lowest numbered transmit request.
+ *  - Internal loopback (CAN_TEST_LBACK): the module receives its own frames and ignores the bus.
+ *
+ *  Time is in seconds. The bus only moves in nextFrame(), so the caller interleaves it with its own events
+ *  (interrupts, control periods) in time order.
+ */
+
+#ifndef HOSTSIM_INCLUDE_CAN_SIM_H_
+#define HOSTSIM_INCLUDE_CAN_SIM_H_
+
+#include <stdint.h>
+#include <deque>
+#include <vector>
+
+#define SIM_CAN_OBJECTS 32
+#define SIM_CAN_INTERFRAME_BITS 3
+
+typedef struct {
+    uint32_t id; // Standard, 11 bits
+    uint16_t dlc;
+    uint16_t bytes[8];
+} SimCanFrame;
+
+typedef struct {
+    bool configured;
+    bool transmit;
+    bool interrupt_enable; // RxIE or TxIE
+    uint32_t id;
+    uint32_t mask;
+    uint16_t dlc;
+    uint16_t bytes[8];
+    bool new_data;
+    bool message_lost;
+    bool tx_request;
+    bool interrupt_pending;
+    double requested_s; // When TxRqst was set
+} SimCanObject;
+
+class SimCan {
+    public:
+        explicit SimCan(double bit_rate);
+
+        void reset();
+
+        /* CAN_setupMessageObject(): a receive object takes frames with ((id ^ object id) & mask) == 0 */
+        void setupObject(uint16_t object, uint32_t id, uint32_t mask, bool transmit, bool interrupt_enable, uint16_t dlc);
+
+        void setLoopback(bool loopback);
+
+        /* CAN_sendMessage(): new data and TxRqst. A request still pending just gets the new data. */
+        void sendMessage(uint16_t object, const uint16_t *bytes, uint16_t dlc);
+
+        /* Reads an object through IF2 as can_port.c does: its data, DLC as received and MsgLst, and clears
+         * NewDat and IntPnd. MsgLst stays set until writeControl() clears it. Returns NewDat. */
+        bool readObject(uint16_t object, uint16_t *bytes, uint16_t *dlc, bool *lost);
+
+        /* Writes an object's NewDat, MsgLst and IntPnd through IF2 */
+        void writeControl(uint16_t object, bool new_data, bool lost, bool interrupt_pending);
+
+        /* Lowest numbered object with an interrupt pending, or 0 */
+        uint16_t interruptCause() const;
+
+        /* TxRqst, as CAN_getTxRequests() reads it: set until the frame has gone out */
+        bool txRequested(uint16_t object) const;
+
+        /* A frame another node starts trying to send at time_s. Queued frames are in time order. */
+        void queueFrame(double time_s, const SimCanFrame &frame);
+
+        /* Runs the bus to the end of the next frame, if it ends by until_s, and returns true. Otherwise runs
+         * it to until_s (a frame under way carries on) and returns false. */
+        bool nextFrame(double until_s);
+
+        double now() const {
+            return time_s;
+        }
+
+        /* Bits the frame takes on the bus, stuff bits and interframe space included */
+        static uint16_t frameBits(const SimCanFrame &frame);
+
+        double bit_rate;
+        unsigned long frames; // On the bus
+        unsigned long received; // Stored in a receive object
+        unsigned long filtered; // Taken by no object
+        unsigned long interrupts; // Interrupt pending bits set
+        double busy_s; // Time the bus carried frames
+        std::vector<SimCanFrame> sent; // This module's frames, as they went out
+        std::vector<double> sent_s; // When each ended
+
+    private:
+        void deliver(const SimCanFrame &frame);
+
+        SimCanObject objects[SIM_CAN_OBJECTS + 1]; // 1 to 32
+        std::deque<std::pair<double, SimCanFrame>> queue;
+        bool loopback;
+        double time_s;
+        double idle_s; // When the bus is next free
+        bool in_flight;
+        bool in_flight_own;
+        uint16_t in_flight_object;
+        SimCanFrame in_flight_frame;
+        double in_flight_end_s;
+};
+
+#endif /* HOSTSIM_INCLUDE_CAN_SIM_H_ */
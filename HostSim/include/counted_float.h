@@ -0,0 +1,63 @@
+/*
+ * counted_float.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  A float which counts the operations done on it, for estimating the cost of the control kernels
+ *  without a target. The kernels in foc_math.h, observer.h and cla_shared.h are plain C, so
+ *  isr_cost.cpp compiles them a second time with 'float' defined as CountedFloat (inside a namespace,
+ *  so the real types are untouched) and runs them on representative inputs.
+ *
+ *  Loads and register moves aren't visible at this level. Stores are counted through assignment.
+ */
+
+#ifndef HOSTSIM_INCLUDE_COUNTED_FLOAT_H_
+#define HOSTSIM_INCLUDE_COUNTED_FLOAT_H_
+
+typedef struct {
+    unsigned long add; // Add, subtract, negate
+    unsigned long mul;
+    unsigned long div;
+    unsigned long compare;
+    unsigned long convert; // Integer to float and back
+    unsigned long sqrt;
+    unsigned long store;
+} OpCounts;
+
+extern OpCounts opCounts;
+
+class CountedFloat {
+    private:
+        float v;
+
+    public:
+        CountedFloat() : v(0.0f) {}
+        CountedFloat(float x) : v(x) {} // Constants
+        CountedFloat(double x) : v((float)x) {}
+        CountedFloat(int x) : v((float)x) { opCounts.convert++; }
+        CountedFloat(unsigned x) : v((float)x) { opCounts.convert++; }
+        CountedFloat(long x) : v((float)x) { opCounts.convert++; }
+        CountedFloat(unsigned long x) : v((float)x) { opCounts.convert++; }
+        CountedFloat(unsigned short x) : v((float)x) { opCounts.convert++; }
+        CountedFloat(const CountedFloat &x) : v(x.v) {}
+
+        CountedFloat &operator=(const CountedFloat &x) { v = x.v; opCounts.store++; return *this; }
+        template<typename T> explicit operator T() const { opCounts.convert++; return (T)v; }
+        float value() const { return v; }
+
+        CountedFloat operator-() const { opCounts.add++; return CountedFloat(-v); }
+        CountedFloat &operator+=(CountedFloat x) { opCounts.add++; opCounts.store++; v += x.v; return *this; }
+        CountedFloat &operator-=(CountedFloat x) { opCounts.add++; opCounts.store++; v -= x.v; return *this; }
+
+        friend CountedFloat operator+(CountedFloat a, CountedFloat b) { opCounts.add++; return CountedFloat(a.v + b.v); }
+        friend CountedFloat operator-(CountedFloat a, CountedFloat b) { opCounts.add++; return CountedFloat(a.v - b.v); }
+        friend CountedFloat operator*(CountedFloat a, CountedFloat b) { opCounts.mul++; return CountedFloat(a.v * b.v); }
+        friend CountedFloat operator/(CountedFloat a, CountedFloat b) { opCounts.div++; return CountedFloat(a.v / b.v); }
+        friend bool operator<(CountedFloat a, CountedFloat b) { opCounts.compare++; return a.v < b.v; }
+        friend bool operator>(CountedFloat a, CountedFloat b) { opCounts.compare++; return a.v > b.v; }
+        friend bool operator<=(CountedFloat a, CountedFloat b) { opCounts.compare++; return a.v <= b.v; }
+        friend bool operator>=(CountedFloat a, CountedFloat b) { opCounts.compare++; return a.v >= b.v; }
+};
+
+#endif /* HOSTSIM_INCLUDE_COUNTED_FLOAT_H_ */
@@ -0,0 +1,98 @@
+/*
+ * fsi_sim.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Simulated FSI link between a controller and ThreePhaseGen, at the level fsi_port.c uses it:
+ *  - Two directions, one lane each at bit_rate. Frames go out back to back in the order they're started,
+ *    each at its length from the TRM's frame structure: start of frame, type, data words, user data, CRC,
+ *    tag and end of frame, plus the preamble and postamble (SIM_FSI_LINE_BITS, estimated).
+ *  - Data frames of FSIL_FRAME_WORDS words and ping frames with a 4-bit tag.
+ *  - The generator's receive DMA: each good data frame is copied whole into the next slot of its ring,
+ *    and position() is the slot it'll write next, which fsi_port.c works out from DST_ADDR_ACTIVE.
+ *  - Damaged frames: they fail the CRC, never reach the DMA and set the receiver's error flag.
+ *  - The generator's FSI flags as fsi_port.c reads them through fsi_hal.h (hal_sim.h forwards the HAL to
+ *    simPeripherals.fsi): the receive events, the ping tag and watchdog counter, and frame done on transmit.
+ *
+ *  Time is in seconds. The link only moves in nextFrame(), so the caller interleaves it with its own events
+ *  (interrupts, polls) in time order.
+ */
+
+#ifndef HOSTSIM_INCLUDE_FSI_SIM_H_
+#define HOSTSIM_INCLUDE_FSI_SIM_H_
+
+#include <stdint.h>
+#include <deque>
+#include "fsi_link.h"
+
+#define SIM_FSI_FRAME_BITS 32 // SOF, type, user data, CRC, tag and EOF
+#define SIM_FSI_LINE_BITS 16 // Preamble and postamble
+
+enum {
+    SIM_FSI_TO_GENERATOR,
+    SIM_FSI_TO_CONTROLLER
+};
+
+typedef struct {
+    bool ping;
+    uint16_t tag; // Ping frames
+    uint16_t words[FSIL_FRAME_WORDS]; // Data frames
+    bool damaged;
+} SimFsiFrame;
+
+class SimFsiLink {
+    public:
+        /* clock_hz is the generator's SYSCLK, which its ping watchdog counts */
+        SimFsiLink(double bit_rate, double clock_hz);
+
+        void reset();
+
+        /* The generator's DMA destination: frames slots of FSIL_FRAME_WORDS words */
+        void setRing(volatile uint16_t *ring, uint16_t frames);
+
+        /* Starts a frame at time_s, or when the line is free */
+        void send(int direction, double time_s, const SimFsiFrame &frame);
+
+        /* A frame started in this direction hasn't finished by time_s */
+        bool busy(int direction, double time_s) const;
+
+        /* Runs the link to the end of the next frame, if it ends by until_s, and returns true with it. A good
+         * data frame to the generator has also gone to the ring. Otherwise returns false. */
+        bool nextFrame(double until_s, int *direction, SimFsiFrame *frame);
+
+        /* The DMA's slot */
+        uint16_t position() const {
+            return dma_slot;
+        }
+
+        /* The ping watchdog's counter: the generator's SYSCLK cycles since the last ping ended */
+        uint32_t pingAge() const;
+
+        double now() const {
+            return time_s;
+        }
+
+        static uint16_t frameBits(const SimFsiFrame &frame);
+
+        double bit_rate;
+        double clock_hz;
+        bool rx_error; // The generator's receiver saw a damaged frame (CRC error). Cleared by the port.
+        bool rx_ping; // And a ping frame. Cleared by the port.
+        uint16_t ping_tag; // The last ping's
+        bool tx_done; // A frame from the generator has ended. Cleared by the port.
+        unsigned long frames[2]; // Each direction
+        unsigned long damaged[2];
+        double busy_s[2]; // Time each direction carried frames
+
+    private:
+        std::deque<std::pair<double, SimFsiFrame>> line[2]; // In flight, by end time
+        double free_s[2]; // When each direction is next free
+        volatile uint16_t *ring;
+        uint16_t ring_frames;
+        uint16_t dma_slot;
+        double ping_s; // When the last ping ended
+        double time_s;
+};
+
+#endif /* HOSTSIM_INCLUDE_FSI_SIM_H_ */
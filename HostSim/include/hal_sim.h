@@ -0,0 +1,191 @@
+/*
+ * hal_sim.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Simulated backend of the firmware HALs, selected by defining HAL_SIMULATED:
+ *  - SimHal: the policy class for the CPU1 drivers (F28379D_Firmware/CPU1_Controller/peripherals/include/hal.h)
+ *  - HAL_x() functions: the same operations for the C code in ThreePhaseGen (ThreePhaseGen/hal.h)
+ *  - HAL_xCan() functions: CPU2's CAN port (F28379D_Firmware/CPU2_Communication/can_hal.h), on the DCAN and
+ *    bus a bench attaches as simPeripherals.can (can_sim.h)
+ *  - HAL_xFsi() functions: ThreePhaseGen's FSI port (ThreePhaseGen/fsi_hal.h), on the link a bench attaches as
+ *    simPeripherals.fsi (fsi_sim.h)
+ *
+ *  Every write lands in the matching register of simPeripherals (sim_peripherals.h), which the
+ *  simulation steps, and every read comes from there. Base addresses are the real ones, so code
+ *  which computes them itself still finds the right module.
+ *
+ *  Also provides the driverlib additions the drivers use for naming modules (EPWM_Module, EPWM_Outputs).
+ */
+
+#ifndef HOSTSIM_INCLUDE_HAL_SIM_H_
+#define HOSTSIM_INCLUDE_HAL_SIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SIM_EPWM1_BASE 0x00004000U // Same on the F28379D and F28002x
+#define SIM_EPWM_STRIDE 0x00000100U
+#define SIM_CPUTIMER0_BASE 0x00000C00U
+#define SIM_CPUTIMER_STRIDE 0x00000008U
+
+typedef enum {
+    EPWM1,
+    EPWM2,
+    EPWM3,
+    EPWM4,
+    EPWM5,
+    EPWM6,
+    EPWM7,
+    EPWM8,
+    EPWM9,
+    EPWM10,
+    EPWM11,
+    EPWM12
+} EPWM_Module;
+
+typedef enum {
+    EPWM_OUTPUT_NONE,
+    EPWM_OUTPUT_A,
+    EPWM_OUTPUT_B,
+    EPWM_OUTPUT_A_B
+} EPWM_Outputs;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* C interface, for ThreePhaseGen */
+uint32_t HAL_pwmBase(EPWM_Module module);
+void HAL_enablePwm(EPWM_Module module, EPWM_Outputs outputs);
+void HAL_setPwmClockDivider(uint32_t base, uint16_t divider, uint16_t hs_divider);
+void HAL_setPwmPeriod(uint32_t base, uint16_t period);
+uint16_t HAL_getPwmPeriod(uint32_t base);
+void HAL_setPwmCounterMode(uint32_t base, uint16_t mode);
+void HAL_setPwmActionQualifiersA(uint32_t base, uint16_t actions);
+void HAL_writePwmCompareA(uint32_t base, uint16_t value);
+void HAL_enablePwmTimeBaseSync(void);
+uint32_t HAL_cpuTimerBase(uint16_t index);
+void HAL_configCpuTimer(uint32_t base, uint32_t period_count, uint16_t clock_divider);
+void HAL_setCpuTimerInterrupt(uint32_t base, void (*handler)(void));
+uint32_t HAL_readCpuTimer(uint32_t base);
+
+/* C interface, for CPU2's CAN port */
+void HAL_initCan(uint32_t base, uint32_t sysclk, uint32_t bit_rate, uint16_t bit_time);
+void HAL_enableCanLoopback(uint32_t base);
+void HAL_setupCanRxObject(uint32_t base, uint16_t object, uint32_t id, uint32_t mask);
+void HAL_setupCanTxObject(uint32_t base, uint16_t object, uint32_t id, uint16_t bytes);
+void HAL_startCan(uint32_t base, uint32_t sysclk, void (*handler)(void));
+uint16_t HAL_getCanInterruptCause(uint32_t base);
+uint16_t HAL_getCanStatus(uint32_t base);
+uint32_t HAL_getCanTxRequests(uint32_t base);
+void HAL_sendCanMessage(uint32_t base, uint16_t object, uint16_t count, const uint16_t *bytes);
+uint16_t HAL_readCanObject(uint32_t base, uint16_t object, uint32_t *data);
+void HAL_writeCanObjectControl(uint32_t base, uint16_t object, uint16_t control);
+void HAL_acknowledgeCanInterrupt(uint32_t base);
+
+/* C interface, for ThreePhaseGen's FSI port */
+void HAL_initFsi(uint32_t tx_base, uint32_t rx_base, uint16_t prescaler, uint16_t frame_words);
+void HAL_startFsiRxDma(uint32_t dma_base, uint32_t rx_base, volatile uint16_t *ring, uint16_t frames,
+                       uint16_t frame_words);
+uint32_t HAL_getDmaDestinationOffset(uint32_t dma_base, const volatile uint16_t *ring);
+uint16_t HAL_getFsiRxEvents(uint32_t rx_base);
+void HAL_clearFsiRxEvents(uint32_t rx_base, uint16_t events);
+uint32_t HAL_getFsiPingAge(uint32_t rx_base);
+uint16_t HAL_getFsiPingTag(uint32_t rx_base);
+uint16_t HAL_getFsiTxEvents(uint32_t tx_base);
+void HAL_clearFsiTxEvents(uint32_t tx_base, uint16_t events);
+void HAL_sendFsiFrame(uint32_t tx_base, const uint16_t *words, uint16_t count);
+
+#ifdef __cplusplus
+}
+
+#include "sim_peripherals.h"
+
+struct SimHal {
+    static inline SimEpwm &pwm(uint32_t base) { return simPeripherals.epwm[(base - SIM_EPWM1_BASE)/SIM_EPWM_STRIDE]; }
+    static inline SimCpuTimer &cpuTimer(uint32_t base) {
+        return simPeripherals.timer[(base - SIM_CPUTIMER0_BASE)/SIM_CPUTIMER_STRIDE];
+    }
+
+    /*** ePWM ***/
+    static inline uint32_t pwmBase(EPWM_Module module) { return SIM_EPWM1_BASE + module * SIM_EPWM_STRIDE; }
+
+    static inline void enablePwm(EPWM_Module module, EPWM_Outputs outputs) {
+        SimEpwm &p = pwm(pwmBase(module));
+        p.enabled = true;
+        p.outputs = outputs;
+    }
+
+    static inline void setPwmClockDivider(uint32_t base, uint16_t divider, uint16_t hs_divider) {
+        pwm(base).clock_divider = divider;
+        pwm(base).hs_clock_divider = hs_divider;
+    }
+
+    static inline void setPwmPeriod(uint32_t base, uint16_t period) { pwm(base).period = period; }
+    static inline uint16_t getPwmPeriod(uint32_t base) { return pwm(base).period; }
+    static inline void setPwmCounterMode(uint32_t base, uint16_t mode) { pwm(base).counter_mode = mode; }
+    static inline void setPwmActionQualifiersA(uint32_t base, uint16_t actions) { pwm(base).aq_actions_a = actions; }
+
+    static inline void writePwmCompareA(uint32_t base, uint16_t value) { pwm(base).writeCompareA(value); }
+
+    static inline void setDeadBandClock(uint32_t base, bool half_cycle) { pwm(base).db_half_cycle = half_cycle; }
+
+    static inline void setDeadBandMode(uint32_t base, uint16_t polarity, uint16_t output_mode) {
+        pwm(base).db_polarity = polarity;
+        pwm(base).db_output_mode = output_mode;
+    }
+
+    static inline void setDeadBandDelays(uint32_t base, uint16_t rising_count, uint16_t falling_count) {
+        pwm(base).db_rising = rising_count;
+        pwm(base).db_falling = falling_count;
+    }
+
+    static inline void enablePwmAdcTrigger(uint32_t base, uint16_t source, uint16_t prescale) {
+        pwm(base).soca_source = source;
+        pwm(base).soca_prescale = prescale;
+        pwm(base).soca_enabled = true;
+    }
+
+    static inline void enablePwmTimeBaseSync() { simPeripherals.tbclk_sync = true; }
+    static inline void disablePwmTimeBaseSync() { simPeripherals.tbclk_sync = false; }
+
+    /*** CPU timers ***/
+    static inline uint32_t cpuTimerBase(uint16_t index) { return SIM_CPUTIMER0_BASE + index * SIM_CPUTIMER_STRIDE; }
+
+    static inline void configCpuTimer(uint32_t base, uint32_t period_count, uint16_t clock_divider) {
+        SimCpuTimer &t = cpuTimer(base);
+        t.reset();
+        t.period = period_count;
+        t.divider = clock_divider;
+        t.start();
+    }
+
+    static inline void setCpuTimerInterrupt(uint32_t base, void (*handler)(void)) { cpuTimer(base).handler = handler; }
+    static inline uint32_t readCpuTimer(uint32_t base) { return cpuTimer(base).getCounter(); }
+    static inline void acknowledgeInterruptGroup(uint16_t group) { (void)group; simPeripherals.pie_acks++; }
+
+    /*** ADC ***/
+    static inline void powerUpAdc(uint16_t adc) { simPeripherals.adc[adc].powered = true; }
+    static inline void waitAdcPowerUp() {}
+
+    static inline void setupAdcSoc(uint16_t adc, uint16_t soc, uint16_t trigger, uint16_t channel,
+                                   uint32_t acquisition_window) {
+        SimAdc &a = simPeripherals.adc[adc];
+        a.soc_trigger[soc] = trigger;
+        a.soc_channel[soc] = channel;
+        a.soc_window[soc] = acquisition_window;
+    }
+
+    static inline void configAdcInterrupt(uint16_t adc, uint16_t soc) {
+        simPeripherals.adc[adc].int1_soc = soc;
+        simPeripherals.adc[adc].int1_enabled = true;
+    }
+
+    static inline uint16_t readAdcResult(uint16_t adc, uint16_t soc) { return simPeripherals.adc[adc].results[soc]; }
+};
+
+#endif /* __cplusplus */
+
+#endif /* HOSTSIM_INCLUDE_HAL_SIM_H_ */
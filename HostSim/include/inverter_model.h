@@ -0,0 +1,44 @@
+/*
+ * inverter_model.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Three-phase two-level inverter model which turns the gate signals of three simulated ePWM modules
+ *  into leg voltages relative to DC-.
+ *
+ *  - SWITCHING_INVERTER: evaluated every TBCLK from the gate states. While both switches of a leg
+ *    are off (dead time) the current decides which diode conducts: positive current (out of the leg)
+ *    flows through the low side diode, negative current through the high side diode.
+ *  - AVERAGE_INVERTER: the leg voltage averaged over a PWM period, D*Vdc, less the average dead time
+ *    error Vdc*Td/T_pwm*sign(i). Much smoother, for looking at the control dynamics without ripple.
+ *
+ *  Switches are ideal apart from an optional on-state voltage drop.
+ */
+
+#ifndef HOSTSIM_INCLUDE_INVERTER_MODEL_H_
+#define HOSTSIM_INCLUDE_INVERTER_MODEL_H_
+
+#include "sim_peripherals.h"
+
+typedef enum {
+    AVERAGE_INVERTER,
+    SWITCHING_INVERTER
+} InverterMode;
+
+class InverterModel {
+    private:
+        InverterMode mode;
+        double vdc; // DC link voltage (V)
+        double v_drop; // Switch/diode on-state voltage (V)
+
+    public:
+        InverterModel(InverterMode mode, double vdc, double v_drop);
+        void getLegVoltages(SimEpwm *const legs[3], const double i[3], double v_leg[3]) const;
+
+        void setMode(InverterMode new_mode) { mode = new_mode; }
+        void setVdc(double new_vdc) { vdc = new_vdc; }
+        double getVdc() const { return vdc; }
+};
+
+#endif /* HOSTSIM_INCLUDE_INVERTER_MODEL_H_ */
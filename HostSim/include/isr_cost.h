@@ -0,0 +1,33 @@
+/*
+ * isr_cost.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Cost estimate of one current loop sample (CLA Task 1) from operation counts. See counted_float.h.
+ *
+ *  The cycle costs are for the CLA, which runs the loop by default: one cycle per arithmetic
+ *  instruction plus about one for loading its operand, a conditional branch with partly filled delay
+ *  slots per comparison, and the inverse and inverse square root estimates with two Newton-Raphson
+ *  iterations for division and square root. sin/cos are the portable polynomials, which is what the
+ *  CLA runs, so they are counted as ordinary arithmetic. Treat the result as +-30%; the target
+ *  measurement is the reference.
+ */
+
+#ifndef HOSTSIM_INCLUDE_ISR_COST_H_
+#define HOSTSIM_INCLUDE_ISR_COST_H_
+
+#include "counted_float.h"
+
+#define CLA_CYCLES_ADD 2
+#define CLA_CYCLES_MUL 2
+#define CLA_CYCLES_DIV 10
+#define CLA_CYCLES_COMPARE 5
+#define CLA_CYCLES_CONVERT 2
+#define CLA_CYCLES_SQRT 12
+#define CLA_CYCLES_STORE 1
+
+OpCounts SIM_countCurrentLoopOps(bool sensorless); // Worst case sample over a run with rotating currents
+unsigned long SIM_estimateClaCycles(const OpCounts &ops);
+
+#endif /* HOSTSIM_INCLUDE_ISR_COST_H_ */
@@ -0,0 +1,130 @@
+/*
+ * pie_simulator.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Discrete-event simulation of interrupt timing on a C28x, for checking that a mix of ISRs fits
+ *  before flashing it. Time is in SYSCLK cycles and only changes when something happens, so seconds
+ *  of run time take milliseconds.
+ *
+ *  - Priority: CPU interrupts INT1 to INT12 (PIE groups), then INT13 and INT14 (CPU timers 1 and 2,
+ *    which don't go through the PIE). Within a group the lower channel (INTx.1) wins.
+ *  - Nesting: the C28x disables interrupts on ISR entry, so by default an ISR runs to completion.
+ *    An ISR marked 'nesting' re-enables the groups of higher priority than its own after the entry
+ *    (the TRM's software prioritization), so it can be preempted by those. Its own group stays blocked
+ *    by PIEACK until it returns. Setting nest_ier instead re-enables exactly those CPU interrupts, e.g. a
+ *    lower priority FIFO interrupt that can't wait for a long ISR to finish.
+ *  - Cost: each ISR takes the clock profile's entry cycles (context save), then a cost drawn uniformly
+ *    from [cycles_min, cycles_max] (or always cycles_max in worst case mode), then the exit cycles.
+ *    PIE_loadCycleProfile() reads the costs from a file of profiling results.
+ *  - Sources: periodic (period and phase) or random events (exponential intervals with a minimum
+ *    spacing, e.g. bytes at a baud rate). A source triggering while its flag is still set loses an
+ *    interrupt, which is counted as an overrun.
+ *
+ *  Latency is from the trigger to the first instruction of the ISR body (after the entry cycles),
+ *  jitter is the spread of the latency.
+ */
+
+#ifndef HOSTSIM_INCLUDE_PIE_SIMULATOR_H_
+#define HOSTSIM_INCLUDE_PIE_SIMULATOR_H_
+
+#include <stdint.h>
+#include <vector>
+#include <string>
+#include <random>
+
+#define PIE_CPU_TIMER1_INT 13 // CPU interrupt of CPU timer 1
+#define PIE_CPU_TIMER2_INT 14 // CPU interrupt of CPU timer 2
+
+typedef struct {
+    const char *name;
+    double sysclk_Hz;
+    uint32_t entry_cycles; // Trigger to first ISR instruction with the CPU idle (hardware context save and vector fetch)
+    uint32_t exit_cycles; // Context restore and IRET
+} PieClockProfile;
+
+typedef enum {
+    PIE_SOURCE_PERIODIC,
+    PIE_SOURCE_RANDOM
+} PieSourceType;
+
+typedef struct {
+    std::string name; // Matched against the names in cycle profiles
+    uint16_t cpu_interrupt; // 1 to 12 for PIE groups, PIE_CPU_TIMER1_INT or PIE_CPU_TIMER2_INT
+    uint16_t channel; // PIE channel 1 to 16 (INTx.y); unused for INT13/INT14
+    PieSourceType type;
+    double period_s; // Periodic: trigger period. Random: mean time between events.
+    double phase_s; // Periodic: first trigger. Random: minimum time between events.
+    uint32_t cycles_min; // ISR body cost (SYSCLK cycles)
+    uint32_t cycles_max;
+    bool nesting; // Re-enables higher priority groups after entry
+    uint16_t nest_ier; // With nesting, the CPU interrupts re-enabled instead (IER: bit n-1 for INTn), or 0
+    double deadline_s; // Worst latency allowed, or 0 for half the period (sil_bench's rule)
+} PieIsrSource;
+
+typedef struct {
+    unsigned long triggers;
+    unsigned long serviced;
+    unsigned long overruns; // Triggers lost because the previous one hadn't been serviced
+    uint64_t latency_min; // Cycles
+    uint64_t latency_max;
+    uint64_t latency_sum;
+    uint64_t response_max; // Trigger to return from the ISR (cycles)
+    uint64_t busy_cycles; // Time spent in this ISR, excluding ISRs nested in it
+} PieIsrStats;
+
+class PieSimulator {
+    private:
+        typedef struct {
+            size_t source;
+            uint64_t trigger_time;
+            uint64_t total_cycles;
+            uint64_t remaining;
+        } Frame;
+
+        PieClockProfile clock;
+        bool worst_case;
+        std::vector<PieIsrSource> sources;
+        std::vector<PieIsrStats> stats;
+        std::vector<uint64_t> next_trigger;
+        std::vector<uint64_t> pending_since;
+        std::vector<bool> pending;
+        std::vector<Frame> stack; // Running ISRs, innermost last
+        uint64_t now;
+        uint64_t duration;
+        std::mt19937 rng;
+
+        uint64_t cycles(double seconds) const { return (uint64_t)(seconds*clock.sysclk_Hz + 0.5); }
+        uint64_t nextInterval(size_t k);
+        bool isHigherPriority(size_t a, size_t b) const;
+        bool canPreempt(size_t k) const;
+        bool dispatch();
+
+    public:
+        PieSimulator(const PieClockProfile &clock, bool worst_case, unsigned seed);
+        size_t addSource(const PieIsrSource &source);
+        bool setCost(const std::string &name, uint32_t cycles_min, uint32_t cycles_max); // False if no such source
+        void run(double duration_s);
+
+        size_t getSourceCount() const { return sources.size(); }
+        const PieIsrSource &getSource(size_t k) const { return sources[k]; }
+        const PieIsrStats &getStats(size_t k) const { return stats[k]; }
+        const PieClockProfile &getClock() const { return clock; }
+
+        double worstLatencyUs(size_t k) const;
+        double jitterUs(size_t k) const;
+        double loadPct(size_t k) const;
+        double totalLoadPct() const;
+};
+
+PieIsrSource PIE_periodicSource(const char *name, uint16_t cpu_interrupt, uint16_t channel, double frequency_Hz);
+PieIsrSource PIE_randomSource(const char *name, uint16_t cpu_interrupt, uint16_t channel, double mean_rate_Hz,
+                              double max_rate_Hz);
+
+/* Reads ISR costs from a profile: one "name cycles_min cycles_max source" per line, '#' starts a comment.
+ * Returns the number of costs applied, or -1 if the file can't be read, and counts those whose source isn't
+ * "measured" (an estimate, a budget or none) in *unmeasured. */
+int PIE_loadCycleProfile(const char *path, PieSimulator &sim, int *unmeasured);
+
+#endif /* HOSTSIM_INCLUDE_PIE_SIMULATOR_H_ */
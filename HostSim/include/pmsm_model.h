@@ -0,0 +1,62 @@
+/*
+ * pmsm_model.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Discrete-time PMSM model in the rotor (dq) frame with a mechanical load, for running the
+ *  control code on a host PC.
+ *
+ *  Electrical:  Ld did/dt = vd - Rs*id + we*Lq*iq
+ *               Lq diq/dt = vq - Rs*iq - we*(Ld*id + flux)
+ *  Mechanical:  J dwm/dt = Te - T_load - B*wm,  Te = 1.5*p*(flux*iq + (Ld - Lq)*id*iq)
+ *
+ *  The inputs are the three inverter leg (pole) voltages relative to DC-. The star point floats,
+ *  so the common mode part is removed before the Clarke transform.
+ *  Integration is forward Euler, so the step should be much smaller than L/R (the simulation uses
+ *  one ePWM TBCLK period).
+ */
+
+#ifndef HOSTSIM_INCLUDE_PMSM_MODEL_H_
+#define HOSTSIM_INCLUDE_PMSM_MODEL_H_
+
+typedef struct {
+    double Rs; // Stator resistance (ohm)
+    double Ld; // d-axis inductance (H)
+    double Lq; // q-axis inductance (H)
+    double flux; // Permanent magnet flux linkage (Wb)
+    int pole_pairs;
+    double J; // Rotor plus load inertia (kg m^2)
+    double B; // Viscous friction (Nm s/rad)
+} PmsmParameters;
+
+class PmsmModel {
+    private:
+        PmsmParameters params;
+
+        // State
+        double id, iq; // (A)
+        double omega_m; // Mechanical speed (rad/s)
+        double theta_e; // Electrical angle (rad, 0 to 2*pi)
+
+        // Load
+        double load_torque; // (Nm)
+        bool speed_held; // Speed fixed by an ideal dynamometer, the mechanical equation is ignored
+
+    public:
+        PmsmModel(const PmsmParameters &params);
+        void step(const double v_leg[3], double dt);
+
+        void setLoadTorque(double torque) { load_torque = torque; }
+        void holdSpeed(double omega_e); // Fixes the electrical speed (rad/s)
+        void releaseSpeed() { speed_held = false; }
+
+        void getPhaseCurrents(double i[3]) const;
+        double getId() const { return id; }
+        double getIq() const { return iq; }
+        double getTorque() const;
+        double getOmegaElectrical() const { return omega_m * params.pole_pairs; }
+        double getThetaElectrical() const { return theta_e; } // (rad)
+};
+
+#endif /* HOSTSIM_INCLUDE_PMSM_MODEL_H_ */
@@ -0,0 +1,60 @@
+/*
+ * pwm_timeline.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Steps a SimEpwm and records what it did, one TBCLK at a time:
+ *  - every edge of EPWMxA and EPWMxB
+ *  - every CMPA write (from the code under test, between ticks) and the shadow load that applied it
+ *
+ *  The measurements are in whole TBCLKs, so duty cycle, dead time and update latency can be checked
+ *  exactly against the register values.
+ */
+
+#ifndef HOSTSIM_INCLUDE_PWM_TIMELINE_H_
+#define HOSTSIM_INCLUDE_PWM_TIMELINE_H_
+
+#include "sim_peripherals.h"
+#include <vector>
+
+#define SIM_PWM_OUTPUT_A 0
+#define SIM_PWM_OUTPUT_B 1
+
+typedef struct {
+    unsigned long tick; // TBCLK at which the output changed
+    uint16_t output; // SIM_PWM_OUTPUT_A or SIM_PWM_OUTPUT_B
+    bool level;
+} SimPwmEdge;
+
+typedef struct {
+    unsigned long write_tick; // Last TBCLK before the write
+    unsigned long load_tick; // TBCLK at which it became active
+} SimCompareUpdate;
+
+class PwmTimeline {
+    private:
+        SimEpwm *pwm;
+        std::vector<SimPwmEdge> edges;
+        std::vector<SimCompareUpdate> updates;
+        bool level[2];
+        bool start_level[2]; // Output levels when the recording started
+        unsigned long compare_writes;
+        bool update_pending;
+
+    public:
+        PwmTimeline(SimEpwm *pwm);
+        void clear(); // Forgets the recorded history, keeps the module state
+        bool tick(); // Steps the module one TBCLK. Returns true on SOCA.
+        void run(unsigned long ticks);
+
+        const std::vector<SimPwmEdge> &getEdges() const { return edges; }
+        const std::vector<SimCompareUpdate> &getUpdates() const { return updates; }
+        unsigned long getTick() const { return pwm->getTicks(); }
+
+        unsigned long highTicks(uint16_t output, unsigned long from, unsigned long to) const; // TBCLKs high in [from, to)
+        bool deadTimes(unsigned long from, unsigned long to, unsigned long *min_ticks, unsigned long *max_ticks) const;
+        bool overlap(unsigned long from, unsigned long to) const; // True if A and B were ever high together
+};
+
+#endif /* HOSTSIM_INCLUDE_PWM_TIMELINE_H_ */
@@ -0,0 +1,85 @@
+/*
+ * sil_bench.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  What the benchmarks share. Each bench is in its own source/bench_x.cpp, and main() in sil_bench.cpp runs
+ *  them in order (see there for what each checks).
+ *
+ *  ThreePhaseGen is C built with its own hal.h (libthreephasegen.a), so its header can't be included by the
+ *  benches: its interface and settings are mirrored here, as are the settings of other firmware files the
+ *  benches don't build.
+ */
+
+#ifndef HOSTSIM_INCLUDE_SIL_BENCH_H_
+#define HOSTSIM_INCLUDE_SIL_BENCH_H_
+
+#include "clock_config.h"
+#include <stdint.h>
+#include <vector>
+
+extern "C" void ConfigThreePhaseGen(void);
+extern "C" void updateDutyCycles(void);
+extern "C" bool TPG_setFrequency(float frequency);
+extern "C" bool TPG_setFrequencyAt(float frequency, uint32_t start);
+extern "C" volatile uint32_t tpgVersion;
+extern "C" volatile uint32_t tpgSample;
+extern "C" volatile uint32_t tpgSampleTicks;
+typedef struct { // TPG_Parameters in threephasegen.h
+    float frequency;
+    uint32_t phase_step;
+    uint32_t version;
+    uint32_t start;
+} TpgParameters;
+extern "C" const TpgParameters *volatile tpgInUse;
+#define TPG_SINUSOID_FREQUENCY 50 // SINUSOID_FREQUENCY in threephasegen.h
+#define TPG_EPWM_PHASE_A 3 // EPWM4
+#define TPG_SAMPLING_FREQUENCY 50000 // SAMPLING_FREQUENCY in threephasegen.h
+#define TPG_SYSCLK_HZ 25000000.0 // PLLSYSCLK in ThreePhaseGen/system_config/clock_config.h
+#define TPG_TIMESTAMP_TIMER 2 // TIMESTAMP_TIMER in threephasegen.h
+#define FSI_BIT_RATE 50e6 // FSI_PORT_BIT_RATE in ThreePhaseGen/fsi_port.h
+#define LED_TOGGLE_FREQUENCY_HZ 1 // LED_TOGGLE_FREQUENCY in led_blink.h
+#define TPG_SCI_BAUD 115200 // ThreePhaseGen's command link
+#define COMMS_SCI_BAUD (LSPCLK/16) // SCI_PORT_BAUD in CPU2_Communication/sci_port.h
+#define COMMS_SCI_RX_FIFO_LEVEL 8 // SCI_RX_FIFO_LEVEL in sci_port.h
+#define COMMS_SCI_TX_FIFO_LEVEL 6 // SCI_TX_FIFO_LEVEL in sci_port.h
+#define COMMS_SCI_FIFO_DEPTH 16
+#define COMMS_POLL_FREQUENCY 1000 // In CPU2_Communication/comms.h
+#define COMMS_MAX_FRAME_WORDS 32 // In comms.h
+#define CAN_MASTER_FREQUENCY 1000 // SYNC cycle of the bench's CAN bus master (Hz)
+#define CAN_DATA_FRAME_US 111.0 // An 8 byte frame at 1 Mbit/s without stuff bits
+#define ENCODER_COUNTS_PER_REV 4000 // 4*ENCODER_LINES in CPU1 peripherals/include/encoder.h
+#define ENCODER_UNIT_FREQUENCY_HZ 1000 // ENCODER_UNIT_FREQUENCY in encoder.h
+#define ENCODER_CAPTURE_TICK_S (64/25e6) // ENCODER_CAPTURE_PRESCALE in encoder.h, at PLLSYSCLK = 25MHz
+
+/* Prints a result and checks it against its limits. main()'s exit code counts the failures. */
+void report(const char *name, double value, double min, double max, const char *unit);
+
+double wrapRadians(double x);
+
+/* Fourier coefficient of a signal at the given harmonic of its period */
+void fourier(const std::vector<double> &x, int harmonic, double *magnitude, double *phase);
+
+void benchCurrentStep(); // bench_current_loop.cpp
+void benchRipple();
+void benchSensorless();
+void benchIsr();
+void benchEncoder(); // bench_encoder.cpp
+void benchPwm(); // bench_pwm.cpp
+void benchPie(); // bench_pie.cpp
+void benchThreePhaseGen(); // bench_threephasegen.cpp
+void benchIpc(); // bench_ipc.cpp
+void benchFrames(); // bench_frames.cpp
+void benchMotion(); // bench_motion.cpp
+void benchBoot(); // bench_boot.cpp
+void benchSerial(); // bench_serial.cpp
+void benchScope(); // bench_scope.cpp
+void benchCapture(); // bench_capture.cpp
+void benchCommand(); // bench_command.cpp
+void benchParams(); // bench_params.cpp
+void benchSnapshot(); // bench_snapshot.cpp
+void benchCan(); // bench_can.cpp
+void benchFsi(); // bench_fsi.cpp
+
+#endif /* HOSTSIM_INCLUDE_SIL_BENCH_H_ */
@@ -0,0 +1,80 @@
+/*
+ * sil_simulation.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Software-in-the-loop simulation of the CPU1 current loop. The peripherals are configured by the
+ *  firmware's own ConfigPwm() and ConfigAdcs() on the simulated HAL (hal_sim.h). The plant (PMSM,
+ *  inverter, ADC front end) runs in steps of one TBCLK alongside the simulated ePWMs, and when EPWM1
+ *  SOCA converts the ADC SOCs and ADCA INT1 fires, the real control code (CLA_runCurrentLoopSample()
+ *  from cla_shared.h, i.e. what CLA Task 1 runs) is called on the result registers. Its compare values
+ *  go to phaseA/B/C through setCompare() and take effect at the next counter zero through the CMPA
+ *  shadow register. This matches the hardware as long as the task finishes within half a PWM period;
+ *  the conversion and task time are not modelled.
+ *
+ *  The control state is public so tests can set references and read telemetry between samples,
+ *  the same way the C28x uses claParams and claTelemetry.
+ */
+
+#ifndef HOSTSIM_INCLUDE_SIL_SIMULATION_H_
+#define HOSTSIM_INCLUDE_SIL_SIMULATION_H_
+
+#include "pmsm_model.h"
+#include "inverter_model.h"
+#include "adc_model.h"
+#include "sim_peripherals.h"
+#include "foc.h"
+#include "cla_shared.h"
+
+/* Running mean, RMS deviation and range of a signal */
+class SimStatistics {
+    private:
+        double sum, sum_sq, min_value, max_value;
+        unsigned long n;
+
+    public:
+        SimStatistics() { reset(); }
+        void reset();
+        void add(double x);
+        double mean() const { return n ? sum/n : 0.0; }
+        double rmsDeviation() const; // RMS of the signal minus its mean
+        double peakToPeak() const { return n ? max_value - min_value : 0.0; }
+};
+
+class SilSimulation {
+    private:
+        SimEpwm *legs[3]; // EPWM1 to EPWM3
+        InverterModel inverter;
+        AdcModel adc;
+        PmsmModel motor;
+        double time; // (s)
+        double dt; // One TBCLK (s)
+
+        void tick();
+        void currentLoopSample();
+
+    public:
+        // Control state, the same variables as CLA Task 1 uses
+        FOC_CurrentLoop loop;
+        OBS_Sensorless observer;
+        CLA_CurrentLoopParams params;
+        CLA_CurrentLoopTelemetry telemetry;
+
+        // The plant's dq currents (in the real rotor frame) every TBCLK
+        SimStatistics id_stats;
+        SimStatistics iq_stats;
+
+        SilSimulation(const PmsmParameters &motor_params, InverterMode mode, double vdc, double adc_noise_lsb);
+        void runSample(); // Runs until just after the next current loop sample
+        void run(double duration_s);
+
+        PmsmModel &getMotor() { return motor; }
+        InverterModel &getInverter() { return inverter; }
+        double getTime() const { return time; }
+        double getSamplePeriod() const; // Actual period between current loop samples (s)
+};
+
+PmsmParameters SIM_defaultMotor(); // Motor with the parameters in foc.h
+
+#endif /* HOSTSIM_INCLUDE_SIL_SIMULATION_H_ */
@@ -0,0 +1,158 @@
+/*
+ * sim_peripherals.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Simulated ePWM, CPU timer and ADC modules. The firmware configures them through SimHal (hal_sim.h)
+ *  exactly as it configures the real ones through RegisterHal, and the simulation steps them:
+ *  - SimEpwm: cycle-level model of one ePWM module stepped one TBCLK at a time. Time base counter
+ *    (up, down or up-down), CMPA shadow register with the load events (or immediate), action qualifier
+ *    for outputs A and B with the TRM event priorities, dead band (RED/FED, polarity, output mode,
+ *    half cycle clocking) and SOCA with the event prescaler. PwmTimeline (pwm_timeline.h) records
+ *    the output edges.
+ *  - SimCpuTimer: down counter with prescaler stepped one SYSCLK at a time, calls its interrupt handler.
+ *  - SimAdc: SOC configuration and result registers. Triggered SOCs convert the voltages the simulation
+ *    puts on the pins through an AdcModel.
+ *
+ *  - CAN-B: the DCAN and bus model (can_sim.h) a bench attaches for CPU2's CAN port.
+ *  - FSIA: the link model (fsi_sim.h) a bench attaches for ThreePhaseGen's FSI port.
+ *
+ *  There is one set of peripherals (simPeripherals), like on the device. reset() it between simulations.
+ */
+
+#ifndef HOSTSIM_INCLUDE_SIM_PERIPHERALS_H_
+#define HOSTSIM_INCLUDE_SIM_PERIPHERALS_H_
+
+#include <stdint.h>
+#include "adc_model.h"
+
+class SimCan;
+class SimFsiLink;
+
+#define SIM_EPWM_MODULES 12
+#define SIM_CPU_TIMERS 3
+#define SIM_ADC_MODULES 4
+#define SIM_ADC_SOCS 16
+#define SIM_ADC_CHANNELS 16
+
+// Action qualifier events (shift of the 2-bit action in AQCTLx)
+#define SIM_AQ_ZERO 0
+#define SIM_AQ_PERIOD 2
+#define SIM_AQ_UP_CMPA 4
+#define SIM_AQ_DOWN_CMPA 6
+
+// CMPA shadow load events (CMPCTL.LOADAMODE)
+#define SIM_CMPA_LOAD_ZERO 0
+#define SIM_CMPA_LOAD_PERIOD 1
+#define SIM_CMPA_LOAD_ZERO_OR_PERIOD 2
+
+class SimEpwm {
+    private:
+        uint16_t counter;
+        bool counting_up;
+        uint16_t cmpa_active;
+        bool aq_a, aq_b; // Action qualifier outputs, before the dead band
+        uint16_t edge_age; // TBCLKs since aq_a last changed (saturates)
+        bool output_a, output_b; // EPWMxA and EPWMxB, after the dead band
+        uint16_t soc_events;
+        unsigned long ticks;
+        unsigned long load_tick; // Tick of the last shadow to active CMPA load
+
+        bool applyAction(bool output, uint16_t aqctl, const uint16_t *events, int n_events, bool zero, bool top,
+                         bool cmpa_up, bool cmpa_down) const;
+        uint16_t delayTicks(uint16_t count) const;
+
+    public:
+        // Registers, as written through the HAL
+        bool enabled;
+        uint16_t outputs; // EPWM_Outputs
+        uint16_t clock_divider; // TBCTL.CLKDIV encoding
+        uint16_t hs_clock_divider; // TBCTL.HSPCLKDIV encoding
+        uint16_t period; // TBPRD
+        uint16_t counter_mode; // TBCTL.CTRMODE encoding
+        uint16_t aq_actions_a; // AQCTLA
+        uint16_t aq_actions_b; // AQCTLB
+        uint16_t cmpa; // CMPA shadow register
+        bool cmpa_immediate; // CMPCTL.SHDWAMODE: writes go straight to the active register
+        uint16_t cmpa_load_mode; // CMPCTL.LOADAMODE
+        bool db_half_cycle; // DBCTL.HALFCYCLE
+        uint16_t db_polarity; // DBCTL.POLSEL
+        uint16_t db_output_mode; // DBCTL.OUT_MODE
+        uint16_t db_rising; // DBRED
+        uint16_t db_falling; // DBFED
+        bool soca_enabled;
+        uint16_t soca_source;
+        uint16_t soca_prescale;
+        unsigned long compare_writes;
+
+        SimEpwm() { reset(); }
+        void reset();
+        bool tick(); // Advances one TBCLK. Returns true if SOCA was generated.
+        void writeCompareA(uint16_t value);
+
+        double getTbclkHz(double sysclk_Hz) const;
+        bool getOutputA() const { return output_a; }
+        bool getOutputB() const { return output_b; }
+        bool isHighSideOn() const { return output_a; }
+        bool isLowSideOn() const { return output_b; }
+        uint16_t risingDelay() const; // TBCLKs from EPWMxA input rising to EPWMxA rising
+        uint16_t fallingDelay() const; // TBCLKs from EPWMxA input falling to EPWMxB rising
+        uint16_t getActiveCompare() const { return cmpa_active; }
+        uint16_t getCounter() const { return counter; }
+        unsigned long getTicks() const { return ticks; } // TBCLKs since reset
+        unsigned long getLoadTick() const { return load_tick; }
+        uint32_t getPeriodCounts() const; // TBCLKs per PWM period
+        double getDutyCycle() const; // Fraction of the period output A is high for HalfBridgePWM's action qualifiers, from the active CMPA
+};
+
+class SimCpuTimer {
+    private:
+        uint32_t counter;
+        uint16_t prescale_counter;
+
+    public:
+        uint32_t period; // PRD
+        uint16_t divider; // Prescaler (TDDR + 1)
+        bool running;
+        void (*handler)(void);
+        unsigned long interrupts;
+
+        SimCpuTimer() { reset(); }
+        void reset();
+        void start(); // Reloads the counter from the period and starts counting
+        bool tick(); // Advances one SYSCLK. Calls the handler and returns true when the counter wraps.
+        uint32_t getCounter() const { return counter; } // TIM
+};
+
+class SimAdc {
+    public:
+        bool powered;
+        uint16_t soc_trigger[SIM_ADC_SOCS];
+        uint16_t soc_channel[SIM_ADC_SOCS];
+        uint32_t soc_window[SIM_ADC_SOCS];
+        uint16_t results[SIM_ADC_SOCS];
+        bool int1_enabled;
+        uint16_t int1_soc; // INT1 fires at the end of this SOC's conversion
+        double pin_voltage[SIM_ADC_CHANNELS]; // Set by the simulation
+
+        SimAdc() { reset(); }
+        void reset();
+        bool trigger(uint16_t trigger_source, AdcModel &model); // Converts the SOCs on this trigger. Returns true for INT1.
+};
+
+struct SimPeripherals {
+    SimEpwm epwm[SIM_EPWM_MODULES];
+    SimCpuTimer timer[SIM_CPU_TIMERS];
+    SimAdc adc[SIM_ADC_MODULES];
+    bool tbclk_sync; // Time base clocks enabled
+    unsigned long pie_acks;
+    SimCan *can; // Attached by the bench, 0 without one
+    SimFsiLink *fsi; // The same
+
+    void reset();
+};
+
+extern SimPeripherals simPeripherals;
+
+#endif /* HOSTSIM_INCLUDE_SIM_PERIPHERALS_H_ */
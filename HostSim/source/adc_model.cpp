@@ -0,0 +1,37 @@
+/*
+ * adc_model.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ */
+
+#include "adc_model.h"
+#include "adc_channels.h"
+#include <math.h>
+
+AdcModel::AdcModel(double noise_lsb, unsigned seed) : rng(seed), noise(0.0, 1.0) {
+    this->noise_lsb = noise_lsb;
+}
+
+uint16_t AdcModel::convert(double volts) {
+    double counts = volts/SIM_ADC_VREF*SIM_ADC_FULL_SCALE_COUNTS;
+    if (noise_lsb > 0.0) {
+        counts += noise_lsb*noise(rng);
+    }
+    counts = floor(counts + 0.5);
+    if (counts < 0.0) {
+        return 0;
+    }
+    if (counts > SIM_ADC_FULL_SCALE_COUNTS - 1) {
+        return SIM_ADC_FULL_SCALE_COUNTS - 1;
+    }
+    return (uint16_t)counts;
+}
+
+uint16_t AdcModel::convertCurrent(double amps) {
+    return convert(CURRENT_SENSE_OFFSET_V + amps/CURRENT_SENSE_A_PER_V);
+}
+
+uint16_t AdcModel::convertVdc(double volts) {
+    return convert(volts/VDC_SENSE_DIVIDER);
+}
@@ -0,0 +1,101 @@
+/*
+ * bench_boot.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Bench "boot": the dual-core boot sequence and its timeline.
+ */
+
+#include "sil_bench.h"
+#include "sil_simulation.h"
+#include "pwm.h"
+#include "boot_sync.h"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+/* One step of the boot timeline (profiles/boot_steps_us.txt) */
+struct BootStep {
+    char cpu[8];
+    char name[32];
+    double us;
+};
+
+static std::vector<BootStep> loadBootSteps(const char *path) {
+    std::vector<BootStep> steps;
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return steps;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        char *comment = strchr(line, '#');
+        if (comment) {
+            *comment = '\0';
+        }
+        BootStep step;
+        if (sscanf(line, "%7s %31s %lf", step.cpu, step.name, &step.us) == 3) {
+            steps.push_back(step);
+        }
+    }
+    fclose(f);
+    return steps;
+}
+
+void benchBoot() {
+    // PWM gate. ConfigPwm() leaves the time base stopped, so the gate drivers see no edge and the current
+    // loop takes no sample until StartPwm().
+    {
+        SilSimulation sim(SIM_defaultMotor(), AVERAGE_INVERTER, 24.0, 0.0);
+        ConfigPwm(); // Back to the state after configuration, before the rendezvous
+        uint32_t samples = sim.telemetry.sample_count;
+        uint16_t counter = simPeripherals.epwm[PHASE_A_PWM].getCounter();
+        sim.run(1e-3);
+        bool held = sim.telemetry.sample_count == samples && simPeripherals.epwm[PHASE_A_PWM].getCounter() == counter;
+        report("boot.pwm_held_until_start", held, 1.0, 1.0, "");
+
+        StartPwm();
+        sim.run(1e-3);
+        bool in_step = simPeripherals.epwm[PHASE_A_PWM].getCounter() == simPeripherals.epwm[PHASE_B_PWM].getCounter()
+                && simPeripherals.epwm[PHASE_A_PWM].getCounter() == simPeripherals.epwm[PHASE_C_PWM].getCounter();
+        report("boot.samples_after_start", sim.telemetry.sample_count - samples, 1.0, 1e9, "");
+        report("boot.counters_in_step", in_step, 1.0, 1.0, "");
+    }
+
+    // Timeline. CPU2 starts when CPU1 finishes release_cpu2 and both wait for each other before start_pwm.
+    // Serially, CPU2 would only be released once CPU1 had finished its own initialisation.
+    std::vector<BootStep> steps = loadBootSteps("profiles/boot_steps_us.txt");
+    double cpu1_init = 0.0, cpu2_init = 0.0, released = -1.0, start_pwm = 0.0;
+    for (size_t k = 0; k < steps.size(); k++) {
+        if (!strcmp(steps[k].cpu, "cpu2")) {
+            cpu2_init += steps[k].us;
+        }
+        else if (!strcmp(steps[k].name, "start_pwm")) {
+            start_pwm = steps[k].us;
+        }
+        else {
+            cpu1_init += steps[k].us;
+            if (!strcmp(steps[k].name, "release_cpu2")) {
+                released = cpu1_init;
+            }
+        }
+    }
+    report("boot.profile_steps", (double)steps.size(), 3.0, 100.0, "");
+    report("boot.profile_has_release", released >= 0.0, 1.0, 1.0, "");
+
+    double cpu2_ready = released + cpu2_init;
+    double parallel = (cpu1_init > cpu2_ready ? cpu1_init : cpu2_ready) + start_pwm;
+    double serial = cpu1_init + cpu2_init + start_pwm;
+    printf("%-34s %12.4g %-8s\n", "boot.cpu1_ready", cpu1_init, "us");
+    printf("%-34s %12.4g %-8s\n", "boot.cpu2_ready", cpu2_ready, "us");
+    printf("%-34s %12.4g %-8s\n", "boot.serial_time_to_pwm", serial, "us");
+    report("boot.time_to_pwm", parallel, 0.0, serial - cpu2_init, "us"); // CPU2's boot fully hidden
+    report("boot.saved_pct", 100.0*(serial - parallel)/serial, 0.0, 100.0, "%");
+
+    // The report's conversion from IPC counter stamps: the reset clock up to the PLL lock, PLLSYSCLK after
+    BOOT_Report r;
+    r.pll_locked = (uint32_t)(1000e-6*BOOT_RESET_SYSCLK_HZ); // 1 ms at the reset clock
+    r.first_pwm = r.pll_locked + (uint32_t)(2000e-6*PLLSYSCLK); // 2 ms at PLLSYSCLK
+    report("boot.report_conversion_us", BOOT_microseconds(&r, r.first_pwm), 2999.0, 3001.0, "us");
+}
@@ -0,0 +1,333 @@
+/*
+ * bench_can.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Bench "can": CPU2's CAN port (can_port.c, in libcpu2_communication.a) on a simulated DCAN and bus. The
+ *  bench plays the PIE and the motion ISR: it runs canRxISR() while an object is pending, and the port's
+ *  calls every control period.
+ */
+
+#include "sil_bench.h"
+#include "motion_control.h"
+#include "can_port.h"
+#include "can_sim.h"
+#include "sim_peripherals.h"
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+static SimCanFrame canFrame(uint32_t id, const uint16_t *bytes, uint16_t dlc) {
+    SimCanFrame frame = {};
+    frame.id = id;
+    frame.dlc = dlc;
+    for (uint16_t k = 0; k < dlc; k++) {
+        frame.bytes[k] = bytes[k];
+    }
+    return frame;
+}
+
+static SimCanFrame canSetpointFrame(uint16_t node, uint16_t mode, uint16_t sequence, float target) {
+    CANP_Setpoint setpoint = {mode, (uint16_t)(sequence & 0xFFU), target};
+    uint16_t bytes[CANP_FRAME_BYTES];
+    CANP_encodeSetpoint(&setpoint, bytes);
+    return canFrame(CANP_ID_SETPOINT(node), bytes, CANP_FRAME_BYTES);
+}
+
+/* What the drive saw: setpoints and SYNCs received, and what each control period did */
+typedef struct {
+    double time_s;
+    uint16_t what; // CANP_x from CANP_receive(), or the due mask of a period
+    uint16_t sequence; // Of a setpoint received or applied
+    bool applied;
+} CanEvent;
+
+typedef struct {
+    SimCan *can;
+    double period_s;
+    double next_period_s;
+    std::vector<CanEvent> received;
+    std::vector<CanEvent> periods;
+    unsigned long interrupts;
+} CanDrive;
+
+/* canRxISR() until nothing is pending, as the PIE takes it again after each acknowledge. Records what the
+ * next period will make of each frame it put in the ring. */
+static void serviceCanInterrupts(CanDrive *d) {
+    while (d->can->interruptCause() != 0) {
+        uint16_t head = canService.head;
+        canRxISR();
+        d->interrupts++;
+
+        CanEvent event = {d->can->now(), CANP_IGNORED, 0, false};
+        if (canService.head != head) {
+            const CANP_Frame *frame = &canService.frames[head & (CANP_RX_RING_SIZE - 1U)];
+            CANP_Setpoint setpoint;
+            event.what = frame->object == CANP_OBJECT_SYNC ? CANP_SYNC
+                         : CANP_decodeSetpoint(frame, &setpoint) ? CANP_SETPOINT : CANP_REFUSED;
+            event.sequence = (uint16_t)(frame->data[0] >> 8) & 0xFFU; // Byte 1
+        }
+        d->received.push_back(event);
+    }
+}
+
+/* Runs the bus and CPU2 to until_s: the receive interrupt at the end of each frame, and every control period
+ * what motionTimerISR does with the port. The status reports the period's number as its position. */
+static void runCanDrive(CanDrive *d, double until_s) {
+    while (d->next_period_s < until_s) {
+        while (d->can->nextFrame(d->next_period_s)) {
+            serviceCanInterrupts(d);
+        }
+        CANP_Setpoint setpoint;
+        uint16_t due;
+        CanEvent event = {d->next_period_s, 0, 0, false};
+        event.applied = CANPORT_startPeriod(&setpoint, &due);
+        event.what = due;
+        event.sequence = event.applied ? setpoint.sequence : 0;
+        d->periods.push_back(event);
+
+        CANP_Status status = {(float)d->periods.size(), 0.0f, 0.0f, 0};
+        CANPORT_sendStatus(due, &status);
+        d->next_period_s += d->period_s;
+    }
+    while (d->can->nextFrame(until_s)) {
+        serviceCanInterrupts(d);
+    }
+}
+
+/* CANPORT_init() on a new bus, with the latching the case wants. The library is built with CAN_PORT_LOOPBACK
+ * for CANPORT_inject(), so the module is taken back out of loopback unless the case is about it. */
+static void initCanDrive(CanDrive *d, SimCan *can, uint16_t latch_mode, double phase_s, bool loopback) {
+    can->reset();
+    simPeripherals.can = can;
+    CANPORT_init();
+    can->setLoopback(loopback);
+    canService.latch_mode = latch_mode;
+    d->can = can;
+    d->period_s = 1.0/MOTION_CONTROL_FREQUENCY;
+    d->next_period_s = phase_s;
+    d->received.clear();
+    d->periods.clear();
+    d->interrupts = 0;
+}
+
+/* Checks each setpoint a period applied against the setpoints and SYNCs before it: the latest setpoint
+ * received (before the latest SYNC, when latching on SYNC), taken by the first period after it was latched.
+ * Returns the errors and the longest time from being latched to being applied. */
+static unsigned long checkCanLatching(const CanDrive &d, bool on_sync, double *max_delay_s) {
+    unsigned long errors = 0;
+    size_t r = 0;
+    bool have_latched = false, have_pending = false, taken = true;
+    uint16_t latched = 0, pending = 0;
+    double latched_s = 0.0;
+    *max_delay_s = 0.0;
+    for (const CanEvent &period : d.periods) {
+        for (; r < d.received.size() && d.received[r].time_s <= period.time_s; r++) {
+            const CanEvent &e = d.received[r];
+            if (e.what == CANP_SETPOINT && !on_sync) {
+                have_latched = true;
+                latched = e.sequence;
+                latched_s = e.time_s;
+                taken = false;
+            }
+            else if (e.what == CANP_SETPOINT) {
+                have_pending = true;
+                pending = e.sequence;
+            }
+            else if (e.what == CANP_SYNC && have_pending) {
+                have_latched = true;
+                latched = pending;
+                latched_s = e.time_s;
+                have_pending = false;
+                taken = false;
+            }
+        }
+        if (period.applied != (have_latched && !taken) || (period.applied && period.sequence != latched)) {
+            errors++;
+        }
+        if (period.applied) {
+            taken = true;
+            *max_delay_s = std::max(*max_delay_s, period.time_s - latched_s);
+        }
+    }
+    return errors;
+}
+
+void benchCan() {
+    SimCan can(CAN_PORT_BITRATE);
+    CanDrive drive;
+    uint32_t lcg = 11;
+    auto next = [&lcg]() {
+        lcg = lcg*1664525U + 1013904223U;
+        return lcg >> 8;
+    };
+    auto uniform = [&next]() {
+        return (next() & 0xFFFFU)/65536.0;
+    };
+
+    // The cases one at a time, all taken by the first period: frames the port refuses or filters, a setpoint
+    // overwritten in the DCAN before the interrupt read it, and more frames than the ring holds
+    initCanDrive(&drive, &can, CANP_LATCH_NEXT_PERIOD, 4e-3, false);
+    unsigned long errors = 0;
+    uint16_t bytes[CANP_FRAME_BYTES];
+    CANP_Setpoint bad = {MOTION_MODE_SPEED, 1, 100.0f};
+    CANP_encodeSetpoint(&bad, bytes);
+    can.queueFrame(0.0, canFrame(CANP_ID_SETPOINT(CAN_PORT_NODE), bytes, 6)); // Short
+    can.queueFrame(0.0, canSetpointFrame(CAN_PORT_NODE, 7, 2, 100.0f)); // No such mode
+    can.queueFrame(0.0, canSetpointFrame(CAN_PORT_NODE, MOTION_MODE_SPEED, 3, NAN));
+    can.queueFrame(0.0, canSetpointFrame(CAN_PORT_NODE, MOTION_MODE_SPEED, 4, 2e6f));
+    can.queueFrame(0.0, canSetpointFrame(CAN_PORT_NODE + 1, MOTION_MODE_SPEED, 5, 100.0f)); // Another drive's
+    runCanDrive(&drive, 0.9e-3);
+    errors += can.filtered != 1 || drive.interrupts != 4;
+    can.queueFrame(can.now(), canSetpointFrame(CAN_PORT_NODE, MOTION_MODE_SPEED, 6, 100.0f));
+    can.queueFrame(can.now(), canSetpointFrame(CAN_PORT_NODE, MOTION_MODE_POSITION, 7, -3.0f));
+    while (can.nextFrame(1.9e-3)) {
+        // The interrupt doesn't get in before the second frame
+    }
+    serviceCanInterrupts(&drive);
+    const int ring_free = CANP_RX_RING_SIZE - 5;
+    for (int k = 0; k <= ring_free; k++) {
+        can.queueFrame(can.now(), canSetpointFrame(CAN_PORT_NODE, MOTION_MODE_SPEED, 10 + k, 1.0f));
+    }
+    runCanDrive(&drive, 3.9e-3);
+    errors += canService.received != 0 || canService.overflows != 1;
+    runCanDrive(&drive, 4.4e-3);
+    errors += canService.refused != 4 || canService.lost != 1 || canService.received != 1 + ring_free
+            || drive.periods.size() != 1 || !drive.periods[0].applied || drive.periods[0].sequence != 10 + ring_free - 1;
+    report("can.case_errors", (double)errors, 0.0, 0.0, "");
+
+    // Filtering on a busy bus: two other drives with their setpoints and status frames, and traffic on other
+    // identifiers, all at random times around this drive's setpoints (CAN_MASTER_FREQUENCY) and status frames
+    // (every second period). Only this drive's frames may interrupt, and each setpoint must be taken by the
+    // first period after it.
+    const double duration_s = 1.0;
+    initCanDrive(&drive, &can, CANP_LATCH_NEXT_PERIOD, 0.21e-3, false);
+    unsigned long foreign = 0, setpoints = 0, cycle_count = 0;
+    for (double t = 0.0; t < duration_s; t += 1.0/CAN_MASTER_FREQUENCY) {
+        std::vector<std::pair<double, SimCanFrame>> cycle;
+        cycle.push_back(std::make_pair(t + 0.9e-3*uniform(), canSetpointFrame(CAN_PORT_NODE, MOTION_MODE_SPEED, setpoints++, 50.0f)));
+        for (uint16_t node = CAN_PORT_NODE + 1; node <= CAN_PORT_NODE + 2; node++) {
+            cycle.push_back(std::make_pair(t + 0.9e-3*uniform(), canSetpointFrame(node, MOTION_MODE_SPEED, 0, 1.0f)));
+            uint16_t k = (uint16_t)(cycle_count % CANP_STATUS_FRAMES);
+            cycle.push_back(std::make_pair(t + 0.9e-3*uniform(), canFrame(CANP_ID_STATUS(k, node), bytes, 8)));
+        }
+        if (next() % 2) {
+            uint32_t id = 0x300U + next() % 0x400U; // Above every identifier the drive takes
+            cycle.push_back(std::make_pair(t + 0.9e-3*uniform(), canFrame(id, bytes, (uint16_t)(next() % 9))));
+        }
+        cycle_count++;
+        std::sort(cycle.begin(), cycle.end(), [](const std::pair<double, SimCanFrame> &a, const std::pair<double, SimCanFrame> &b) {
+            return a.first < b.first;
+        });
+        for (const auto &f : cycle) {
+            can.queueFrame(f.first, f.second);
+        }
+        foreign += cycle.size() - 1;
+    }
+    runCanDrive(&drive, duration_s + 2e-3);
+    double max_delay_s;
+    unsigned long latch_errors = checkCanLatching(drive, false, &max_delay_s);
+    report("can.filter.foreign_frames_filtered", (double)can.filtered, (double)foreign, (double)foreign, "");
+    report("can.filter.foreign_interrupts", (double)drive.interrupts - setpoints, 0.0, 0.0, "");
+    report("can.filter.setpoints_received", (double)canService.received, (double)setpoints, (double)setpoints, "");
+    report("can.next_period.latch_errors", (double)latch_errors, 0.0, 0.0, "");
+    report("can.next_period.max_latch_delay_us", max_delay_s*1e6, 0.0, 1e6/MOTION_CONTROL_FREQUENCY, "us");
+    report("can.status.frames_sent", (double)can.sent.size(), drive.periods.size() - 2.0, (double)drive.periods.size(), "");
+    report("can.status.late", (double)canService.late, 0.0, 0.0, "");
+    printf("%-34s %12.4g %-8s\n", "can.bus_load_pct", 100.0*can.busy_s/can.now(), "%");
+    printf("%-34s %12.4g %-8s\n", "can.setpoints_overwritten", (double)canService.overwritten, "");
+
+    // Latching on SYNC: each master cycle a SYNC, then one or two setpoints at random before the next. Every
+    // setpoint taken must be the last before a SYNC, in the first period after that SYNC, which also sends
+    // the status frames reporting its sequence.
+    initCanDrive(&drive, &can, CANP_LATCH_ON_SYNC, 0.37e-3, false);
+    unsigned long syncs = 0, replaced = 0;
+    setpoints = 0;
+    for (double t = 0.0; t < duration_s; t += 1.0/CAN_MASTER_FREQUENCY) {
+        can.queueFrame(t, canFrame(CANP_ID_SYNC, bytes, 0));
+        syncs++;
+        int count = 1 + (next() % 4 == 0);
+        double at = t + 0.1e-3;
+        for (int k = 0; k < count; k++) {
+            at += 0.35e-3*uniform();
+            can.queueFrame(at, canSetpointFrame(CAN_PORT_NODE, MOTION_MODE_POSITION, setpoints, 0.01f*setpoints));
+            setpoints++;
+        }
+        replaced += count - 1;
+    }
+    runCanDrive(&drive, duration_s + 2e-3);
+    latch_errors = checkCanLatching(drive, true, &max_delay_s);
+    unsigned long status_periods = 0, status_errors = 0;
+    size_t sent_status = 0;
+    uint16_t sequence = 0;
+    for (const CanEvent &period : drive.periods) {
+        sequence = period.applied ? period.sequence : sequence;
+        status_periods += period.what != 0;
+        status_errors += period.what != 0 && period.what != (1U << CANP_STATUS_FRAMES) - 1U;
+        if (period.what) {
+            // This period's frame 1 must carry the setpoint it applied
+            for (; sent_status < can.sent.size() && can.sent[sent_status].id != CANP_ID_STATUS(1, CAN_PORT_NODE); sent_status++) {
+            }
+            status_errors += sent_status >= can.sent.size() || can.sent[sent_status].bytes[5] != sequence;
+            sent_status++;
+        }
+    }
+    report("can.sync.latch_errors", (double)latch_errors, 0.0, 0.0, "");
+    report("can.sync.max_latch_delay_us", max_delay_s*1e6, 0.0, 1e6/MOTION_CONTROL_FREQUENCY, "us");
+    report("can.sync.setpoints_overwritten", (double)canService.overwritten, (double)replaced, (double)replaced, "");
+    report("can.sync.status_periods", (double)status_periods, (double)syncs, (double)syncs, "");
+    report("can.sync.status_errors", (double)status_errors, 0.0, 0.0, "");
+
+    // A flood of higher priority frames holds the bus for 12 ms. Status frames due meanwhile replace the
+    // one waiting in their object and are counted late, and once the flood is over every period's frames
+    // go out again.
+    initCanDrive(&drive, &can, CANP_LATCH_NEXT_PERIOD, 0.0, false);
+    canService.every[0] = canService.every[1] = 1;
+    for (int k = 0; k < 100; k++) {
+        can.queueFrame(20e-3, canFrame(0x050, bytes, 8));
+    }
+    runCanDrive(&drive, 40e-3);
+    uint32_t late = canService.late;
+    size_t sent = can.sent.size();
+    runCanDrive(&drive, 50e-3);
+    report("can.flood.status_late", (double)late, 10.0, 1e9, "");
+    report("can.flood.frames_replaced", (double)(canService.loaded[0] + canService.loaded[1] - can.sent.size()),
+           (double)late, (double)late, "");
+    report("can.flood.late_after", (double)(canService.late - late), 0.0, 0.0, "");
+    report("can.flood.sent_after", (double)(can.sent.size() - sent), 2.0*20, 2.0*20, "");
+
+    // Internal loopback, as on a board by itself: setpoints and SYNCs injected through the test object come
+    // back through the filters and are latched, the drive's own status frames are filtered, and the bus
+    // (another node's setpoint) isn't heard at all
+    initCanDrive(&drive, &can, CANP_LATCH_ON_SYNC, 0.0, true);
+    can.queueFrame(0.0, canSetpointFrame(CAN_PORT_NODE, MOTION_MODE_SPEED, 200, 1.0f));
+    errors = 0;
+    for (uint16_t k = 0; k < 20; k++) {
+        SimCanFrame setpoint = canSetpointFrame(CAN_PORT_NODE, MOTION_MODE_SPEED, k, (float)k);
+        CANPORT_inject(setpoint.id, setpoint.bytes, setpoint.dlc);
+        runCanDrive(&drive, can.now() + 0.2e-3);
+        CANPORT_inject(CANP_ID_SYNC, bytes, 0);
+        runCanDrive(&drive, can.now() + 1e-3);
+        errors += canService.applied_sequence != k;
+    }
+    errors += canService.received != 20 || canService.latch.syncs != 20 || canService.loaded[0] != 20
+            || can.filtered != 2*20;
+    report("can.loopback_errors", (double)errors, 0.0, 0.0, "");
+
+    // Host time of the control period's work for one setpoint
+    const int n = 1000000;
+    SimCanFrame frame = canSetpointFrame(CAN_PORT_NODE, MOTION_MODE_SPEED, 1, 10.0f);
+    CANP_Frame received = {CANP_OBJECT_SETPOINT, frame.dlc, 0, {CANP_bytesToLong(frame.bytes), CANP_bytesToLong(frame.bytes + 4)}};
+    CANP_init(&canService, CAN_PORT_NODE, CANP_LATCH_NEXT_PERIOD);
+    auto start = std::chrono::steady_clock::now();
+    for (int k = 0; k < n; k++) {
+        received.data[0] = (received.data[0] & ~0xFF00UL) | (uint32_t)(k & 0xFF) << 8; // Sequence
+        CANP_receive(&canService, &received);
+    }
+    auto stop = std::chrono::steady_clock::now();
+    printf("%-34s %12.4g %-8s\n", "can.host_ns_per_setpoint", std::chrono::duration<double, std::nano>(stop - start).count()/n, "ns");
+    printf("%-34s %12.4g %-8s\n", "can.setpoint_frame_us", SimCan::frameBits(frame)*1e6/CAN_PORT_BITRATE, "us");
+}
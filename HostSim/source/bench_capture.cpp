@@ -0,0 +1,231 @@
+/*
+ * bench_capture.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Bench "capture": the triggered capture on the simulation.
+ */
+
+#include "sil_bench.h"
+#include "sil_simulation.h"
+#include "ipc_link.h"
+#include "scope.h"
+#include "capture.h"
+#include "serial_frame.h"
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+uint32_t scopeRaw(const SCOPE_Variable *registry, uint16_t id); // bench_scope.cpp
+
+/* A record's raw values as a capture holds them: the 32-bit channels in order, then the 16-bit ones */
+static std::vector<uint32_t> captureRecord(const SCOPE_Variable *registry, const CAPTURE_Arm &arm) {
+    std::vector<uint32_t> raw;
+    for (int wide = 1; wide >= 0; wide--) {
+        for (uint16_t k = 0; k < arm.count; k++) {
+            if (SCOPE_isWide(registry[arm.ids[k]].type) == (wide == 1)) {
+                raw.push_back(scopeRaw(registry, arm.ids[k]));
+            }
+        }
+    }
+    return raw;
+}
+
+/* Unrolls a frozen capture the way the host does, record k from ring slot (oldest + k) % records, and
+ * checks the header against the arm and each record against history, the raw record of every sample
+ * from sample first on. Record pre_trigger is the trigger's.
+ * \return the errors, with the unrolled records in records */
+static unsigned long checkCapture(const uint16_t *frame, uint16_t words, const CAPTURE_Arm &arm, uint16_t trigger,
+                                  const SCOPE_Variable *registry, const std::vector<std::vector<uint32_t>> &history,
+                                  uint32_t first, std::vector<std::vector<uint32_t>> *records) {
+    CAPTURE_FrameHeader header;
+    memcpy(&header, frame, sizeof(header));
+    unsigned long errors = header.kind != CAPTURE_FRAME_KIND || header.decimation != arm.decimation
+                         || header.records != arm.pre_trigger + arm.post_trigger
+                         || header.pre_trigger != arm.pre_trigger || header.trigger != trigger
+                         || header.oldest >= header.records;
+    std::vector<bool> layout; // Whether each value of a record is 32-bit, from the header alone
+    uint16_t record_words = 0;
+    for (int wide = 1; wide >= 0; wide--) {
+        for (uint16_t k = 0; k < SCOPE_MAX_CHANNELS && SCOPE_channelId(header.ids, k) != SCOPE_NO_CHANNEL; k++) {
+            uint16_t id = SCOPE_channelId(header.ids, k);
+            if (id >= SCOPE_VARIABLE_COUNT) {
+                return errors + 1;
+            }
+            if (SCOPE_isWide(registry[id].type) == (wide == 1)) {
+                layout.push_back(wide == 1);
+                record_words += wide ? 2 : 1;
+            }
+        }
+    }
+    for (uint16_t k = 0; k < SCOPE_MAX_CHANNELS; k++) {
+        errors += SCOPE_channelId(header.ids, k) != (k < arm.count ? arm.ids[k] : SCOPE_NO_CHANNEL);
+    }
+    errors += words != CAPTURE_HEADER_WORDS + header.records*record_words;
+    if (errors) {
+        return errors;
+    }
+
+    records->clear();
+    for (uint16_t k = 0; k < header.records; k++) {
+        const uint16_t *data = frame + CAPTURE_HEADER_WORDS + ((header.oldest + k) % header.records)*record_words;
+        std::vector<uint32_t> raw;
+        for (bool wide : layout) {
+            raw.push_back(wide ? (uint32_t)data[0] | (uint32_t)data[1] << 16 : data[0]);
+            data += wide ? 2 : 1;
+        }
+        int64_t index = (int64_t)header.trigger_sample + ((int64_t)k - header.pre_trigger)*header.decimation - first;
+        errors += index < 0 || index >= (int64_t)history.size() || raw != history[(size_t)index];
+        records->push_back(raw);
+    }
+    return errors;
+}
+
+static float captureFloat(uint32_t raw) {
+    float f;
+    memcpy(&f, &raw, sizeof(f));
+    return f;
+}
+
+void benchCapture() {
+    SilSimulation sim(SIM_defaultMotor(), AVERAGE_INVERTER, 24.0, 0.0);
+    sim.getMotor().holdSpeed(300.0);
+    sim.params.enable = 1;
+    const FOC_DQ i_zero = {0.0f, 0.0f};
+    CLA_forceCurrentReference(&sim.params, i_zero);
+
+    // The firmware's registry, on the simulation's copies of the current loop variables
+#undef FOC_TELEMETRY
+#undef FOC_LOOP
+#define FOC_TELEMETRY sim.telemetry
+#define FOC_LOOP sim.loop
+#define claParams sim.params
+#define SCOPE_TABLE_ENTRY(name, variable, type, scale, unit) {&(variable), type},
+    const SCOPE_Variable registry[SCOPE_VARIABLE_COUNT] = {
+        SCOPE_REGISTRY(SCOPE_TABLE_ENTRY)
+    };
+#undef claParams
+
+    CAPTURE_Engine capture;
+    CAPTURE_init(&capture, registry, SCOPE_VARIABLE_COUNT);
+    static uint16_t frame[FRAME_BUFFER_WORDS];
+    linkReferencesRefused = 0;
+
+    // iq rising through 1 A, 100 records before it and 150 from it, every other sample
+    const CAPTURE_Arm edge = {2, 3, {SCOPE_ID_iq, SCOPE_ID_startup_state, SCOPE_ID_sample_count}, 100, 150,
+                              CAPTURE_TRIGGER_RISING, SCOPE_ID_iq, 1.0f, 0};
+    CAPTURE_Arm bad[6] = {edge, edge, edge, edge, edge, edge};
+    bad[0].post_trigger = 0;
+    bad[1].trigger = CAPTURE_TRIGGER_FORCED;
+    bad[2].trigger = CAPTURE_TRIGGER_FAULT; // On a float
+    bad[3].pre_trigger = CAPTURE_RING_WORDS/5U; // Five words a record: too deep
+    bad[4].trigger_id = SCOPE_VARIABLE_COUNT;
+    bad[5].decimation = 0;
+    int accepted = 0;
+    for (const CAPTURE_Arm &arm : bad) {
+        accepted += CAPTURE_arm(&capture, &arm);
+    }
+    report("capture.invalid_arms_accepted", accepted + (capture.state != CAPTURE_IDLE), 0.0, 0.0, "");
+
+    // Arms, applies the stimulus before each sample until the capture freezes, then checks the frame,
+    // that it's offered unchanged until taken, and that nothing is recorded after
+    std::vector<std::vector<uint32_t>> records;
+    uint32_t trigger_sample = 0, first = 0;
+    auto run = [&](const CAPTURE_Arm &arm, uint16_t trigger, const std::function<void(unsigned long)> &stimulus) {
+        unsigned long errors = !CAPTURE_arm(&capture, &arm);
+        std::vector<std::vector<uint32_t>> history;
+        uint16_t words = 0;
+        for (unsigned long n = 0; n < 20000 && !words; n++) {
+            stimulus(n);
+            sim.runSample();
+            if (n == 0) {
+                first = sim.telemetry.sample_count;
+            }
+            history.push_back(captureRecord(registry, arm));
+            words = CAPTURE_sample(&capture, frame, sim.telemetry.sample_count);
+        }
+        errors += !words || capture.state != CAPTURE_FROZEN;
+        std::vector<uint16_t> frozen(frame, frame + FRAME_BUFFER_WORDS);
+        for (int n = 0; n < 10; n++) {
+            sim.runSample();
+            errors += CAPTURE_sample(&capture, frame, sim.telemetry.sample_count) != words;
+        }
+        CAPTURE_taken(&capture);
+        sim.runSample();
+        errors += CAPTURE_sample(&capture, frame, sim.telemetry.sample_count) != 0 || capture.state != CAPTURE_IDLE
+                || memcmp(frozen.data(), frame, sizeof(frame)) != 0;
+        errors += checkCapture(frozen.data(), words, arm, trigger, registry, history, first, &records);
+        CAPTURE_FrameHeader header;
+        memcpy(&header, frozen.data(), sizeof(header));
+        trigger_sample = header.trigger_sample;
+        return errors;
+    };
+
+    // The edge: a 2 A step after 400 samples. Records hold iq and sample_count (32-bit), then startup_state.
+    const FOC_DQ i_step = {0.0f, 2.0f};
+    unsigned long errors = run(edge, CAPTURE_TRIGGER_RISING, [&](unsigned long n) {
+        if (n == 400) {
+            CLA_setCurrentReference(&sim.params, &sim.telemetry, i_step, 1);
+        }
+    });
+    if (records.size() == edge.pre_trigger + edge.post_trigger) {
+        errors += !(captureFloat(records[edge.pre_trigger - 1][0]) <= edge.level
+                    && captureFloat(records[edge.pre_trigger][0]) > edge.level)
+                || records[edge.pre_trigger][1] != trigger_sample;
+    }
+    report("capture.edge_errors", (double)errors, 0.0, 0.0, "");
+    printf("%-34s %12.4g %-8s\n", "capture.edge_after_step", (trigger_sample - first - 400.0)/FOC_SAMPLING_FREQUENCY*1e6, "us");
+
+    // Above 1 A when armed: it fires as soon as the pre-trigger records are there
+    CAPTURE_Arm level = edge;
+    level.trigger = CAPTURE_TRIGGER_ABOVE;
+    level.decimation = 1;
+    level.pre_trigger = 50;
+    level.post_trigger = 20;
+    errors = run(level, CAPTURE_TRIGGER_ABOVE, [](unsigned long) {});
+    report("capture.level_errors", (double)errors, 0.0, 0.0, "");
+    report("capture.level_trigger_record", (double)(trigger_sample - first), level.pre_trigger, level.pre_trigger, "");
+
+    // A fault bit in references_refused, raised before sample 100, and the same capture forced instead
+    CAPTURE_Arm fault = {1, 2, {SCOPE_ID_iq, SCOPE_ID_references_refused}, 10, 10, CAPTURE_TRIGGER_FAULT,
+                         SCOPE_ID_references_refused, 0.0f, 0x8};
+    errors = run(fault, CAPTURE_TRIGGER_FAULT, [](unsigned long n) {
+        linkReferencesRefused = n >= 100 ? 0x9 : 0x1;
+    });
+    errors += trigger_sample - first != 100;
+    linkReferencesRefused = 0;
+    errors += run(fault, CAPTURE_TRIGGER_FORCED, [&](unsigned long n) {
+        if (n == 100) {
+            CAPTURE_force(&capture);
+        }
+    });
+    errors += trigger_sample - first != 100;
+    report("capture.fault_and_forced_errors", (double)errors, 0.0, 0.0, "");
+
+    // Host time of an armed record with four float channels, against the scope's
+    CAPTURE_Arm never = {1, 4, {SCOPE_ID_ia, SCOPE_ID_ib, SCOPE_ID_id, SCOPE_ID_iq}, 0, 1, CAPTURE_TRIGGER_ABOVE,
+                         SCOPE_ID_iq, 1e9f, 0};
+    never.pre_trigger = (uint16_t)(CAPTURE_RING_WORDS/8U - 1U);
+    CAPTURE_arm(&capture, &never);
+    const int calls = 2000000;
+    auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < calls; n++) {
+        CAPTURE_sample(&capture, frame, (uint32_t)n);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()/calls;
+    printf("%-34s %12.4g %-8s\n", "capture.host_ns_per_record_4ch", ns, "ns");
+
+    // The deepest capture of those four channels, and the time CPU2 takes to stream it next to the telemetry
+    uint16_t depth = (uint16_t)(CAPTURE_RING_WORDS/8U);
+    uint16_t words = (uint16_t)(CAPTURE_HEADER_WORDS + depth*8U);
+    double frame_bytes = SFRAME_ENCODED_BYTES(2U*CHAN_WORDS(FRAME_Ready))
+                       + (words/COMMS_MAX_FRAME_WORDS)*SFRAME_ENCODED_BYTES(2U*COMMS_MAX_FRAME_WORDS)
+                       + (words % COMMS_MAX_FRAME_WORDS ? SFRAME_ENCODED_BYTES(2U*(words % COMMS_MAX_FRAME_WORDS)) : 0);
+    double telemetry_bytes = SFRAME_ENCODED_BYTES(2U*CHAN_WORDS(LINK_Telemetry))*(double)LINK_TELEMETRY_FREQUENCY;
+    printf("%-34s %12.4g %-8s\n", "capture.depth_4ch", (double)depth, "records");
+    printf("%-34s %12.4g %-8s\n", "capture.window_4ch", 1e3*depth/FOC_SAMPLING_FREQUENCY, "ms");
+    report("capture.stream_time_4ch", frame_bytes/(COMMS_SCI_BAUD/10.0 - telemetry_bytes), 0.0, 0.5, "s");
+}
@@ -0,0 +1,247 @@
+/*
+ * bench_command.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Bench "command": the host command protocol with CPU2's parameter registry.
+ */
+
+#include "sil_bench.h"
+#include "sil_simulation.h"
+#include "motion_control.h"
+#include "scope.h"
+#include "commands.h"
+#include "can_port.h"
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+
+// CPU2's variables behind the command parameters, for the registry (commands.c is target only). The CAN
+// port's come from can_port.c.
+static MOTION_Controller motion;
+volatile uint16_t motionCommandMode;
+volatile float motionCommandTarget;
+volatile uint32_t motionRoundTrip, motionRoundTripMax;
+volatile uint16_t motionMissedFeedback, motionRefused, commsDropped, sciRxErrors, sciTxOverflows;
+static CMD_RxRing commandRing;
+static SFRAME_Decoder commandDecoder;
+static CMD_Service commandService;
+
+// What the bench's handler was given: CPU2's CMD_MODE checks, and the commands for CPU1 recorded
+static std::vector<std::vector<uint16_t>> commandsForCpu1;
+static uint16_t benchCommandHandler(uint16_t type, const SFRAME_Decoder *frame, CMD_Reply *reply) {
+    (void)reply;
+    if (type == CMD_MODE) {
+        if (!CMD_hasWords(frame, CHAN_WORDS(CMD_Mode))) {
+            return CMD_BAD_LENGTH;
+        }
+        uint16_t mode = CMD_word(frame, 0);
+        float target = CMD_toFloat(CMD_long(frame, 2));
+        if (mode > MOTION_MODE_POSITION || !(target >= -1e6f && target <= 1e6f)) {
+            return CMD_OUT_OF_RANGE;
+        }
+        motionCommandMode = mode;
+        motionCommandTarget = target;
+        return CMD_OK;
+    }
+    if (type >= CMD_SCOPE_SELECT && type <= CMD_CURRENT_GAINS) {
+        std::vector<uint16_t> words(SFRAME_MAX_PAYLOAD_BYTES/2 + 1);
+        words[0] = type;
+        words.resize(1 + SFRAME_payloadWords(frame, words.data() + 1, SFRAME_MAX_PAYLOAD_BYTES/2));
+        commandsForCpu1.push_back(words);
+        return CMD_OK;
+    }
+    return CMD_UNKNOWN;
+}
+
+/* One comms poll as commands.c runs it: at most COMMANDS_BYTES_PER_POLL bytes and one command */
+static bool pollCommands(CMD_Reply *reply, uint16_t *bytes_taken) {
+    uint16_t budget = COMMANDS_BYTES_PER_POLL;
+    bool executed = CMD_nextFrame(&commandRing, &commandDecoder, &budget);
+    if (executed) {
+        CMD_execute(&commandService, &commandDecoder, reply);
+    }
+    *bytes_taken = COMMANDS_BYTES_PER_POLL - budget;
+    return executed;
+}
+
+static void encodeCommand(std::vector<uint16_t> *stream, uint16_t type, uint16_t sequence,
+                          const uint16_t *payload, uint16_t words) {
+    uint16_t encoded[SFRAME_ENCODED_BYTES(SFRAME_MAX_PAYLOAD_BYTES)];
+    uint16_t n = SFRAME_encode(encoded, type, sequence, 0, payload, words);
+    stream->insert(stream->end(), encoded, encoded + n);
+}
+
+/* Feeds a stream to the ring in SCI FIFO sized pieces, as fast as the polls take it without overflowing,
+ * and collects the replies */
+static std::vector<CMD_Reply> runCommands(const std::vector<uint16_t> &stream, uint16_t *max_bytes_per_poll) {
+    std::vector<CMD_Reply> replies;
+    size_t fed = 0;
+    while (fed < stream.size() || commandRing.head != commandRing.tail) {
+        size_t piece = stream.size() - fed < COMMS_SCI_RX_FIFO_LEVEL ? stream.size() - fed : COMMS_SCI_RX_FIFO_LEVEL;
+        if (CMD_RX_RING_SIZE - (uint16_t)(commandRing.head - commandRing.tail) >= piece) {
+            CMD_putBytes(&commandRing, stream.data() + fed, (uint16_t)piece);
+            fed += piece;
+        }
+        CMD_Reply reply;
+        uint16_t taken;
+        if (pollCommands(&reply, &taken)) {
+            replies.push_back(reply);
+        }
+        *max_bytes_per_poll = taken > *max_bytes_per_poll ? taken : *max_bytes_per_poll;
+    }
+    return replies;
+}
+
+void benchCommand() {
+#define COMMAND_TABLE_ENTRY(name, variable, type, access, min, max) {&(variable), type, access, min, max},
+    static const CMD_Parameter parameters[COMMAND_PARAMETER_COUNT] = {
+        COMMAND_PARAMETERS(COMMAND_TABLE_ENTRY)
+    };
+    MOTION_init(&motion, 1.0f/MOTION_CONTROL_FREQUENCY, MOTOR_POLE_PAIRS, MOTOR_FLUX);
+    motionCommandMode = MOTION_MODE_OFF;
+    motionCommandTarget = 0.0f;
+    motionRoundTrip = 1234;
+    CMD_initRing(&commandRing);
+    SFRAME_initDecoder(&commandDecoder);
+    CMD_initService(&commandService, parameters, COMMAND_PARAMETER_COUNT, benchCommandHandler);
+    report("command.reply_words", CHAN_WORDS(CMD_Reply), 6.0, 6.0, "");
+
+    // Every case once: what each does to the parameters and the status it answers with
+    struct Case {
+        uint16_t type;
+        std::vector<uint16_t> payload;
+        uint16_t status;
+    };
+    auto write = [](uint16_t id, uint32_t bits) {
+        return std::vector<uint16_t>{id, 0, (uint16_t)bits, (uint16_t)(bits >> 16)};
+    };
+    uint32_t kp = CMD_fromFloat(0.01f), mode_target = CMD_fromFloat(-250.0f);
+    const std::vector<uint16_t> scope_select = {10, 2, SCOPE_ID_ia, SCOPE_ID_iq, 0, 0, 0, 0, 0, 0};
+    const Case cases[] = {
+        {CMD_PARAM_READ, {COMMAND_ID_speed_kp}, CMD_OK},
+        {CMD_PARAM_WRITE, write(COMMAND_ID_speed_kp, kp), CMD_OK},
+        {CMD_PARAM_WRITE, write(COMMAND_ID_speed_kp, CMD_fromFloat(5.0f)), CMD_OUT_OF_RANGE},
+        {CMD_PARAM_WRITE, write(COMMAND_ID_speed_kp, 0x7FC00000U), CMD_OUT_OF_RANGE}, // NaN
+        {CMD_PARAM_WRITE, write(COMMAND_ID_mode, 1), CMD_READ_ONLY},
+        {CMD_PARAM_WRITE, write(COMMAND_ID_round_trip, 0), CMD_READ_ONLY},
+        {CMD_PARAM_WRITE, write(COMMAND_ID_comms_dropped, 3), CMD_OUT_OF_RANGE},
+        {CMD_PARAM_WRITE, write(COMMAND_ID_comms_dropped, 0), CMD_OK},
+        {CMD_PARAM_READ, {COMMAND_PARAMETER_COUNT}, CMD_BAD_ID},
+        {CMD_PARAM_READ, {COMMAND_ID_speed_kp, 0}, CMD_BAD_LENGTH},
+        {CMD_PARAM_WRITE, {COMMAND_ID_speed_kp, 0, 0}, CMD_BAD_LENGTH},
+        {CMD_MODE, {MOTION_MODE_SPEED, 0, (uint16_t)mode_target, (uint16_t)(mode_target >> 16)}, CMD_OK},
+        {CMD_MODE, {7, 0, 0, 0}, CMD_OUT_OF_RANGE},
+        {CMD_SCOPE_SELECT, scope_select, CMD_OK},
+        {CMD_CAPTURE_TRIGGER, {}, CMD_OK},
+        {0x7F, {1, 2, 3}, CMD_UNKNOWN},
+    };
+    commsDropped = 9;
+    std::vector<uint16_t> stream;
+    uint16_t sequence = 0;
+    for (const Case &c : cases) {
+        encodeCommand(&stream, c.type, sequence++, c.payload.data(), (uint16_t)c.payload.size());
+    }
+    uint16_t max_bytes = 0;
+    std::vector<CMD_Reply> replies = runCommands(stream, &max_bytes);
+    unsigned long errors = replies.size() != sizeof(cases)/sizeof(cases[0]);
+    for (size_t k = 0; k < replies.size() && !errors; k++) {
+        errors += replies[k].command != cases[k].type || replies[k].sequence != k || replies[k].status != cases[k].status;
+    }
+    errors += replies.size() < 2 || replies[1].value != kp || CMD_fromFloat(motion.speed_pi.Kp) != kp
+            || commsDropped != 0 || motionCommandMode != MOTION_MODE_SPEED || motionCommandTarget != -250.0f
+            || commandsForCpu1.size() != 2 || commandsForCpu1[0][0] != CMD_SCOPE_SELECT
+            || !std::equal(scope_select.begin(), scope_select.end(), commandsForCpu1[0].begin() + 1)
+            || commandsForCpu1[1].size() != 1;
+    report("command.case_errors", (double)errors, 0.0, 0.0, "");
+
+    // Fuzz: random command frames of random types and lengths, a third of them damaged (a bit flipped, a
+    // byte lost or added, or noise after them). Parameters must stay in range, read-only ones unchanged,
+    // and every undamaged frame answered in order.
+    uint32_t lcg = 7;
+    auto next = [&lcg]() {
+        lcg = lcg*1664525U + 1013904223U;
+        return lcg >> 8;
+    };
+    const int frames = 30000;
+    stream.clear();
+    std::vector<uint16_t> intact; // Sequence numbers (low byte) and types of the undamaged frames
+    for (int k = 0; k < frames; k++) {
+        uint16_t type = (uint16_t)(0x3E + next() % 11); // A few either side of the commands
+        std::vector<uint16_t> payload(next() % 3 ? (type == CMD_PARAM_WRITE ? 4 : type == CMD_PARAM_READ ? 1 : next() % 6)
+                                                 : next() % 12);
+        for (uint16_t &w : payload) {
+            w = (uint16_t)next();
+        }
+        if (!payload.empty() && next() % 2) {
+            payload[0] %= COMMAND_PARAMETER_COUNT + 2; // Mostly real parameters
+        }
+        if (payload.size() == 4 && next() % 2) {
+            uint32_t bits = CMD_fromFloat((float)((int32_t)next() % 2000000)*1e-4f); // Plausible floats
+            payload[2] = (uint16_t)bits;
+            payload[3] = (uint16_t)(bits >> 16);
+        }
+        std::vector<uint16_t> frame;
+        encodeCommand(&frame, type, (uint16_t)(k & 0xFF), payload.data(), (uint16_t)payload.size());
+        if (next() % 3 == 0) {
+            size_t at = next() % (frame.size() - 1); // Not the delimiter
+            switch (next() % 4) {
+                case 0: frame[at] ^= 1U << (next() % 8); break;
+                case 1: frame.erase(frame.begin() + at); break;
+                case 2: frame.insert(frame.begin() + at, (uint16_t)(next() | 1U)); break;
+                default:
+                    for (int n = next() % 40; n > 0; n--) {
+                        frame.insert(frame.begin() + at, (uint16_t)(next() & 0xFFU)); // Noise, zeros too
+                    }
+                    break;
+            }
+        }
+        else {
+            intact.push_back((uint16_t)((k & 0xFF) | type << 8));
+        }
+        stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+    const uint32_t round_trip = motionRoundTrip;
+    uint32_t executed = commandService.executed;
+    auto start = std::chrono::steady_clock::now();
+    max_bytes = 0;
+    replies = runCommands(stream, &max_bytes);
+    double ns_per_byte = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()/stream.size();
+
+    size_t matched = 0;
+    for (const CMD_Reply &r : replies) {
+        if (matched < intact.size() && ((r.sequence & 0xFFU) | r.command << 8) == intact[matched]) {
+            matched++;
+        }
+    }
+    unsigned long out_of_range = 0;
+    for (uint16_t id = 0; id < COMMAND_PARAMETER_COUNT; id++) {
+        const CMD_Parameter &p = parameters[id];
+        uint32_t bits = CMD_readParameter(&p);
+        float value = p.type == CMD_FLOAT32 ? CMD_toFloat(bits) : (float)bits;
+        out_of_range += p.access == CMD_RW && p.max > p.min && !(value >= p.min && value <= p.max); // Not counters
+    }
+    out_of_range += motionCommandMode > MOTION_MODE_POSITION || !(motionCommandTarget >= -1e6f && motionCommandTarget <= 1e6f)
+                  || motionRoundTrip != round_trip;
+    printf("%-34s %12.4g %-8s\n", "command.fuzz_frames", (double)frames, "");
+    report("command.fuzz_replies", (double)replies.size(), 0.5*frames, (double)frames, "");
+    report("command.fuzz_intact_answered", (double)matched, (double)intact.size(), (double)intact.size(), "");
+    report("command.fuzz_executed", (double)(commandService.executed - executed), (double)replies.size(), (double)replies.size(), "");
+    report("command.fuzz_parameters_out_of_range", (double)out_of_range, 0.0, 0.0, "");
+    report("command.fuzz_max_bytes_per_poll", max_bytes, 1.0, COMMANDS_BYTES_PER_POLL, "bytes");
+    printf("%-34s %12.4g %-8s\n", "command.host_ns_per_byte", ns_per_byte, "ns");
+
+    // A flood bigger than the ring with no polls: the excess is counted, and the next command still gets
+    // through once the damaged frame ends
+    stream.assign(3*CMD_RX_RING_SIZE, 0x55);
+    CMD_putBytes(&commandRing, stream.data(), (uint16_t)stream.size());
+    uint16_t lost = commandRing.overflows;
+    stream.assign(1, SFRAME_DELIMITER);
+    const uint16_t read_kp = COMMAND_ID_speed_kp;
+    encodeCommand(&stream, CMD_PARAM_READ, 42, &read_kp, 1);
+    replies = runCommands(stream, &max_bytes);
+    report("command.flood_bytes_lost", lost, 2*CMD_RX_RING_SIZE, 2*CMD_RX_RING_SIZE, "bytes");
+    report("command.flood_then_answered", !replies.empty() && replies.back().sequence == 42 && replies.back().status == CMD_OK,
+           1.0, 1.0, "");
+}
@@ -0,0 +1,156 @@
+/*
+ * bench_current_loop.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Benches "current_step", "ripple", "sensorless" and "isr": the CPU1 current loop on the simulation.
+ */
+
+#include "sil_bench.h"
+#include "sil_simulation.h"
+#include "isr_cost.h"
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+void benchCurrentStep() {
+    // The compare resolution is 0.39 V a count at 24 V, about Kp times 0.4 A of error, so a small step rises
+    // in a few counts of voltage and reads up to 20% fast or slow. 6 A is within about 5% of the design.
+    const double step = 6.0;
+    SilSimulation sim(SIM_defaultMotor(), AVERAGE_INVERTER, 24.0, 0.0);
+    sim.getMotor().holdSpeed(300.0);
+    sim.params.enable = 1;
+    sim.run(0.02);
+
+    // Record the plant current every 2 us after the step
+    const FOC_DQ step_ref = {0.0f, (float)step};
+    CLA_setCurrentReference(&sim.params, &sim.telemetry, step_ref, 1); // As CPU1 does for a reference from CPU2
+    double t0 = sim.getTime();
+    std::vector<double> t, iq;
+    while (sim.getTime() - t0 < 0.01) {
+        sim.run(2e-6);
+        t.push_back(sim.getTime() - t0);
+        iq.push_back(sim.getMotor().getIq());
+    }
+
+    double t10 = -1.0, t90 = -1.0, peak = 0.0;
+    for (size_t k = 0; k < iq.size(); k++) {
+        if (t10 < 0.0 && iq[k] >= 0.1*step) {
+            t10 = t[k];
+        }
+        if (t90 < 0.0 && iq[k] >= 0.9*step) {
+            t90 = t[k];
+        }
+        if (iq[k] > peak) {
+            peak = iq[k];
+        }
+    }
+    double rise_time = t90 - t10;
+
+    // The compare resolution (TBPRD = 62) makes the current limit cycle by a few tens of mA, so the
+    // steady state error is averaged over the last 2 ms
+    SimStatistics final_iq;
+    for (size_t k = 4*iq.size()/5; k < iq.size(); k++) {
+        final_iq.add(iq[k]);
+    }
+    double bandwidth = rise_time > 0.0 ? 0.35/rise_time : 0.0; // First order equivalent
+
+    report("current_step.rise_time_us", rise_time*1e6, 0.35e6/(1.2*FOC_CURRENT_BANDWIDTH_HZ),
+           0.35e6/(0.8*FOC_CURRENT_BANDWIDTH_HZ), "us");
+    report("current_step.bandwidth_hz", bandwidth, 0.8*FOC_CURRENT_BANDWIDTH_HZ, 1.2*FOC_CURRENT_BANDWIDTH_HZ, "Hz");
+    report("current_step.overshoot_pct", 100.0*(peak - step)/step, -100.0, 20.0, "%");
+    report("current_step.final_error_a", final_iq.mean() - step, -0.1, 0.1, "A");
+}
+
+void benchRipple() {
+    const double iq_ref = 3.0;
+    SilSimulation sim(SIM_defaultMotor(), SWITCHING_INVERTER, 24.0, 1.0);
+    sim.getMotor().holdSpeed(500.0);
+    sim.params.enable = 1;
+    const FOC_DQ ripple_ref = {0.0f, (float)iq_ref};
+    CLA_setCurrentReference(&sim.params, &sim.telemetry, ripple_ref, 1);
+    sim.run(0.05);
+
+    sim.id_stats.reset();
+    sim.iq_stats.reset();
+    sim.run(0.05);
+
+    report("ripple.iq_mean_error_a", sim.iq_stats.mean() - iq_ref, -0.1, 0.1, "A");
+    report("ripple.iq_rms_a", sim.iq_stats.rmsDeviation(), 0.0, 0.3, "A");
+    report("ripple.iq_peak_to_peak_a", sim.iq_stats.peakToPeak(), 0.0, 1.5, "A");
+    report("ripple.id_rms_a", sim.id_stats.rmsDeviation(), 0.0, 0.3, "A");
+}
+
+void benchSensorless() {
+    const double TWO_PI = 6.283185307179586;
+    PmsmParameters motor = SIM_defaultMotor();
+    motor.B = 2e-4; // Speed settles at a few hundred rad/s with the closed loop current below
+    SilSimulation sim(motor, SWITCHING_INVERTER, 24.0, 1.0);
+    sim.getMotor().setLoadTorque(0.005);
+    sim.params.enable = 1;
+    sim.params.sensorless = 1;
+    const FOC_DQ closed_loop_ref = {0.0f, 1.0f}; // Used once the observer has taken over
+    CLA_setCurrentReference(&sim.params, &sim.telemetry, closed_loop_ref, 1);
+
+    double startup_time = STARTUP_ALIGN_TIME + STARTUP_HANDOVER_SPEED/STARTUP_ACCELERATION + STARTUP_HANDOVER_TIME;
+    sim.run(startup_time + 0.2);
+
+    SimStatistics angle_error, speed_error;
+    while (sim.getTime() < startup_time + 0.5) {
+        sim.runSample();
+        double theta_true = sim.getMotor().getThetaElectrical();
+        angle_error.add(wrapRadians(TWO_PI*sim.telemetry.theta - theta_true)*180.0/3.141592653589793);
+        speed_error.add(sim.telemetry.omega - sim.getMotor().getOmegaElectrical());
+    }
+    double omega = sim.getMotor().getOmegaElectrical();
+
+    report("sensorless.closed_loop", sim.telemetry.startup_state == OBS_STATE_CLOSED_LOOP, 1.0, 1.0, "");
+    report("sensorless.speed_rad_s", omega, 100.0, 2000.0, "rad/s");
+    report("sensorless.angle_error_mean_deg", angle_error.mean(), -10.0, 10.0, "deg");
+    report("sensorless.angle_error_rms_deg", angle_error.rmsDeviation(), 0.0, 5.0, "deg");
+    report("sensorless.speed_error_rms_pct", 100.0*sqrt(pow(speed_error.mean(), 2) + pow(speed_error.rmsDeviation(), 2))/omega,
+           0.0, 5.0, "%");
+}
+
+void benchIsr() {
+    const double budget = (double)PLLSYSCLK/FOC_SAMPLING_FREQUENCY; // CLA runs at SYSCLK
+
+    for (int sensorless = 0; sensorless <= 1; sensorless++) {
+        OpCounts ops = SIM_countCurrentLoopOps(sensorless);
+        unsigned long cycles = SIM_estimateClaCycles(ops);
+        const char *mode = sensorless ? "sensorless" : "encoder";
+        printf("isr.%s ops: add %lu, mul %lu, div %lu, compare %lu, convert %lu, sqrt %lu, store %lu\n", mode,
+               ops.add, ops.mul, ops.div, ops.compare, ops.convert, ops.sqrt, ops.store);
+
+        char name[64];
+        snprintf(name, sizeof(name), "isr.%s.cla_cycles", mode);
+        report(name, cycles, 0.0, 0.8*budget, "cycles");
+        snprintf(name, sizeof(name), "isr.%s.sample_budget_pct", mode);
+        report(name, 100.0*cycles/budget, 0.0, 80.0, "%");
+    }
+
+    // Host time per sample, for spotting large regressions between builds on the same machine
+    static FOC_CurrentLoop loop;
+    static OBS_Sensorless observer;
+    static CLA_CurrentLoopParams params;
+    static CLA_CurrentLoopTelemetry telemetry;
+    SilSimulation sim(SIM_defaultMotor(), AVERAGE_INVERTER, 24.0, 0.0);
+    loop = sim.loop;
+    observer = sim.observer;
+    params = sim.params;
+    params.enable = 1;
+    params.sensorless = 1;
+    const FOC_DQ i_ref = {0.0f, 2.0f};
+    CLA_forceCurrentReference(&params, i_ref);
+    uint16_t cmp[3];
+    const int n = 1000000;
+    auto start = std::chrono::steady_clock::now();
+    for (int k = 0; k < n; k++) {
+        CLA_runCurrentLoopSample(&loop, &observer, &params, 2048 + (k & 63), 2048 - (k & 63), 600, cmp, &telemetry);
+    }
+    auto stop = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(stop - start).count()/n;
+    printf("%-34s %12.4g %-8s\n", "isr.host_ns_per_sample", ns, "ns");
+}
@@ -0,0 +1,142 @@
+/*
+ * bench_encoder.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Bench "encoder": the encoder's M/T speed and angle interpolation (encoder_math.h) on the counts and timer
+ *  values of a synthesised eQEP.
+ */
+
+#include "sil_bench.h"
+#include "encoder_math.h"
+#include "foc.h" // MOTOR_POLE_PAIRS, FOC_SAMPLING_FREQUENCY
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+
+/* A rotor turning at a constant speed in front of the eQEP. The count is the edge below the rotor, the
+ * capture timer counts ticks from the last count, and the unit timer latches both every unit period. */
+typedef struct {
+    double start; // Rotor position at time 0 (counts), between two edges
+    double cps; // Speed (counts/s)
+} EncoderRotor;
+
+static double encoderPosition(const EncoderRotor *r, double t) {
+    return r->start + r->cps*t;
+}
+
+/* The position count at t and the capture timer, which is false if it has overflowed */
+static bool encoderRead(const EncoderRotor *r, double t, uint32_t *count, uint16_t *timer) {
+    double position = encoderPosition(r, t);
+    double edge = floor(position) + (r->cps < 0.0 ? 1.0 : 0.0); // The last one passed
+    double ticks = floor((t - (edge - r->start)/r->cps)/ENCODER_CAPTURE_TICK_S);
+    double turns = floor(position/ENCODER_COUNTS_PER_REV);
+    *count = (uint32_t)(floor(position) - turns*ENCODER_COUNTS_PER_REV);
+    *timer = ticks > 65535.0 ? 65535 : (uint16_t)ticks;
+    return ticks <= 65535.0;
+}
+
+typedef struct {
+    double speed_error_pct; // Largest M/T error after the first estimates
+    double angle_error_counts; // Largest interpolated angle error
+    double count_error_counts; // The same from the count alone
+    double predict_error_counts; // Largest error of the angle predicted to the next sample
+} EncoderResult;
+
+/* Samples the encoder at the current loop rate for duration_s, each sample read_s after its SOC, the way
+ * ENC_updateRotorAngle() does: the speed at each unit time out, the angle, and the angle at the next SOC */
+static EncoderResult runEncoder(const EncoderRotor *r, double duration_s, double settle_s, double read_s) {
+    ENC_Estimator e;
+    ENC_init(&e, ENCODER_COUNTS_PER_REV, MOTOR_POLE_PAIRS, ENCODER_CAPTURE_TICK_S, 1.0f/ENCODER_UNIT_FREQUENCY_HZ);
+    const double sample_s = 1.0/FOC_SAMPLING_FREQUENCY;
+    const double unit_phase_s = 13e-6; // The unit timer isn't synchronised with the PWM
+    EncoderResult result = {0.0, 0.0, 0.0, 0.0};
+    int unit = 0;
+    for (int k = 0; k*sample_s < duration_s; k++) {
+        double t = k*sample_s + read_s;
+        for (double timeout_s; (timeout_s = unit_phase_s + (unit + 1)*(1.0/ENCODER_UNIT_FREQUENCY_HZ)) <= t; unit++) {
+            uint32_t count;
+            uint16_t timer;
+            bool valid = encoderRead(r, timeout_s, &count, &timer);
+            ENC_updateSpeed(&e, count, timer, !valid);
+            if (timeout_s >= settle_s) {
+                result.speed_error_pct = std::max(result.speed_error_pct, fabs(e.speed_cps/r->cps - 1.0)*100.0);
+            }
+        }
+
+        uint32_t count;
+        uint16_t timer;
+        encoderRead(r, t, &count, &timer);
+        float theta = ENC_angle(&e, count, timer);
+        float predicted = ENC_predict(theta, ENC_omega(&e), (float)(sample_s - read_s));
+        if (t < settle_s) {
+            continue;
+        }
+        // Electrical angle errors in counts: a count is 1/ENCODER_COUNTS_PER_REV of a turn
+        const double counts_per_unit = (double)ENCODER_COUNTS_PER_REV/MOTOR_POLE_PAIRS;
+        double now = encoderPosition(r, t)/counts_per_unit;
+        double next = encoderPosition(r, (k + 1)*sample_s)/counts_per_unit;
+        double from_count = (double)count/counts_per_unit;
+        result.angle_error_counts = std::max(result.angle_error_counts,
+                                             fabs(wrapRadians(6.283185307179586*(theta - now)))/6.283185307179586*counts_per_unit);
+        result.count_error_counts = std::max(result.count_error_counts,
+                                             fabs(wrapRadians(6.283185307179586*(from_count - now)))/6.283185307179586*counts_per_unit);
+        result.predict_error_counts = std::max(result.predict_error_counts,
+                                               fabs(wrapRadians(6.283185307179586*(predicted - next)))/6.283185307179586*counts_per_unit);
+    }
+    return result;
+}
+
+void benchEncoder() {
+    // A sample reads the encoder this long after its SOC: the ADC and CLA Task 1, then the end of task ISR
+    const double read_s = 8e-6;
+    const double unit_s = 1.0/ENCODER_UNIT_FREQUENCY_HZ;
+
+    // Constant speeds both ways, from a count every 470 us to two a capture tick, none a whole number of
+    // counts a sample or a unit period, so the edges come at every phase of the timers. The M/T speed is
+    // only out by the capture timer's resolution at each end of the unit period, and the interpolated angle
+    // by that plus the distance the rotor turns in a tick. The count alone is up to a whole count behind.
+    const double rpm[] = {31.9, 297.3, 3011.7, -303.1};
+    char name[64];
+    for (size_t k = 0; k < sizeof(rpm)/sizeof(rpm[0]); k++) {
+        EncoderRotor rotor = {1234.3, rpm[k]/60.0*ENCODER_COUNTS_PER_REV};
+        EncoderResult r = runEncoder(&rotor, 0.2, 3.0*unit_s, read_s);
+        double tick_counts = fabs(rotor.cps)*ENCODER_CAPTURE_TICK_S;
+        double speed_limit = 2.0*ENCODER_CAPTURE_TICK_S/unit_s*100.0;
+        int whole = (int)floor(fabs(rpm[k]) + 0.5);
+        const char *sign = rpm[k] < 0.0 ? "minus" : "";
+        snprintf(name, sizeof(name), "encoder.%s%drpm.speed_error_pct", sign, whole);
+        report(name, r.speed_error_pct, 0.0, speed_limit, "%");
+        snprintf(name, sizeof(name), "encoder.%s%drpm.angle_error_counts", sign, whole);
+        report(name, r.angle_error_counts, 0.0, tick_counts*(1.0 + speed_limit/100.0) + 0.01, "counts");
+        snprintf(name, sizeof(name), "encoder.%s%drpm.predict_error_counts", sign, whole);
+        report(name, r.predict_error_counts, 0.0,
+               tick_counts + fabs(rotor.cps)*(1.0/FOC_SAMPLING_FREQUENCY)*speed_limit/100.0 + 0.02, "counts");
+        snprintf(name, sizeof(name), "encoder.%s%drpm.count_error_counts", sign, whole);
+        printf("%-34s %12.4g %-8s\n", name, r.count_error_counts, "counts");
+    }
+
+    // 0.5 rpm: a count every 30 ms, so most unit periods have none. Once two counts have been timed, the
+    // speed is exact to a tick in 30 ms, and between counts it's still the speed, not the bound.
+    EncoderRotor slow = {17.6, 0.5/60.0*ENCODER_COUNTS_PER_REV};
+    EncoderResult r = runEncoder(&slow, 1.0, 0.1, read_s);
+    report("encoder.slow.speed_error_pct", r.speed_error_pct, 0.0, 2.0*ENCODER_CAPTURE_TICK_S*slow.cps*100.0, "%");
+    report("encoder.slow.angle_error_counts", r.angle_error_counts, 0.0, 0.01, "counts");
+
+    // Host time for one sample's angle and prediction
+    ENC_Estimator e;
+    ENC_init(&e, ENCODER_COUNTS_PER_REV, MOTOR_POLE_PAIRS, ENCODER_CAPTURE_TICK_S, (float)unit_s);
+    e.speed_cps = 20000.0f;
+    const int n = 1000000;
+    volatile float sink = 0.0f;
+    auto start = std::chrono::steady_clock::now();
+    for (int k = 0; k < n; k++) {
+        float theta = ENC_angle(&e, (uint32_t)k & 4095U, (uint16_t)(k & 7));
+        sink = ENC_predict(theta, ENC_omega(&e), 42e-6f);
+    }
+    auto stop = std::chrono::steady_clock::now();
+    (void)sink;
+    printf("%-34s %12.4g %-8s\n", "encoder.host_ns_per_sample", std::chrono::duration<double, std::nano>(stop - start).count()/n, "ns");
+}
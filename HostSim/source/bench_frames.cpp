@@ -0,0 +1,105 @@
+/*
+ * bench_frames.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Bench "frames": the GSx frame handoff, with a thread per core.
+ */
+
+#include "sil_bench.h"
+#include "ipc_channel.h"
+#include "frame_service.h"
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+uint16_t ipcTestWord(uint32_t sequence, uint16_t k); // bench_ipc.cpp
+
+/* Master select of the two frame buffers' GSx blocks, checked by both sides on every access */
+static std::atomic<uint16_t> frameOwner[FRAME_BUFFER_COUNT];
+static void selectTestFrameOwner(uint16_t buffer, uint16_t owner) {
+    frameOwner[buffer].store(owner);
+}
+
+void benchFrames() {
+    static CHAN_Outbox cpu1, cpu2;
+    static uint16_t gs12[FRAME_BUFFER_WORDS], gs13[FRAME_BUFFER_WORDS];
+    CHAN_Ring cpu1_ring, cpu2_ring;
+    CHAN_initRing(&cpu1_ring, &cpu1, &cpu2);
+    CHAN_initRing(&cpu2_ring, &cpu2, &cpu1);
+    FRAME_Writer writer;
+    FRAME_Reader reader;
+    FRAME_initWriter(&writer, gs12, gs13, selectTestFrameOwner);
+    FRAME_initReader(&reader, gs12, gs13);
+
+    // CPU1 fills frames of varying length as fast as it can, polling for releases like its IPC ISR would.
+    // CPU2 streams each frame in chunks, like the SCI, and releases it.
+    const uint32_t count = 20000;
+    std::atomic<uint32_t> owner_errors(0);
+    uint32_t data_errors = 0, received = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::thread consumer([&]() {
+        uint16_t type;
+        uint16_t message[CHAN_MAX_PAYLOAD_WORDS];
+        while (received < count) {
+            int16_t words = CHAN_receive(&cpu2_ring, &type, message, CHAN_MAX_PAYLOAD_WORDS);
+            if (words == CHAN_EMPTY) {
+                std::this_thread::yield();
+                continue;
+            }
+            FRAME_Ready ready;
+            memcpy(&ready, message, sizeof(ready));
+            if (type != CHAN_MSG_FRAME_READY || !FRAME_accept(&reader, &ready)) {
+                data_errors++;
+                continue;
+            }
+            uint16_t expected_words = (uint16_t)(1 + ready.sequence*97 % FRAME_BUFFER_WORDS);
+            data_errors += ready.words != expected_words;
+            uint16_t chunk_words, offset = 0;
+            const uint16_t *chunk;
+            while ((chunk = FRAME_nextChunk(&reader, 32, &chunk_words)) != NULL) {
+                owner_errors += frameOwner[ready.buffer].load() != FRAME_OWNER_CPU2;
+                for (uint16_t k = 0; k < chunk_words; k++) {
+                    data_errors += chunk[k] != ipcTestWord(ready.sequence, offset + k);
+                }
+                offset += chunk_words;
+            }
+            while (!FRAME_release(&reader, &cpu2_ring)) {
+                std::this_thread::yield();
+            }
+            received++;
+        }
+    });
+    uint32_t busy = 0;
+    double total_words = 0.0;
+    for (uint32_t sequence = 0; sequence < count; sequence++) {
+        uint16_t words = (uint16_t)(1 + sequence*97 % FRAME_BUFFER_WORDS);
+        total_words += words;
+        uint16_t *buffer = FRAME_buffer(&writer);
+        owner_errors += frameOwner[writer.filling].load() != FRAME_OWNER_CPU1;
+        for (uint16_t k = 0; k < words; k++) {
+            buffer[k] = ipcTestWord(sequence, k);
+        }
+        while (!FRAME_publish(&writer, &cpu1_ring, words)) {
+            busy++;
+            uint16_t type;
+            FRAME_Release release;
+            while (CHAN_receive(&cpu1_ring, &type, &release, CHAN_WORDS(release)) == CHAN_WORDS(release)) {
+                FRAME_handleRelease(&writer, &release);
+            }
+            std::this_thread::yield(); // The firmware would overwrite the frame. The test waits so none is lost.
+        }
+    }
+    consumer.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    report("frames.received", received, count, count, "");
+    report("frames.corrupt_or_out_of_order", data_errors + reader.errors + reader.lost, 0.0, 0.0, "");
+    report("frames.owner_violations", owner_errors.load(), 0.0, 0.0, "");
+    report("frames.writer_owns_filling_buffer", frameOwner[writer.filling].load() == FRAME_OWNER_CPU1, 1.0, 1.0, "");
+    printf("%-34s %12.4g %-8s\n", "frames.publish_retries_when_busy", (double)busy, "");
+    printf("%-34s %12.4g %-8s\n", "frames.host_mwords_per_s", total_words/seconds/1e6, "Mword/s");
+}
@@ -0,0 +1,227 @@
+/*
+ * bench_fsi.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Bench "fsi": ThreePhaseGen's FSI port against a controller on a simulated link. fsi_port.c runs from
+ *  libthreephasegen.a on the link through fsi_hal.h, and the bench plays the main loop calling its poll.
+ */
+
+#include "sil_bench.h"
+#include "sim_peripherals.h"
+#include "fsi_sim.h"
+#include "fsi_port.h"
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+/* The FSI bench's two ends on the simulated link: ThreePhaseGen with its FSI port (libthreephasegen.a), and
+ * a controller sending pings and references. The controller's clock is the SYSCLK cycle count, so the true
+ * offset of the generator's is known. */
+typedef struct {
+    SimFsiLink *link;
+    FSIL_Controller controller;
+    uint32_t cycle; // SYSCLK cycles since ConfigThreePhaseGen(): the controller's ticks
+    bool polling; // False stalls the generator's background
+    double ping_every_s;
+    double next_ping_s;
+    unsigned long pings;
+    unsigned long data_frames; // To the generator
+    uint32_t version; // tpgVersion after the last interrupt
+    std::vector<std::pair<uint32_t, uint32_t>> changes; // The sample and cycle of each new parameter set
+} FsiBench;
+
+static uint32_t fsiGeneratorTicks() {
+    return ~simPeripherals.timer[TPG_TIMESTAMP_TIMER].getCounter(); // TPG_ticks()
+}
+
+static double fsiNow(const FsiBench *b) {
+    return b->cycle/TPG_SYSCLK_HZ;
+}
+
+static void fsiSend(FsiBench *b, int direction, const uint16_t *words, bool damaged) {
+    SimFsiFrame frame = {false, 0, {0}, damaged};
+    memcpy(frame.words, words, sizeof(frame.words));
+    b->link->send(direction, fsiNow(b), frame);
+    b->data_frames += direction == SIM_FSI_TO_GENERATOR;
+}
+
+/* Runs both ends to until_s, a SYSCLK at a time: the frames that have ended, the timer interrupt with the
+ * port's poll after it, and the controller's pings whenever its line is free */
+static void runFsi(FsiBench *b, double until_s) {
+    SimCpuTimer &timer1 = simPeripherals.timer[1];
+    SimCpuTimer &timestamps = simPeripherals.timer[TPG_TIMESTAMP_TIMER];
+    while (fsiNow(b) < until_s) {
+        timestamps.tick();
+        bool sampled = timer1.tick();
+        b->cycle++;
+        int direction;
+        SimFsiFrame frame;
+        while (b->link->nextFrame(fsiNow(b), &direction, &frame)) {
+            if (direction == SIM_FSI_TO_CONTROLLER && !frame.damaged) { // The generator's end is in the link
+                FSIL_controllerReceive(&b->controller, frame.words, b->cycle);
+            }
+        }
+        if (sampled) {
+            if (tpgVersion != b->version) {
+                b->changes.push_back(std::make_pair((uint32_t)tpgSample, b->cycle));
+                b->version = tpgVersion;
+            }
+            if (b->polling) {
+                FSIPORT_poll(); // The main loop, woken by the interrupt
+            }
+        }
+        if (b->ping_every_s > 0.0 && fsiNow(b) >= b->next_ping_s && !b->link->busy(SIM_FSI_TO_GENERATOR, fsiNow(b))) {
+            SimFsiFrame ping = {true, FSIL_ping(&b->controller, b->cycle), {0}, false};
+            b->link->send(SIM_FSI_TO_GENERATOR, fsiNow(b), ping);
+            b->pings++;
+            b->next_ping_s += b->ping_every_s;
+        }
+    }
+}
+
+static void initFsi(FsiBench *b, SimFsiLink *link) {
+    simPeripherals.reset();
+    ConfigThreePhaseGen();
+    link->reset();
+    simPeripherals.fsi = link;
+    FSIPORT_init();
+    b->link = link;
+    FSIL_initController(&b->controller);
+    b->cycle = 0;
+    b->polling = true;
+    b->ping_every_s = 0.0;
+    b->next_ping_s = 0.0;
+    b->pings = 0;
+    b->data_frames = 0;
+    b->version = tpgVersion;
+    b->changes.clear();
+}
+
+void benchFsi() {
+    SimFsiLink link(FSI_BIT_RATE, TPG_SYSCLK_HZ);
+    static FsiBench b;
+    initFsi(&b, &link);
+    uint16_t words[FSIL_FRAME_WORDS];
+    const SimFsiFrame ping_frame = {true, 0, {0}, false}, data_frame = {false, 0, {0}, false};
+    const double ping_s = SimFsiLink::frameBits(ping_frame)/FSI_BIT_RATE;
+    const double data_s = SimFsiLink::frameBits(data_frame)/FSI_BIT_RATE;
+    const double sample_s = 1.0/TPG_SAMPLING_FREQUENCY;
+
+    // Pings every 200 us and status frames at 1 kHz. Each reply takes the generator's time holding the
+    // ping out of the round trip, which leaves the frames' time on the line, and the offset of its clock is
+    // only out by half the difference in their lengths.
+    b.ping_every_s = 200e-6;
+    runFsi(&b, 5e-3);
+    const FSIL_Controller &c = b.controller;
+    const double link_delay_s = (ping_s + data_s)/2.0;
+    const double true_offset = (double)(int32_t)(fsiGeneratorTicks() - b.cycle);
+    report("fsi.ping.replies", (double)c.replies, b.pings - 1.0, (double)b.pings, "");
+    report("fsi.ping.lost_or_stray", (double)(c.pings_lost + c.strays), 0.0, 0.0, "");
+    report("fsi.ping.min_link_delay_us", c.min_link_delay*1e6/TPG_SYSCLK_HZ, link_delay_s*1e6 - 0.05, link_delay_s*1e6 + 0.05, "us");
+    report("fsi.ping.max_link_delay_us", c.max_link_delay*1e6/TPG_SYSCLK_HZ, link_delay_s*1e6 - 0.05, link_delay_s*1e6 + 0.05, "us");
+    report("fsi.ping.offset_error_ticks", fabs(c.offset - true_offset), 0.0, (data_s - ping_s)/2.0*TPG_SYSCLK_HZ + 2.0, "");
+    report("fsi.status.frames", (double)fsiReceiver.statuses, 4.0, 5.0, "");
+    printf("%-34s %12.4g %-8s\n", "fsi.ping.round_trip_us", c.round_trip*1e6/TPG_SYSCLK_HZ, "us");
+
+    // References for a time on the controller's clock, each sent 300 us ahead and 100 us after the last, so
+    // a few are queued while the one before waits for its sample. Each must take effect at exactly the
+    // sample it names, the first at or after that time, and the status must then report the last one.
+    const int timed = 12;
+    std::vector<uint32_t> starts;
+    std::vector<uint32_t> wanted;
+    float frequency = 0.0f;
+    for (int k = 0; k < timed; k++) {
+        uint32_t at = b.cycle + (uint32_t)((300e-6 + 7e-6*k)*TPG_SYSCLK_HZ);
+        frequency = 60.0f + 10.0f*k;
+        starts.push_back(FSIL_sampleAt(&c, at));
+        wanted.push_back(at);
+        FSIL_encodeNextReference(&b.controller, frequency, starts.back(), words);
+        fsiSend(&b, SIM_FSI_TO_GENERATOR, words, false);
+        runFsi(&b, fsiNow(&b) + 100e-6);
+    }
+    runFsi(&b, fsiNow(&b) + 2e-3);
+    unsigned long start_errors = b.changes.size() != (size_t)timed;
+    double max_late_us = 0.0, min_late_us = 1e9;
+    for (size_t k = 0; k < b.changes.size() && k < starts.size(); k++) {
+        start_errors += b.changes[k].first != starts[k];
+        double late_us = (int32_t)(b.changes[k].second - wanted[k])*1e6/TPG_SYSCLK_HZ;
+        max_late_us = std::max(max_late_us, late_us);
+        min_late_us = std::min(min_late_us, late_us);
+    }
+    report("fsi.timed.start_errors", (double)start_errors, 0.0, 0.0, "");
+    report("fsi.timed.min_late_us", min_late_us, -1.5, 1.5, "us"); // The offset's error either way
+    report("fsi.timed.max_late_us", max_late_us, 0.0, sample_s*1e6 + 1.5, "us");
+    report("fsi.timed.status", c.status.sequence == ((timed - 1) & 0xFF) && c.status.frequency == frequency
+           && c.status.errors == 0, 1.0, 1.0, "");
+    report("fsi.timed.late", (double)fsiReceiver.late, 0.0, 0.0, "");
+
+    // The cases one at a time: a frame damaged on the line (lost, found by the next one's sequence), a
+    // frequency out of range, a start already past (late, applied from the next sample), one too far
+    // ahead, and a frame that isn't a reference
+    const FSIL_Receiver before = fsiReceiver;
+    FSIL_encodeNextReference(&b.controller, 100.0f, FSIL_sampleAt(&c, b.cycle) + 100, words);
+    fsiSend(&b, SIM_FSI_TO_GENERATOR, words, true);
+    FSIL_encodeNextReference(&b.controller, 5000.0f, FSIL_sampleAt(&c, b.cycle) + 100, words);
+    fsiSend(&b, SIM_FSI_TO_GENERATOR, words, false);
+    FSIL_encodeNextReference(&b.controller, 110.0f, tpgSample - 10, words);
+    fsiSend(&b, SIM_FSI_TO_GENERATOR, words, false);
+    runFsi(&b, fsiNow(&b) + 100e-6);
+    uint32_t late_sample = tpgSample;
+    bool late_applied = b.changes.back().first <= late_sample && tpgInUse->frequency == 110.0f;
+    FSIL_encodeNextReference(&b.controller, 120.0f, tpgSample + 2*FSIL_MAX_LEAD, words);
+    fsiSend(&b, SIM_FSI_TO_GENERATOR, words, false);
+    FSIL_Status status = {0, 0, 0, 0.0f, 0};
+    FSIL_encodeStatus(&status, words);
+    fsiSend(&b, SIM_FSI_TO_GENERATOR, words, false);
+    runFsi(&b, fsiNow(&b) + 2e-3);
+    unsigned long errors = fsiReceiver.lost - before.lost != 1 || fsiReceiver.line_errors - before.line_errors != 1
+                           || fsiReceiver.refused - before.refused != 3 || fsiReceiver.late - before.late != 1
+                           || fsiReceiver.received - before.received != 1 || !late_applied;
+    report("fsi.case_errors", (double)errors, 0.0, 0.0, "");
+
+    // The background stalled while references come back to back: the DMA goes round the ring over frames
+    // not yet read, and the queue fills. Every reference must still be counted once, as received (queued or
+    // overflowed), refused or lost.
+    const int flood = 60;
+    b.polling = false;
+    for (int k = 0; k < flood; k++) {
+        FSIL_encodeNextReference(&b.controller, 50.0f, tpgSample + 10, words);
+        fsiSend(&b, SIM_FSI_TO_GENERATOR, words, false);
+    }
+    runFsi(&b, fsiNow(&b) + flood*data_s + 50e-6);
+    b.polling = true;
+    FSIL_encodeNextReference(&b.controller, 50.0f, tpgSample + 10, words);
+    fsiSend(&b, SIM_FSI_TO_GENERATOR, words, false);
+    runFsi(&b, fsiNow(&b) + 2e-3);
+    const FSIL_Receiver &r = fsiReceiver;
+    report("fsi.flood.lost", (double)(r.lost - before.lost - 1), flood - FSIL_RX_RING_FRAMES, flood - 1.0, "");
+    report("fsi.flood.overflows", (double)r.overflows, 1.0, flood, "");
+    report("fsi.references_unaccounted", (double)b.data_frames - r.received - r.refused - r.lost, 0.0, 0.0, "");
+    report("fsi.ping.lost_at_end", (double)(c.pings_lost + c.strays), 0.0, 0.0, "");
+    printf("%-34s %12.4g %-8s\n", "fsi.data_frame_us", data_s*1e6, "us");
+    printf("%-34s %12.4g %-8s\n", "fsi.link_load_pct", 100.0*(link.busy_s[0] + link.busy_s[1])/(2.0*fsiNow(&b)), "%");
+
+    // Host time to decode a ring of references
+    static uint16_t ring[FSIL_RX_RING_FRAMES*FSIL_FRAME_WORDS];
+    FSIL_Receiver timing;
+    FSIL_initReceiver(&timing, ring, 50.0f);
+    for (int k = 0; k < FSIL_RX_RING_FRAMES; k++) {
+        FSIL_Reference reference = {(uint16_t)k, 100, 50.0f};
+        FSIL_encodeReference(&reference, ring + k*FSIL_FRAME_WORDS);
+    }
+    const int n = 100000;
+    auto start = std::chrono::steady_clock::now();
+    for (int k = 0; k < n; k++) {
+        timing.tail = 1;
+        timing.queue_tail = timing.queue_head;
+        FSIL_receive(&timing, 0, 0);
+    }
+    auto stop = std::chrono::steady_clock::now();
+    printf("%-34s %12.4g %-8s\n", "fsi.host_ns_per_frame",
+           std::chrono::duration<double, std::nano>(stop - start).count()/n/(FSIL_RX_RING_FRAMES - 1), "ns");
+}
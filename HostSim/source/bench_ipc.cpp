@@ -0,0 +1,110 @@
+/*
+ * bench_ipc.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Bench "ipc": the CPU1-CPU2 message ring, with a thread per core.
+ */
+
+#include "sil_bench.h"
+#include "ipc_channel.h"
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+/* Typed message of the stress test. The bulk frames are words derived from the sequence number. */
+struct IpcTestMessage {
+    uint32_t sequence;
+    float values[3];
+};
+
+uint16_t ipcTestWord(uint32_t sequence, uint16_t k) {
+    return (uint16_t)(sequence*2654435761U >> 16) ^ (uint16_t)(k*40503U);
+}
+
+void benchIpc() {
+    static CHAN_Outbox cpu1, cpu2; // The two message RAMs
+    CHAN_Ring sender, receiver;
+    CHAN_initRing(&sender, &cpu1, &cpu2);
+    CHAN_initRing(&receiver, &cpu2, &cpu1);
+
+    // Single thread: a full ring refuses a message without writing it, and an oversized one is dropped
+    uint16_t frame[CHAN_MAX_PAYLOAD_WORDS + 1] = {0};
+    int accepted = 0;
+    while (CHAN_send(&sender, CHAN_MSG_USER, frame, 100)) {
+        accepted++;
+    }
+    report("ipc.full_ring_messages", accepted, CHAN_RING_WORDS/102, CHAN_RING_WORDS/102, "");
+    report("ipc.full_ring_write_index_kept", cpu1.write_index == accepted*102, 1.0, 1.0, "");
+    uint16_t type;
+    int drained = 0;
+    while (CHAN_receive(&receiver, &type, frame, 99) == CHAN_TOO_LONG) {
+        drained++;
+    }
+    report("ipc.too_long_dropped", drained, accepted, accepted, "");
+    report("ipc.oversized_send_refused", !CHAN_send(&sender, CHAN_MSG_USER, frame, CHAN_MAX_PAYLOAD_WORDS + 1), 1.0, 1.0, "");
+
+    // Two threads, like the two cores: typed messages alternate with bulk frames of varying length
+    const uint32_t count = 200000;
+    uint32_t errors = 0, received = 0, full = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::thread consumer([&]() {
+        uint16_t buffer[CHAN_MAX_PAYLOAD_WORDS];
+        uint16_t message_type;
+        while (received < count) {
+            int16_t words = CHAN_receive(&receiver, &message_type, buffer, CHAN_MAX_PAYLOAD_WORDS);
+            if (words == CHAN_EMPTY) {
+                std::this_thread::yield(); // The host may have fewer cores than threads
+                continue;
+            }
+            if (message_type == CHAN_MSG_USER) {
+                IpcTestMessage m;
+                memcpy(&m, buffer, sizeof(m));
+                if (words != CHAN_WORDS(m) || m.sequence != received || m.values[2] != (float)received) {
+                    errors++;
+                }
+            }
+            else {
+                uint16_t expected_words = (uint16_t)(1 + received % CHAN_MAX_PAYLOAD_WORDS);
+                if (message_type != CHAN_MSG_USER + 1 || words != expected_words) {
+                    errors++;
+                }
+                for (uint16_t k = 0; k < expected_words && k < words; k++) {
+                    errors += buffer[k] != ipcTestWord(received, k);
+                }
+            }
+            received++;
+        }
+    });
+    for (uint32_t sequence = 0; sequence < count; sequence++) {
+        bool sent;
+        do {
+            if (sequence % 2 == 0) {
+                IpcTestMessage m = {sequence, {0.0f, 1.0f, (float)sequence}};
+                sent = CHAN_SEND_STRUCT(&sender, CHAN_MSG_USER, m);
+            }
+            else {
+                uint16_t words = (uint16_t)(1 + sequence % CHAN_MAX_PAYLOAD_WORDS);
+                for (uint16_t k = 0; k < words; k++) {
+                    frame[k] = ipcTestWord(sequence, k);
+                }
+                sent = CHAN_send(&sender, CHAN_MSG_USER + 1, frame, words);
+            }
+            if (!sent) {
+                full++;
+                std::this_thread::yield();
+            }
+        } while (!sent); // The firmware would drop or retry later. The test waits so nothing is lost.
+    }
+    consumer.join();
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()/count;
+
+    report("ipc.messages_received", received, count, count, "");
+    report("ipc.corrupt_or_out_of_order", errors, 0.0, 0.0, "");
+    report("ipc.ring_empty_after", CHAN_hasMessage(&receiver), 0.0, 0.0, "");
+    printf("%-34s %12.4g %-8s\n", "ipc.send_retries_when_full", (double)full, "");
+    printf("%-34s %12.4g %-8s\n", "ipc.host_ns_per_message", ns, "ns");
+}
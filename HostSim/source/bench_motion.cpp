@@ -0,0 +1,143 @@
+/*
+ * bench_motion.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Bench "motion": CPU2's speed and position control on the current loop.
+ */
+
+#include "sil_bench.h"
+#include "sil_simulation.h"
+#include "pwm.h"
+#include "motion_control.h"
+#include <stdio.h>
+#include <math.h>
+
+/* Runs the motion controller on the current loop as CPU2 does: every period of its own timer, locked to
+ * a whole number of current loop samples, it reads the angle from the telemetry and hands a new iq
+ * reference to the current loop. The IPC delay is left out, it is a fraction of a current sample. */
+class MotionLoop {
+    public:
+        SilSimulation sim;
+        MOTION_Controller mc;
+        uint32_t sequence;
+        double period; // (s)
+        double next_period; // Time of the next one (s)
+        unsigned long refused;
+        unsigned long late; // Samples that used a reference older than the last one handed over
+        double position; // The motor's mechanical position, unwrapped (rad)
+        double following; // Largest distance between it and the trajectory at the start of a period (rad)
+
+        explicit MotionLoop(const PmsmParameters &motor)
+            : sim(motor, AVERAGE_INVERTER, 24.0, 0.0), sequence(0), next_period(0.0), refused(0), late(0),
+              position(0.0), following(0.0) {
+            sim.params.enable = 1;
+            MOTION_init(&mc, 1.0f/MOTION_CONTROL_FREQUENCY, (float)MOTOR_POLE_PAIRS, (float)MOTOR_FLUX);
+            period = (FOC_SAMPLING_FREQUENCY/MOTION_CONTROL_FREQUENCY)*sim.getSamplePeriod();
+            MOTION_setPeriod(&mc, (float)period);
+        }
+
+        void run(double duration_s) {
+            double end = sim.getTime() + duration_s;
+            while (sim.getTime() < end) {
+                if (sim.getTime() >= next_period) {
+                    next_period += period;
+                    following = fmax(following, fabs(mc.trajectory.position - position));
+                    const FOC_DQ ref = {0.0f, MOTION_run(&mc, sim.telemetry.theta)};
+                    if (!CLA_setCurrentReference(&sim.params, &sim.telemetry, ref, ++sequence)) {
+                        refused++;
+                    }
+                }
+                double theta = sim.getMotor().getThetaElectrical();
+                sim.runSample();
+                position += wrapRadians(sim.getMotor().getThetaElectrical() - theta)/MOTOR_POLE_PAIRS;
+                if (sim.telemetry.ref_sequence != sequence) {
+                    late++;
+                }
+            }
+        }
+};
+
+void benchMotion() {
+    // Only one SilSimulation at a time: they share the simulated peripherals
+    unsigned long refused = 0, late = 0;
+    {
+        const double move = 20.0; // rad
+        MotionLoop loop(SIM_defaultMotor());
+        loop.run(0.01); // Settle with the motion controller off
+        loop.position = loop.mc.position; // Both count from the first angle
+        MOTION_setMode(&loop.mc, MOTION_MODE_POSITION, (float)move);
+
+        double overshoot = 0.0, settle = -1.0;
+        double t0 = loop.sim.getTime();
+        while (loop.sim.getTime() - t0 < 0.3) {
+            loop.run(loop.period);
+            double x = loop.position;
+            overshoot = fmax(overshoot, x - move);
+            if (fabs(x - move) > 0.01) {
+                settle = -1.0;
+            } else if (settle < 0.0) {
+                settle = loop.sim.getTime() - t0;
+            }
+        }
+        // Shortest move within the limits: accelerate to the speed limit, cruise, brake
+        double ideal = move/MOTION_MAX_SPEED + MOTION_MAX_SPEED/MOTION_MAX_ACCELERATION;
+        report("motion.position_final_error_rad", loop.position - move, -0.01, 0.01, "rad");
+        report("motion.position_overshoot_rad", overshoot, 0.0, 0.005*move, "rad");
+        report("motion.position_following_max_rad", loop.following, 0.0, 0.2, "rad");
+        report("motion.position_settle_ms", settle*1e3, 0.0, 1e3*(ideal + 0.05), "ms");
+        printf("%-34s %12.4g %-8s\n", "motion.position_move_min_ms", ideal*1e3, "ms");
+        refused += loop.refused;
+        late += loop.late;
+    }
+    {
+        // Speed mode with a load torque step. The speed is measured over whole motion periods from the
+        // position, which averages out the current loop's limit cycle.
+        const double speed = 200.0, load = 0.02;
+        MotionLoop loop(SIM_defaultMotor());
+        loop.run(0.01);
+        MOTION_setMode(&loop.mc, MOTION_MODE_SPEED, (float)speed);
+        loop.run(0.1);
+        loop.sim.getMotor().setLoadTorque(load);
+        double dip = 0.0;
+        double t0 = loop.sim.getTime();
+        while (loop.sim.getTime() - t0 < 0.1) {
+            double x = loop.position, t = loop.sim.getTime();
+            loop.run(loop.period);
+            dip = fmax(dip, speed - (loop.position - x)/(loop.sim.getTime() - t));
+        }
+        double x = loop.position, t = loop.sim.getTime();
+        loop.run(0.05);
+        double omega = (loop.position - x)/(loop.sim.getTime() - t);
+        double friction = SIM_defaultMotor().B*omega;
+        report("motion.speed_error_pct", 100.0*(omega - speed)/speed, -1.0, 1.0, "%");
+        report("motion.load_step_dip_pct", 100.0*dip/speed, 0.0, 10.0, "%");
+        report("motion.load_estimate_error_pct", 100.0*(loop.mc.observer.load_torque - load - friction)/load,
+               -10.0, 10.0, "%");
+        refused += loop.refused;
+        late += loop.late;
+
+        // What CPU1 reports as its sample period (FOC_getSamplePeriodCycles()), which CPU2 locks to
+        double cycles = (double)phaseA->getPeriodCycles()*(PWM_FREQUENCY_HZ/FOC_SAMPLING_FREQUENCY);
+        report("motion.sample_cycles_error", cycles - loop.sim.getSamplePeriod()*PLLSYSCLK, -0.5, 0.5, "cycles");
+    }
+
+    // Every reference was accepted and used from the next current sample on
+    report("motion.references_refused", (double)refused, 0.0, 0.0, "");
+    report("motion.samples_with_stale_reference", (double)late, 0.0, 0.0, "");
+
+    // The handoff never overwrites the slot a sample is using: with a sample still on slot 0 after the
+    // first handoff flipped to slot 1, the second handoff is refused until the next sample latches slot 1
+    CLA_CurrentLoopParams p;
+    CLA_CurrentLoopTelemetry t;
+    const FOC_DQ zero = {0.0f, 0.0f}, a = {0.0f, 1.0f}, b = {0.0f, 2.0f};
+    CLA_forceCurrentReference(&p, zero);
+    t.ref_index = p.ref_index;
+    bool first = CLA_setCurrentReference(&p, &t, a, 1);
+    bool second = CLA_setCurrentReference(&p, &t, b, 2); // The sample on slot 0 hasn't finished
+    bool intact = p.ref[t.ref_index].i_ref.q == 0.0f && p.ref[p.ref_index].i_ref.q == 1.0f;
+    t.ref_index = p.ref_index; // The next sample latches slot 1
+    bool third = CLA_setCurrentReference(&p, &t, b, 2);
+    report("motion.handoff_protects_latched_slot", first && !second && intact && third, 1.0, 1.0, "");
+}
@@ -0,0 +1,180 @@
+/*
+ * bench_params.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Bench "params": live retuning through the double-buffered parameter sets.
+ */
+
+#include "sil_bench.h"
+#include "sil_simulation.h"
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+/* 10-90% rise time of the plant's iq for a step from 0 to step (A), with whatever gains the loop has */
+static double currentRiseTime(SilSimulation &sim, double step, uint32_t sequence) {
+    const FOC_DQ zero = {0.0f, 0.0f}, step_ref = {0.0f, (float)step};
+    CLA_setCurrentReference(&sim.params, &sim.telemetry, zero, sequence);
+    sim.run(0.01);
+    CLA_setCurrentReference(&sim.params, &sim.telemetry, step_ref, sequence + 1);
+    double t0 = sim.getTime(), t10 = -1.0, t90 = -1.0;
+    while (sim.getTime() - t0 < 0.01 && t90 < 0.0) {
+        sim.run(2e-6);
+        double iq = sim.getMotor().getIq();
+        if (t10 < 0.0 && iq >= 0.1*step) {
+            t10 = sim.getTime();
+        }
+        if (t90 < 0.0 && iq >= 0.9*step) {
+            t90 = sim.getTime();
+        }
+    }
+    return t10 >= 0.0 && t90 >= 0.0 ? t90 - t10 : 1.0;
+}
+
+/* The current gains a version of the stress test commits, so a sample's set can be checked against its version */
+static FOC_CurrentGains versionGains(uint32_t version) {
+    FOC_CurrentGains gains;
+    gains.Kp_d = 0.5f + (float)(version & 1023U)*1e-3f;
+    gains.Ki_Ts_d = gains.Kp_d*0.1f;
+    gains.Kp_q = gains.Kp_d*2.0f;
+    gains.Ki_Ts_q = gains.Kp_d*0.3f;
+    return gains;
+}
+
+static bool gainsMatch(const CLA_CurrentGains &set) {
+    FOC_CurrentGains expected = versionGains(set.version);
+    return set.pi.Kp_d == expected.Kp_d && set.pi.Ki_Ts_d == expected.Ki_Ts_d && set.pi.Kp_q == expected.Kp_q
+           && set.pi.Ki_Ts_q == expected.Ki_Ts_q;
+}
+
+void benchParams() {
+    // Closed loop: halving the current bandwidth through the gain bank doubles the rise time, from the
+    // sample after the commit, and the telemetry says which set each sample ran with
+    SilSimulation sim(SIM_defaultMotor(), AVERAGE_INVERTER, 24.0, 0.0);
+    sim.getMotor().holdSpeed(300.0);
+    sim.params.enable = 1;
+    sim.run(0.02);
+    double design_rise = currentRiseTime(sim, 6.0, 1); // As large as current_step's, for the compare resolution
+
+    CLA_CurrentGains *shadow = CLA_editCurrentGains(&sim.params, &sim.telemetry);
+    bool edited = shadow && shadow->version == 0 && shadow != &sim.params.gains[sim.telemetry.gains_index];
+    if (shadow) {
+        shadow->pi = FOC_designCurrentGains(MOTOR_RS, MOTOR_LD, MOTOR_LQ, 1.0f/FOC_SAMPLING_FREQUENCY,
+                                            0.5f*FOC_CURRENT_BANDWIDTH_HZ);
+        CLA_commitCurrentGains(&sim.params);
+    }
+    bool refused = CLA_editCurrentGains(&sim.params, &sim.telemetry) == 0; // The loop hasn't taken it yet
+    uint32_t committed_at = sim.telemetry.sample_count;
+    while (sim.telemetry.gains_version == 0 && sim.telemetry.sample_count - committed_at < 10) {
+        sim.runSample();
+    }
+    uint32_t latency = sim.telemetry.sample_count - committed_at;
+    double slow_rise = currentRiseTime(sim, 6.0, 3);
+    report("params.edit_and_refusal", edited && refused, 1.0, 1.0, "");
+    report("params.samples_to_new_set", (double)latency, 1.0, 1.0, "samples");
+    report("params.rise_time_ratio", slow_rise/design_rise, 1.6, 2.4, "");
+
+    // Stress: a loop thread runs samples while an editor thread commits new sets as fast as it can. After
+    // each sample the set it latched must be whole and the version it reported, and versions never go back.
+    static FOC_CurrentLoop loop;
+    static OBS_Sensorless observer;
+    static CLA_CurrentLoopParams params;
+    static CLA_CurrentLoopTelemetry telemetry;
+    loop = sim.loop;
+    observer = sim.observer;
+    params = sim.params;
+    telemetry = sim.telemetry;
+    CLA_initCurrentGains(&params, versionGains(0));
+    telemetry.gains_index = 0;
+    const unsigned long target_commits = 20000;
+    std::atomic<unsigned long> commits(0);
+    std::atomic<bool> done(false);
+    unsigned long samples = 0, busy = 0;
+    uint32_t torn = 0, mismatched = 0, backwards = 0, versions_seen = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::thread editor([&]() {
+        while (!done.load()) {
+            CLA_CurrentGains *set = CLA_editCurrentGains(&params, &telemetry);
+            if (!set) {
+                busy++;
+                std::this_thread::yield(); // The host may have fewer cores than threads
+                continue;
+            }
+            set->pi = versionGains(set->version + 1U); // The version the commit makes it
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            CLA_commitCurrentGains(&params);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            commits++;
+        }
+    });
+    uint16_t cmp[3];
+    uint32_t last_version = 0;
+    while (commits.load() < target_commits && samples < 100*target_commits) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        CLA_runCurrentLoopSample(&loop, &observer, &params, (uint16_t)(2048 + (samples & 63)),
+                                 (uint16_t)(2048 - (samples & 63)), 600, cmp, &telemetry);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const CLA_CurrentGains &set = params.gains[telemetry.gains_index]; // Not written until the next sample
+        torn += !gainsMatch(set);
+        mismatched += set.version != telemetry.gains_version;
+        backwards += telemetry.gains_version < last_version;
+        versions_seen += telemetry.gains_version != last_version;
+        last_version = telemetry.gains_version;
+        if (++samples % 16 == 0) {
+            std::this_thread::yield();
+        }
+    }
+    done = true;
+    editor.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report("params.stress_versions_seen", (double)versions_seen, target_commits - 1.0, (double)target_commits, ""); // The last may not be taken
+    report("params.stress_torn_sets", (double)torn, 0.0, 0.0, "");
+    report("params.stress_version_mismatches", (double)mismatched, 0.0, 0.0, "");
+    report("params.stress_versions_backwards", (double)backwards, 0.0, 0.0, "");
+    printf("%-34s %12.4g %-8s\n", "params.stress_samples", (double)samples, "");
+    printf("%-34s %12.4g %-8s\n", "params.stress_commits_per_s", commits.load()/seconds, "");
+    printf("%-34s %12.4g %-8s\n", "params.stress_edits_refused", (double)busy, "");
+
+    // ThreePhaseGen: the frequency changes at the next timer interrupt without a jump in the waveform,
+    // and what it can't take is refused
+    simPeripherals.reset();
+    ConfigThreePhaseGen();
+    SimCpuTimer &timer1 = simPeripherals.timer[1];
+    SimEpwm &phase_a = simPeripherals.epwm[TPG_EPWM_PHASE_A];
+    std::vector<double> duty;
+    auto runTpg = [&](double seconds_to_run) {
+        for (unsigned long n = (unsigned long)(seconds_to_run*PLLSYSCLK); n > 0; n--) {
+            timer1.tick();
+            phase_a.tick();
+            if (phase_a.getCounter() == 0) {
+                duty.push_back(phase_a.getDutyCycle());
+            }
+        }
+    };
+    runTpg(0.25/TPG_SINUSOID_FREQUENCY);
+    duty.clear(); // From the first compare value
+    runTpg(0.25/TPG_SINUSOID_FREQUENCY);
+    uint32_t version = tpgVersion;
+    bool set = TPG_setFrequency(2.0f*TPG_SINUSOID_FREQUENCY);
+    bool too_soon = !TPG_setFrequency(3.0f*TPG_SINUSOID_FREQUENCY); // The ISR hasn't taken the last one
+    runTpg(0.5/TPG_SINUSOID_FREQUENCY);
+    bool out_of_range = !TPG_setFrequency(2000.0f) && !TPG_setFrequency(-1.0f) && !TPG_setFrequency(NAN);
+    double max_step = 0.0;
+    for (size_t k = 1; k < duty.size(); k++) {
+        max_step = std::max(max_step, fabs(duty[k] - duty[k - 1]));
+    }
+    duty.clear();
+    runTpg(0.5/TPG_SINUSOID_FREQUENCY); // One period at the new frequency
+    double magnitude, phase;
+    fourier(duty, 1, &magnitude, &phase);
+    report("params.tpg_version_taken", tpgVersion == version + 1U, 1.0, 1.0, "");
+    report("params.tpg_refusals", set && too_soon && out_of_range, 1.0, 1.0, "");
+    report("params.tpg_max_duty_step", max_step, 0.0, 0.015, "");
+    report("params.tpg_amplitude_at_new_frequency", magnitude, 0.49, 0.51, "");
+}
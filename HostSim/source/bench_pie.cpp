@@ -0,0 +1,120 @@
+/*
+ * bench_pie.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Bench "pie": the CPU1, CPU2 and ThreePhaseGen interrupt mixes on the PIE simulator.
+ */
+
+#include "sil_bench.h"
+#include "sil_simulation.h"
+#include "pie_simulator.h"
+#include "motion_control.h"
+#include "ipc_link.h"
+#include <stdio.h>
+
+/* Runs a PIE scenario in worst case mode and reports every ISR against its deadline */
+static void reportPieScenario(const char *scenario, PieSimulator &pie, const char *profile) {
+    char name[96];
+    int unmeasured;
+    snprintf(name, sizeof(name), "pie.%s.profile_costs", scenario);
+    report(name, PIE_loadCycleProfile(profile, pie, &unmeasured), (double)pie.getSourceCount(), (double)pie.getSourceCount(), "");
+    snprintf(name, sizeof(name), "pie.%s.unmeasured_costs", scenario); // Estimates only show the schedule could work
+    report(name, unmeasured, 0.0, 0.0, "");
+
+    pie.run(2.0);
+    for (size_t k = 0; k < pie.getSourceCount(); k++) {
+        const PieIsrSource &source = pie.getSource(k);
+        const PieIsrStats &stats = pie.getStats(k);
+        double period_us = source.type == PIE_SOURCE_PERIODIC ? source.period_s*1e6 : source.phase_s*1e6;
+        printf("pie.%s.%s: %lu triggers, latency %.2f-%.2f us, response %.2f us\n", scenario, source.name.c_str(),
+               stats.triggers, stats.latency_min*1e6/pie.getClock().sysclk_Hz, pie.worstLatencyUs(k),
+               stats.response_max*1e6/pie.getClock().sysclk_Hz);
+
+        snprintf(name, sizeof(name), "pie.%s.%s.overruns", scenario, source.name.c_str());
+        report(name, stats.overruns, 0.0, 0.0, "");
+        snprintf(name, sizeof(name), "pie.%s.%s.worst_latency_us", scenario, source.name.c_str());
+        double deadline_us = source.deadline_s > 0.0 ? source.deadline_s*1e6 : 0.5*period_us; // Half its period by default
+        report(name, pie.worstLatencyUs(k), 0.0, deadline_us, "us");
+        snprintf(name, sizeof(name), "pie.%s.%s.jitter_us", scenario, source.name.c_str());
+        report(name, pie.jitterUs(k), 0.0, deadline_us, "us");
+        snprintf(name, sizeof(name), "pie.%s.%s.load_pct", scenario, source.name.c_str());
+        report(name, pie.loadPct(k), 0.0, 100.0, "%");
+    }
+    snprintf(name, sizeof(name), "pie.%s.total_load_pct", scenario);
+    report(name, pie.totalLoadPct(), 0.0, 80.0, "%");
+}
+
+void benchPie() {
+    const PieClockProfile cpu1_clock = {"cpu1", PLLSYSCLK, 14, 8}; // Hardware interrupt latency and IRET (TRM)
+    const PieClockProfile cpu2_clock = {"cpu2", PLLSYSCLK, 14, 8}; // Same clock as CPU1
+    const PieClockProfile tpg_clock = {"threephasegen", TPG_SYSCLK_HZ, 14, 8};
+
+    // CPU1 with the current loop on the C28x (FOC_RUN_ON_CLA 0), the heavier case. CPU2 owns the comms
+    // peripherals and the motion control, so CPU1 only publishes telemetry (CPU timer 0) and receives a
+    // current reference every motion period plus at most one command per CPU2 poll over IPC.
+    PieSimulator cpu1(cpu1_clock, true, 1);
+    PieIsrSource foc = PIE_periodicSource("focAdcISR", 1, 1, FOC_SAMPLING_FREQUENCY); // ADCA1 is INT1.1
+    PieIsrSource blink = PIE_periodicSource("blink_led", PIE_CPU_TIMER1_INT, 0, LED_TOGGLE_FREQUENCY_HZ);
+    PieIsrSource telemetry = PIE_periodicSource("telemetryTimerISR", 1, 7, LINK_TELEMETRY_FREQUENCY); // TIMER0
+    PieIsrSource commands = PIE_randomSource("ipcReceiveISR", 1, 13, MOTION_CONTROL_FREQUENCY + COMMS_POLL_FREQUENCY/2.0,
+                                             MOTION_CONTROL_FREQUENCY + COMMS_POLL_FREQUENCY); // IPC_0 is INT1.13
+    cpu1.addSource(foc);
+    cpu1.addSource(blink);
+    cpu1.addSource(telemetry);
+    cpu1.addSource(commands);
+    reportPieScenario("cpu1", cpu1, "profiles/cpu1_isr_cycles.txt");
+
+    // CPU1 as built (FOC_RUN_ON_CLA 1): the CLA runs the current loop and after each sample (CLA Task 1's
+    // end of task interrupt) the C28x reads the encoder and records the live scope, with 8 channels and a
+    // frame published. INT11 waits behind the whole of group 1, but the angle has to be in before the next
+    // sample reads it: a period less the task (23-33 us, foc.cpp) and the encoder's part of the ISR (~3 us).
+    PieSimulator cpu1_cla(cpu1_clock, true, 1);
+    PieIsrSource cla_end = PIE_periodicSource("focClaEndISR", 11, 1, FOC_SAMPLING_FREQUENCY); // CLA1_1 is INT11.1
+    cla_end.deadline_s = 1.0/FOC_SAMPLING_FREQUENCY - 36e-6;
+    cpu1_cla.addSource(cla_end);
+    cpu1_cla.addSource(blink);
+    cpu1_cla.addSource(telemetry);
+    cpu1_cla.addSource(commands);
+    reportPieScenario("cpu1_cla", cpu1_cla, "profiles/cpu1_isr_cycles.txt");
+
+    // CPU2, the communications processor: SCI-A at full rate both ways, telemetry frames and reference
+    // feedback from CPU1, the poll timer and the motion control on CPU timer 1. The poll, message and
+    // motion ISRs let the SCI and CAN (INT9) nest (COMMS_ALLOW_SCI_INTERRUPTS() in comms.h).
+    const double sci_bytes_per_s = COMMS_SCI_BAUD/10.0;
+    const int tx_refill = COMMS_SCI_FIFO_DEPTH - COMMS_SCI_TX_FIFO_LEVEL;
+    PieSimulator cpu2(cpu2_clock, true, 1);
+    PieIsrSource motion_timer = PIE_periodicSource("motionTimerISR", PIE_CPU_TIMER1_INT, 0, MOTION_CONTROL_FREQUENCY);
+    PieIsrSource cpu1_message = PIE_periodicSource("cpu1MessageISR", 1, 13, MOTION_CONTROL_FREQUENCY + LINK_TELEMETRY_FREQUENCY);
+    PieIsrSource comms_timer = PIE_periodicSource("commsTimerISR", 1, 7, COMMS_POLL_FREQUENCY);
+    motion_timer.nesting = cpu1_message.nesting = comms_timer.nesting = true;
+    motion_timer.nest_ier = cpu1_message.nest_ier = comms_timer.nest_ier = 1U << (9 - 1);
+    cpu2.addSource(comms_timer);
+    cpu2.addSource(motion_timer);
+    cpu2.addSource(cpu1_message);
+    size_t sci_rx = cpu2.addSource(PIE_randomSource("sciRxISR", 9, 1, sci_bytes_per_s/COMMS_SCI_RX_FIFO_LEVEL,
+                                                    sci_bytes_per_s/COMMS_SCI_RX_FIFO_LEVEL)); // SCIA_RX is INT9.1
+    size_t sci_tx = cpu2.addSource(PIE_randomSource("sciTxISR", 9, 2, sci_bytes_per_s/tx_refill,
+                                                    sci_bytes_per_s/tx_refill)); // SCIA_TX is INT9.2
+    // CAN-B (can_port.h) at the master's rate: a SYNC and a setpoint received every cycle, back to back at
+    // worst. A setpoint must be read before the next one fills its object. Sending takes no interrupt.
+    PieIsrSource can_rx = PIE_randomSource("canRxISR", 9, 7, 2.0*CAN_MASTER_FREQUENCY, 1e6/CAN_DATA_FRAME_US); // CANB_0 is INT9.7
+    can_rx.deadline_s = CAN_DATA_FRAME_US*1e-6;
+    cpu2.addSource(can_rx);
+    reportPieScenario("cpu2", cpu2, "profiles/cpu2_isr_cycles.txt");
+
+    // The FIFOs' headroom is the real deadline: the RX FIFO overflows after 16 - level more bytes, and
+    // the line goes idle when the TX FIFO's last level bytes are out before the refill
+    report("pie.cpu2.sciRxISR.fifo_margin_us",
+           (COMMS_SCI_FIFO_DEPTH - COMMS_SCI_RX_FIFO_LEVEL)*1e6/sci_bytes_per_s - cpu2.worstLatencyUs(sci_rx), 0.0, 1e6, "us");
+    report("pie.cpu2.sciTxISR.fifo_margin_us",
+           COMMS_SCI_TX_FIFO_LEVEL*1e6/sci_bytes_per_s - cpu2.worstLatencyUs(sci_tx), 0.0, 1e6, "us");
+
+    // ThreePhaseGen: the duty cycle update on CPU timer 1 is the lowest priority interrupt. The FSI doesn't
+    // interrupt: data frames go by DMA and the ping watchdog times the pings for the poll.
+    PieSimulator tpg(tpg_clock, true, 1);
+    tpg.addSource(PIE_periodicSource("updateDutyCycles", PIE_CPU_TIMER1_INT, 0, TPG_SAMPLING_FREQUENCY));
+    tpg.addSource(PIE_randomSource("sciRxISR", 9, 1, TPG_SCI_BAUD/10.0/4, TPG_SCI_BAUD/10.0/4));
+    reportPieScenario("threephasegen", tpg, "profiles/threephasegen_isr_cycles.txt");
+}
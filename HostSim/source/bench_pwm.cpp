@@ -0,0 +1,102 @@
+/*
+ * bench_pwm.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Bench "pwm": HalfBridgePWM on the ePWM emulator in every PWMCountMode.
+ */
+
+#include "sil_bench.h"
+#include "pwm_timeline.h"
+#include "pwm.h"
+#include <stdio.h>
+
+/* One PWMCountMode of HalfBridgePWM on EPWM4 (not used by the SIL), measured from the output edges */
+static void benchPwmMode(PWMCountMode mode, const char *mode_name) {
+    const float dead_time_ns = 100.0f;
+    simPeripherals.reset();
+    HalfBridgePWMT<SimHal> pwm(EPWM4, PWM_FREQUENCY_HZ, mode, dead_time_ns);
+    SimEpwm &module = simPeripherals.epwm[EPWM4];
+    PwmTimeline timeline(&module);
+    const unsigned long period = module.getPeriodCounts();
+    const double tbclk_Hz = module.getTbclkHz(PLLSYSCLK);
+    char name[64];
+
+    // Duty cycle: output A is high for the action qualifier high time less the rising edge delay,
+    // output B for the low time less the falling edge delay
+    const float duties[] = {0.1f, 0.25f, 0.5f, 0.75f, 0.9f};
+    unsigned long worst_error = 0;
+    for (int k = 0; k < 5; k++) {
+        pwm.setDutyCycle(duties[k]);
+        timeline.run(2*period); // Let the new compare load
+        while (module.getCounter() != 0) {
+            timeline.tick();
+        }
+        timeline.clear();
+        unsigned long from = timeline.getTick();
+        timeline.run(4*period);
+        unsigned long to = timeline.getTick();
+
+        uint16_t compare = (uint16_t)(duties[k]*pwm.getTimerTop());
+        unsigned long aq_high = mode == SYMMETRICAL_PWM ? 2*compare : compare;
+        unsigned long expected_a = 4*(aq_high - module.risingDelay());
+        unsigned long expected_b = 4*(period - aq_high - module.fallingDelay());
+        unsigned long a = timeline.highTicks(SIM_PWM_OUTPUT_A, from, to);
+        unsigned long b = timeline.highTicks(SIM_PWM_OUTPUT_B, from, to);
+        unsigned long error = (a > expected_a ? a - expected_a : expected_a - a)
+                              + (b > expected_b ? b - expected_b : expected_b - b);
+        if (error > worst_error) {
+            worst_error = error;
+        }
+
+        if (duties[k] == 0.5f) {
+            unsigned long min_dead, max_dead;
+            bool found = timeline.deadTimes(from, to, &min_dead, &max_dead);
+            snprintf(name, sizeof(name), "pwm.%s.dead_time_min_ns", mode_name);
+            report(name, found ? min_dead*1e9/tbclk_Hz : 0.0, dead_time_ns, 2.0*dead_time_ns, "ns");
+            snprintf(name, sizeof(name), "pwm.%s.dead_time_spread_ticks", mode_name);
+            report(name, found ? max_dead - min_dead : -1.0, 0.0, 0.0, "ticks");
+            snprintf(name, sizeof(name), "pwm.%s.shoot_through", mode_name);
+            report(name, timeline.overlap(from, to), 0.0, 0.0, "");
+        }
+    }
+    snprintf(name, sizeof(name), "pwm.%s.duty_error_ticks", mode_name);
+    report(name, worst_error, 0.0, 0.0, "ticks");
+
+    // Update latency: compare writes spread over the period take effect at the next shadow load
+    timeline.clear();
+    unsigned long worst_latency = 0;
+    for (unsigned long k = 0; k < period; k += 7) {
+        pwm.setDutyCycle(k & 1 ? 0.3f : 0.6f);
+        timeline.run(period + 7);
+    }
+    for (size_t k = 0; k < timeline.getUpdates().size(); k++) {
+        const SimCompareUpdate &u = timeline.getUpdates()[k];
+        if (u.load_tick - u.write_tick > worst_latency) {
+            worst_latency = u.load_tick - u.write_tick;
+        }
+    }
+    snprintf(name, sizeof(name), "pwm.%s.max_update_latency_us", mode_name);
+    report(name, worst_latency*1e6/tbclk_Hz, 0.0, 1e6/PWM_FREQUENCY_HZ, "us");
+
+    // Ends of the range, at the action qualifier (before the dead band)
+    const float ends[] = {0.0f, 1.0f};
+    for (int k = 0; k < 2; k++) {
+        pwm.setDutyCycle(ends[k]);
+        timeline.run(2*period);
+        double high = 0.0;
+        for (unsigned long n = 0; n < 4*period; n++) {
+            timeline.tick();
+            high += module.getOutputA() || !module.getOutputB() ? 1.0 : 0.0; // Either A on or in A's dead time
+        }
+        snprintf(name, sizeof(name), "pwm.%s.duty_at_%d_pct", mode_name, (int)ends[k]);
+        report(name, 100.0*high/(4*period), k ? 98.0 : 0.0, k ? 100.0 : 2.0, "%");
+    }
+}
+
+void benchPwm() {
+    benchPwmMode(SYMMETRICAL_PWM, "symmetrical");
+    benchPwmMode(UP_COUNT_PWM, "up_count");
+    benchPwmMode(DOWN_COUNT_PWM, "down_count");
+}
@@ -0,0 +1,160 @@
+/*
+ * bench_scope.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Bench "scope": the live scope on the simulation.
+ */
+
+#include "sil_bench.h"
+#include "sil_simulation.h"
+#include "ipc_link.h"
+#include "scope.h"
+#include "capture.h"
+#include "serial_frame.h"
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+// The IPC link's and the scope ISR's variables, for the registry (ipc_link.cpp and scope.cpp are target only)
+volatile uint32_t linkReferenceLatency, linkReferenceLatencyMax;
+volatile uint16_t linkReferencesRefused;
+volatile uint32_t scopeSampleInterval, scopeCycles;
+volatile uint16_t captureState;
+
+/* Reads registry variable id as its raw 32 or 16 bits, like a record holds it */
+uint32_t scopeRaw(const SCOPE_Variable *registry, uint16_t id) {
+    return SCOPE_isWide(registry[id].type) ? *(const volatile uint32_t *)registry[id].address
+                                           : *(const volatile uint16_t *)registry[id].address;
+}
+
+void benchScope() {
+    SilSimulation sim(SIM_defaultMotor(), AVERAGE_INVERTER, 24.0, 0.0);
+    sim.getMotor().holdSpeed(300.0);
+    sim.params.enable = 1;
+    const FOC_DQ i_ref = {0.5f, 2.0f};
+    CLA_setCurrentReference(&sim.params, &sim.telemetry, i_ref, 1);
+
+    // The firmware's registry, on the simulation's copies of the current loop variables
+#undef FOC_TELEMETRY
+#undef FOC_LOOP
+#define FOC_TELEMETRY sim.telemetry
+#define FOC_LOOP sim.loop
+#define claParams sim.params
+#define SCOPE_TABLE_ENTRY(name, variable, type, scale, unit) {&(variable), type},
+    const SCOPE_Variable registry[SCOPE_VARIABLE_COUNT] = {
+        SCOPE_REGISTRY(SCOPE_TABLE_ENTRY)
+    };
+#undef claParams
+    report("scope.registry_variables", SCOPE_VARIABLE_COUNT, 1.0, SCOPE_NO_CHANNEL - 1.0, "");
+
+    SCOPE_Engine scope;
+    SCOPE_init(&scope, registry, SCOPE_VARIABLE_COUNT);
+    const uint16_t too_many[SCOPE_MAX_CHANNELS + 1] = {0};
+    const uint16_t unknown[] = {SCOPE_ID_iq, SCOPE_VARIABLE_COUNT};
+    int accepted = SCOPE_select(&scope, too_many, SCOPE_MAX_CHANNELS + 1, 1) + SCOPE_select(&scope, unknown, 2, 1)
+                 + SCOPE_select(&scope, unknown, 1, 0);
+    report("scope.invalid_selections_accepted", accepted, 0.0, 0.0, "");
+
+    // Mixed widths in an awkward order, then every channel at every sample, then 16-bit only. Each frame
+    // is checked against the variables as they were when its records were due.
+    const uint16_t mixed[] = {SCOPE_ID_startup_state, SCOPE_ID_iq, SCOPE_ID_sample_count, SCOPE_ID_duty_a, SCOPE_ID_theta};
+    const uint16_t full[SCOPE_MAX_CHANNELS] = {SCOPE_ID_ia, SCOPE_ID_ib, SCOPE_ID_id, SCOPE_ID_iq, SCOPE_ID_vd,
+                                               SCOPE_ID_vq, SCOPE_ID_duty_b, SCOPE_ID_references_refused};
+    const uint16_t narrow[] = {SCOPE_ID_startup_state, SCOPE_ID_references_refused};
+    struct { const uint16_t *ids; uint16_t count, decimation; } selections[] = {{mixed, 5, 4}, {full, 8, 1}, {narrow, 2, 7}};
+    static uint16_t frame[FRAME_BUFFER_WORDS];
+    unsigned long records = 0, errors = 0, frames = 0;
+    for (const auto &selection : selections) {
+        errors += !SCOPE_select(&scope, selection.ids, selection.count, selection.decimation);
+        std::vector<uint32_t> expected; // Raw values of the records due, in record order
+        std::vector<uint32_t> due_samples;
+        unsigned long samples = 0, frames_here = 0;
+        while (frames_here < 3) {
+            sim.runSample();
+            linkReferencesRefused = (uint16_t)(samples*7);
+            if (samples++ % selection.decimation == 0) {
+                due_samples.push_back(sim.telemetry.sample_count);
+                for (int wide = 1; wide >= 0; wide--) {
+                    for (uint16_t k = 0; k < selection.count; k++) {
+                        if (SCOPE_isWide(registry[selection.ids[k]].type) == (wide == 1)) {
+                            expected.push_back(scopeRaw(registry, selection.ids[k]));
+                        }
+                    }
+                }
+            }
+            uint16_t words = SCOPE_sample(&scope, frame, sim.telemetry.sample_count);
+            if (!words) {
+                continue;
+            }
+
+            // Decode it as the host would, from the header alone
+            SCOPE_FrameHeader header;
+            memcpy(&header, frame, sizeof(header));
+            uint16_t record_words = 0;
+            uint16_t count = 0;
+            while (count < SCOPE_MAX_CHANNELS && SCOPE_channelId(header.ids, count) != SCOPE_NO_CHANNEL) {
+                errors += SCOPE_channelId(header.ids, count) != selection.ids[count];
+                record_words += SCOPE_isWide(registry[SCOPE_channelId(header.ids, count)].type) ? 2 : 1;
+                count++;
+            }
+            errors += header.kind != SCOPE_FRAME_KIND || header.decimation != selection.decimation
+                    || count != selection.count || (words - SCOPE_HEADER_WORDS) % record_words != 0
+                    || header.first_sample != due_samples[0];
+            const uint16_t *data = frame + SCOPE_HEADER_WORDS;
+            size_t value = 0;
+            for (uint16_t r = 0; r < (words - SCOPE_HEADER_WORDS)/record_words; r++) {
+                for (int wide = 1; wide >= 0; wide--) {
+                    for (uint16_t k = 0; k < count; k++) {
+                        if (SCOPE_isWide(registry[SCOPE_channelId(header.ids, k)].type) != (wide == 1)) {
+                            continue;
+                        }
+                        uint32_t raw = wide ? (uint32_t)data[0] | (uint32_t)data[1] << 16 : data[0];
+                        data += wide ? 2 : 1;
+                        errors += value >= expected.size() || raw != expected[value];
+                        value++;
+                    }
+                }
+                records++;
+            }
+            errors += value != expected.size();
+            expected.clear();
+            due_samples.clear();
+            frames_here++;
+        }
+        frames += frames_here;
+    }
+    report("scope.frames", (double)frames, 9.0, 9.0, "");
+    report("scope.records_checked", (double)records, 9.0, 1e6, "");
+    report("scope.record_errors", (double)errors, 0.0, 0.0, "");
+
+    // Host time of a record with one channel and with eight, for the cost per channel
+    double ns[2];
+    const uint16_t channels[2] = {1, SCOPE_MAX_CHANNELS};
+    for (int k = 0; k < 2; k++) {
+        SCOPE_select(&scope, full, channels[k], 1);
+        const int calls = 2000000;
+        auto start = std::chrono::steady_clock::now();
+        for (int n = 0; n < calls; n++) {
+            SCOPE_sample(&scope, frame, (uint32_t)n);
+        }
+        ns[k] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()/calls;
+    }
+    printf("%-34s %12.4g %-8s\n", "scope.host_ns_per_record_1ch", ns[0], "ns");
+    printf("%-34s %12.4g %-8s\n", "scope.host_ns_per_channel", (ns[1] - ns[0])/(SCOPE_MAX_CHANNELS - 1), "ns");
+
+    // The line: four float channels at a tenth of the sample rate, streamed as FRAME_READY and data
+    // chunks, next to the telemetry
+    const uint16_t four[] = {SCOPE_ID_ia, SCOPE_ID_ib, SCOPE_ID_id, SCOPE_ID_iq};
+    SCOPE_select(&scope, four, 4, 10);
+    double frames_per_s = FOC_SAMPLING_FREQUENCY/10.0/((scope.frame_words - SCOPE_HEADER_WORDS)/scope.channels.record_words);
+    double frame_bytes = SFRAME_ENCODED_BYTES(2U*CHAN_WORDS(FRAME_Ready))
+                       + (scope.frame_words/COMMS_MAX_FRAME_WORDS)*SFRAME_ENCODED_BYTES(2U*COMMS_MAX_FRAME_WORDS)
+                       + (scope.frame_words % COMMS_MAX_FRAME_WORDS ? SFRAME_ENCODED_BYTES(2U*(scope.frame_words % COMMS_MAX_FRAME_WORDS)) : 0);
+    double telemetry_bytes = SFRAME_ENCODED_BYTES(2U*CHAN_WORDS(LINK_Telemetry))*(double)LINK_TELEMETRY_FREQUENCY;
+    report("scope.line_pct_4ch_decimation_10", 100.0*(frames_per_s*frame_bytes + telemetry_bytes)/(COMMS_SCI_BAUD/10.0),
+           0.0, 100.0, "%"); // With the telemetry
+}
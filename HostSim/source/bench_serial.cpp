@@ -0,0 +1,117 @@
+/*
+ * bench_serial.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Bench "serial": the host link framing.
+ */
+
+#include "sil_bench.h"
+#include "ipc_link.h"
+#include "serial_frame.h"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+void benchSerial() {
+    uint16_t crc = 0xFFFF;
+    for (const char *c = "123456789"; *c; c++) {
+        crc = SFRAME_crc16(crc, (uint16_t)*c);
+    }
+    report("serial.crc_check_value", crc, 0x29B1, 0x29B1, ""); // CRC-16/CCITT-FALSE
+
+    // A stream of frames of every length, with plenty of zeros in the payloads and timestamps
+    const int frames = 2000;
+    std::vector<uint16_t> stream;
+    std::vector<std::vector<uint16_t> > payloads;
+    std::vector<size_t> starts;
+    uint32_t lcg = 1;
+    for (int k = 0; k < frames; k++) {
+        std::vector<uint16_t> words(k % (SFRAME_MAX_PAYLOAD_BYTES/2 + 1));
+        for (size_t w = 0; w < words.size(); w++) {
+            lcg = lcg*1664525U + 1013904223U;
+            words[w] = (lcg >> 8) % 3 ? (uint16_t)(lcg >> 12) : 0; // A third of the words zero
+        }
+        uint16_t encoded[SFRAME_ENCODED_BYTES(SFRAME_MAX_PAYLOAD_BYTES)];
+        uint16_t n = SFRAME_encode(encoded, (uint16_t)(k % 7), (uint16_t)(k & 0xFF), (uint32_t)k << 20,
+                                   words.data(), (uint16_t)words.size());
+        starts.push_back(stream.size());
+        stream.insert(stream.end(), encoded, encoded + n);
+        payloads.push_back(words);
+    }
+    size_t zeros_inside = 0;
+    for (int k = 0; k < frames; k++) {
+        size_t end = k + 1 < frames ? starts[k + 1] : stream.size();
+        for (size_t b = starts[k]; b + 1 < end; b++) {
+            zeros_inside += stream[b] == 0;
+        }
+    }
+    report("serial.zeros_inside_frames", (double)zeros_inside, 0.0, 0.0, "");
+    const uint16_t longest = SFRAME_MAX_PAYLOAD_BYTES;
+    report("serial.longest_frame_bytes", (double)(starts[SFRAME_MAX_PAYLOAD_BYTES/2 + 1] - starts[SFRAME_MAX_PAYLOAD_BYTES/2]),
+           SFRAME_ENCODED_BYTES(longest), SFRAME_ENCODED_BYTES(longest), "bytes");
+
+    SFRAME_Decoder d;
+    SFRAME_initDecoder(&d);
+    int intact = 0;
+    for (size_t b = 0; b < stream.size(); b++) {
+        if (SFRAME_decodeByte(&d, stream[b])) {
+            int k = (int)(d.frames - 1);
+            uint16_t words[SFRAME_MAX_PAYLOAD_BYTES/2];
+            uint16_t count = SFRAME_payloadWords(&d, words, SFRAME_MAX_PAYLOAD_BYTES/2);
+            intact += SFRAME_type(&d) == (uint16_t)(k % 7) && SFRAME_sequence(&d) == (uint16_t)(k & 0xFF)
+                    && SFRAME_timestamp(&d) == (uint32_t)k << 20 && count == payloads[k].size()
+                    && !memcmp(words, payloads[k].data(), count*sizeof(uint16_t));
+        }
+    }
+    report("serial.frames_intact", intact, frames, frames, "");
+
+    // One bit flipped, a byte lost or a byte added in every other frame: none of those may get through,
+    // and the frame after each must still arrive
+    std::vector<uint16_t> damaged;
+    std::vector<int> expected; // Frame numbers that should decode
+    for (int k = 0; k < frames; k++) {
+        size_t end = k + 1 < frames ? starts[k + 1] : stream.size();
+        std::vector<uint16_t> frame(stream.begin() + starts[k], stream.begin() + end);
+        if (k % 2) {
+            lcg = lcg*1664525U + 1013904223U;
+            size_t at = (lcg >> 8) % (frame.size() - 1); // Not the delimiter
+            switch (k/2 % 3) {
+                case 0: frame[at] ^= 1U << ((lcg >> 4) % 8); break;
+                case 1: frame.erase(frame.begin() + at); break;
+                default: frame.insert(frame.begin() + at, (uint16_t)((lcg >> 16) | 1U)); break;
+            }
+        }
+        else {
+            expected.push_back(k);
+        }
+        damaged.insert(damaged.end(), frame.begin(), frame.end());
+    }
+    SFRAME_initDecoder(&d);
+    size_t next = 0;
+    int accepted_damaged = 0;
+    for (size_t b = 0; b < damaged.size(); b++) {
+        if (SFRAME_decodeByte(&d, damaged[b])) {
+            int k = SFRAME_timestamp(&d) >> 20;
+            if (next < expected.size() && k == expected[next]) {
+                next++;
+            }
+            else {
+                accepted_damaged++;
+            }
+        }
+    }
+    report("serial.damaged_frames_accepted", accepted_damaged, 0.0, 0.0, "");
+    report("serial.good_frames_after_damage", (double)next, (double)expected.size(), (double)expected.size(), "");
+    report("serial.errors_counted", (double)(d.crc_errors + d.framing_errors), frames/2, frames, ""); // A zero splits one
+
+    // The link: telemetry framed at LINK_TELEMETRY_FREQUENCY against the SCI at its fastest
+    double line_bytes_per_s = COMMS_SCI_BAUD/10.0;
+    double telemetry_bytes = SFRAME_ENCODED_BYTES(2U*CHAN_WORDS(LINK_Telemetry));
+    printf("%-34s %12.4g %-8s\n", "serial.baud", (double)COMMS_SCI_BAUD, "baud");
+    printf("%-34s %12.4g %-8s\n", "serial.telemetry_frame", telemetry_bytes, "bytes");
+    report("serial.baud_error_pct", 100.0*(LSPCLK/(8.0*(int)(LSPCLK/(COMMS_SCI_BAUD*8.0))) - COMMS_SCI_BAUD)/COMMS_SCI_BAUD,
+           -0.5, 0.5, "%"); // BRR rounding
+    report("serial.telemetry_line_pct", 100.0*telemetry_bytes*LINK_TELEMETRY_FREQUENCY/line_bytes_per_s, 0.0, 50.0, "%");
+}
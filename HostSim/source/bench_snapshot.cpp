@@ -0,0 +1,143 @@
+/*
+ * bench_snapshot.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Bench "snapshot": the sequence-count snapshots of the telemetry and rotor angle.
+ */
+
+#include "sil_bench.h"
+#include "sil_simulation.h"
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+/* The speed the snapshot test's angle writer pairs with an angle, so a sample's pair can be checked */
+static float snapshotOmega(float theta) {
+    return theta*1000.0f + 7.0f;
+}
+
+/* Phase A current the snapshot test's loop gets in the sample that makes sample_count this */
+static float snapshotIa(const CLA_CurrentLoopParams &p, uint32_t sample_count) {
+    return ((float)(uint16_t)(2048 + ((sample_count - 1U) & 63U)) - p.current_offset_a) * p.current_scale;
+}
+
+static bool snapshotCoherent(const CLA_CurrentLoopParams &p, const CLA_CurrentLoopTelemetry &t) {
+    return t.ia == snapshotIa(p, t.sample_count) && t.omega == snapshotOmega(t.theta);
+}
+
+void benchSnapshot() {
+    // The loop runs samples on this thread while one thread writes the rotor angle as fast as it can and
+    // another copies the telemetry. Every sample must use an angle and speed from the same write, and every
+    // copy CLA_readTelemetry() accepts must be from one sample.
+    SilSimulation sim(SIM_defaultMotor(), AVERAGE_INVERTER, 24.0, 0.0);
+    static FOC_CurrentLoop loop;
+    static OBS_Sensorless observer;
+    static CLA_CurrentLoopParams params;
+    static CLA_CurrentLoopTelemetry telemetry;
+    loop = sim.loop;
+    observer = sim.observer;
+    params = sim.params;
+    telemetry = sim.telemetry;
+    params.enable = 1;
+    CLA_setRotorAngle(&params, 0.0f, snapshotOmega(0.0f));
+    uint16_t cmp[3];
+    CLA_runCurrentLoopSample(&loop, &observer, &params, 2048, 2048, 600, cmp, &telemetry);
+
+    // The cases the target has, one at a time: a sample while the C28x is half way through writing the
+    // angle uses the last sample's, and a copy which a sample overlaps is refused
+    unsigned long errors = 0;
+    SEQ_writeBegin(&params.angle_sequence);
+    params.angle.theta = 0.5f;
+    CLA_runCurrentLoopSample(&loop, &observer, &params, 2048, 2048, 600, cmp, &telemetry);
+    errors += telemetry.theta != 0.0f || telemetry.omega != snapshotOmega(0.0f) || telemetry.angle_stale != 1;
+    params.angle.omega = snapshotOmega(0.5f);
+    SEQ_writeEnd(&params.angle_sequence);
+    CLA_runCurrentLoopSample(&loop, &observer, &params, 2048, 2048, 600, cmp, &telemetry);
+    errors += telemetry.theta != 0.5f || telemetry.omega != snapshotOmega(0.5f) || telemetry.angle_stale != 1;
+
+    CLA_CurrentLoopTelemetry torn;
+    const size_t half = offsetof(CLA_CurrentLoopTelemetry, theta);
+    uint32_t sequence = SEQ_readBegin(&telemetry.sequence);
+    memcpy(&torn, &telemetry, half);
+    CLA_setRotorAngle(&params, 0.25f, snapshotOmega(0.25f));
+    CLA_runCurrentLoopSample(&loop, &observer, &params, 2048, 2048, 600, cmp, &telemetry);
+    memcpy((char *)&torn + half, (const char *)&telemetry + half, sizeof(torn) - half);
+    errors += SEQ_readValid(&telemetry.sequence, sequence) || torn.theta != 0.25f || torn.omega != snapshotOmega(0.25f);
+    report("snapshot.interrupted_case_errors", (double)errors, 0.0, 0.0, "");
+
+    const uint32_t samples = 200000;
+    telemetry.sample_count = 0; // So the reader can tell each sample's inputs from its count
+    std::atomic<bool> done(false);
+    unsigned long angle_writes = 0, reads = 0, failed = 0, inconsistent = 0, unguarded = 0, unguarded_torn = 0;
+    std::thread angle_writer([&]() {
+        while (!done.load()) {
+            float theta = (float)(angle_writes % 1000U)*1e-3f;
+            CLA_setRotorAngle(&params, theta, snapshotOmega(theta));
+            angle_writes++;
+            if (angle_writes % 16 == 0) {
+                std::this_thread::yield(); // The host may have fewer cores than threads
+            }
+        }
+    });
+    std::thread reader([&]() {
+        while (!done.load()) {
+            CLA_CurrentLoopTelemetry copy;
+            if (!CLA_readTelemetry(&telemetry, &copy)) {
+                failed++;
+            }
+            else if (copy.sample_count > 0) {
+                reads++;
+                inconsistent += !snapshotCoherent(params, copy);
+            }
+            // The same copy without the count, to show what the count catches
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const volatile unsigned char *source = (const volatile unsigned char *)&telemetry;
+            unsigned char *destination = (unsigned char *)&copy;
+            for (size_t k = 0; k < sizeof(copy); k++) {
+                destination[k] = source[k];
+            }
+            if (copy.sample_count > 0) {
+                unguarded++;
+                unguarded_torn += !snapshotCoherent(params, copy);
+            }
+            std::this_thread::yield();
+        }
+    });
+    unsigned long torn_angles = 0;
+    for (uint32_t k = 0; k < samples; k++) {
+        CLA_runCurrentLoopSample(&loop, &observer, &params, (uint16_t)(2048 + (k & 63)), 2048, 600, cmp, &telemetry);
+        torn_angles += telemetry.omega != snapshotOmega(telemetry.theta);
+        if (k % 16 == 0) {
+            std::this_thread::yield();
+        }
+    }
+    done = true;
+    angle_writer.join();
+    reader.join();
+    report("snapshot.torn_angles", (double)torn_angles, 0.0, 0.0, "");
+    report("snapshot.telemetry_reads", (double)reads, 1000.0, 1e12, "");
+    report("snapshot.inconsistent_reads", (double)inconsistent, 0.0, 0.0, "");
+    printf("%-34s %12.4g %-8s\n", "snapshot.angle_writes", (double)angle_writes, "");
+    printf("%-34s %12.4g %-8s\n", "snapshot.stale_angle_samples", (double)telemetry.angle_stale, "");
+    printf("%-34s %12.4g %-8s\n", "snapshot.reads_given_up", (double)failed, "");
+    printf("%-34s %12.4g %-8s\n", "snapshot.unguarded_torn_pct", unguarded ? 100.0*unguarded_torn/unguarded : 0.0,
+           "%");
+
+    // Host time of a coherent copy, with nothing writing
+    const int n = 1000000;
+    CLA_CurrentLoopTelemetry copy;
+    unsigned long ok = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int k = 0; k < n; k++) {
+        ok += CLA_readTelemetry(&telemetry, &copy);
+    }
+    auto stop = std::chrono::steady_clock::now();
+    report("snapshot.idle_reads_given_up", (double)(n - ok), 0.0, 0.0, "");
+    printf("%-34s %12.4g %-8s\n", "snapshot.host_ns_per_read",
+           std::chrono::duration<double, std::nano>(stop - start).count()/n, "ns");
+}
@@ -0,0 +1,62 @@
+/*
+ * bench_threephasegen.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Bench "threephasegen": the ThreePhaseGen firmware on the simulated HAL.
+ */
+
+#include "sil_bench.h"
+#include "sim_peripherals.h"
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+void benchThreePhaseGen() {
+    simPeripherals.reset();
+    ConfigThreePhaseGen();
+
+    // Run one period of the sinusoid, recording each phase's duty cycle once per PWM period
+    std::vector<double> duty[3];
+    SimCpuTimer &timer1 = simPeripherals.timer[1];
+    SimEpwm *phases = &simPeripherals.epwm[TPG_EPWM_PHASE_A];
+    const unsigned long cycles = (unsigned long)(PLLSYSCLK/TPG_SINUSOID_FREQUENCY);
+    for (unsigned long n = 0; n < cycles; n++) {
+        timer1.tick(); // TBCLK = SYSCLK
+        for (int k = 0; k < 3; k++) {
+            phases[k].tick();
+            if (phases[k].getCounter() == 0) {
+                duty[k].push_back(phases[k].getDutyCycle());
+            }
+        }
+    }
+    report("threephasegen.timer_interrupts", timer1.interrupts, 999.0, 1001.0, "");
+
+    double magnitude[3], phase[3], harmonics = 0.0;
+    for (int k = 0; k < 3; k++) {
+        fourier(duty[k], 1, &magnitude[k], &phase[k]);
+    }
+    for (int h = 2; h <= 20; h++) {
+        double m, p;
+        fourier(duty[0], h, &m, &p);
+        harmonics += m*m;
+    }
+    report("threephasegen.amplitude", magnitude[0], 0.49, 0.51, "");
+    report("threephasegen.phase_b_lead_deg", wrapRadians(phase[1] - phase[0])*180.0/3.141592653589793,
+           119.0, 121.0, "deg");
+    report("threephasegen.phase_c_lead_deg", wrapRadians(phase[2] - phase[0])*180.0/3.141592653589793,
+           -121.0, -119.0, "deg");
+    report("threephasegen.thd_pct", 100.0*sqrt(harmonics)/magnitude[0], 0.0, 1.0, "%");
+
+    // Host time per interrupt
+    const int n = 1000000;
+    auto start = std::chrono::steady_clock::now();
+    for (int k = 0; k < n; k++) {
+        updateDutyCycles();
+    }
+    auto stop = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(stop - start).count()/n;
+    printf("%-34s %12.4g %-8s\n", "threephasegen.host_ns_per_isr", ns, "ns");
+}
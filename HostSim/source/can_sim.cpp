@@ -0,0 +1,242 @@
+/*
+ * can_sim.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ */
+
+#include "can_sim.h"
+#include <string.h>
+
+SimCan::SimCan(double bit_rate) : bit_rate(bit_rate) {
+    reset();
+}
+
+void SimCan::reset() {
+    memset(objects, 0, sizeof(objects));
+    queue.clear();
+    loopback = false;
+    time_s = 0.0;
+    idle_s = 0.0;
+    in_flight = false;
+    in_flight_own = false;
+    in_flight_object = 0;
+    in_flight_end_s = 0.0;
+    frames = 0;
+    received = 0;
+    filtered = 0;
+    interrupts = 0;
+    busy_s = 0.0;
+    sent.clear();
+    sent_s.clear();
+}
+
+void SimCan::setupObject(uint16_t object, uint32_t id, uint32_t mask, bool transmit, bool interrupt_enable, uint16_t dlc) {
+    SimCanObject &o = objects[object];
+    memset(&o, 0, sizeof(o));
+    o.configured = true;
+    o.transmit = transmit;
+    o.interrupt_enable = interrupt_enable;
+    o.id = id & 0x7FFU;
+    o.mask = transmit ? 0x7FFU : mask & 0x7FFU;
+    o.dlc = dlc;
+}
+
+void SimCan::setLoopback(bool on) {
+    loopback = on;
+}
+
+void SimCan::sendMessage(uint16_t object, const uint16_t *bytes, uint16_t dlc) {
+    SimCanObject &o = objects[object];
+    o.dlc = dlc;
+    for (uint16_t k = 0; k < dlc && k < 8; k++) {
+        o.bytes[k] = bytes[k] & 0xFFU;
+    }
+    if (!o.tx_request) {
+        o.requested_s = time_s;
+    }
+    o.tx_request = true;
+}
+
+bool SimCan::readObject(uint16_t object, uint16_t *bytes, uint16_t *dlc, bool *lost) {
+    SimCanObject &o = objects[object];
+    bool new_data = o.new_data;
+    *dlc = o.dlc;
+    for (uint16_t k = 0; k < 8; k++) {
+        bytes[k] = o.bytes[k];
+    }
+    *lost = o.message_lost;
+    o.new_data = false;
+    o.interrupt_pending = false;
+    return new_data;
+}
+
+void SimCan::writeControl(uint16_t object, bool new_data, bool lost, bool interrupt_pending) {
+    SimCanObject &o = objects[object];
+    o.new_data = new_data;
+    o.message_lost = lost;
+    o.interrupt_pending = interrupt_pending;
+}
+
+uint16_t SimCan::interruptCause() const {
+    for (uint16_t k = 1; k <= SIM_CAN_OBJECTS; k++) {
+        if (objects[k].interrupt_pending) {
+            return k;
+        }
+    }
+    return 0;
+}
+
+bool SimCan::txRequested(uint16_t object) const {
+    return objects[object].tx_request || (in_flight && in_flight_own && in_flight_object == object);
+}
+
+void SimCan::queueFrame(double at_s, const SimCanFrame &frame) {
+    queue.push_back(std::make_pair(at_s, frame));
+}
+
+/* Stores a frame off the bus in the lowest numbered receive object that takes it */
+void SimCan::deliver(const SimCanFrame &frame) {
+    for (uint16_t k = 1; k <= SIM_CAN_OBJECTS; k++) {
+        SimCanObject &o = objects[k];
+        if (!o.configured || o.transmit || ((frame.id ^ o.id) & o.mask) != 0U) {
+            continue;
+        }
+        o.message_lost = o.message_lost || o.new_data;
+        o.new_data = true;
+        o.dlc = frame.dlc;
+        memcpy(o.bytes, frame.bytes, sizeof(o.bytes));
+        if (o.interrupt_enable) {
+            o.interrupt_pending = true;
+            interrupts++;
+        }
+        received++;
+        return;
+    }
+    filtered++;
+}
+
+bool SimCan::nextFrame(double until_s) {
+    if (!in_flight) {
+        // Drop what the bus can't see in loopback, then arbitrate when the bus is next free and something is ready
+        while (loopback && !queue.empty()) {
+            queue.pop_front();
+        }
+        uint16_t own = 0;
+        for (uint16_t k = 1; k <= SIM_CAN_OBJECTS && !own; k++) {
+            own = objects[k].configured && objects[k].transmit && objects[k].tx_request ? k : 0;
+        }
+        double ready_s = 1e300;
+        if (own) {
+            ready_s = objects[own].requested_s;
+        }
+        if (!queue.empty() && queue.front().first < ready_s) {
+            ready_s = queue.front().first;
+        }
+        double start_s = ready_s > idle_s ? ready_s : idle_s;
+        if (start_s >= until_s) {
+            time_s = until_s > time_s ? until_s : time_s;
+            return false;
+        }
+        // Lowest identifier of everything ready by the start
+        bool own_ready = own && objects[own].requested_s <= start_s;
+        uint32_t best_id = own_ready ? objects[own].id : 0xFFFFFFFFU;
+        size_t best = queue.size();
+        for (size_t k = 0; k < queue.size() && queue[k].first <= start_s; k++) {
+            if (queue[k].second.id < best_id) {
+                best_id = queue[k].second.id;
+                best = k;
+            }
+        }
+        in_flight = true;
+        in_flight_own = best == queue.size();
+        if (in_flight_own) {
+            SimCanObject &o = objects[own];
+            in_flight_object = own;
+            in_flight_frame.id = o.id;
+            in_flight_frame.dlc = o.dlc;
+            memcpy(in_flight_frame.bytes, o.bytes, sizeof(o.bytes));
+            o.tx_request = false; // Set again by a reload during the transmission, which then goes again
+        }
+        else {
+            in_flight_frame = queue[best].second;
+            queue.erase(queue.begin() + best);
+        }
+        in_flight_end_s = start_s + frameBits(in_flight_frame)/bit_rate;
+    }
+
+    if (in_flight_end_s > until_s) {
+        time_s = until_s > time_s ? until_s : time_s;
+        return false;
+    }
+    double start_s = in_flight_end_s - frameBits(in_flight_frame)/bit_rate;
+    time_s = in_flight_end_s;
+    idle_s = in_flight_end_s;
+    busy_s += in_flight_end_s - start_s;
+    frames++;
+    in_flight = false;
+    if (in_flight_own) {
+        SimCanObject &o = objects[in_flight_object];
+        if (o.interrupt_enable) {
+            o.interrupt_pending = true;
+            interrupts++;
+        }
+        sent.push_back(in_flight_frame);
+        sent_s.push_back(time_s);
+        if (loopback) {
+            deliver(in_flight_frame);
+        }
+    }
+    else {
+        deliver(in_flight_frame);
+    }
+    return true;
+}
+
+uint16_t SimCan::frameBits(const SimCanFrame &frame) {
+    // The stuffed part: SOF, identifier, RTR, IDE, r0, DLC, data, CRC
+    uint16_t dlc = frame.dlc > 8 ? 8 : frame.dlc;
+    uint8_t bits[1 + 11 + 3 + 4 + 64 + 15];
+    uint16_t n = 0;
+    bits[n++] = 0;
+    for (int k = 10; k >= 0; k--) {
+        bits[n++] = (frame.id >> k) & 1U;
+    }
+    bits[n++] = 0; // Data frame
+    bits[n++] = 0; // Standard identifier
+    bits[n++] = 0;
+    for (int k = 3; k >= 0; k--) {
+        bits[n++] = (frame.dlc >> k) & 1U;
+    }
+    for (uint16_t byte = 0; byte < dlc; byte++) {
+        for (int k = 7; k >= 0; k--) {
+            bits[n++] = (frame.bytes[byte] >> k) & 1U;
+        }
+    }
+    uint16_t crc = 0;
+    for (uint16_t k = 0; k < n; k++) {
+        uint16_t feedback = bits[k] ^ ((crc >> 14) & 1U);
+        crc = (uint16_t)((crc << 1) & 0x7FFFU);
+        if (feedback) {
+            crc ^= 0x4599U;
+        }
+    }
+    for (int k = 14; k >= 0; k--) {
+        bits[n++] = (crc >> k) & 1U;
+    }
+
+    // A stuff bit after five equal bits, which itself starts the next run
+    uint16_t stuffed = 0;
+    uint16_t run = 0;
+    uint8_t last = 2;
+    for (uint16_t k = 0; k < n; k++) {
+        run = bits[k] == last ? run + 1 : 1;
+        last = bits[k];
+        if (run == 5) {
+            stuffed++;
+            last = !last;
+            run = 1;
+        }
+    }
+    return n + stuffed + 1 + 2 + 7 + SIM_CAN_INTERFRAME_BITS; // CRC delimiter, ACK slot and delimiter, EOF
+}
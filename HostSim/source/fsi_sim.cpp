@@ -0,0 +1,96 @@
+/*
+ * fsi_sim.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ */
+
+#include "fsi_sim.h"
+
+SimFsiLink::SimFsiLink(double bit_rate, double clock_hz) : bit_rate(bit_rate), clock_hz(clock_hz) {
+    ring = 0;
+    ring_frames = 0;
+    reset();
+}
+
+void SimFsiLink::reset() {
+    for (int k = 0; k < 2; k++) {
+        line[k].clear();
+        free_s[k] = 0.0;
+        frames[k] = 0;
+        damaged[k] = 0;
+        busy_s[k] = 0.0;
+    }
+    dma_slot = 0;
+    rx_error = false;
+    rx_ping = false;
+    ping_tag = 0;
+    tx_done = false;
+    ping_s = 0.0;
+    time_s = 0.0;
+}
+
+void SimFsiLink::setRing(volatile uint16_t *ring_words, uint16_t frames_in_ring) {
+    ring = ring_words;
+    ring_frames = frames_in_ring;
+    dma_slot = 0;
+}
+
+void SimFsiLink::send(int direction, double at_s, const SimFsiFrame &frame) {
+    double start_s = at_s > free_s[direction] ? at_s : free_s[direction];
+    double length_s = frameBits(frame)/bit_rate;
+    free_s[direction] = start_s + length_s;
+    busy_s[direction] += length_s;
+    line[direction].push_back(std::make_pair(free_s[direction], frame));
+}
+
+bool SimFsiLink::busy(int direction, double at_s) const {
+    return free_s[direction] > at_s;
+}
+
+bool SimFsiLink::nextFrame(double until_s, int *direction, SimFsiFrame *frame) {
+    int next = -1;
+    for (int k = 0; k < 2; k++) {
+        if (!line[k].empty() && line[k].front().first <= until_s
+            && (next < 0 || line[k].front().first < line[next].front().first)) {
+            next = k;
+        }
+    }
+    if (next < 0) {
+        time_s = until_s > time_s ? until_s : time_s;
+        return false;
+    }
+    time_s = line[next].front().first;
+    *direction = next;
+    *frame = line[next].front().second;
+    line[next].pop_front();
+    frames[next]++;
+
+    if (next == SIM_FSI_TO_CONTROLLER) {
+        tx_done = true; // Sent whole, whatever the line did to it
+    }
+    if (frame->damaged) {
+        damaged[next]++;
+        rx_error = rx_error || next == SIM_FSI_TO_GENERATOR;
+    }
+    else if (next == SIM_FSI_TO_GENERATOR && frame->ping) {
+        rx_ping = true;
+        ping_tag = frame->tag;
+        ping_s = time_s;
+    }
+    else if (next == SIM_FSI_TO_GENERATOR && ring) {
+        for (uint16_t k = 0; k < FSIL_FRAME_WORDS; k++) { // One burst
+            ring[dma_slot*FSIL_FRAME_WORDS + k] = frame->words[k];
+        }
+        dma_slot = (uint16_t)((dma_slot + 1U) % ring_frames);
+    }
+    return true;
+}
+
+uint32_t SimFsiLink::pingAge() const {
+    return (uint32_t)((time_s - ping_s)*clock_hz + 0.5);
+}
+
+uint16_t SimFsiLink::frameBits(const SimFsiFrame &frame) {
+    return SIM_FSI_FRAME_BITS + SIM_FSI_LINE_BITS + (frame.ping ? 0 : 16*FSIL_FRAME_WORDS);
+}
@@ -0,0 +1,213 @@
+/*
+ * hal_sim.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  C interface of the simulated HAL: for ThreePhaseGen, forwarding to SimHal, for CPU2's CAN port, on
+ *  simPeripherals.can, and for ThreePhaseGen's FSI port, on simPeripherals.fsi.
+ */
+
+#include "hal_sim.h"
+#include "can_hal.h"
+#include "can_sim.h"
+#include "fsi_hal.h"
+#include "fsi_sim.h"
+
+uint32_t HAL_pwmBase(EPWM_Module module) {
+    return SimHal::pwmBase(module);
+}
+
+void HAL_enablePwm(EPWM_Module module, EPWM_Outputs outputs) {
+    SimHal::enablePwm(module, outputs);
+}
+
+void HAL_setPwmClockDivider(uint32_t base, uint16_t divider, uint16_t hs_divider) {
+    SimHal::setPwmClockDivider(base, divider, hs_divider);
+}
+
+void HAL_setPwmPeriod(uint32_t base, uint16_t period) {
+    SimHal::setPwmPeriod(base, period);
+}
+
+uint16_t HAL_getPwmPeriod(uint32_t base) {
+    return SimHal::getPwmPeriod(base);
+}
+
+void HAL_setPwmCounterMode(uint32_t base, uint16_t mode) {
+    SimHal::setPwmCounterMode(base, mode);
+}
+
+void HAL_setPwmActionQualifiersA(uint32_t base, uint16_t actions) {
+    SimHal::setPwmActionQualifiersA(base, actions);
+}
+
+void HAL_writePwmCompareA(uint32_t base, uint16_t value) {
+    SimHal::writePwmCompareA(base, value);
+}
+
+void HAL_enablePwmTimeBaseSync(void) {
+    SimHal::enablePwmTimeBaseSync();
+}
+
+uint32_t HAL_cpuTimerBase(uint16_t index) {
+    return SimHal::cpuTimerBase(index);
+}
+
+void HAL_configCpuTimer(uint32_t base, uint32_t period_count, uint16_t clock_divider) {
+    SimHal::configCpuTimer(base, period_count, clock_divider);
+}
+
+void HAL_setCpuTimerInterrupt(uint32_t base, void (*handler)(void)) {
+    SimHal::setCpuTimerInterrupt(base, handler);
+}
+
+uint32_t HAL_readCpuTimer(uint32_t base) {
+    return SimHal::readCpuTimer(base);
+}
+
+/*** CAN ***/
+static SimCan &can() {
+    return *simPeripherals.can;
+}
+
+void HAL_initCan(uint32_t base, uint32_t sysclk, uint32_t bit_rate, uint16_t bit_time) {
+    (void)base;
+    uint32_t prescaler = sysclk/(bit_rate*bit_time); // As CAN_setBitRate() works it out
+    can().bit_rate = (double)sysclk/(prescaler*bit_time);
+    can().setLoopback(false);
+}
+
+void HAL_enableCanLoopback(uint32_t base) {
+    (void)base;
+    can().setLoopback(true);
+}
+
+void HAL_setupCanRxObject(uint32_t base, uint16_t object, uint32_t id, uint32_t mask) {
+    (void)base;
+    can().setupObject(object, id, mask, false, true, 0);
+}
+
+void HAL_setupCanTxObject(uint32_t base, uint16_t object, uint32_t id, uint16_t bytes) {
+    (void)base;
+    can().setupObject(object, id, 0, true, false, bytes);
+}
+
+void HAL_startCan(uint32_t base, uint32_t sysclk, void (*handler)(void)) {
+    (void)base;
+    (void)sysclk;
+    (void)handler; // The bench calls it while an object is pending
+}
+
+uint16_t HAL_getCanInterruptCause(uint32_t base) {
+    (void)base;
+    return can().interruptCause();
+}
+
+uint16_t HAL_getCanStatus(uint32_t base) {
+    (void)base;
+    return 0; // The simulated bus has no errors
+}
+
+uint32_t HAL_getCanTxRequests(uint32_t base) {
+    (void)base;
+    uint32_t requests = 0;
+    for (uint16_t k = 1; k <= SIM_CAN_OBJECTS; k++) {
+        requests |= can().txRequested(k) ? 1UL << (k - 1U) : 0U;
+    }
+    return requests;
+}
+
+void HAL_sendCanMessage(uint32_t base, uint16_t object, uint16_t count, const uint16_t *bytes) {
+    (void)base;
+    can().sendMessage(object, bytes, count);
+}
+
+uint16_t HAL_readCanObject(uint32_t base, uint16_t object, uint32_t *data) {
+    (void)base;
+    uint16_t bytes[8], dlc;
+    bool lost;
+    bool new_data = can().readObject(object, bytes, &dlc, &lost);
+    for (uint16_t k = 0; k < 2; k++) { // IF2DATA and IF2DATB, low byte first
+        data[k] = (uint32_t)bytes[4*k] | (uint32_t)bytes[4*k + 1] << 8 | (uint32_t)bytes[4*k + 2] << 16
+                  | (uint32_t)bytes[4*k + 3] << 24;
+    }
+    return (new_data ? HAL_CAN_MCTL_NEWDAT : 0U) | (lost ? HAL_CAN_MCTL_MSGLST : 0U) | (dlc & HAL_CAN_MCTL_DLC_M);
+}
+
+void HAL_writeCanObjectControl(uint32_t base, uint16_t object, uint16_t control) {
+    (void)base;
+    can().writeControl(object, (control & HAL_CAN_MCTL_NEWDAT) != 0, (control & HAL_CAN_MCTL_MSGLST) != 0,
+                       (control & HAL_CAN_MCTL_INTPND) != 0);
+}
+
+void HAL_acknowledgeCanInterrupt(uint32_t base) {
+    (void)base;
+    simPeripherals.pie_acks++;
+}
+
+/*** FSI ***/
+static SimFsiLink &fsi() {
+    return *simPeripherals.fsi;
+}
+
+void HAL_initFsi(uint32_t tx_base, uint32_t rx_base, uint16_t prescaler, uint16_t frame_words) {
+    (void)tx_base;
+    (void)rx_base;
+    (void)prescaler; // The link has its own bit rate
+    (void)frame_words;
+}
+
+void HAL_startFsiRxDma(uint32_t dma_base, uint32_t rx_base, volatile uint16_t *ring, uint16_t frames,
+                       uint16_t frame_words) {
+    (void)dma_base;
+    (void)rx_base;
+    (void)frame_words; // Always FSIL_FRAME_WORDS
+    fsi().setRing(ring, frames);
+}
+
+uint32_t HAL_getDmaDestinationOffset(uint32_t dma_base, const volatile uint16_t *ring) {
+    (void)dma_base;
+    (void)ring;
+    return (uint32_t)fsi().position()*FSIL_FRAME_WORDS;
+}
+
+uint16_t HAL_getFsiRxEvents(uint32_t rx_base) {
+    (void)rx_base;
+    return (fsi().rx_error ? HAL_FSI_RX_EVT_CRC_ERR : 0U) | (fsi().rx_ping ? HAL_FSI_RX_EVT_PING_FRAME : 0U);
+}
+
+void HAL_clearFsiRxEvents(uint32_t rx_base, uint16_t events) {
+    (void)rx_base;
+    fsi().rx_error = fsi().rx_error && !(events & HAL_FSI_RX_EVT_CRC_ERR);
+    fsi().rx_ping = fsi().rx_ping && !(events & HAL_FSI_RX_EVT_PING_FRAME);
+}
+
+uint32_t HAL_getFsiPingAge(uint32_t rx_base) {
+    (void)rx_base;
+    return fsi().pingAge();
+}
+
+uint16_t HAL_getFsiPingTag(uint32_t rx_base) {
+    (void)rx_base;
+    return fsi().ping_tag;
+}
+
+uint16_t HAL_getFsiTxEvents(uint32_t tx_base) {
+    (void)tx_base;
+    return fsi().tx_done ? HAL_FSI_TX_EVT_FRAME_DONE : 0U;
+}
+
+void HAL_clearFsiTxEvents(uint32_t tx_base, uint16_t events) {
+    (void)tx_base;
+    fsi().tx_done = fsi().tx_done && !(events & HAL_FSI_TX_EVT_FRAME_DONE);
+}
+
+void HAL_sendFsiFrame(uint32_t tx_base, const uint16_t *words, uint16_t count) {
+    (void)tx_base;
+    SimFsiFrame frame = {false, 0, {0}, false};
+    for (uint16_t k = 0; k < count && k < FSIL_FRAME_WORDS; k++) {
+        frame.words[k] = words[k];
+    }
+    fsi().send(SIM_FSI_TO_CONTROLLER, fsi().now(), frame);
+}
@@ -0,0 +1,46 @@
+/*
+ * inverter_model.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ */
+
+#include "inverter_model.h"
+
+InverterModel::InverterModel(InverterMode mode, double vdc, double v_drop) {
+    this->mode = mode;
+    this->vdc = vdc;
+    this->v_drop = v_drop;
+}
+
+/* Leg voltages for the present TBCLK
+ *
+ * \param i is the current out of each leg into the motor (A)
+ * */
+void InverterModel::getLegVoltages(SimEpwm *const legs[3], const double i[3], double v_leg[3]) const {
+    for (int k = 0; k < 3; k++) {
+        double sign = i[k] >= 0.0 ? 1.0 : -1.0;
+
+        if (mode == SWITCHING_INVERTER) {
+            if (legs[k]->isHighSideOn()) {
+                v_leg[k] = vdc;
+            }
+            else if (legs[k]->isLowSideOn()) {
+                v_leg[k] = 0.0;
+            }
+            else {
+                v_leg[k] = i[k] >= 0.0 ? 0.0 : vdc; // Dead time: a diode carries the current
+            }
+        }
+        else {
+            double period = legs[k]->getPeriodCounts();
+            double duty = legs[k]->getDutyCycle();
+            double dead_time_fraction = legs[k]->risingDelay()/period; // One rising edge per side per period
+            if (duty <= 0.0 || duty >= 1.0) {
+                dead_time_fraction = 0.0; // No switching, no dead time
+            }
+            v_leg[k] = vdc*(duty - sign*dead_time_fraction);
+        }
+        v_leg[k] -= sign*v_drop;
+    }
+}
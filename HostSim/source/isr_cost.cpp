@@ -0,0 +1,88 @@
+/*
+ * isr_cost.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Compiles the current loop kernels with 'float' replaced by CountedFloat. Nothing else in this file
+ *  may include the control headers, since their include guards would stop the second copy.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "isr_cost.h"
+#include "adc_model.h"
+#include "pwm.h"
+#include "adcs.h"
+#include "adc_channels.h"
+
+OpCounts opCounts;
+
+namespace counted {
+
+static inline CountedFloat sqrtf(CountedFloat x) {
+    opCounts.sqrt++;
+    return CountedFloat(::sqrtf(x.value()));
+}
+
+#define float CountedFloat
+#include "foc.h"
+#include "cla_shared.h"
+#undef float
+
+}
+
+/* Runs the loop on ADC results for a 3 A current vector rotating at 1000 rad/s and returns the counts
+ * of the most expensive sample. Sensorless runs with the observer already in closed loop. */
+OpCounts SIM_countCurrentLoopOps(bool sensorless) {
+    using namespace counted;
+
+    static FOC_CurrentLoop loop;
+    static OBS_Sensorless observer;
+    static CLA_CurrentLoopParams params;
+    static CLA_CurrentLoopTelemetry telemetry;
+
+    const double adc_lsb = ADC_VREF/ADC_FULL_SCALE_COUNTS;
+    const double Ts = 1.0/FOC_SAMPLING_FREQUENCY;
+    const double omega = 1000.0;
+
+    FOC_initLoopState(&loop, &observer, &telemetry);
+    observer.startup.state = OBS_STATE_CLOSED_LOOP;
+    FOC_initLoopParams(&params, (uint16_t)(PLLSYSCLK/2/(2*PWM_FREQUENCY_HZ))); // HalfBridgePWM timer top (TBCLK = SYSCLK/2, up-down)
+    const FOC_DQ i_ref = {0.0f, 3.0f};
+    CLA_forceCurrentReference(&params, i_ref);
+    params.enable = 1;
+    params.sensorless = sensorless ? 1 : 0;
+
+    const OpCounts zero = {0, 0, 0, 0, 0, 0, 0};
+    OpCounts worst = zero;
+    unsigned long worst_cycles = 0;
+    for (int k = 0; k < 1000; k++) {
+        double theta = omega*Ts*k;
+        double ia = 3.0*cos(theta + 1.5707963);
+        double ib = 3.0*cos(theta + 1.5707963 - 2.0943951);
+        uint16_t adc_ia = (uint16_t)((CURRENT_SENSE_OFFSET_V + ia/CURRENT_SENSE_A_PER_V)/adc_lsb);
+        uint16_t adc_ib = (uint16_t)((CURRENT_SENSE_OFFSET_V + ib/CURRENT_SENSE_A_PER_V)/adc_lsb);
+        uint16_t adc_vdc = (uint16_t)(24.0/VDC_SENSE_DIVIDER/adc_lsb);
+        uint16_t cmp[3];
+
+        CLA_setRotorAngle(&params, (float)(theta/6.283185307179586 - floor(theta/6.283185307179586)), (float)omega);
+
+        opCounts = zero;
+        CLA_runCurrentLoopSample(&loop, &observer, &params, adc_ia, adc_ib, adc_vdc, cmp, &telemetry);
+
+        unsigned long cycles = SIM_estimateClaCycles(opCounts);
+        if (cycles > worst_cycles) {
+            worst_cycles = cycles;
+            worst = opCounts;
+        }
+    }
+    return worst;
+}
+
+unsigned long SIM_estimateClaCycles(const OpCounts &ops) {
+    return ops.add*CLA_CYCLES_ADD + ops.mul*CLA_CYCLES_MUL + ops.div*CLA_CYCLES_DIV
+            + ops.compare*CLA_CYCLES_COMPARE + ops.convert*CLA_CYCLES_CONVERT + ops.sqrt*CLA_CYCLES_SQRT
+            + ops.store*CLA_CYCLES_STORE;
+}
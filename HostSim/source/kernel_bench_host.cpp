@@ -0,0 +1,135 @@
+/*
+ * kernel_bench_host.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Host runner for the control kernel microbenchmarks (F28379D_Firmware/CPU1_Controller/benchmark).
+ *  Reports ns per operation for each kernel in KB_kernels[] and compares against a baseline.
+ *
+ *  Usage: kernel_bench [--baseline FILE] [--save FILE] [--threshold PERCENT]
+ *  - --baseline: exits non-zero if a kernel is more than the threshold slower than in FILE
+ *  - --save: writes the results in the baseline format ("name ns_per_op" per line)
+ *  - --threshold: allowed slowdown, default 25%. Host timings are noisy, so keep it well above a few percent.
+ *
+ *  Host times only show relative changes in the C code. The C28x cycle counts come from the target runner.
+ */
+
+#include "kernel_bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <map>
+#include <string>
+
+#define REPEATS 5 // Best of this many samples
+#define MIN_SAMPLE_S 0.02 // Minimum length of one sample
+
+static double secondsFor(void (*run)(void), unsigned long runs) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned long r = 0; r < runs; r++) {
+        run();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/* Fewest ns per operation over the repeats */
+static double nsPerOp(void (*run)(void)) {
+    unsigned long runs = 1;
+    while (secondsFor(run, runs) < MIN_SAMPLE_S) {
+        runs *= 2;
+    }
+    double best = 1e30;
+    for (int r = 0; r < REPEATS; r++) {
+        double ns = secondsFor(run, runs)*1e9/((double)runs*KB_BATCH);
+        if (ns < best) {
+            best = ns;
+        }
+    }
+    return best;
+}
+
+static bool loadBaseline(const char *path, std::map<std::string, double> &baseline) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return false;
+    }
+    char name[128];
+    double ns;
+    while (fscanf(f, "%127s %lf", name, &ns) == 2) {
+        baseline[name] = ns;
+    }
+    fclose(f);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    const char *baseline_path = 0;
+    const char *save_path = 0;
+    double threshold_pct = 25.0;
+    for (int k = 1; k < argc; k++) {
+        if (!strcmp(argv[k], "--baseline") && k + 1 < argc) {
+            baseline_path = argv[++k];
+        }
+        else if (!strcmp(argv[k], "--save") && k + 1 < argc) {
+            save_path = argv[++k];
+        }
+        else if (!strcmp(argv[k], "--threshold") && k + 1 < argc) {
+            threshold_pct = atof(argv[++k]);
+        }
+        else {
+            fprintf(stderr, "Usage: %s [--baseline FILE] [--save FILE] [--threshold PERCENT]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::map<std::string, double> baseline;
+    if (baseline_path && !loadBaseline(baseline_path, baseline)) {
+        fprintf(stderr, "Can't read baseline %s\n", baseline_path);
+        return 2;
+    }
+
+    FILE *save = 0;
+    if (save_path) {
+        save = fopen(save_path, "w");
+        if (!save) {
+            fprintf(stderr, "Can't write %s\n", save_path);
+            return 2;
+        }
+    }
+
+    KB_init();
+    int regressions = 0;
+    printf("%-22s %10s %10s %8s\n", "kernel", "ns/op", "baseline", "change");
+    for (uint16_t k = 0; k < KB_kernelCount; k++) {
+        const KB_Kernel &kernel = KB_kernels[k];
+        double ns = nsPerOp(kernel.run);
+        if (save) {
+            fprintf(save, "%s %.4f\n", kernel.name, ns);
+        }
+
+        std::map<std::string, double>::const_iterator b = baseline.find(kernel.name);
+        if (b == baseline.end()) {
+            printf("%-22s %10.3f %10s %8s\n", kernel.name, ns, "-", "-");
+            continue;
+        }
+        double change_pct = 100.0*(ns - b->second)/b->second;
+        bool regressed = change_pct > threshold_pct;
+        printf("%-22s %10.3f %10.3f %+7.1f%%%s\n", kernel.name, ns, b->second, change_pct,
+               regressed ? "  REGRESSION" : "");
+        if (regressed) {
+            regressions++;
+        }
+    }
+
+    if (save) {
+        fclose(save);
+        printf("Saved %s\n", save_path);
+    }
+    if (baseline_path) {
+        printf("%s: %d regression%s over %.0f%%\n", regressions ? "FAIL" : "PASS", regressions,
+               regressions == 1 ? "" : "s", threshold_pct);
+    }
+    return regressions ? 1 : 0;
+}
@@ -0,0 +1,245 @@
+/*
+ * pie_simulator.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ */
+
+#include "pie_simulator.h"
+#include <stdio.h>
+#include <string.h>
+
+PieIsrSource PIE_periodicSource(const char *name, uint16_t cpu_interrupt, uint16_t channel, double frequency_Hz) {
+    PieIsrSource s;
+    s.name = name;
+    s.cpu_interrupt = cpu_interrupt;
+    s.channel = channel;
+    s.type = PIE_SOURCE_PERIODIC;
+    s.period_s = 1.0/frequency_Hz;
+    s.phase_s = 0.0;
+    s.cycles_min = 0;
+    s.cycles_max = 0;
+    s.nesting = false;
+    s.nest_ier = 0;
+    s.deadline_s = 0.0;
+    return s;
+}
+
+PieIsrSource PIE_randomSource(const char *name, uint16_t cpu_interrupt, uint16_t channel, double mean_rate_Hz,
+                              double max_rate_Hz) {
+    PieIsrSource s = PIE_periodicSource(name, cpu_interrupt, channel, mean_rate_Hz);
+    s.type = PIE_SOURCE_RANDOM;
+    s.phase_s = 1.0/max_rate_Hz;
+    return s;
+}
+
+PieSimulator::PieSimulator(const PieClockProfile &clock, bool worst_case, unsigned seed) : rng(seed) {
+    this->clock = clock;
+    this->worst_case = worst_case;
+    now = 0;
+    duration = 0;
+}
+
+size_t PieSimulator::addSource(const PieIsrSource &source) {
+    sources.push_back(source);
+    PieIsrStats s;
+    memset(&s, 0, sizeof(s));
+    stats.push_back(s);
+    pending_since.push_back(0);
+    pending.push_back(false);
+    size_t k = sources.size() - 1;
+    next_trigger.push_back(now + (source.type == PIE_SOURCE_PERIODIC ? cycles(source.phase_s) : nextInterval(k)));
+    return k;
+}
+
+bool PieSimulator::setCost(const std::string &name, uint32_t cycles_min, uint32_t cycles_max) {
+    bool found = false;
+    for (size_t k = 0; k < sources.size(); k++) {
+        if (sources[k].name == name) {
+            sources[k].cycles_min = cycles_min;
+            sources[k].cycles_max = cycles_max;
+            found = true;
+        }
+    }
+    return found;
+}
+
+uint64_t PieSimulator::nextInterval(size_t k) {
+    const PieIsrSource &s = sources[k];
+    if (s.type == PIE_SOURCE_PERIODIC) {
+        return cycles(s.period_s);
+    }
+    if (s.period_s <= s.phase_s) {
+        return cycles(s.phase_s); // Mean rate at the maximum: back to back
+    }
+    std::exponential_distribution<double> interval(1.0/(s.period_s - s.phase_s));
+    uint64_t n = cycles(s.phase_s + interval(rng));
+    return n > 0 ? n : 1;
+}
+
+/* Lower CPU interrupt number first, then lower PIE channel */
+bool PieSimulator::isHigherPriority(size_t a, size_t b) const {
+    if (sources[a].cpu_interrupt != sources[b].cpu_interrupt) {
+        return sources[a].cpu_interrupt < sources[b].cpu_interrupt;
+    }
+    return sources[a].channel < sources[b].channel;
+}
+
+/* Whether source k can be taken now */
+bool PieSimulator::canPreempt(size_t k) const {
+    if (stack.empty()) {
+        return true;
+    }
+    const Frame &top = stack.back();
+    const PieIsrSource &running = sources[top.source];
+    bool past_entry = top.total_cycles - top.remaining >= clock.entry_cycles;
+    bool enabled = running.nest_ier ? ((running.nest_ier >> (sources[k].cpu_interrupt - 1)) & 1U) != 0
+                                    : sources[k].cpu_interrupt < running.cpu_interrupt;
+    return running.nesting && past_entry && enabled && sources[k].cpu_interrupt != running.cpu_interrupt;
+}
+
+/* Starts the highest priority pending ISR which is allowed to run. Returns false if there was none. */
+bool PieSimulator::dispatch() {
+    size_t best = sources.size();
+    for (size_t k = 0; k < sources.size(); k++) {
+        if (pending[k] && canPreempt(k) && (best == sources.size() || isHigherPriority(k, best))) {
+            best = k;
+        }
+    }
+    if (best == sources.size()) {
+        return false;
+    }
+
+    const PieIsrSource &s = sources[best];
+    PieIsrStats &st = stats[best];
+    uint32_t cost = s.cycles_max;
+    if (!worst_case && s.cycles_max > s.cycles_min) {
+        std::uniform_int_distribution<uint32_t> spread(s.cycles_min, s.cycles_max);
+        cost = spread(rng);
+    }
+
+    Frame f;
+    f.source = best;
+    f.trigger_time = pending_since[best];
+    f.total_cycles = clock.entry_cycles + cost + clock.exit_cycles;
+    f.remaining = f.total_cycles;
+    stack.push_back(f);
+    pending[best] = false;
+
+    uint64_t latency = now + clock.entry_cycles - f.trigger_time;
+    if (st.serviced == 0 || latency < st.latency_min) {
+        st.latency_min = latency;
+    }
+    if (latency > st.latency_max) {
+        st.latency_max = latency;
+    }
+    st.latency_sum += latency;
+    st.serviced++;
+    return true;
+}
+
+void PieSimulator::run(double duration_s) {
+    uint64_t end = now + cycles(duration_s);
+    duration += end - now;
+
+    while (now < end) {
+        while (dispatch()) {
+        }
+
+        // Next thing to happen: a trigger, the running ISR returning, or it reaching the point where it
+        // re-enables nesting
+        uint64_t next = end;
+        for (size_t k = 0; k < sources.size(); k++) {
+            if (next_trigger[k] < next) {
+                next = next_trigger[k];
+            }
+        }
+        if (!stack.empty()) {
+            const Frame &top = stack.back();
+            if (now + top.remaining < next) {
+                next = now + top.remaining;
+            }
+            uint64_t elapsed = top.total_cycles - top.remaining;
+            if (sources[top.source].nesting && elapsed < clock.entry_cycles && now + clock.entry_cycles - elapsed < next) {
+                next = now + clock.entry_cycles - elapsed;
+            }
+        }
+
+        uint64_t dt = next - now;
+        now = next;
+        if (!stack.empty()) {
+            Frame &top = stack.back();
+            top.remaining -= dt;
+            stats[top.source].busy_cycles += dt;
+            if (top.remaining == 0) {
+                PieIsrStats &st = stats[top.source];
+                if (now - top.trigger_time > st.response_max) {
+                    st.response_max = now - top.trigger_time;
+                }
+                stack.pop_back();
+            }
+        }
+
+        for (size_t k = 0; k < sources.size(); k++) {
+            if (next_trigger[k] == now) {
+                stats[k].triggers++;
+                if (pending[k]) {
+                    stats[k].overruns++; // Flag already set
+                }
+                else {
+                    pending[k] = true;
+                    pending_since[k] = now;
+                }
+                next_trigger[k] = now + nextInterval(k);
+            }
+        }
+    }
+}
+
+double PieSimulator::worstLatencyUs(size_t k) const {
+    return stats[k].latency_max*1e6/clock.sysclk_Hz;
+}
+
+double PieSimulator::jitterUs(size_t k) const {
+    return stats[k].serviced ? (stats[k].latency_max - stats[k].latency_min)*1e6/clock.sysclk_Hz : 0.0;
+}
+
+double PieSimulator::loadPct(size_t k) const {
+    return duration ? 100.0*stats[k].busy_cycles/duration : 0.0;
+}
+
+double PieSimulator::totalLoadPct() const {
+    double total = 0.0;
+    for (size_t k = 0; k < sources.size(); k++) {
+        total += loadPct(k);
+    }
+    return total;
+}
+
+int PIE_loadCycleProfile(const char *path, PieSimulator &sim, int *unmeasured) {
+    *unmeasured = 0;
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return -1;
+    }
+    int applied = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        char *comment = strchr(line, '#');
+        if (comment) {
+            *comment = '\0';
+        }
+        char name[128];
+        char source[32] = "";
+        unsigned long cycles_min, cycles_max;
+        if (sscanf(line, "%127s %lu %lu %31s", name, &cycles_min, &cycles_max, source) >= 3
+                && sim.setCost(name, (uint32_t)cycles_min, (uint32_t)cycles_max)) {
+            applied++;
+            if (strcmp(source, "measured") != 0) {
+                (*unmeasured)++;
+            }
+        }
+    }
+    fclose(f);
+    return applied;
+}
@@ -0,0 +1,69 @@
+/*
+ * pmsm_model.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ */
+
+#include "pmsm_model.h"
+#include <math.h>
+
+static const double TWO_PI = 6.283185307179586;
+
+PmsmModel::PmsmModel(const PmsmParameters &params) : params(params) {
+    id = 0.0;
+    iq = 0.0;
+    omega_m = 0.0;
+    theta_e = 0.0;
+    load_torque = 0.0;
+    speed_held = false;
+}
+
+/* Advances the model by dt seconds with the leg voltages held constant */
+void PmsmModel::step(const double v_leg[3], double dt) {
+    // Phase voltages to the star point
+    double v_common = (v_leg[0] + v_leg[1] + v_leg[2])/3.0;
+    double va = v_leg[0] - v_common;
+    double vb = v_leg[1] - v_common;
+    double vc = v_leg[2] - v_common;
+
+    // Clarke (amplitude invariant) and Park
+    double v_alpha = (2.0*va - vb - vc)/3.0;
+    double v_beta = (vb - vc)/sqrt(3.0);
+    double c = cos(theta_e);
+    double s = sin(theta_e);
+    double vd = v_alpha*c + v_beta*s;
+    double vq = -v_alpha*s + v_beta*c;
+
+    double omega_e = omega_m * params.pole_pairs;
+    double did = (vd - params.Rs*id + omega_e*params.Lq*iq)/params.Ld;
+    double diq = (vq - params.Rs*iq - omega_e*(params.Ld*id + params.flux))/params.Lq;
+
+    if (!speed_held) {
+        omega_m += dt*(getTorque() - load_torque - params.B*omega_m)/params.J;
+    }
+    id += dt*did;
+    iq += dt*diq;
+
+    theta_e += dt*omega_e;
+    theta_e -= TWO_PI*floor(theta_e/TWO_PI);
+}
+
+void PmsmModel::holdSpeed(double omega_e) {
+    omega_m = omega_e/params.pole_pairs;
+    speed_held = true;
+}
+
+void PmsmModel::getPhaseCurrents(double i[3]) const {
+    double c = cos(theta_e);
+    double s = sin(theta_e);
+    double i_alpha = id*c - iq*s;
+    double i_beta = id*s + iq*c;
+    i[0] = i_alpha;
+    i[1] = -0.5*i_alpha + 0.5*sqrt(3.0)*i_beta;
+    i[2] = -0.5*i_alpha - 0.5*sqrt(3.0)*i_beta;
+}
+
+double PmsmModel::getTorque() const {
+    return 1.5*params.pole_pairs*(params.flux*iq + (params.Ld - params.Lq)*id*iq);
+}
@@ -0,0 +1,136 @@
+/*
+ * pwm_timeline.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ */
+
+#include "pwm_timeline.h"
+
+PwmTimeline::PwmTimeline(SimEpwm *pwm) {
+    this->pwm = pwm;
+    clear();
+}
+
+void PwmTimeline::clear() {
+    edges.clear();
+    updates.clear();
+    level[SIM_PWM_OUTPUT_A] = pwm->getOutputA();
+    level[SIM_PWM_OUTPUT_B] = pwm->getOutputB();
+    start_level[SIM_PWM_OUTPUT_A] = level[SIM_PWM_OUTPUT_A];
+    start_level[SIM_PWM_OUTPUT_B] = level[SIM_PWM_OUTPUT_B];
+    compare_writes = pwm->compare_writes;
+    update_pending = false;
+}
+
+bool PwmTimeline::tick() {
+    if (pwm->compare_writes != compare_writes) {
+        compare_writes = pwm->compare_writes;
+        SimCompareUpdate update;
+        update.write_tick = pwm->getTicks();
+        update.load_tick = update.write_tick;
+        updates.push_back(update);
+        update_pending = !pwm->cmpa_immediate; // Immediate writes are already active
+    }
+
+    bool soc = pwm->tick();
+
+    if (update_pending && pwm->getLoadTick() == pwm->getTicks()) {
+        updates.back().load_tick = pwm->getTicks();
+        update_pending = false;
+    }
+
+    bool now[2] = {pwm->getOutputA(), pwm->getOutputB()};
+    for (uint16_t k = 0; k < 2; k++) {
+        if (now[k] != level[k]) {
+            SimPwmEdge edge;
+            edge.tick = pwm->getTicks();
+            edge.output = k;
+            edge.level = now[k];
+            edges.push_back(edge);
+            level[k] = now[k];
+        }
+    }
+    return soc;
+}
+
+void PwmTimeline::run(unsigned long ticks) {
+    for (unsigned long n = 0; n < ticks; n++) {
+        tick();
+    }
+}
+
+/* Replays the edges from the start of the recording to find the output level at the start of the window,
+ * then adds up the high time */
+unsigned long PwmTimeline::highTicks(uint16_t output, unsigned long from, unsigned long to) const {
+    bool high = start_level[output];
+    unsigned long since = from;
+    unsigned long total = 0;
+    for (size_t k = 0; k < edges.size(); k++) {
+        const SimPwmEdge &e = edges[k];
+        if (e.output != output) {
+            continue;
+        }
+        if (e.tick <= from) {
+            high = e.level;
+            continue;
+        }
+        if (e.tick >= to) {
+            break;
+        }
+        if (high) {
+            total += e.tick - since;
+        }
+        high = e.level;
+        since = e.tick;
+    }
+    if (high) {
+        total += to - since;
+    }
+    return total;
+}
+
+/* Shortest and longest gap between one output falling and the other rising, in [from, to).
+ * Returns false if there were no such transitions. */
+bool PwmTimeline::deadTimes(unsigned long from, unsigned long to, unsigned long *min_ticks,
+                            unsigned long *max_ticks) const {
+    bool found = false;
+    long fall_tick[2] = {-1, -1};
+    for (size_t k = 0; k < edges.size(); k++) {
+        const SimPwmEdge &e = edges[k];
+        if (e.tick >= to) {
+            break;
+        }
+        if (!e.level) {
+            fall_tick[e.output] = (long)e.tick;
+            continue;
+        }
+        long other_fall = fall_tick[1 - e.output];
+        if (e.tick >= from && other_fall >= (long)from) {
+            unsigned long gap = e.tick - (unsigned long)other_fall;
+            if (!found || gap < *min_ticks) {
+                *min_ticks = gap;
+            }
+            if (!found || gap > *max_ticks) {
+                *max_ticks = gap;
+            }
+            found = true;
+        }
+    }
+    return found;
+}
+
+bool PwmTimeline::overlap(unsigned long from, unsigned long to) const {
+    bool high[2] = {start_level[SIM_PWM_OUTPUT_A], start_level[SIM_PWM_OUTPUT_B]};
+    for (size_t k = 0; k < edges.size(); k++) {
+        const SimPwmEdge &e = edges[k];
+        if (e.tick >= to) {
+            break;
+        }
+        high[e.output] = e.level;
+        if (e.tick >= from && high[0] && high[1]) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,209 @@
+/*
+ * serial_command.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Encodes one host command (F28379D_Firmware/common/command_protocol.h) as a serial frame on stdout, for
+ *  CPU2's SCI-A. The reply comes back on the same port and serial_decode prints it.
+ *
+ *  Usage: serial_command [-s SEQUENCE] COMMAND ARGS...
+ *    read NAME                     a parameter (commands.h), by name or number
+ *    write NAME VALUE
+ *    mode off|speed|position TARGET
+ *    scope DECIMATION [CHANNEL...]  the live scope, channels by name (scope.h). None stops it.
+ *    capture DECIMATION PRE POST above|below|rising|falling LEVEL VARIABLE CHANNEL...
+ *    capture DECIMATION PRE POST fault MASK VARIABLE CHANNEL...
+ *    capture off
+ *    trigger                       the armed capture
+ *    forward BYTE...               to CPU1's command handler, an odd count padded with a zero byte
+ *    gains KP_D KI_TS_D KP_Q KI_TS_Q  CPU1's current regulator gains, taken whole from its next sample
+ *    list                          the parameters and scope variables, to stderr
+ *
+ *  e.g. "serial_command write speed_kp 0.002 > /dev/ttyACM0" with the port at 781250 baud (stty raw).
+ */
+
+#include "serial_frame.h"
+#include "command_protocol.h"
+#include "commands.h"
+#include "motion_control.h"
+#include "scope.h"
+#include "capture.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    const char *name;
+    uint16_t type;
+    uint16_t access;
+} ParameterInfo;
+
+#define PARAMETER_INFO_ENTRY(name, variable, type, access, min, max) {#name, type, access},
+static const ParameterInfo parameterInfo[COMMAND_PARAMETER_COUNT] = {
+    COMMAND_PARAMETERS(PARAMETER_INFO_ENTRY)
+};
+
+#define SCOPE_NAME_ENTRY(name, variable, type, scale, unit) #name,
+static const char *const scopeNames[SCOPE_VARIABLE_COUNT] = {
+    SCOPE_REGISTRY(SCOPE_NAME_ENTRY)
+};
+
+static void usage() {
+    fprintf(stderr, "usage: serial_command [-s SEQUENCE] read NAME | write NAME VALUE | mode off|speed|position TARGET\n"
+                    "       | scope DECIMATION [CHANNEL...] | capture DECIMATION PRE POST TRIGGER LEVEL|MASK VARIABLE CHANNEL...\n"
+                    "       | capture off | trigger | forward BYTE... | gains KP_D KI_TS_D KP_Q KI_TS_Q | list\n");
+    exit(2);
+}
+
+/* Looks a name up in a table, or takes a number. Exits if it's neither. */
+static uint16_t lookup(const char *name, const char *const *names, uint16_t count, size_t stride) {
+    for (uint16_t k = 0; k < count; k++) {
+        if (!strcmp(name, *(const char *const *)((const char *)names + k*stride))) {
+            return k;
+        }
+    }
+    char *end;
+    unsigned long number = strtoul(name, &end, 0);
+    if (*name && !*end && number < count) {
+        return (uint16_t)number;
+    }
+    fprintf(stderr, "serial_command: no such name %s\n", name);
+    exit(2);
+}
+
+static uint16_t parameterId(const char *name) {
+    return lookup(name, &parameterInfo[0].name, COMMAND_PARAMETER_COUNT, sizeof(ParameterInfo));
+}
+
+static uint16_t scopeId(const char *name) {
+    return lookup(name, scopeNames, SCOPE_VARIABLE_COUNT, sizeof(const char *));
+}
+
+static unsigned long number(const char *text) {
+    char *end;
+    unsigned long value = strtoul(text, &end, 0);
+    if (!*text || *end) {
+        usage();
+    }
+    return value;
+}
+
+static void putLong(uint16_t *words, uint32_t value) {
+    words[0] = (uint16_t)value;
+    words[1] = (uint16_t)(value >> 16);
+}
+
+int main(int argc, char **argv) {
+    uint16_t sequence = 0;
+    int a = 1;
+    if (a + 1 < argc && !strcmp(argv[a], "-s")) {
+        sequence = (uint16_t)(number(argv[a + 1]) & 0xFFU);
+        a += 2;
+    }
+    if (a >= argc) {
+        usage();
+    }
+    const char *command = argv[a++];
+    int args = argc - a;
+    char **arg = argv + a;
+
+    uint16_t type;
+    uint16_t payload[SFRAME_MAX_PAYLOAD_BYTES/2];
+    uint16_t words = 0;
+    if (!strcmp(command, "read") && args == 1) {
+        type = CMD_PARAM_READ;
+        payload[words++] = parameterId(arg[0]);
+    }
+    else if (!strcmp(command, "write") && args == 2) {
+        type = CMD_PARAM_WRITE;
+        uint16_t id = parameterId(arg[0]);
+        payload[words++] = id;
+        payload[words++] = 0;
+        putLong(payload + words, parameterInfo[id].type == CMD_FLOAT32 ? CMD_fromFloat(strtof(arg[1], 0))
+                                                                       : (uint32_t)number(arg[1]));
+        words += 2;
+    }
+    else if (!strcmp(command, "mode") && args >= 1) {
+        static const char *const modes[] = {"off", "speed", "position"};
+        type = CMD_MODE;
+        payload[words++] = lookup(arg[0], modes, MOTION_MODE_POSITION + 1, sizeof(const char *));
+        payload[words++] = 0;
+        putLong(payload + words, CMD_fromFloat(args > 1 ? strtof(arg[1], 0) : 0.0f));
+        words += 2;
+    }
+    else if (!strcmp(command, "scope") && args >= 1 && args <= 1 + (int)SCOPE_MAX_CHANNELS) {
+        type = CMD_SCOPE_SELECT;
+        SCOPE_Select select = {};
+        select.decimation = (uint16_t)number(arg[0]);
+        select.count = (uint16_t)(args - 1);
+        for (uint16_t k = 0; k < select.count; k++) {
+            select.ids[k] = scopeId(arg[1 + k]);
+        }
+        memcpy(payload, &select, sizeof(select)); // Same layout on both: 16-bit words, little endian
+        words = CHAN_WORDS(select);
+    }
+    else if (!strcmp(command, "capture") && ((args == 1 && !strcmp(arg[0], "off"))
+                                             || (args >= 7 && args <= 6 + (int)SCOPE_MAX_CHANNELS))) {
+        static const char *const triggers[] = {"above", "below", "rising", "falling", "fault"};
+        type = CMD_CAPTURE_ARM;
+        CAPTURE_Arm arm = {};
+        if (args > 1) {
+            arm.decimation = (uint16_t)number(arg[0]);
+            arm.pre_trigger = (uint16_t)number(arg[1]);
+            arm.post_trigger = (uint16_t)number(arg[2]);
+            arm.trigger = lookup(arg[3], triggers, CAPTURE_TRIGGER_FORCED, sizeof(const char *));
+            if (arm.trigger == CAPTURE_TRIGGER_FAULT) {
+                arm.mask = (uint32_t)number(arg[4]);
+            }
+            else {
+                arm.level = strtof(arg[4], 0);
+            }
+            arm.trigger_id = scopeId(arg[5]);
+            arm.count = (uint16_t)(args - 6);
+            for (uint16_t k = 0; k < arm.count; k++) {
+                arm.ids[k] = scopeId(arg[6 + k]);
+            }
+        }
+        memcpy(payload, &arm, sizeof(arm));
+        words = CHAN_WORDS(arm);
+    }
+    else if (!strcmp(command, "trigger") && args == 0) {
+        type = CMD_CAPTURE_TRIGGER;
+    }
+    else if (!strcmp(command, "forward") && args >= 1 && args <= 32) { // COMMS_MAX_FRAME_WORDS in comms.h
+        type = CMD_FORWARD;
+        memset(payload, 0, sizeof(payload));
+        for (int k = 0; k < args; k++) {
+            payload[k/2] |= (uint16_t)((number(arg[k]) & 0xFFU) << (8*(k & 1)));
+        }
+        words = (uint16_t)((args + 1)/2);
+    }
+    else if (!strcmp(command, "gains") && args == 4) {
+        type = CMD_CURRENT_GAINS; // A FOC_CurrentGains: four floats
+        for (int k = 0; k < 4; k++) {
+            putLong(payload + words, CMD_fromFloat(strtof(arg[k], 0)));
+            words += 2;
+        }
+    }
+    else if (!strcmp(command, "list") && args == 0) {
+        for (uint16_t k = 0; k < COMMAND_PARAMETER_COUNT; k++) {
+            fprintf(stderr, "parameter %2u %-24s %s\n", k, parameterInfo[k].name,
+                    parameterInfo[k].access == CMD_RW ? "rw" : "ro");
+        }
+        for (uint16_t k = 0; k < SCOPE_VARIABLE_COUNT; k++) {
+            fprintf(stderr, "scope     %2u %s\n", k, scopeNames[k]);
+        }
+        return 0;
+    }
+    else {
+        usage();
+    }
+
+    uint16_t encoded[SFRAME_ENCODED_BYTES(SFRAME_MAX_PAYLOAD_BYTES)];
+    uint16_t length = SFRAME_encode(encoded, type, sequence, 0, payload, words);
+    for (uint16_t k = 0; k < length; k++) {
+        putchar(encoded[k]);
+    }
+    return 0;
+}
@@ -0,0 +1,264 @@
+/*
+ * serial_decode.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Decodes a capture of CPU2's serial link (F28379D_Firmware/common/serial_frame.h) into one line per
+ *  frame, with the telemetry and boot report fields spelled out, then a summary of the errors and the
+ *  frames lost to gaps in the sequence. GSx frames are reassembled from their data chunks, and live scope
+ *  frames (scope.h) printed one record per line, with the registry's names, scales and units. Triggered
+ *  captures (capture.h) are unrolled from their ring, with samples counted from the trigger. Replies to
+ *  host commands (command_protocol.h) show the command, its status and any parameter by name.
+ *
+ *  Usage: serial_decode [FILE]
+ *  FILE is the raw bytes from the port, e.g. from "cat /dev/ttyACM0 > capture.bin" with the port at
+ *  781250 baud (stty raw), or stdin if not given. The first frame of a capture that starts mid-frame is
+ *  counted as an error.
+ *
+ *  Times are seconds of the IPC counter (SYSCLK), unwrapped from its low 32 bits, from the first frame.
+ */
+
+#include "serial_frame.h"
+#include "ipc_channel.h"
+#include "ipc_link.h"
+#include "boot_sync.h"
+#include "clock_config.h"
+#include "scope.h"
+#include "capture.h"
+#include "commands.h"
+#include <stdio.h>
+#include <string.h>
+
+#define COMMS_FRAME_DATA 0x80 // In CPU2_Communication/comms.h
+
+typedef struct {
+    const char *name;
+    uint16_t type;
+    float scale;
+    const char *unit;
+} ScopeChannelInfo;
+
+#define SCOPE_INFO_ENTRY(name, variable, type, scale, unit) {#name, type, scale, unit},
+static const ScopeChannelInfo scopeChannels[SCOPE_VARIABLE_COUNT] = {
+    SCOPE_REGISTRY(SCOPE_INFO_ENTRY)
+};
+
+typedef struct {
+    const char *name;
+    uint16_t type;
+} ParameterInfo;
+
+#define PARAMETER_INFO_ENTRY(name, variable, type, access, min, max) {#name, type},
+static const ParameterInfo parameterInfo[COMMAND_PARAMETER_COUNT] = {
+    COMMAND_PARAMETERS(PARAMETER_INFO_ENTRY)
+};
+
+static uint16_t gsxFrame[FRAME_BUFFER_WORDS]; // The GSx frame being reassembled
+static uint16_t gsxWords; // Its length from FRAME_READY
+static uint16_t gsxReceived; // Words of it so far
+
+static double scopeValue(const ScopeChannelInfo &info, const uint16_t *data) {
+    uint32_t raw = SCOPE_isWide(info.type) ? (uint32_t)data[0] | (uint32_t)data[1] << 16 : data[0];
+    float f;
+    switch (info.type) {
+        case SCOPE_FLOAT32: memcpy(&f, &raw, sizeof(f)); return f*info.scale;
+        case SCOPE_INT32: return (int32_t)raw*(double)info.scale;
+        case SCOPE_INT16: return (int16_t)raw*(double)info.scale;
+        default: return raw*(double)info.scale;
+    }
+}
+
+/* Where each channel of a frame header's ids is in a record: 32-bit channels first, as recorded.
+ * \return the record length in words, 0 if a channel is unknown or there are none */
+static uint16_t recordLayout(const uint16_t *header_ids, uint16_t *ids, uint16_t *offsets, uint16_t *count) {
+    uint16_t record_words = 0;
+    *count = 0;
+    for (int wide = 1; wide >= 0; wide--) {
+        for (uint16_t k = 0; k < SCOPE_MAX_CHANNELS && SCOPE_channelId(header_ids, k) != SCOPE_NO_CHANNEL; k++) {
+            uint16_t id = SCOPE_channelId(header_ids, k);
+            if (id >= SCOPE_VARIABLE_COUNT) {
+                printf("        frame with unknown channel %u\n", id);
+                return 0;
+            }
+            if (SCOPE_isWide(scopeChannels[id].type) == (wide == 1)) {
+                ids[*count] = id;
+                offsets[(*count)++] = record_words;
+                record_words += wide ? 2 : 1;
+            }
+        }
+    }
+    return record_words;
+}
+
+static void printRecord(const uint16_t *record, const uint16_t *ids, const uint16_t *offsets, uint16_t count) {
+    for (uint16_t k = 0; k < count; k++) {
+        const ScopeChannelInfo &info = scopeChannels[ids[k]];
+        printf(" %s %.6g%s", info.name, scopeValue(info, record + offsets[k]), info.unit);
+    }
+    printf("\n");
+}
+
+/* One line per record of a live scope frame */
+static void printScopeFrame(const uint16_t *frame, uint16_t words) {
+    SCOPE_FrameHeader header;
+    memcpy(&header, frame, sizeof(header));
+    uint16_t ids[SCOPE_MAX_CHANNELS];
+    uint16_t offsets[SCOPE_MAX_CHANNELS]; // Of each channel in a record
+    uint16_t count;
+    uint16_t record_words = recordLayout(header.ids, ids, offsets, &count);
+    if (!record_words || words < SCOPE_HEADER_WORDS) {
+        return;
+    }
+    for (uint16_t r = 0; r < (words - SCOPE_HEADER_WORDS)/record_words; r++) {
+        printf("        scope sample %lu", (unsigned long)(header.first_sample + (uint32_t)r*header.decimation));
+        printRecord(frame + SCOPE_HEADER_WORDS + r*record_words, ids, offsets, count);
+    }
+}
+
+/* A triggered capture, unrolled from its ring: one line per record, with samples counted from the
+ * trigger record */
+static void printCaptureFrame(const uint16_t *frame, uint16_t words) {
+    static const char *const triggers[] = {"above", "below", "rising", "falling", "fault", "forced"};
+    CAPTURE_FrameHeader header;
+    memcpy(&header, frame, sizeof(header));
+    uint16_t ids[SCOPE_MAX_CHANNELS];
+    uint16_t offsets[SCOPE_MAX_CHANNELS];
+    uint16_t count;
+    uint16_t record_words = recordLayout(header.ids, ids, offsets, &count);
+    if (!record_words || words != CAPTURE_HEADER_WORDS + header.records*record_words
+            || header.oldest >= header.records || header.pre_trigger >= header.records) {
+        printf("        capture frame with an inconsistent header\n");
+        return;
+    }
+    printf("        capture %s trigger at sample %lu, %u records, %u before it\n",
+           header.trigger <= CAPTURE_TRIGGER_FORCED ? triggers[header.trigger] : "unknown",
+           (unsigned long)header.trigger_sample, header.records, header.pre_trigger);
+    for (uint16_t k = 0; k < header.records; k++) {
+        long sample = ((long)k - header.pre_trigger)*header.decimation;
+        printf("        capture sample %+ld", sample);
+        printRecord(frame + CAPTURE_HEADER_WORDS + ((header.oldest + k) % header.records)*record_words, ids, offsets, count);
+    }
+}
+
+static void printReply(const CMD_Reply &r) {
+    static const char *const commands[] = {"read", "write", "mode", "scope", "capture", "trigger", "forward",
+                                          "gains"};
+    static const char *const statuses[] = {"ok", "unknown", "bad_length", "bad_id", "read_only", "out_of_range",
+                                           "busy"};
+    if (r.command >= CMD_PARAM_READ && r.command <= CMD_CURRENT_GAINS) {
+        printf("reply %s", commands[r.command - CMD_PARAM_READ]);
+    }
+    else {
+        printf("reply type %u", r.command);
+    }
+    printf(" to %u %s", r.sequence, r.status <= CMD_BUSY ? statuses[r.status] : "?");
+    if ((r.command == CMD_PARAM_READ || r.command == CMD_PARAM_WRITE) && r.id < COMMAND_PARAMETER_COUNT
+            && r.status != CMD_BAD_ID && r.status != CMD_BAD_LENGTH) {
+        const ParameterInfo &p = parameterInfo[r.id];
+        if (p.type == CMD_FLOAT32) {
+            printf(" %s %g", p.name, CMD_toFloat(r.value));
+        }
+        else {
+            printf(" %s %lu", p.name, (unsigned long)r.value);
+        }
+    }
+    printf("\n");
+}
+
+static void printFrame(const SFRAME_Decoder &d, double time_s) {
+    uint16_t words[SFRAME_MAX_PAYLOAD_BYTES/2];
+    uint16_t count = SFRAME_payloadWords(&d, words, SFRAME_MAX_PAYLOAD_BYTES/2);
+    uint16_t type = SFRAME_type(&d);
+    printf("%3u %12.6f ", SFRAME_sequence(&d), time_s);
+
+    if (type == CHAN_MSG_TELEMETRY && count == CHAN_WORDS(LINK_Telemetry)) {
+        LINK_Telemetry t;
+        memcpy(&t, words, sizeof(t)); // Both little endian with IEEE floats and the same layout
+        printf("telemetry sample %lu ia %.3f ib %.3f vdc %.2f id %.3f iq %.3f vd %.3f vq %.3f theta %.4f "
+               "omega %.1f state %u gains %lu\n", (unsigned long)t.sample_count, t.ia, t.ib, t.vdc, t.id, t.iq,
+               t.vd, t.vq, t.theta, t.omega, t.startup_state, (unsigned long)t.gains_version);
+    }
+    else if (type == CHAN_MSG_BOOT_REPORT && count == CHAN_WORDS(BOOT_Report)) {
+        BOOT_Report r;
+        memcpy(&r, words, sizeof(r));
+        printf("boot cpu2_released %lu pll_locked %lu cpu1_ready %lu cpu2_ready %lu first_pwm %lu "
+               "time_to_pwm %lu us\n", (unsigned long)r.cpu2_released, (unsigned long)r.pll_locked,
+               (unsigned long)r.cpu1_ready, (unsigned long)r.cpu2_ready, (unsigned long)r.first_pwm,
+               (unsigned long)r.time_to_pwm_us);
+    }
+    else if (type == CHAN_MSG_FRAME_READY && count == CHAN_WORDS(FRAME_Ready)) {
+        FRAME_Ready ready;
+        memcpy(&ready, words, sizeof(ready));
+        printf("frame %lu buffer %u words %u\n", (unsigned long)ready.sequence, ready.buffer, ready.words);
+        gsxWords = ready.words <= FRAME_BUFFER_WORDS ? ready.words : 0;
+        gsxReceived = 0;
+    }
+    else if (type == CMD_REPLY && count == CHAN_WORDS(CMD_Reply)) {
+        CMD_Reply r;
+        memcpy(&r, words, sizeof(r));
+        printReply(r);
+    }
+    else if (type == COMMS_FRAME_DATA && gsxReceived < gsxWords) {
+        printf("data %u words\n", count);
+        count = count < gsxWords - gsxReceived ? count : (uint16_t)(gsxWords - gsxReceived);
+        memcpy(gsxFrame + gsxReceived, words, count*sizeof(uint16_t));
+        gsxReceived += count;
+        if (gsxReceived == gsxWords && gsxFrame[0] == SCOPE_FRAME_KIND) {
+            printScopeFrame(gsxFrame, gsxWords);
+        }
+        else if (gsxReceived == gsxWords && gsxFrame[0] == CAPTURE_FRAME_KIND) {
+            printCaptureFrame(gsxFrame, gsxWords);
+        }
+    }
+    else {
+        printf(type == COMMS_FRAME_DATA ? "data" : "type %u", type);
+        for (uint16_t k = 0; k < count; k++) {
+            printf(" %04x", words[k]);
+        }
+        printf("\n");
+    }
+}
+
+int main(int argc, char **argv) {
+    FILE *f = argc > 1 ? fopen(argv[1], "rb") : stdin;
+    if (!f) {
+        fprintf(stderr, "serial_decode: can't open %s\n", argv[1]);
+        return 2;
+    }
+
+    SFRAME_Decoder decoder;
+    SFRAME_initDecoder(&decoder);
+    unsigned long bytes = 0, lost = 0;
+    uint16_t last_sequence = 0;
+    uint32_t last_stamp = 0;
+    double cycles = 0.0;
+    int c;
+    while ((c = fgetc(f)) != EOF) {
+        bytes++;
+        if (!SFRAME_decodeByte(&decoder, (uint16_t)c)) {
+            continue;
+        }
+        uint32_t stamp = SFRAME_timestamp(&decoder);
+        uint16_t sequence = SFRAME_sequence(&decoder);
+        if (decoder.frames > 1) {
+            cycles += (double)(uint32_t)(stamp - last_stamp);
+            uint16_t gap = (uint16_t)(sequence - last_sequence - 1U) & 0xFFU;
+            lost += gap;
+            if (gap) {
+                gsxWords = 0; // Part of the GSx frame may be gone
+            }
+        }
+        last_stamp = stamp;
+        last_sequence = sequence;
+        printFrame(decoder, cycles/PLLSYSCLK);
+    }
+    if (f != stdin) {
+        fclose(f);
+    }
+
+    printf("%lu bytes, %lu frames, %lu lost, %lu CRC errors, %lu framing errors\n", bytes,
+           (unsigned long)decoder.frames, lost, (unsigned long)decoder.crc_errors,
+           (unsigned long)decoder.framing_errors);
+    return 0;
+}
@@ -0,0 +1,116 @@
+/*
+ * sil_bench.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Software-in-the-loop benchmarks for the CPU1 current loop. Each result is checked against a limit
+ *  and the exit code is non-zero if any fail, so a control change which costs bandwidth, ripple or
+ *  cycles shows up in CI.
+ *
+ *  Each bench is in its own source/bench_x.cpp (sil_bench.h), and main() runs them in this order:
+ *  - current_step: iq step on the average inverter with the speed held, 10-90% rise time and overshoot
+ *  - ripple: steady state dq current ripple on the switching inverter with dead time and ADC noise
+ *  - sensorless: align, I/f startup and handover to the observer on a free running motor, then the
+ *    angle and speed error in closed loop
+ *  - isr: operation counts and estimated CLA cycles for one sample, and the host time per sample
+ *  - encoder: the encoder's M/T speed and angle interpolation (encoder_math.h) on a synthesised eQEP at
+ *    constant speeds both ways and at a count every 30 ms: the speed and angle errors against the capture
+ *    timer's resolution, and the angle predicted to the next sample
+ *  - pwm: HalfBridgePWM on the ePWM emulator for every PWMCountMode, exact duty cycle and dead time in
+ *    TBCLKs, no shoot-through, CMPA update latency and the duty cycle at the ends of the range
+ *  - pie: interrupt timing of the CPU1, CPU2 and ThreePhaseGen ISR mixes on the PIE simulator with the costs
+ *    in profiles/, worst case latency, jitter, overruns and CPU load, and that every cost was measured on the
+ *    target
+ *  - threephasegen: the ThreePhaseGen firmware (timer interrupt and ePWM setup) on the simulated HAL,
+ *    amplitude, phase and distortion of the average duty cycles over one period of the sinusoid
+ *  - ipc: the CPU1-CPU2 message ring with a producer and a consumer thread, every message received
+ *    once, in order and intact, plus the full and oversized cases
+ *  - frames: the double-buffered GSx frame handoff with CPU1 and CPU2 threads, every frame intact and
+ *    each buffer only touched by the core its master select gives it to
+ *  - motion: CPU2's speed and position control on the current loop through the reference handoff, a
+ *    trapezoidal move, a load step in speed mode and the handoff refusing to overwrite a latched slot
+ *  - boot: no switching or current loop samples until StartPwm(), then the three counters in step, and the
+ *    time to the first PWM edge with CPU2 released early against after CPU1's initialisation
+ *  - serial: the host link framing (COBS and CRC), every frame of a byte stream decoded intact, every
+ *    corrupted frame rejected with the next one still received, and the telemetry's share of the line
+ *  - scope: the live scope's registry mapped onto the simulation, invalid selections refused, every record
+ *    holding exactly the selected variables of its sample at the decimation, and its share of the line
+ *  - capture: triggered captures on the simulation (an edge at a current step, a level already true, a
+ *    fault mask and a forced trigger), each frame unrolled from its ring and checked record by record
+ *    around the trigger, and the time to stream the largest one
+ *  - command: the host command protocol with CPU2's parameter registry, each command and refusal once,
+ *    then fuzzed with random and damaged frames: parameters stay in range, every undamaged frame is
+ *    answered in order, no poll takes more than its byte budget, and a flood past the ring is counted
+ *  - params: live retuning through the double-buffered parameter sets. Halving the current bandwidth on
+ *    the simulation doubles the rise time from the sample after the commit, an editor thread committing
+ *    against the loop never leaves a sample with a torn set or the wrong version, and ThreePhaseGen
+ *    changes frequency without a step in its duty cycles
+ *  - snapshot: the sequence counts (seqlock.h) on the current loop with an angle writer thread and a
+ *    telemetry reader thread: no sample uses half of an angle write and no accepted copy mixes two samples
+ *  - can: CPU2's CAN port on a simulated DCAN and bus (can_sim.h). Other nodes' frames never interrupt,
+ *    each setpoint is applied by the first period after it (or after its SYNC), status frames report the
+ *    setpoint in use and are replaced rather than queued while the bus is flooded, and loopback works alone
+ *  - fsi: ThreePhaseGen's FSI port (fsi_link.h) against a controller on a simulated link (fsi_sim.h). Pings
+ *    measure the link delay and the generator's clock offset, timed references start at exactly the sample
+ *    they name, and damaged, refused, late and flooded references are each counted once
+ */
+
+#include "sil_bench.h"
+#include <stdio.h>
+#include <math.h>
+
+static int failures = 0;
+
+/* Prints a result and checks it against its limits */
+void report(const char *name, double value, double min, double max, const char *unit) {
+    bool pass = value >= min && value <= max;
+    if (!pass) {
+        failures++;
+    }
+    printf("%-34s %12.4g %-8s [%g, %g] %s\n", name, value, unit, min, max, pass ? "ok" : "FAIL");
+}
+
+double wrapRadians(double x) {
+    const double TWO_PI = 6.283185307179586;
+    return x - TWO_PI*floor(x/TWO_PI + 0.5);
+}
+
+/* Fourier coefficient of a signal at the given harmonic of its period */
+void fourier(const std::vector<double> &x, int harmonic, double *magnitude, double *phase) {
+    const double TWO_PI = 6.283185307179586;
+    double re = 0.0, im = 0.0;
+    for (size_t k = 0; k < x.size(); k++) {
+        double angle = TWO_PI*harmonic*k/x.size();
+        re += x[k]*cos(angle);
+        im += x[k]*sin(angle);
+    }
+    *magnitude = 2.0*sqrt(re*re + im*im)/x.size();
+    *phase = atan2(re, im); // Phase of a sine
+}
+
+int main() {
+    benchCurrentStep();
+    benchRipple();
+    benchSensorless();
+    benchIsr();
+    benchEncoder();
+    benchPwm();
+    benchPie();
+    benchThreePhaseGen();
+    benchIpc();
+    benchFrames();
+    benchMotion();
+    benchBoot();
+    benchSerial();
+    benchScope();
+    benchCapture();
+    benchCommand();
+    benchParams();
+    benchSnapshot();
+    benchCan();
+    benchFsi();
+
+    printf("%s: %d failed\n", failures ? "FAIL" : "PASS", failures);
+    return failures ? 1 : 0;
+}
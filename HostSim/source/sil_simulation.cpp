@@ -0,0 +1,151 @@
+/*
+ * sil_simulation.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ */
+
+#include "sil_simulation.h"
+#include "pwm.h"
+#include "adcs.h"
+#include <math.h>
+
+#define SIM_SWITCH_DROP_V 0.0 // Ideal switches
+
+static const double TWO_PI = 6.283185307179586;
+
+void SimStatistics::reset() {
+    sum = 0.0;
+    sum_sq = 0.0;
+    min_value = 1e300;
+    max_value = -1e300;
+    n = 0;
+}
+
+void SimStatistics::add(double x) {
+    sum += x;
+    sum_sq += x*x;
+    if (x < min_value) {
+        min_value = x;
+    }
+    if (x > max_value) {
+        max_value = x;
+    }
+    n++;
+}
+
+double SimStatistics::rmsDeviation() const {
+    if (n == 0) {
+        return 0.0;
+    }
+    double m = mean();
+    double variance = sum_sq/n - m*m;
+    return variance > 0.0 ? sqrt(variance) : 0.0;
+}
+
+PmsmParameters SIM_defaultMotor() {
+    PmsmParameters p;
+    p.Rs = MOTOR_RS;
+    p.Ld = MOTOR_LD;
+    p.Lq = MOTOR_LQ;
+    p.flux = MOTOR_FLUX;
+    p.pole_pairs = MOTOR_POLE_PAIRS;
+    p.J = 5e-6; // Small motor with a light coupling
+    p.B = 1e-6;
+    return p;
+}
+
+/* Configures the peripherals with the firmware's drivers and sets up the control state with what
+ * ConfigCla() and CLA Task 8 use (foc.h) */
+SilSimulation::SilSimulation(const PmsmParameters &motor_params, InverterMode mode, double vdc, double adc_noise_lsb) :
+        inverter(mode, vdc, SIM_SWITCH_DROP_V),
+        adc(adc_noise_lsb, 1),
+        motor(motor_params) {
+    simPeripherals.reset();
+    ConfigPwm();
+    StartPwm();
+    ConfigAdcs();
+
+    for (int k = 0; k < 3; k++) {
+        legs[k] = &simPeripherals.epwm[EPWM1 + k];
+    }
+    time = 0.0;
+    dt = 1.0/legs[0]->getTbclkHz(PLLSYSCLK);
+
+    // ConfigCla() and CLA Task 8
+    FOC_initLoopParams(&params, phaseA->getTimerTop());
+    phaseA->configAdcTrigger(PWM_FREQUENCY_HZ/FOC_SAMPLING_FREQUENCY);
+    FOC_initLoopState(&loop, &observer, &telemetry);
+
+    // The loop holds 50% until enabled
+    phaseA->setDutyCycle(0.5f);
+    phaseB->setDutyCycle(0.5f);
+    phaseC->setDutyCycle(0.5f);
+}
+
+/* One TBCLK of the plant */
+void SilSimulation::tick() {
+    double i[3], v_leg[3];
+    motor.getPhaseCurrents(i);
+    inverter.getLegVoltages(legs, i, v_leg);
+    motor.step(v_leg, dt);
+    time += dt;
+
+    id_stats.add(motor.getId());
+    iq_stats.add(motor.getIq());
+
+    if (!simPeripherals.tbclk_sync) {
+        return; // Time base clocks not running
+    }
+    legs[1]->tick();
+    legs[2]->tick();
+    if (legs[0]->tick()) { // EPWM1 SOCA
+        // Analogue front end (adc_channels.h)
+        SimAdc &adc_a = simPeripherals.adc[HAL_ADC_A];
+        SimAdc &adc_b = simPeripherals.adc[HAL_ADC_B];
+        motor.getPhaseCurrents(i);
+        adc_a.pin_voltage[PHASE_A_CURRENT_CHANNEL] = CURRENT_SENSE_OFFSET_V + i[0]/CURRENT_SENSE_A_PER_V;
+        adc_b.pin_voltage[PHASE_B_CURRENT_CHANNEL] = CURRENT_SENSE_OFFSET_V + i[1]/CURRENT_SENSE_A_PER_V;
+        adc_a.pin_voltage[VDC_CHANNEL] = inverter.getVdc()/VDC_SENSE_DIVIDER;
+
+        adc_b.trigger(HAL_ADC_TRIGGER_EPWM1_SOCA, adc);
+        if (adc_a.trigger(HAL_ADC_TRIGGER_EPWM1_SOCA, adc)) { // ADCA INT1
+            currentLoopSample();
+        }
+    }
+}
+
+/* What CLA Task 1 (or focAdcISR()) does at ADCA INT1 */
+void SilSimulation::currentLoopSample() {
+    uint16_t adc_ia = SimHal::readAdcResult(HAL_ADC_A, PHASE_A_CURRENT_SOC);
+    uint16_t adc_ib = SimHal::readAdcResult(HAL_ADC_B, PHASE_B_CURRENT_SOC);
+    uint16_t adc_vdc = SimHal::readAdcResult(HAL_ADC_A, VDC_SOC);
+
+    if (!params.sensorless) {
+        // Ideal encoder, as if the C28x had called FOC_setRotorAngle() for this sampling instant
+        CLA_setRotorAngle(&params, (float)(motor.getThetaElectrical()/TWO_PI), (float)motor.getOmegaElectrical());
+    }
+
+    uint16_t cmp[3];
+    CLA_runCurrentLoopSample(&loop, &observer, &params, adc_ia, adc_ib, adc_vdc, cmp, &telemetry);
+
+    setPhaseCompares(cmp[0], cmp[1], cmp[2]);
+}
+
+void SilSimulation::runSample() {
+    uint32_t count = telemetry.sample_count;
+    while (telemetry.sample_count == count) {
+        tick();
+    }
+}
+
+void SilSimulation::run(double duration_s) {
+    double end = time + duration_s;
+    while (time < end) {
+        tick();
+    }
+}
+
+double SilSimulation::getSamplePeriod() const {
+    return legs[0]->getPeriodCounts()*(PWM_FREQUENCY_HZ/FOC_SAMPLING_FREQUENCY)*dt;
+}
@@ -0,0 +1,293 @@
+/*
+ * sim_peripherals.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ */
+
+#include "sim_peripherals.h"
+
+SimPeripherals simPeripherals;
+
+void SimPeripherals::reset() {
+    for (int k = 0; k < SIM_EPWM_MODULES; k++) {
+        epwm[k].reset();
+    }
+    for (int k = 0; k < SIM_CPU_TIMERS; k++) {
+        timer[k].reset();
+    }
+    for (int k = 0; k < SIM_ADC_MODULES; k++) {
+        adc[k].reset();
+    }
+    tbclk_sync = false;
+    pie_acks = 0;
+    can = 0;
+    fsi = 0;
+}
+
+/*** ePWM ***/
+
+// Action qualifier events from highest to lowest priority (TRM, "Action-Qualifier Event Priority")
+static const uint16_t UP_COUNT_PRIORITY[] = {SIM_AQ_PERIOD, SIM_AQ_UP_CMPA, SIM_AQ_ZERO};
+static const uint16_t DOWN_COUNT_PRIORITY[] = {SIM_AQ_ZERO, SIM_AQ_DOWN_CMPA, SIM_AQ_PERIOD};
+static const uint16_t UP_DOWN_INCREMENTING_PRIORITY[] = {SIM_AQ_UP_CMPA, SIM_AQ_ZERO, SIM_AQ_DOWN_CMPA};
+static const uint16_t UP_DOWN_DECREMENTING_PRIORITY[] = {SIM_AQ_DOWN_CMPA, SIM_AQ_PERIOD, SIM_AQ_UP_CMPA};
+
+void SimEpwm::reset() {
+    counter = 0;
+    counting_up = true;
+    cmpa_active = 0;
+    aq_a = false;
+    aq_b = false;
+    edge_age = 0xFFFF;
+    output_a = false;
+    output_b = false;
+    soc_events = 0;
+    ticks = 0;
+    load_tick = 0;
+
+    enabled = false;
+    outputs = 0;
+    clock_divider = 0;
+    hs_clock_divider = 1; // Reset value of HSPCLKDIV is /2
+    period = 0;
+    counter_mode = 3; // Stop-freeze
+    aq_actions_a = 0;
+    aq_actions_b = 0;
+    cmpa = 0;
+    cmpa_immediate = false;
+    cmpa_load_mode = SIM_CMPA_LOAD_ZERO;
+    db_half_cycle = false;
+    db_polarity = 0;
+    db_output_mode = 0;
+    db_rising = 0;
+    db_falling = 0;
+    soca_enabled = false;
+    soca_source = 0;
+    soca_prescale = 1;
+    compare_writes = 0;
+}
+
+void SimEpwm::writeCompareA(uint16_t value) {
+    cmpa = value;
+    if (cmpa_immediate) {
+        cmpa_active = value;
+    }
+    compare_writes++;
+}
+
+double SimEpwm::getTbclkHz(double sysclk_Hz) const {
+    double divider = (double)(1 << clock_divider);
+    if (hs_clock_divider > 0) {
+        divider *= 2.0*hs_clock_divider;
+    }
+    return sysclk_Hz/divider; // EPWMCLK = SYSCLK on this configuration (EPWMCLKDIV = /1)
+}
+
+/* Dead band delay in TBCLKs. Half cycle clocking counts at 2*TBCLK, which the emulator rounds up to
+ * whole TBCLKs. */
+uint16_t SimEpwm::delayTicks(uint16_t count) const {
+    return db_half_cycle ? (count + 1)/2 : count;
+}
+
+uint16_t SimEpwm::risingDelay() const {
+    return (db_output_mode & 0x2) ? delayTicks(db_rising) : 0;
+}
+
+uint16_t SimEpwm::fallingDelay() const {
+    return (db_output_mode & 0x1) ? delayTicks(db_falling) : 0;
+}
+
+uint32_t SimEpwm::getPeriodCounts() const {
+    return counter_mode == 2 ? 2*(uint32_t)period : (uint32_t)period + 1;
+}
+
+double SimEpwm::getDutyCycle() const {
+    double high_counts = counter_mode == 2 ? 2.0*cmpa_active : (double)cmpa_active;
+    double duty = high_counts/getPeriodCounts();
+    return duty > 1.0 ? 1.0 : duty;
+}
+
+/* Applies the highest priority event which has an action (1 = clear, 2 = set, 3 = toggle) */
+bool SimEpwm::applyAction(bool output, uint16_t aqctl, const uint16_t *events, int n_events, bool zero, bool top,
+                          bool cmpa_up, bool cmpa_down) const {
+    for (int k = 0; k < n_events; k++) {
+        uint16_t event = events[k];
+        bool occurred = (event == SIM_AQ_ZERO && zero) || (event == SIM_AQ_PERIOD && top)
+                        || (event == SIM_AQ_UP_CMPA && cmpa_up) || (event == SIM_AQ_DOWN_CMPA && cmpa_down);
+        uint16_t action = (aqctl >> event) & 0x3;
+        if (occurred && action != 0) {
+            return action == 3 ? !output : action == 2;
+        }
+    }
+    return output;
+}
+
+bool SimEpwm::tick() {
+    bool zero = false;
+    bool top = false;
+
+    switch (counter_mode) {
+    case 0: // Up
+        if (counter >= period) {
+            counter = 0;
+        }
+        else {
+            counter++;
+        }
+        break;
+
+    case 1: // Down
+        if (counter == 0) {
+            counter = period;
+        }
+        else {
+            counter--;
+        }
+        break;
+
+    case 2: // Up-down. Counting down from the period, up from zero.
+        if (counting_up) {
+            counter++;
+            if (counter >= period) {
+                counting_up = false;
+            }
+        }
+        else {
+            counter--;
+            if (counter == 0) {
+                counting_up = true;
+            }
+        }
+        break;
+
+    default: // Stopped
+        return false;
+    }
+    ticks++;
+    zero = counter == 0;
+    top = counter == period;
+
+    // Shadow to active CMPA load, before the compare so the new value applies from this TBCLK
+    if (!cmpa_immediate && ((zero && cmpa_load_mode != SIM_CMPA_LOAD_PERIOD)
+                            || (top && cmpa_load_mode != SIM_CMPA_LOAD_ZERO))) {
+        cmpa_active = cmpa;
+        load_tick = ticks;
+    }
+
+    // Action qualifier
+    bool incrementing = counter_mode == 0 || (counter_mode == 2 && counting_up);
+    bool cmpa_match = counter == cmpa_active;
+    const uint16_t *priority;
+    if (counter_mode == 0) {
+        priority = UP_COUNT_PRIORITY;
+    }
+    else if (counter_mode == 1) {
+        priority = DOWN_COUNT_PRIORITY;
+    }
+    else {
+        priority = incrementing ? UP_DOWN_INCREMENTING_PRIORITY : UP_DOWN_DECREMENTING_PRIORITY;
+    }
+    bool previous_a = aq_a;
+    aq_a = applyAction(aq_a, aq_actions_a, priority, 3, zero, top, cmpa_match && incrementing, cmpa_match && !incrementing);
+    aq_b = applyAction(aq_b, aq_actions_b, priority, 3, zero, top, cmpa_match && incrementing, cmpa_match && !incrementing);
+
+    // Dead band, with EPWMxA as the source of both delays (DBCTL.IN_MODE = 0)
+    if (aq_a != previous_a) {
+        edge_age = 0;
+    }
+    else if (edge_age < 0xFFFF) {
+        edge_age++;
+    }
+    bool red = aq_a && edge_age >= delayTicks(db_rising); // Rising edge delayed
+    bool fed = aq_a || edge_age < delayTicks(db_falling); // Falling edge delayed
+    if (db_polarity & 0x1) {
+        red = !red;
+    }
+    if (db_polarity & 0x2) {
+        fed = !fed;
+    }
+    output_a = (db_output_mode & 0x2) ? red : aq_a;
+    output_b = (db_output_mode & 0x1) ? fed : aq_b;
+
+    bool soc = false;
+    if (soca_enabled && ((soca_source == 1 && zero) || (soca_source == 2 && top))) {
+        if (++soc_events >= soca_prescale) {
+            soc_events = 0;
+            soc = true;
+        }
+    }
+    return soc;
+}
+
+/*** CPU timer ***/
+
+void SimCpuTimer::reset() {
+    counter = 0xFFFFFFFF;
+    prescale_counter = 0;
+    period = 0xFFFFFFFF;
+    divider = 1;
+    running = false;
+    handler = 0;
+    interrupts = 0;
+}
+
+void SimCpuTimer::start() {
+    counter = period;
+    prescale_counter = 0;
+    running = true;
+}
+
+bool SimCpuTimer::tick() {
+    if (!running) {
+        return false;
+    }
+    if (++prescale_counter < divider) {
+        return false;
+    }
+    prescale_counter = 0;
+
+    if (counter == 0) {
+        counter = period;
+        interrupts++;
+        if (handler) {
+            handler();
+        }
+        return true;
+    }
+    counter--;
+    return false;
+}
+
+/*** ADC ***/
+
+void SimAdc::reset() {
+    powered = false;
+    for (int k = 0; k < SIM_ADC_SOCS; k++) {
+        soc_trigger[k] = 0; // Software only
+        soc_channel[k] = 0;
+        soc_window[k] = 0;
+        results[k] = 0;
+    }
+    for (int k = 0; k < SIM_ADC_CHANNELS; k++) {
+        pin_voltage[k] = 0.0;
+    }
+    int1_enabled = false;
+    int1_soc = 0;
+}
+
+bool SimAdc::trigger(uint16_t trigger_source, AdcModel &model) {
+    bool int1 = false;
+    if (!powered) {
+        return false;
+    }
+    for (int k = 0; k < SIM_ADC_SOCS; k++) {
+        if (soc_trigger[k] == trigger_source && trigger_source != 0) {
+            results[k] = model.convert(pin_voltage[soc_channel[k]]);
+            if (int1_enabled && int1_soc == k) {
+                int1 = true;
+            }
+        }
+    }
+    return int1;
+}
@@ -0,0 +1,299 @@
+#!/usr/bin/env python3
+#
+# tablegen.py
+#
+#  Created on: 18 Oct 2026
+#      Author: Charley Shi
+#
+#  Generates lookup tables as const C arrays, so the firmware does no table maths at boot.
+#
+#  Usage: tablegen.py SPEC.json [--check]
+#  Writes the header and source named in the spec, next to the spec. With --check nothing is written,
+#  and the exit code is 1 if the files on disk don't match what the spec generates.
+#
+#  Spec (JSON):
+#  {
+#    "header": "name.h", "source": "name.c",   # Output files, relative to the spec
+#    "include": "name.h",                       # How the source includes the header (default: header)
+#    "guard": "NAME_H_",                        # Include guard
+#    "description": "...",                      # Copied into the header comment
+#    "tables": [ { ... }, ... ]
+#  }
+#
+#  Table fields:
+#    name        C symbol of the array
+#    macro       Prefix of the generated macros (default: name in upper case)
+#    kind        "sine", "cosine", "function" or "function2d"
+#    type        "float", "q15" (int16_t, 1.0 = 32768), "int16" or "uint16" (e.g. compare counts).
+#                Integer types are rounded to nearest and saturated.
+#    size        1-D: entries per period (sine, cosine) or over [start, stop) (function)
+#    offset, amplitude, phase   sine/cosine: offset + amplitude*sin(2*pi*(i/size + phase))
+#    expr        function: Python expression of x (math functions available without "math.")
+#    start, stop function: range of x. stop is excluded unless "endpoint" is true.
+#    x, y        function2d: {"start", "stop", "points"} for each axis, both ends included. expr uses x and y,
+#                and the array is [x points][y points].
+#    extra       1-D periodic: entries appended past the end of the period (wrapping), e.g. a quarter period
+#                for reading the cosine from a sine table plus one for interpolation
+#    symmetry    1-D periodic: "full" (default), "half" (stores half a period, f(x + 1/2) = 2*offset - f(x))
+#                or "quarter" (stores a quarter period plus one, also f(1/2 - x) = f(x)). Generates
+#                <name>_lookup(i) to rebuild any entry. The stored values are checked against the full table.
+#    section     Linker section for the array (TI compiler DATA_SECTION), e.g. a RAM section. Default .const.
+#    defines     Extra macros as {"SUFFIX": value}, emitted as <macro>_SUFFIX
+#    description Comment on the array
+
+import json
+import math
+import os
+import sys
+
+TYPES = {
+    # C type, minimum, maximum, scale from the real value
+    "float": ("float", None, None, 1.0),
+    "q15": ("int16_t", -32768, 32767, 32768.0),
+    "int16": ("int16_t", -32768, 32767, 1.0),
+    "uint16": ("uint16_t", 0, 65535, 1.0),
+}
+
+MATH_NAMES = {k: getattr(math, k) for k in dir(math) if not k.startswith("_")}
+
+
+def fail(message):
+    sys.stderr.write("tablegen: " + message + "\n")
+    sys.exit(2)
+
+
+def convert(value, ctype):
+    """Real value to the stored value of the type"""
+    name, low, high, scale = TYPES[ctype]
+    if low is None:
+        return float(value)
+    v = int(math.floor(value * scale + 0.5))
+    return max(low, min(high, v))
+
+
+def literal(value, ctype):
+    if ctype != "float":
+        return str(value)
+    text = format(value, ".9g")
+    if "." not in text and "e" not in text and "n" not in text:
+        text += ".0"
+    return text + "f"
+
+
+def periodic_values(t, count):
+    """Real values of a periodic 1-D table for indices 0 to count - 1"""
+    kind = t["kind"]
+    size = t["size"]
+    if kind in ("sine", "cosine"):
+        f = math.sin if kind == "sine" else math.cos
+        offset = t.get("offset", 0.0)
+        amplitude = t.get("amplitude", 1.0)
+        phase = t.get("phase", 0.0)
+        return [offset + amplitude * f(2.0 * math.pi * (i / size + phase)) for i in range(count)]
+    start = t.get("start", 0.0)
+    stop = t.get("stop", 1.0)
+    step = (stop - start) / (size - 1 if t.get("endpoint", False) else size)
+    return [evaluate(t["expr"], x=start + i * step) for i in range(count)]
+
+
+def evaluate(expr, **variables):
+    names = dict(MATH_NAMES)
+    names.update(variables)
+    return float(eval(expr, {"__builtins__": {}}, names))
+
+
+def axis(a):
+    if a["points"] < 2:
+        fail("an axis needs at least 2 points")
+    step = (a["stop"] - a["start"]) / (a["points"] - 1)
+    return [a["start"] + i * step for i in range(a["points"])], step
+
+
+class Table:
+    def __init__(self, t):
+        for key in ("name", "kind", "type"):
+            if key not in t:
+                fail("table is missing '%s'" % key)
+        if t["type"] not in TYPES:
+            fail("%s: unknown type %s" % (t["name"], t["type"]))
+        self.t = t
+        self.name = t["name"]
+        self.macro = t.get("macro", self.name.upper())
+        self.ctype = t["type"]
+        self.symmetry = t.get("symmetry", "full")
+        self.lines = []  # Header lines after the declaration
+
+        if t["kind"] == "function2d":
+            self.build2d()
+        elif t["kind"] in ("sine", "cosine", "function"):
+            self.build1d()
+        else:
+            fail("%s: unknown kind %s" % (self.name, t["kind"]))
+
+    def build1d(self):
+        t = self.t
+        size = t["size"]
+        extra = t.get("extra", 0)
+        full = [convert(v, self.ctype) for v in periodic_values(t, size + extra)]
+        self.defines = [("SIZE", size)]
+
+        if self.symmetry == "full":
+            self.values = full
+            self.dims = [len(full)]
+            self.defines.append(("LENGTH", len(full)))
+            return
+
+        if extra:
+            fail("%s: 'extra' needs full symmetry" % self.name)
+        if self.symmetry == "half":
+            if size % 2:
+                fail("%s: half symmetry needs an even size" % self.name)
+            stored = size // 2
+        elif self.symmetry == "quarter":
+            if size % 4:
+                fail("%s: quarter symmetry needs a size divisible by 4" % self.name)
+            stored = size // 4 + 1
+        else:
+            fail("%s: unknown symmetry %s" % (self.name, self.symmetry))
+
+        self.values = full[:stored]
+        self.dims = [stored]
+        self.defines.append(("LENGTH", stored))
+        center = t.get("offset", 0.0)
+        if self.ctype != "float":
+            center = convert(center, self.ctype)
+
+        # Check that rebuilding from the stored part gives the full table (to 1 LSB for integer types)
+        tolerance = 1 if self.ctype != "float" else 1e-6 * max(1.0, max(abs(v) for v in full))
+        for i in range(size):
+            if abs(self.rebuild(i, size, center) - full[i]) > tolerance:
+                fail("%s: the function doesn't have %s wave symmetry about %s (index %d)"
+                     % (self.name, self.symmetry, center, i))
+
+        ctype = TYPES[self.ctype][0]
+        half = size // 2
+        c = literal(2 * center, self.ctype) if self.ctype == "float" else str(2 * center)
+        self.lines += [
+            "/* Entry i (0 to %s_SIZE - 1) of the full period */" % self.macro,
+            "static inline %s %s_lookup(uint16_t i) {" % (ctype, self.name),
+            "    uint16_t j = i < %d ? i : i - %d; // Position in the half period" % (half, half),
+        ]
+        if self.symmetry == "quarter":
+            self.lines.append("    %s v = j <= %d ? %s[j] : %s[%d - j];" % (ctype, size // 4, self.name, self.name, half))
+        else:
+            self.lines.append("    %s v = %s[j];" % (ctype, self.name))
+        self.lines += [
+            "    return i < %d ? v : (%s)(%s - v);" % (half, ctype, c),
+            "}",
+        ]
+
+    def rebuild(self, i, size, center):
+        half = size // 2
+        j = i if i < half else i - half
+        if self.symmetry == "quarter" and j > size // 4:
+            j = half - j
+        v = self.values[j]
+        return v if i < half else 2 * center - v
+
+    def build2d(self):
+        t = self.t
+        xs, x_step = axis(t["x"])
+        ys, y_step = axis(t["y"])
+        self.values = [convert(evaluate(t["expr"], x=x, y=y), self.ctype) for x in xs for y in ys]
+        self.dims = [len(xs), len(ys)]
+        self.defines = [("X_POINTS", len(xs)), ("Y_POINTS", len(ys)),
+                        ("X_START", float(t["x"]["start"])), ("X_STEP", x_step),
+                        ("Y_START", float(t["y"]["start"])), ("Y_STEP", y_step)]
+
+    def declaration(self):
+        dims = "".join("[%d]" % d for d in self.dims)
+        return "%s %s%s" % (TYPES[self.ctype][0], self.name, dims)
+
+    def header(self):
+        out = []
+        if "description" in self.t:
+            out.append("/* %s */" % self.t["description"])
+        for suffix, value in self.defines + sorted(self.t.get("defines", {}).items()):
+            text = literal(value, "float") if isinstance(value, float) else str(value)
+            out.append("#define %s_%s %s" % (self.macro, suffix, text))
+        out.append("extern const %s;" % self.declaration())
+        out += self.lines
+        return out
+
+    def source(self):
+        out = []
+        if self.t.get("section"):
+            out += ["#ifdef __TI_COMPILER_VERSION__",
+                    '#pragma DATA_SECTION(%s, "%s")' % (self.name, self.t["section"]),
+                    "#endif"]
+        out.append("const %s = {" % self.declaration())
+        text = [literal(v, self.ctype) for v in self.values]
+        row = self.dims[-1] if len(self.dims) == 2 else 8
+        for k in range(0, len(text), row):
+            chunk = text[k:k + row]
+            if len(self.dims) == 2:
+                out.append("    {" + ", ".join(chunk) + "},")
+            else:
+                out.append("    " + ", ".join(chunk) + ",")
+        out.append("};")
+        return out
+
+
+def generate(spec, spec_name):
+    tables = [Table(t) for t in spec["tables"]]
+    guard = spec["guard"]
+
+    def banner(path):
+        lines = ["/*", " * " + os.path.basename(path), " *",
+                 " *  Generated by TableGen/tablegen.py from %s. Don't edit: change the spec and regenerate." % spec_name]
+        if "description" in spec:
+            lines += [" *", " *  " + spec["description"]]
+        return lines + [" */"]
+
+    h = banner(spec["header"])
+    h += ["", "#ifndef " + guard, "#define " + guard, "", "#include <stdint.h>", "",
+          "#ifdef __cplusplus", 'extern "C" {', "#endif", ""]
+    for t in tables:
+        h += t.header() + [""]
+    h += ["#ifdef __cplusplus", "}", "#endif", "", "#endif /* %s */" % guard, ""]
+
+    c = banner(spec["source"])
+    c += ["", '#include "%s"' % spec.get("include", spec["header"]), ""]
+    for t in tables:
+        c += t.source() + [""]
+    return "\n".join(h), "\n".join(c)
+
+
+def main(argv):
+    if len(argv) < 2 or len(argv) > 3 or (len(argv) == 3 and argv[2] != "--check"):
+        sys.stderr.write("Usage: tablegen.py SPEC.json [--check]\n")
+        return 2
+    spec_path = argv[1]
+    with open(spec_path) as f:
+        spec = json.load(f)
+    folder = os.path.dirname(spec_path)
+    header, source = generate(spec, os.path.basename(spec_path))
+    outputs = [(os.path.join(folder, spec["header"]), header), (os.path.join(folder, spec["source"]), source)]
+
+    if len(argv) == 3:
+        stale = []
+        for path, text in outputs:
+            try:
+                with open(path) as f:
+                    if f.read() != text:
+                        stale.append(path)
+            except IOError:
+                stale.append(path)
+        for path in stale:
+            sys.stderr.write("tablegen: %s is out of date with %s\n" % (path, spec_path))
+        return 1 if stale else 0
+
+    for path, text in outputs:
+        with open(path, "w") as f:
+            f.write(text)
+        print("Wrote " + path)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,46 @@
+/*
+ * fsi_hal.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Thin hardware abstraction for the FSI port, so fsi_port.c also builds with gcc on a host PC and runs in
+ *  the HostSim bench "fsi" as it is. As in hal.h, the backend is chosen at compile time:
+ *  - fsi_hal_registers.h: driverlib calls and register reads. The default.
+ *  - HostSim/include/hal_sim.h: the simulated link (fsi_sim.h). Selected by defining HAL_SIMULATED, which
+ *    only the host build does.
+ *
+ *  The ring, the ping timing and which frame to send are up to fsi_port.c. The functions here are the
+ *  FSI and DMA set up, the event flags, the ping watchdog and the transmit buffer.
+ *
+ *  The constants are the register field encodings from the TRM (the same values as driverlib's).
+ */
+
+#ifndef FSI_HAL_H_
+#define FSI_HAL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Base addresses, the same for the real and simulated modules
+#define HAL_FSITXA_BASE 0x00006600U
+#define HAL_FSIRXA_BASE 0x00006680U
+#define HAL_DMA_CH1_BASE 0x00001020U
+
+// RX_EVT_STS
+#define HAL_FSI_RX_EVT_CRC_ERR 0x0004U
+#define HAL_FSI_RX_EVT_TYPE_ERR 0x0008U
+#define HAL_FSI_RX_EVT_EOF_ERR 0x0010U
+#define HAL_FSI_RX_EVT_ERR_FRAME 0x0100U
+#define HAL_FSI_RX_EVT_PING_FRAME 0x0200U
+
+// TX_EVT_STS
+#define HAL_FSI_TX_EVT_FRAME_DONE 0x0001U
+
+#if defined(HAL_SIMULATED)
+#include "hal_sim.h"
+#else
+#include "fsi_hal_registers.h"
+#endif
+
+#endif /* FSI_HAL_H_ */
@@ -0,0 +1,96 @@
+/*
+ * fsi_hal_registers.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Register backend of the FSI HAL (see fsi_hal.h). The calls and register reads fsi_port.c used to make
+ *  itself, so the target build is unchanged.
+ */
+
+#ifndef FSI_HAL_REGISTERS_H_
+#define FSI_HAL_REGISTERS_H_
+
+#include <driverlib.h>
+
+/* Clocks, pins (fsi_port.h) and one lane each way with frames of frame_words words. TXCLK is PLLRAWCLK
+ * over prescaler. The ping watchdog only runs for its counter. */
+static inline void HAL_initFsi(uint32_t tx_base, uint32_t rx_base, uint16_t prescaler, uint16_t frame_words) {
+    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_FSITXA);
+    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_FSIRXA);
+    GPIO_setPinConfig(GPIO_27_FSITXA_CLK);
+    GPIO_setPinConfig(GPIO_26_FSITXA_D0);
+    GPIO_setPinConfig(GPIO_13_FSIRXA_CLK);
+    GPIO_setPinConfig(GPIO_12_FSIRXA_D0);
+    GPIO_setQualificationMode(13, GPIO_QUAL_ASYNC);
+    GPIO_setQualificationMode(12, GPIO_QUAL_ASYNC);
+
+    FSI_performTxInitialization(tx_base, prescaler);
+    FSI_setTxDataWidth(tx_base, FSI_DATA_WIDTH_1_LANE);
+    FSI_setTxStartMode(tx_base, FSI_TX_START_FRAME_CTRL);
+    FSI_setTxFrameType(tx_base, FSI_FRAME_TYPE_NWORD_DATA);
+    FSI_setTxSoftwareFrameSize(tx_base, frame_words);
+
+    FSI_performRxInitialization(rx_base);
+    FSI_setRxDataWidth(rx_base, FSI_DATA_WIDTH_1_LANE);
+    FSI_setRxSoftwareFrameSize(rx_base, frame_words);
+    FSI_setRxBufferPtr(rx_base, 0);
+    FSI_enableRxPingWatchdog(rx_base, 0xFFFFFFFFUL); // 171 s between pings at 25 MHz
+}
+
+/* The receiver's DMA trigger at the end of each good data frame, and dma_base copying each into the next
+ * slot of ring (frames slots of frame_words): one frame a burst, the source back to the start of the
+ * receive buffer every two, round the ring for ever */
+static inline void HAL_startFsiRxDma(uint32_t dma_base, uint32_t rx_base, volatile uint16_t *ring, uint16_t frames,
+                                     uint16_t frame_words) {
+    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_DMA);
+    FSI_enableRxDMAEvent(rx_base);
+    DMA_initController();
+    DMA_setEmulationMode(DMA_EMULATION_FREE_RUN);
+    DMA_configAddresses(dma_base, ring, (const void *)FSI_getRxBufferAddress(rx_base));
+    DMA_configBurst(dma_base, frame_words, 1, 1);
+    DMA_configTransfer(dma_base, frames, 1, 1);
+    DMA_configWrap(dma_base, 2, 0, 0x10000UL, 0); // The destination only wraps at the end of the transfer
+    DMA_configMode(dma_base, DMA_TRIGGER_FSIRXA, DMA_CFG_ONESHOT_DISABLE | DMA_CFG_CONTINUOUS_ENABLE | DMA_CFG_SIZE_16BIT);
+    DMA_enableTrigger(dma_base);
+    DMA_startChannel(dma_base);
+}
+
+/* Words from the start of ring to the DMA's active destination address */
+static inline uint32_t HAL_getDmaDestinationOffset(uint32_t dma_base, const volatile uint16_t *ring) {
+    return HWREG(dma_base + DMA_O_DST_ADDR_ACTIVE) - (uint32_t)ring;
+}
+
+static inline uint16_t HAL_getFsiRxEvents(uint32_t rx_base) {
+    return FSI_getRxEventStatus(rx_base);
+}
+
+static inline void HAL_clearFsiRxEvents(uint32_t rx_base, uint16_t events) {
+    FSI_clearRxEvents(rx_base, events);
+}
+
+/* The ping watchdog's counter: SYSCLK cycles since the last ping frame */
+static inline uint32_t HAL_getFsiPingAge(uint32_t rx_base) {
+    return FSI_getRxPingWatchdogCounter(rx_base);
+}
+
+static inline uint16_t HAL_getFsiPingTag(uint32_t rx_base) {
+    return (uint16_t)FSI_getRxPingTag(rx_base);
+}
+
+static inline uint16_t HAL_getFsiTxEvents(uint32_t tx_base) {
+    return FSI_getTxEventStatus(tx_base);
+}
+
+static inline void HAL_clearFsiTxEvents(uint32_t tx_base, uint16_t events) {
+    FSI_clearTxEvents(tx_base, events);
+}
+
+/* Copies a frame into the transmit buffer from its start and sends it */
+static inline void HAL_sendFsiFrame(uint32_t tx_base, const uint16_t *words, uint16_t count) {
+    FSI_setTxBufferPtr(tx_base, 0);
+    FSI_writeTxBuffer(tx_base, words, count, 0);
+    FSI_startTxTransmit(tx_base);
+}
+
+#endif /* FSI_HAL_REGISTERS_H_ */
@@ -0,0 +1,406 @@
+/*
+ * fsi_link.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  The FSI link between a controller and the generator (fsi_port.h): waveform references in, status and
+ *  ping replies out, on one lane each way.
+ *
+ *  Data frames are always FSIL_FRAME_WORDS 16-bit words, with the kind and an 8-bit count in word 0. The
+ *  FSI checks its own CRC, so a frame that arrives is intact, and a damaged one never reaches the ring and
+ *  shows as a gap in the counts.
+ *
+ *  - FSIL_KIND_REFERENCE (controller to generator): a sequence number, the frequency, and the sample to
+ *    apply it from. The generator counts samples from start up (tpgSample in threephasegen.h), and the
+ *    controller works out which sample is due at a time on its own clock with FSIL_sampleAt().
+ *  - FSIL_KIND_STATUS (generator to controller): the sequence number and frequency of the reference in
+ *    use, and the last sample with its timestamp, which is what FSIL_sampleAt() counts from.
+ *  - FSIL_KIND_PING_REPLY (generator to controller): the answer to one of the controller's FSI ping
+ *    frames. A ping frame carries only its 4-bit tag, which the reply echoes with the generator's
+ *    timestamps for the ping's arrival and for the reply's start. The controller takes the time the
+ *    generator held the ping out of the round trip to get the link delay, and works out the offset of the
+ *    generator's clock from its own as NTP does.
+ *
+ *  Times are in generator ticks, SYSCLK cycles (FSIL_TICK_HZ). The controller passes its own times in the
+ *  same unit: only the offset between the clocks is measured, not their rates.
+ *
+ *  The receiving side is laid out for DMA: each data frame is copied into the next slot of a ring without
+ *  the CPU, and the background decodes the slots up to the one the DMA is writing (FSIL_receive()). There's
+ *  no count to say the DMA has gone round the ring past slots not yet read, but the references' sequence
+ *  numbers do: frames it overwrote are counted lost, as are those damaged on the line.
+ *
+ *  Decoded references queue for the generator, which takes the oldest whenever its parameter sets have a
+ *  free slot (FSIL_nextReference() and FSIL_referenceTaken()), so a reference for a later sample doesn't
+ *  hold up the link, only the references behind it.
+ *
+ *  Portable C, tested on the host with a loopback stand-in for the link (HostSim bench "fsi").
+ */
+
+#ifndef FSI_LINK_H_
+#define FSI_LINK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FSIL_FRAME_WORDS 8 // Two frames fill the FSI's 16-word receive buffer
+#define FSIL_RX_RING_FRAMES 16 // Power of two. At least 56 us of frames back to back at 50 Mbit/s.
+#define FSIL_REFERENCE_QUEUE 4 // Power of two
+#define FSIL_PING_TAGS 16 // An FSI frame tag is 4 bits
+
+#define FSIL_TICK_HZ 25000000UL // PLLSYSCLK in ThreePhaseGen/system_config/clock_config.h
+#define FSIL_TICKS_PER_SAMPLE 500 // PLLSYSCLK/SAMPLING_FREQUENCY in threephasegen.h
+#define FSIL_MAX_FREQUENCY 1000 // MAX_SINUSOID_FREQUENCY in threephasegen.h (Hz)
+#define FSIL_MAX_LEAD 50000UL // Samples ahead a reference can be for: 1 s
+
+/* Word 0: kind in the high byte, sequence number or ping tag in the low byte */
+#define FSIL_KIND_REFERENCE 1U
+#define FSIL_KIND_STATUS 2U
+#define FSIL_KIND_PING_REPLY 3U
+
+/* What FSIL_controllerReceive() did with a frame */
+#define FSIL_IGNORED 0
+#define FSIL_STATUS 1
+#define FSIL_PING_REPLY 2
+
+/* Frame words: sequence, start (words 1 and 2, low first), frequency as an IEEE single (3 and 4) */
+typedef struct {
+    uint16_t sequence; // 8 bits, one more for each reference sent
+    uint32_t start; // Sample to apply it from
+    float frequency; // (Hz)
+} FSIL_Reference;
+
+/* Frame words: sequence, sample (1 and 2), sample ticks (3 and 4), frequency (5 and 6), errors (7) */
+typedef struct {
+    uint16_t sequence; // Of the reference in use
+    uint32_t sample; // The last sample
+    uint32_t sample_ticks; // Its timestamp
+    float frequency; // In use
+    uint16_t errors; // References refused, late or lost, low 16 bits
+} FSIL_Status;
+
+/* Frame words: tag, arrived (1 and 2), replied (3 and 4) */
+typedef struct {
+    uint16_t tag;
+    uint32_t arrived; // Ticks when the ping frame came in
+    uint32_t replied; // Ticks when the reply started
+} FSIL_PingReply;
+
+/* The generator's end */
+typedef struct {
+    volatile const uint16_t *ring; // FSIL_RX_RING_FRAMES frames, written by the DMA
+    uint16_t tail; // Next slot to decode
+    uint16_t synced; // A reference has been seen, so expected is valid
+    uint16_t expected; // Sequence of the next reference
+    FSIL_Reference queue[FSIL_REFERENCE_QUEUE];
+    uint16_t queue_head;
+    uint16_t queue_tail;
+    uint16_t has_pending; // Taken by the generator, start not reached yet
+    FSIL_Reference pending;
+    FSIL_Reference applied; // The reference in use (sequence and frequency)
+    uint32_t received; // References decoded and valid, queue overflows included
+    uint32_t refused; // Frames of the wrong kind, or a frequency or start out of range
+    uint32_t late; // References for a sample already past, applied from the next one
+    uint32_t lost; // Gaps in the sequence: damaged on the line or overwritten in the ring
+    uint32_t overflows; // Valid references dropped because the queue was full
+    uint32_t line_errors; // Damaged frames the FSI reported (counted by the port)
+    uint32_t pings; // Ping frames answered
+    uint32_t statuses; // Status frames sent
+} FSIL_Receiver;
+
+/* The controller's end: one ping outstanding per tag */
+typedef struct {
+    uint16_t sequence; // Of the next reference
+    uint16_t tag; // Of the next ping
+    uint16_t outstanding; // Bit per tag
+    uint32_t ping_sent[FSIL_PING_TAGS]; // When each was sent
+    FSIL_Status status; // The latest
+    uint16_t has_status;
+    int32_t offset; // Generator ticks less controller ticks, from the latest ping
+    uint16_t has_offset;
+    uint32_t round_trip; // Latest ping, time in the generator included (ticks)
+    uint32_t link_delay; // Latest ping, one way: half the round trip less the time in the generator (ticks)
+    uint32_t min_link_delay;
+    uint32_t max_link_delay;
+    uint32_t replies;
+    uint32_t pings_lost; // Tags reused before their reply came
+    uint32_t strays; // Replies to a tag not outstanding
+} FSIL_Controller;
+
+static inline void FSIL_longToWords(uint32_t value, uint16_t *words) {
+    words[0] = (uint16_t)(value & 0xFFFFU);
+    words[1] = (uint16_t)(value >> 16);
+}
+
+static inline uint32_t FSIL_wordsToLong(const volatile uint16_t *words) {
+    return (uint32_t)words[0] | (uint32_t)words[1] << 16;
+}
+
+static inline float FSIL_toFloat(uint32_t bits) {
+    union {
+        uint32_t bits;
+        float value;
+    } u;
+    u.bits = bits;
+    return u.value;
+}
+
+static inline uint32_t FSIL_fromFloat(float value) {
+    union {
+        uint32_t bits;
+        float value;
+    } u;
+    u.value = value;
+    return u.bits;
+}
+
+static inline uint16_t FSIL_header(uint16_t kind, uint16_t low) {
+    return (uint16_t)(kind << 8 | (low & 0xFFU));
+}
+
+static inline void FSIL_encodeReference(const FSIL_Reference *reference, uint16_t *words) {
+    words[0] = FSIL_header(FSIL_KIND_REFERENCE, reference->sequence);
+    FSIL_longToWords(reference->start, words + 1);
+    FSIL_longToWords(FSIL_fromFloat(reference->frequency), words + 3);
+    words[5] = 0;
+    words[6] = 0;
+    words[7] = 0;
+}
+
+/* False if it isn't a reference or its frequency is out of range, NaN included */
+static inline bool FSIL_decodeReference(const volatile uint16_t *words, FSIL_Reference *reference) {
+    if (words[0] >> 8 != FSIL_KIND_REFERENCE) {
+        return false;
+    }
+    reference->sequence = words[0] & 0xFFU;
+    reference->start = FSIL_wordsToLong(words + 1);
+    reference->frequency = FSIL_toFloat(FSIL_wordsToLong(words + 3));
+    return reference->frequency >= 0.0f && reference->frequency <= FSIL_MAX_FREQUENCY;
+}
+
+static inline void FSIL_encodeStatus(const FSIL_Status *status, uint16_t *words) {
+    words[0] = FSIL_header(FSIL_KIND_STATUS, status->sequence);
+    FSIL_longToWords(status->sample, words + 1);
+    FSIL_longToWords(status->sample_ticks, words + 3);
+    FSIL_longToWords(FSIL_fromFloat(status->frequency), words + 5);
+    words[7] = status->errors;
+}
+
+static inline void FSIL_decodeStatus(const uint16_t *words, FSIL_Status *status) {
+    status->sequence = words[0] & 0xFFU;
+    status->sample = FSIL_wordsToLong(words + 1);
+    status->sample_ticks = FSIL_wordsToLong(words + 3);
+    status->frequency = FSIL_toFloat(FSIL_wordsToLong(words + 5));
+    status->errors = words[7];
+}
+
+static inline void FSIL_encodePingReply(const FSIL_PingReply *reply, uint16_t *words) {
+    words[0] = FSIL_header(FSIL_KIND_PING_REPLY, reply->tag);
+    FSIL_longToWords(reply->arrived, words + 1);
+    FSIL_longToWords(reply->replied, words + 3);
+    words[5] = 0;
+    words[6] = 0;
+    words[7] = 0;
+}
+
+static inline void FSIL_decodePingReply(const uint16_t *words, FSIL_PingReply *reply) {
+    reply->tag = words[0] & 0xFFU;
+    reply->arrived = FSIL_wordsToLong(words + 1);
+    reply->replied = FSIL_wordsToLong(words + 3);
+}
+
+/*** The generator's end ***/
+
+/* ring is FSIL_RX_RING_FRAMES*FSIL_FRAME_WORDS words, the DMA's destination */
+static inline void FSIL_initReceiver(FSIL_Receiver *r, volatile const uint16_t *ring, float frequency) {
+    r->ring = ring;
+    r->tail = 0;
+    r->synced = 0;
+    r->expected = 0;
+    r->queue_head = 0;
+    r->queue_tail = 0;
+    r->has_pending = 0;
+    r->applied.sequence = 0;
+    r->applied.start = 0;
+    r->applied.frequency = frequency;
+    r->pending = r->applied;
+    r->received = 0;
+    r->refused = 0;
+    r->late = 0;
+    r->lost = 0;
+    r->overflows = 0;
+    r->line_errors = 0;
+    r->pings = 0;
+    r->statuses = 0;
+}
+
+/* Decodes one frame out of the ring */
+static inline void FSIL_receiveFrame(FSIL_Receiver *r, const volatile uint16_t *words, uint32_t sample) {
+    if (words[0] >> 8 != FSIL_KIND_REFERENCE) {
+        r->refused++;
+        return;
+    }
+    uint16_t sequence = words[0] & 0xFFU;
+    if (r->synced) {
+        r->lost += (uint16_t)(sequence - r->expected) & 0xFFU;
+    }
+    r->expected = (sequence + 1U) & 0xFFU;
+    r->synced = 1;
+
+    FSIL_Reference reference;
+    if (!FSIL_decodeReference(words, &reference)) {
+        r->refused++;
+        return;
+    }
+    int32_t lead = (int32_t)(reference.start - sample);
+    if (lead > (int32_t)FSIL_MAX_LEAD) {
+        r->refused++;
+        return;
+    }
+    r->received++;
+    if (lead <= 0) {
+        r->late++; // Applied from the next sample all the same
+    }
+    if ((uint16_t)(r->queue_head - r->queue_tail) >= FSIL_REFERENCE_QUEUE) {
+        r->overflows++;
+        return;
+    }
+    r->queue[r->queue_head & (FSIL_REFERENCE_QUEUE - 1U)] = reference;
+    r->queue_head++;
+}
+
+/* Decodes the frames the DMA has written since the last call, in order. position is the slot it's writing
+ * now (a partly written frame is left for the next call), sample the generator's last sample. Returns the
+ * number of frames decoded. */
+static inline uint16_t FSIL_receive(FSIL_Receiver *r, uint16_t position, uint32_t sample) {
+    uint16_t count = 0;
+    for (uint16_t tail = r->tail; tail != position; tail = (tail + 1U) & (FSIL_RX_RING_FRAMES - 1U)) {
+        FSIL_receiveFrame(r, r->ring + tail*FSIL_FRAME_WORDS, sample);
+        count++;
+    }
+    r->tail = position;
+    return count;
+}
+
+/* The oldest queued reference, or 0. The generator calls FSIL_referenceTaken() once it has committed it. */
+static inline const FSIL_Reference *FSIL_nextReference(const FSIL_Receiver *r) {
+    if (r->queue_head == r->queue_tail) {
+        return 0;
+    }
+    return &r->queue[r->queue_tail & (FSIL_REFERENCE_QUEUE - 1U)];
+}
+
+static inline void FSIL_referenceTaken(FSIL_Receiver *r) {
+    if (r->has_pending) {
+        r->applied = r->pending; // The generator only takes one when it's finished with the last
+    }
+    r->pending = r->queue[r->queue_tail & (FSIL_REFERENCE_QUEUE - 1U)];
+    r->has_pending = 1;
+    r->queue_tail++;
+}
+
+/* The status for sample, and the generator's frequency in use */
+static inline void FSIL_status(FSIL_Receiver *r, uint32_t sample, uint32_t sample_ticks, float frequency,
+                               FSIL_Status *status) {
+    if (r->has_pending && (int32_t)(sample - r->pending.start) >= 0) {
+        r->applied = r->pending;
+        r->has_pending = 0;
+    }
+    status->sequence = r->applied.sequence;
+    status->sample = sample;
+    status->sample_ticks = sample_ticks;
+    status->frequency = frequency;
+    status->errors = (uint16_t)(r->refused + r->late + r->lost);
+    r->statuses++;
+}
+
+/*** The controller's end ***/
+
+static inline void FSIL_initController(FSIL_Controller *c) {
+    c->sequence = 0;
+    c->tag = 0;
+    c->outstanding = 0;
+    for (uint16_t k = 0; k < FSIL_PING_TAGS; k++) {
+        c->ping_sent[k] = 0;
+    }
+    c->has_status = 0;
+    c->offset = 0;
+    c->has_offset = 0;
+    c->round_trip = 0;
+    c->link_delay = 0;
+    c->min_link_delay = 0xFFFFFFFFUL;
+    c->max_link_delay = 0;
+    c->replies = 0;
+    c->pings_lost = 0;
+    c->strays = 0;
+}
+
+/* The next reference's frame words */
+static inline void FSIL_encodeNextReference(FSIL_Controller *c, float frequency, uint32_t start, uint16_t *words) {
+    FSIL_Reference reference;
+    reference.sequence = c->sequence;
+    reference.start = start;
+    reference.frequency = frequency;
+    FSIL_encodeReference(&reference, words);
+    c->sequence = (c->sequence + 1U) & 0xFFU;
+}
+
+/* The tag for a ping frame sent at now. A tag still outstanding from 16 pings ago is counted lost. */
+static inline uint16_t FSIL_ping(FSIL_Controller *c, uint32_t now) {
+    uint16_t tag = c->tag;
+    c->pings_lost += (c->outstanding >> tag) & 1U;
+    c->outstanding |= 1U << tag;
+    c->ping_sent[tag] = now;
+    c->tag = (tag + 1U) & (FSIL_PING_TAGS - 1U);
+    return tag;
+}
+
+/* A frame from the generator, received at now */
+static inline uint16_t FSIL_controllerReceive(FSIL_Controller *c, const uint16_t *words, uint32_t now) {
+    uint16_t kind = words[0] >> 8;
+    if (kind == FSIL_KIND_STATUS) {
+        FSIL_decodeStatus(words, &c->status);
+        c->has_status = 1;
+        return FSIL_STATUS;
+    }
+    if (kind != FSIL_KIND_PING_REPLY) {
+        return FSIL_IGNORED;
+    }
+    FSIL_PingReply reply;
+    FSIL_decodePingReply(words, &reply);
+    if (reply.tag >= FSIL_PING_TAGS || !((c->outstanding >> reply.tag) & 1U)) {
+        c->strays++;
+        return FSIL_IGNORED;
+    }
+    c->outstanding &= ~(1U << reply.tag);
+    uint32_t sent = c->ping_sent[reply.tag];
+    uint32_t held = reply.replied - reply.arrived;
+    c->round_trip = now - sent;
+    c->link_delay = (c->round_trip - held)/2U;
+    c->offset = (int32_t)((reply.arrived - sent) - c->link_delay); // The generator's clock when the ping arrived, less ours
+    c->has_offset = 1;
+    c->min_link_delay = c->link_delay < c->min_link_delay ? c->link_delay : c->min_link_delay;
+    c->max_link_delay = c->link_delay > c->max_link_delay ? c->link_delay : c->max_link_delay;
+    c->replies++;
+    return FSIL_PING_REPLY;
+}
+
+/* The first generator sample at or after controller time ticks, from the latest status and offset. Only
+ * valid once both have been received (has_status and has_offset). */
+static inline uint32_t FSIL_sampleAt(const FSIL_Controller *c, uint32_t ticks) {
+    int32_t after = (int32_t)(ticks + (uint32_t)c->offset - c->status.sample_ticks); // Generator ticks from the status sample
+    if (after <= 0) {
+        return c->status.sample - (uint32_t)(-after/FSIL_TICKS_PER_SAMPLE);
+    }
+    return c->status.sample + (uint32_t)((after + FSIL_TICKS_PER_SAMPLE - 1)/FSIL_TICKS_PER_SAMPLE);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FSI_LINK_H_ */
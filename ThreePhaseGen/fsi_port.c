@@ -0,0 +1,93 @@
+/*
+ * fsi_port.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ */
+
+#include "threephasegen.h"
+#include "fsi_port.h"
+
+// fsi_link.h is portable, so it has its own copies of the generator's settings
+#if FSIL_TICK_HZ != PLLSYSCLK || FSIL_TICKS_PER_SAMPLE != PLLSYSCLK/SAMPLING_FREQUENCY
+#error "fsi_link.h's clock doesn't match clock_config.h and threephasegen.h"
+#endif
+#if FSIL_MAX_FREQUENCY != MAX_SINUSOID_FREQUENCY
+#error "FSIL_MAX_FREQUENCY doesn't match MAX_SINUSOID_FREQUENCY"
+#endif
+
+#define RX_ERRORS (HAL_FSI_RX_EVT_CRC_ERR | HAL_FSI_RX_EVT_EOF_ERR | HAL_FSI_RX_EVT_TYPE_ERR | HAL_FSI_RX_EVT_ERR_FRAME)
+
+FSIL_Receiver fsiReceiver;
+
+static volatile uint16_t fsiRing[FSIL_RX_RING_FRAMES*FSIL_FRAME_WORDS] __attribute__((section("ramgs0")));
+
+static bool txBusy;
+static uint32_t lastStatus; // Sample of the last status frame
+
+void FSIPORT_init(void) {
+    FSIL_initReceiver(&fsiReceiver, fsiRing, SINUSOID_FREQUENCY);
+
+    HAL_initFsi(FSI_PORT_TX_BASE, FSI_PORT_RX_BASE, FSI_PORT_PRESCALER, FSIL_FRAME_WORDS); // TXCLK from PLLRAWCLK
+    HAL_startFsiRxDma(FSI_PORT_DMA, FSI_PORT_RX_BASE, fsiRing, FSIL_RX_RING_FRAMES, FSIL_FRAME_WORDS);
+}
+
+/* The slot the DMA is writing. At the end of the ring it's back at the start. */
+static uint16_t dmaPosition(void) {
+    uint32_t offset = HAL_getDmaDestinationOffset(FSI_PORT_DMA, fsiRing);
+    return (uint16_t)(offset/FSIL_FRAME_WORDS) & (FSIL_RX_RING_FRAMES - 1U);
+}
+
+static void send(const uint16_t *words) {
+    HAL_sendFsiFrame(FSI_PORT_TX_BASE, words, FSIL_FRAME_WORDS);
+    txBusy = true;
+}
+
+void FSIPORT_poll(void) {
+    // Damaged frames never reach the DMA. At most one a poll is counted, and the references' sequence counts the rest.
+    uint16_t events = HAL_getFsiRxEvents(FSI_PORT_RX_BASE);
+    if (events & RX_ERRORS) {
+        fsiReceiver.line_errors++;
+        HAL_clearFsiRxEvents(FSI_PORT_RX_BASE, RX_ERRORS);
+    }
+
+    uint32_t sample, ticks;
+    TPG_getSample(&sample, &ticks);
+    FSIL_receive(&fsiReceiver, dmaPosition(), sample);
+    const FSIL_Reference *reference = FSIL_nextReference(&fsiReceiver);
+    if (reference && TPG_setFrequencyAt(reference->frequency, reference->start)) { // False until the last one's started
+        FSIL_referenceTaken(&fsiReceiver);
+    }
+
+    if (txBusy) {
+        if (!(HAL_getFsiTxEvents(FSI_PORT_TX_BASE) & HAL_FSI_TX_EVT_FRAME_DONE)) {
+            return;
+        }
+        HAL_clearFsiTxEvents(FSI_PORT_TX_BASE, HAL_FSI_TX_EVT_FRAME_DONE);
+        txBusy = false;
+    }
+
+    uint16_t words[FSIL_FRAME_WORDS];
+    if (events & HAL_FSI_RX_EVT_PING_FRAME) {
+        FSIL_PingReply reply;
+        uint32_t age, now;
+        do { // Again if another ping came in between
+            HAL_clearFsiRxEvents(FSI_PORT_RX_BASE, HAL_FSI_RX_EVT_PING_FRAME);
+            age = HAL_getFsiPingAge(FSI_PORT_RX_BASE);
+            now = TPG_ticks();
+            reply.tag = HAL_getFsiPingTag(FSI_PORT_RX_BASE);
+        } while (HAL_getFsiRxEvents(FSI_PORT_RX_BASE) & HAL_FSI_RX_EVT_PING_FRAME);
+        reply.arrived = now - age; // An interrupt between the two reads only makes it look a little earlier
+        reply.replied = TPG_ticks();
+        FSIL_encodePingReply(&reply, words);
+        send(words);
+        fsiReceiver.pings++;
+    }
+    else if ((uint32_t)(sample - lastStatus) >= FSI_PORT_STATUS_SAMPLES) {
+        FSIL_Status status;
+        FSIL_status(&fsiReceiver, sample, ticks, tpgInUse->frequency, &status);
+        FSIL_encodeStatus(&status, words);
+        send(words);
+        lastStatus = sample;
+    }
+}
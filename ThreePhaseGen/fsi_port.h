@@ -0,0 +1,60 @@
+/*
+ * fsi_port.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  FSIA on the generator: references from a controller and status back (fsi_link.h), one lane each way
+ *  (TX: GPIO27 clock, GPIO26 data. RX: GPIO13 clock, GPIO12 data).
+ *
+ *  Received data frames are copied by DMA channel 1, which the FSI triggers at the end of each one, into a
+ *  ring of frames in RAMGS0 (the DMA can't reach the LSx RAM). A burst is one frame: the source wraps with
+ *  the FSI's 16-word receive buffer every two bursts, and the destination runs round the ring in continuous
+ *  mode. Nothing interrupts the CPU for a data frame. The background works out the slot being written from
+ *  the DMA's active destination address.
+ *
+ *  Ping frames from the controller don't interrupt either. The FSI's ping watchdog counts SYSCLK cycles
+ *  from the last one, so the background works out when it arrived from the counter, exactly, however long
+ *  after it looks.
+ *
+ *  Everything is in FSIPORT_poll(), from the main loop, which runs whenever an interrupt wakes the CPU from
+ *  IDLE, so at least once a sample: it decodes the ring, gives the generator the next reference, counts the
+ *  frames the FSI dropped, and sends a ping reply or the status frame when one is due. The CPU writes frames
+ *  out through the transmit buffer one at a time: a few per millisecond don't need the DMA.
+ *
+ *  The FSI and DMA are behind fsi_hal.h, so this file also runs on a host PC against a simulated link
+ *  (HostSim bench "fsi").
+ */
+
+#ifndef FSI_PORT_H_
+#define FSI_PORT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fsi_link.h"
+#include "fsi_hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FSI_PORT_TX_BASE HAL_FSITXA_BASE
+#define FSI_PORT_RX_BASE HAL_FSIRXA_BASE
+#define FSI_PORT_DMA HAL_DMA_CH1_BASE
+#define FSI_PORT_PRESCALER 2 // TXCLK = PLLRAWCLK/2 = 25 MHz
+#define FSI_PORT_BIT_RATE (2UL*PLLRAWCLK/FSI_PORT_PRESCALER) // Data on both clock edges: 50 Mbit/s
+#define FSI_PORT_STATUS_SAMPLES 50 // A status frame every 50 samples: 1 kHz
+
+extern FSIL_Receiver fsiReceiver;
+
+/* Configures FSIA, its pins and the receive DMA */
+void FSIPORT_init(void);
+
+/* From the main loop after each wake up */
+void FSIPORT_poll(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FSI_PORT_H_ */
@@ -0,0 +1,47 @@
+/*
+ * hal.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Thin hardware abstraction layer so the waveform code also builds with gcc on a host PC.
+ *
+ *  The backend is chosen at compile time, there are no function pointers:
+ *  - hal_registers.h: driverlib calls and register writes. The default. The functions used in the
+ *    timer interrupt are macros, so the ISR is the same code as writing EPwmxRegs directly.
+ *  - HostSim/include/hal_sim.h: writes into simulated peripherals. Selected by defining HAL_SIMULATED,
+ *    which only the host build does.
+ *
+ *  The constants are the register field encodings from the TRM (the same values as the driverlib enums).
+ */
+
+#ifndef HAL_H_
+#define HAL_H_
+
+#include <stdint.h>
+
+// ePWM clock dividers (TBCTL.CLKDIV and TBCTL.HSPCLKDIV)
+#define HAL_PWM_CLOCK_DIVIDER_1 0
+#define HAL_PWM_HSCLOCK_DIVIDER_1 0
+
+// ePWM counter modes (TBCTL.CTRMODE)
+#define HAL_PWM_COUNTER_UP 0
+#define HAL_PWM_COUNTER_DOWN 1
+#define HAL_PWM_COUNTER_UP_DOWN 2
+
+// ePWM action qualifier actions for output A (AQCTLA bits)
+#define HAL_AQ_LOW_ZERO 0x01
+#define HAL_AQ_HIGH_ZERO 0x02
+#define HAL_AQ_LOW_UP_CMPA 0x10
+#define HAL_AQ_HIGH_DOWN_CMPA 0x80
+
+// ePWM base addresses, the same for the real and simulated peripherals
+#define HAL_PWM_BASE(module) (0x00004000U + (uint32_t)(module) * 0x00000100U)
+
+#if defined(HAL_SIMULATED)
+#include "hal_sim.h"
+#else
+#include "hal_registers.h"
+#endif
+
+#endif /* HAL_H_ */
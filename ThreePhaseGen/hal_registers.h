@@ -0,0 +1,65 @@
+/*
+ * hal_registers.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Register backend of the HAL (see hal.h).
+ */
+
+#ifndef HAL_REGISTERS_H_
+#define HAL_REGISTERS_H_
+
+#include <f28002x_device.h>
+#include <driverlib.h>
+
+/*** ePWM ***/
+static inline uint32_t HAL_pwmBase(EPWM_Module module) {
+    return EPWM1_BASE + module * 0x00000100U; // Base address of registers. See <inc/hw.memmap.h> in driverlib
+}
+
+static inline void HAL_enablePwm(EPWM_Module module, EPWM_Outputs outputs) {
+    EPWM_enableModule(module, outputs); // Call the function I defined in the ePWM DriverLib file.
+}
+
+static inline void HAL_setPwmClockDivider(uint32_t base, uint16_t divider, uint16_t hs_divider) {
+    EPWM_setClockPrescaler(base, (EPWM_ClockDivider)divider, (EPWM_HSClockDivider)hs_divider);
+}
+
+static inline void HAL_setPwmPeriod(uint32_t base, uint16_t period) {
+    EPWM_setTimeBasePeriod(base, period);
+}
+
+static inline void HAL_setPwmCounterMode(uint32_t base, uint16_t mode) {
+    EPWM_setTimeBaseCounterMode(base, (EPWM_TimeBaseCountMode)mode);
+}
+
+static inline void HAL_setPwmActionQualifiersA(uint32_t base, uint16_t actions) {
+    EPWM_setActionQualifierActionComplete(base, EPWM_AQ_OUTPUT_A, actions);
+}
+
+static inline void HAL_enablePwmTimeBaseSync(void) {
+    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_TBCLKSYNC); // Enable time base clocks for all ePWM modules
+}
+
+// Used in the ISR. With a constant base these are single accesses to fixed addresses, the same as EPwmxRegs.
+#define HAL_getPwmPeriod(base) HWREGH((base) + EPWM_O_TBPRD)
+#define HAL_writePwmCompareA(base, value) (HWREGH((base) + EPWM_O_CMPA + 1) = (value)) // '+1' for the high word of CMPA
+
+/*** CPU timers ***/
+static inline uint32_t HAL_cpuTimerBase(uint16_t index) {
+    return CPUTIMER0_BASE + index * (CPUTIMER1_BASE - CPUTIMER0_BASE);
+}
+
+static inline void HAL_configCpuTimer(uint32_t base, uint32_t period_count, uint16_t clock_divider) {
+    CPUTimer_setConfig(base, period_count, clock_divider);
+    CPUTimer_startTimer(base); // Start timer. Not actually necessary since timer starts automatically by default.
+}
+
+static inline void HAL_setCpuTimerInterrupt(uint32_t base, void (*handler)(void)) {
+    CPUTimer_configInterrupt(base, handler);
+}
+
+#define HAL_readCpuTimer(base) HWREG((base) + CPUTIMER_O_TIM) // TIM, one 32-bit read. Used in the ISR.
+
+#endif /* HAL_REGISTERS_H_ */
@@ -4,16 +4,22 @@
  *
  * This generates three sinusoids using PWM. The PWM will be filtered using a low pass
  * filter to give the sinusoids.
+ *
+ * References and status go over the FSI link (fsi_port.h), serviced after every interrupt wakes the CPU.
  */
 
+#include "system_config.h"
 #include "threephasegen.h"
+#include "fsi_port.h"
 
 int main(void) {
     ConfigSystem();
     ConfigThreePhaseGen();
+    FSIPORT_init();
     EnableInterrupts(); // Enables global interrupts
 
     while (1) {
         IDLE; // Execute the IDLE instruction to make the CPU go into sleep mode.
+        FSIPORT_poll(); // Woken by an interrupt: at least once a sample
     }
 }
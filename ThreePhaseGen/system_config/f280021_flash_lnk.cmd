@@ -11,9 +11,10 @@ MEMORY
    RAMLS6           : origin = 0x0000B000, length = 0x00000800
    RAMLS7           : origin = 0x0000B800, length = 0x00000800*/
 
-   /* Combining all the LS RAMs */
-   RAMLS4567        : origin = 0x0000A000, length = 0x00002000
-   RAMGS0           : origin = 0x0000C000, length = 0x000007F8
+   /* Combining LS4 to LS6. LS7 holds the hot constants. */
+   RAMLS456         : origin = 0x0000A000, length = 0x00001800
+   RAMLS7           : origin = 0x0000B800, length = 0x00000800     /* Hot constants (ramconsts) budget */
+   RAMGS0           : origin = 0x0000C000, length = 0x000007F8     /* Hot code (.TI.ramfunc) budget */
 // RAMGS0_RSVD      : origin = 0x0000C7F8, length = 0x00000008 /* Reserve and do not use for code as per the errata advisory "Memory: Prefetching Beyond Valid Memory" */
 
 
@@ -42,18 +43,18 @@ SECTIONS
    .stack           : > RAMM1
 
    .init_array      : > FLASH_BANK0_SEC3,  ALIGN(8)
-   .bss             : > RAMLS4567
-   .bss:output      : > RAMLS4567
+   .bss             : > RAMLS456
+   .bss:output      : > RAMLS456
    .bss:cio         : > RAMGS0
    .const           : > FLASH_BANK0_SEC3,  ALIGN(8)
-   .data            : > RAMLS4567
-   .sysmem          : > RAMLS4567
+   .data            : > RAMLS456
+   .sysmem          : > RAMLS456
 
-    ramgs0 : > RAMGS0
+    ramgs0 : > RAMGS0 /* DMA buffers (fsi_port.c): the DMA can't reach LSx. Shares the hot code budget. */
 
     /*  Allocate IQ math areas: */
-   IQmath           : > RAMLS4567
-   IQmathTables     : > RAMLS4567
+   IQmath           : > RAMLS456
+   IQmathTables     : > RAMLS456
 
   .TI.ramfunc      : LOAD = FLASH_BANK0_SEC2,
                   RUN = RAMGS0,
@@ -65,6 +66,15 @@ SECTIONS
                   RUN_END(RamfuncsRunEnd),
                   ALIGN(8)
 
+  /* Constants read by the hot path (the waveform table, see hot_path.h), copied from flash by InitRam().
+   * The hot code must fit RAMGS0 and these RAMLS7, so the link fails if either hot set outgrows its block. */
+  ramconsts        : LOAD = FLASH_BANK0_SEC3,
+                  RUN = RAMLS7,
+                  LOAD_START(RamconstsLoadStart),
+                  LOAD_SIZE(RamconstsLoadSize),
+                  RUN_START(RamconstsRunStart),
+                  ALIGN(8)
+
 }
 /*
 //===========================================================================
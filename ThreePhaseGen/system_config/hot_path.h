@@ -0,0 +1,29 @@
+/*
+ * hot_path.h
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: Charley Shi
+ *
+ *  Places the timer ISR in zero-wait-state RAM. Nothing sets up the flash wait states, so flash runs at
+ *  the reset default (the maximum), and even when tuned the prefetch buffer only helps straight-line code.
+ *  The ISR runs faster and with less jitter from RAM.
+ *  - HOT_ISR: interrupt service routines (.TI.ramfunc:isr)
+ *
+ *  The waveform table it reads is put in ramconsts by TableGen ("section": "ramconsts" in its spec).
+ *  Both are loaded to flash and copied to RAM by InitRam(). .TI.ramfunc runs from RAMGS0 and ramconsts
+ *  from RAMLS7. Each block is the budget for its hot set: the link fails if the set no longer fits.
+ *
+ *  Put the macro before the declaration: HOT_ISR interrupt void myISR() {...}
+ *  On the host (HostSim) it is empty. CPU1_Controller's hot_path.h has the same for kernels and constants.
+ */
+
+#ifndef HOT_PATH_H_
+#define HOT_PATH_H_
+
+#if defined(__TI_COMPILER_VERSION__)
+#define HOT_ISR __attribute__((section(".TI.ramfunc:isr")))
+#else
+#define HOT_ISR
+#endif
+
+#endif /* HOT_PATH_H_ */
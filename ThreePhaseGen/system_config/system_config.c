@@ -80,6 +80,7 @@ void ConfigPllSysClock() {
 
 void InitRam() {
     memcpy((uint32_t *)&RamfuncsRunStart, (uint32_t *)&RamfuncsLoadStart, (uint32_t)&RamfuncsLoadSize);
+    memcpy((uint32_t *)&RamconstsRunStart, (uint32_t *)&RamconstsLoadStart, (uint32_t)&RamconstsLoadSize);
 }
 
 /* Enables the PIE and global interrupts */
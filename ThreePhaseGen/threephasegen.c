@@ -12,76 +12,165 @@
  */
 
 #include "threephasegen.h"
-#include <math.h>
+#include "hot_path.h"
+#include "waveform_table.h" // Generated from waveform_table.json by TableGen/tablegen.py
 
-static float sinusoidDutyCycles[(Uint16)N_SAMPLES]; // Array stores all the duty cycles for each sample. Assumes zero phase.
+// The compare values are generated at build time, so they must match the sampling and PWM settings here
+#if WAVE_COMPARE_SIZE != N_SAMPLES
+#error "waveform_table.json size doesn't match N_SAMPLES. Update it and rerun TableGen/tablegen.py."
+#endif
+#if WAVE_COMPARE_PERIOD != PLLSYSCLK/PWM_FREQUENCY
+#error "waveform_table.json period doesn't match the ePWM period. Update it and rerun TableGen/tablegen.py."
+#endif
 
-// Initialise these to include phase information.
-Uint16 PhaseA_Index = (Uint16)((float)PHASEA_PHASE_DEGREES/360.0 * N_SAMPLES); // Index of sinusoidDutyCycles for duty cycle of phase A
-Uint16 PhaseB_Index = (Uint16)((float)PHASEB_PHASE_DEGREES/360.0 * N_SAMPLES); // Index of sinusoidDutyCycles for duty cycle of phase B
-Uint16 PhaseC_Index = (Uint16)((float)PHASEC_PHASE_DEGREES/360.0 * N_SAMPLES); // Index of sinusoidDutyCycles for duty cycle of phase C
+#define PHASEB_OFFSET (uint16_t)((float)PHASEB_PHASE_DEGREES/360.0 * N_SAMPLES) // Table samples from phase A
+#define PHASEC_OFFSET (uint16_t)((float)PHASEC_PHASE_DEGREES/360.0 * N_SAMPLES)
+#define TABLE_PHASE ((uint32_t)N_SAMPLES << 16) // One period in 16.16 table samples
 
-void ConfigThreePhaseGen() { // Configures everything using the other functions
-    // Initialise the sinusoidDutyCycles array
-    int i;
-    for (i = 0; i < N_SAMPLES; i++) {
-        sinusoidDutyCycles[i] = 0.5 + 0.5*sin(i*2*M_PI/N_SAMPLES); // 0.5*sin(2pi*i/N) + 0.5
-    }
+static uint32_t phase = (uint32_t)((float)PHASEA_PHASE_DEGREES/360.0 * N_SAMPLES) << 16; // Phase A in 16.16 table samples
+uint16_t PhaseA_Index; // Index of WAVE_compareTable for phase A
+uint16_t PhaseB_Index; // Index of WAVE_compareTable for phase B
+uint16_t PhaseC_Index; // Index of WAVE_compareTable for phase C
 
+static TPG_Parameters parameters[2] = {
+    {SINUSOID_FREQUENCY, 1UL << 16, 0, 0}, // One table sample per ISR
+    {SINUSOID_FREQUENCY, 1UL << 16, 0, 0}
+};
+TPG_Parameters *volatile tpgActive = &parameters[0];
+const TPG_Parameters *volatile tpgInUse = &parameters[0];
+volatile uint32_t tpgVersion;
+volatile uint32_t tpgSample;
+volatile uint32_t tpgSampleTicks;
+#if TPG_ISR_PROFILE
+volatile uint32_t tpgIsrCyclesMin = 0xFFFFFFFFUL;
+volatile uint32_t tpgIsrCyclesMax = 0;
+#endif
+
+void ConfigThreePhaseGen() { // Configures everything using the other functions
     ConfigTimer();
 
     // Configure PWMs
     ConfigEpwmPhase(EPWM4); // Phase A
     ConfigEpwmPhase(EPWM5); // Phase B
     ConfigEpwmPhase(EPWM6); // Phase C
-    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_TBCLKSYNC); // Enable time base clocks for all ePWM modules
+    HAL_enablePwmTimeBaseSync(); // Enable time base clocks for all ePWM modules
 }
 
 void ConfigTimer() {
-    Uint32 base = CPUTIMER1_BASE; // Use Timer 1
-    Uint32 timer_top = PLLSYSCLK/SAMPLING_FREQUENCY - 1; // Top value of timer with /1 prescaler
-    CPUTimer_setConfig(base, timer_top, 1); // /1 prescaler
-    CPUTimer_startTimer(base); // Start timer. Not actually necessary since timer starts automatically by default.
-    CPUTimer_configInterrupt(base, updateDutyCycles); // Assign the ISR as updateDutyCycles()
+    HAL_configCpuTimer(HAL_cpuTimerBase(TIMESTAMP_TIMER), 0xFFFFFFFFUL, 1); // Free running, no interrupt
+
+    uint32_t base = HAL_cpuTimerBase(1); // Use Timer 1
+    uint32_t timer_top = PLLSYSCLK/SAMPLING_FREQUENCY - 1; // Top value of timer with /1 prescaler
+    HAL_configCpuTimer(base, timer_top, 1); // /1 prescaler. Also starts the timer.
+    HAL_setCpuTimerInterrupt(base, updateDutyCycles); // Assign the ISR as updateDutyCycles()
 }
 
 void ConfigEpwmPhase(EPWM_Module module) {
     // Do not enable the output here. Enable it when the mode is changed to 'PWM'
-    EPWM_enableModule(module, EPWM_OUTPUT_A); // Call the function I defined in the ePWM DriverLib file.
-    uint32_t base = EPWM1_BASE + module * 0x00000100U; // Base address of registers. See <inc/hw.memmap.h> in driverlib
+    HAL_enablePwm(module, EPWM_OUTPUT_A);
+    uint32_t base = HAL_pwmBase(module); // Base address of registers
 
     /* Configure time base clock */
-    EPWM_setClockPrescaler(base, EPWM_CLOCK_DIVIDER_1, EPWM_HSCLOCK_DIVIDER_1); // Net prescaler of /1
+    HAL_setPwmClockDivider(base, HAL_PWM_CLOCK_DIVIDER_1, HAL_PWM_HSCLOCK_DIVIDER_1); // Net prescaler of /1
     uint32_t EPWM_clock = PLLSYSCLK; // Prescaled clock
     uint32_t timer_top = EPWM_clock/PWM_FREQUENCY - 1;
-    EPWM_setTimeBasePeriod(base, (Uint16)timer_top);
+    HAL_setPwmPeriod(base, (uint16_t)timer_top);
 
-    EPWM_setTimeBaseCounterMode(base, EPWM_COUNTER_MODE_UP);
+    HAL_setPwmCounterMode(base, HAL_PWM_COUNTER_UP);
 
     /* Configure action qualifiers */
     // Set on bottom (zero), clear on compare match when up counting
-    EPWM_setActionQualifierActionComplete(base, EPWM_AQ_OUTPUT_A,
-                                          EPWM_AQ_OUTPUT_HIGH_ZERO | EPWM_AQ_OUTPUT_LOW_UP_CMPA);
+    HAL_setPwmActionQualifiersA(base, HAL_AQ_HIGH_ZERO | HAL_AQ_LOW_UP_CMPA);
 
 }
 
-interrupt void updateDutyCycles() { // This is the timer interrupt
-    // Update indices
-    PhaseA_Index = incrementIndex(PhaseA_Index);
-    PhaseB_Index = incrementIndex(PhaseB_Index);
-    PhaseC_Index = incrementIndex(PhaseC_Index);
+HOT_ISR interrupt void updateDutyCycles() { // This is the timer interrupt
+    uint32_t ticks = TPG_ticks(); // First, so it's the same point in every period
+    uint32_t sample = tpgSample + 1;
+    const TPG_Parameters *p = tpgActive; // Read once: this period uses this set even if the background commits meanwhile
+    if (p != tpgInUse && (int32_t)(sample - p->start) < 0) {
+        p = tpgInUse; // Committed to start at a later sample: the last set until then
+    }
+    tpgInUse = p; // Tells the background the other set is free once it's the active one
 
-    // Update duty cycles
-    updatePhaseA_Duty(sinusoidDutyCycles[PhaseA_Index]);
-    updatePhaseB_Duty(sinusoidDutyCycles[PhaseB_Index]);
-    updatePhaseC_Duty(sinusoidDutyCycles[PhaseC_Index]);
-}
+    // Advance the phase and index the table for each phase
+    phase += p->phase_step;
+    if (phase >= TABLE_PHASE) {
+        phase -= TABLE_PHASE;
+    }
+    PhaseA_Index = (uint16_t)(phase >> 16);
+    PhaseB_Index = PhaseA_Index + PHASEB_OFFSET;
+    if (PhaseB_Index >= N_SAMPLES) {
+        PhaseB_Index -= N_SAMPLES;
+    }
+    PhaseC_Index = PhaseA_Index + PHASEC_OFFSET;
+    if (PhaseC_Index >= N_SAMPLES) {
+        PhaseC_Index -= N_SAMPLES;
+    }
 
-Uint16 incrementIndex(Uint16 num) {
-    if (num < N_SAMPLES - 1) {
-        return num + 1;
+    // Update duty cycles. The table holds compare values, so there's no float maths here.
+    HAL_writePwmCompareA(PHASEA_PWM_BASE, WAVE_compareTable[PhaseA_Index]);
+    HAL_writePwmCompareA(PHASEB_PWM_BASE, WAVE_compareTable[PhaseB_Index]);
+    HAL_writePwmCompareA(PHASEC_PWM_BASE, WAVE_compareTable[PhaseC_Index]);
+    tpgVersion = p->version;
+    tpgSampleTicks = ticks;
+    tpgSample = sample;
+#if TPG_ISR_PROFILE
+    uint32_t cycles = TPG_ticks() - ticks;
+    if (cycles < tpgIsrCyclesMin) {
+        tpgIsrCyclesMin = cycles;
     }
-    else {
+    if (cycles > tpgIsrCyclesMax) {
+        tpgIsrCyclesMax = cycles;
+    }
+#endif
+}
+
+TPG_Parameters *TPG_editParameters() {
+    TPG_Parameters *active = tpgActive;
+    if (tpgInUse != active) {
         return 0;
     }
+    TPG_Parameters *shadow = active == &parameters[0] ? &parameters[1] : &parameters[0];
+    *shadow = *active;
+    return shadow;
+}
+
+void TPG_commitParameters() {
+    TPG_commitParametersAt(tpgSample); // Already past
+}
+
+void TPG_commitParametersAt(uint32_t start) {
+    TPG_Parameters *active = tpgActive;
+    TPG_Parameters *shadow = active == &parameters[0] ? &parameters[1] : &parameters[0];
+    shadow->version = active->version + 1;
+    shadow->start = start;
+    tpgActive = shadow; // The one write the ISR sees
+}
+
+bool TPG_setFrequency(float frequency) {
+    return TPG_setFrequencyAt(frequency, tpgSample);
+}
+
+bool TPG_setFrequencyAt(float frequency, uint32_t start) {
+    if (!(frequency >= 0.0f && frequency <= MAX_SINUSOID_FREQUENCY)) {
+        return false;
+    }
+    TPG_Parameters *shadow = TPG_editParameters();
+    if (!shadow) {
+        return false;
+    }
+    shadow->frequency = frequency;
+    shadow->phase_step = (uint32_t)(frequency*TABLE_PHASE_PER_HZ + 0.5f);
+    TPG_commitParametersAt(start);
+    return true;
+}
+
+void TPG_getSample(uint32_t *sample, uint32_t *ticks) {
+    uint32_t before;
+    do { // Again if the ISR came in between
+        before = tpgSample;
+        *ticks = tpgSampleTicks;
+        *sample = tpgSample;
+    } while (*sample != before);
 }
@@ -5,44 +5,102 @@
  *  EPWM6A = Phase C
  *
  *  The duty cycles will be updated via timer interrupts which occur at the sampling frequency.
+ *
+ *  The frequency can be changed while running. The waveform's parameters are a set (TPG_Parameters) in
+ *  two slots: the background edits the shadow slot as long as it likes and commits it, which is one
+ *  pointer write, and the ISR takes the committed set at the start of its next period. The ISR never
+ *  copies a set or disables interrupts, and a period never sees half of one.
+ *
+ *  A set can also be committed to start at a given sample (TPG_commitParametersAt()), e.g. a reference
+ *  from the FSI link (fsi_port.h): the ISR keeps using the last set until that sample. Samples are counted
+ *  from start up (tpgSample), and CPU timer 2 runs free at SYSCLK as the generator's clock for timestamps
+ *  (TPG_ticks()).
  */
 
 /** Macros **/
 #ifndef THREEPHASEGEN_H
 #define THREEPHASEGEN_H
 
-#include <f28002x_device.h>
-#include <driverlib.h>
-#include <system_config.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "hal.h" // Register or simulated peripherals
+#include "hot_path.h" // HOT_ISR
+#include "clock_config.h"
 
 #define PWM_FREQUENCY 100000
 
-#define SINUSOID_FREQUENCY 50 // Frequency of the sinusoids to generate
+#define SINUSOID_FREQUENCY 50 // Frequency of the sinusoids at start up
 #define SAMPLING_FREQUENCY 50000 // How frequently the duty cycle in the PWM is updated.
-#define N_SAMPLES (SAMPLING_FREQUENCY/SINUSOID_FREQUENCY) // Number of samples per period of the sinusoid
+#define N_SAMPLES (SAMPLING_FREQUENCY/SINUSOID_FREQUENCY) // Number of samples in the table, one period at SINUSOID_FREQUENCY
+#define MAX_SINUSOID_FREQUENCY 1000 // Highest frequency TPG_setFrequency() takes: 50 samples per period
+#define TABLE_PHASE_PER_HZ (65536.0f*N_SAMPLES/SAMPLING_FREQUENCY) // Phase step per ISR for 1 Hz, in 16.16 table samples
+
+#define TIMESTAMP_TIMER 2 // CPU timer free running at SYSCLK for TPG_ticks()
+#ifndef TPG_ISR_PROFILE
+#define TPG_ISR_PROFILE 0 // 1 = updateDutyCycles() keeps its fewest and most cycles, for HostSim's PIE profile
+#endif
 
 #define PHASEA_PHASE_DEGREES 0 // Phase A is 0 degrees phase
 #define PHASEB_PHASE_DEGREES 120 // Phase B is 120 degrees phase
 #define PHASEC_PHASE_DEGREES 240 // Phase C is 240 degrees phase
 
+#define PHASEA_PWM_BASE HAL_PWM_BASE(EPWM4) // Phase A is on EPWM4
+#define PHASEB_PWM_BASE HAL_PWM_BASE(EPWM5) // Phase B is on EPWM5
+#define PHASEC_PWM_BASE HAL_PWM_BASE(EPWM6) // Phase C is on EPWM6
+
+/** Parameters **/
+typedef struct {
+    float frequency; // Of the sinusoids (Hz)
+    uint32_t phase_step; // Table samples per ISR in 16.16 fixed point
+    uint32_t version; // Incremented by each TPG_commitParameters()
+    uint32_t start; // First sample to use the set. Must be within 2^31 samples (12 hours) of the commit.
+} TPG_Parameters;
+
+extern TPG_Parameters *volatile tpgActive; // The set the next period uses. Written by TPG_commitParameters().
+extern const TPG_Parameters *volatile tpgInUse; // The set the ISR took at the start of its last period
+extern volatile uint32_t tpgVersion; // Version of the set that produced the last duty cycles
+extern volatile uint32_t tpgSample; // Timer interrupts since start up: the sample of the last duty cycles
+extern volatile uint32_t tpgSampleTicks; // TPG_ticks() at the start of that interrupt. Written before tpgSample.
+#if TPG_ISR_PROFILE
+/* SYSCLK cycles from updateDutyCycles()' timestamp to its end, without the context save and restore */
+extern volatile uint32_t tpgIsrCyclesMin;
+extern volatile uint32_t tpgIsrCyclesMax;
+#endif
+
 /** Functions **/
 void ConfigThreePhaseGen(); // Configures everything using the other functions
 void ConfigTimer();
 void ConfigEpwmPhase(EPWM_Module module); // Configures output A on the EPWM module given by module.
-interrupt void updateDutyCycles(); // This is the timer interrupt
-Uint16 incrementIndex(Uint16 num); // Helper function for ISR
+HOT_ISR interrupt void updateDutyCycles(); // This is the timer interrupt
+
+/* Starts a change of the parameters from the background: returns the shadow set, a copy of the active
+ * one, to edit in place, then TPG_commitParameters(). Returns 0 if the ISR hasn't taken the last commit
+ * (at most one sampling period, or until its start sample), as the shadow is still the set it uses. One
+ * context only. */
+TPG_Parameters *TPG_editParameters();
+void TPG_commitParameters(); // The edited set is used whole from the next period, as the next version
+void TPG_commitParametersAt(uint32_t start); // The same from sample start, or the next period if it's past
+bool TPG_setFrequency(float frequency); // Edits and commits. False if out of range or the ISR hasn't taken the last commit.
+bool TPG_setFrequencyAt(float frequency, uint32_t start); // The same, from sample start
+void TPG_getSample(uint32_t *sample, uint32_t *ticks); // tpgSample and its tpgSampleTicks, from the same interrupt
+
+/* The generator's clock: SYSCLK cycles from start up, wrapping every 171 s. One read, so it's the same
+ * from any context. */
+static inline uint32_t TPG_ticks() {
+    return ~HAL_readCpuTimer(HAL_cpuTimerBase(TIMESTAMP_TIMER)); // The timer counts down from 0xFFFFFFFF
+}
 
 /* Functions for updating duty cycle */
 static inline void updatePhaseA_Duty(float D) {
-    EPwm4Regs.CMPA.bit.CMPA = (Uint16)(D * EPwm4Regs.TBPRD);
+    HAL_writePwmCompareA(PHASEA_PWM_BASE, (uint16_t)(D * HAL_getPwmPeriod(PHASEA_PWM_BASE)));
 }
 
 static inline void updatePhaseB_Duty(float D) {
-    EPwm5Regs.CMPA.bit.CMPA = (Uint16)(D * EPwm5Regs.TBPRD);
+    HAL_writePwmCompareA(PHASEB_PWM_BASE, (uint16_t)(D * HAL_getPwmPeriod(PHASEB_PWM_BASE)));
 }
 
 static inline void updatePhaseC_Duty(float D) {
-    EPwm6Regs.CMPA.bit.CMPA = (Uint16)(D * EPwm6Regs.TBPRD);
+    HAL_writePwmCompareA(PHASEC_PWM_BASE, (uint16_t)(D * HAL_getPwmPeriod(PHASEC_PWM_BASE)));
 }
 
 #endif
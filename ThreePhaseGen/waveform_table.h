@@ -0,0 +1,28 @@
+/*
+ * waveform_table.h
+ *
+ *  Generated by TableGen/tablegen.py from waveform_table.json. Don't edit: change the spec and regenerate.
+ *
+ *  Compare values for one period of the sinusoid, so updateDutyCycles() only has to index and store.
+ */
+
+#ifndef WAVEFORM_TABLE_H
+#define WAVEFORM_TABLE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* CMPA for duty 0.5 + 0.5*sin(2*pi*i/N) with the up-count ePWM set at zero and cleared at CMPA (duty = CMPA/PERIOD) */
+#define WAVE_COMPARE_SIZE 1000
+#define WAVE_COMPARE_LENGTH 1000
+#define WAVE_COMPARE_PERIOD 250
+extern const uint16_t WAVE_compareTable[1000];
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WAVEFORM_TABLE_H */